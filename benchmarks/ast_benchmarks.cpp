@@ -0,0 +1,74 @@
+#include <catch2/catch.hpp>
+#include <ast/ast.h>
+
+#include <vector>
+
+namespace {
+	using namespace seam::ast;
+
+	// a balanced tree of 2^depth - 1 nodes
+	std::unique_ptr<expression::Expression> balanced_tree(const int depth) {
+		if (depth == 1) {
+			return std::make_unique<expression::NumberLiteral>(int64_t { 1 });
+		}
+		return std::make_unique<expression::BinaryExpression>(seam::TokenType::OpAdd, balanced_tree(depth - 1), balanced_tree(depth - 1));
+	}
+
+	// a left-leaning chain of about a million nodes, as a long operator chain parses
+	std::unique_ptr<expression::Expression> deep_tree() {
+		std::unique_ptr<expression::Expression> expr = std::make_unique<expression::Identifier>("a");
+		for (auto i = 0; i < 500000; i++) {
+			expr = std::make_unique<expression::BinaryExpression>(
+				seam::TokenType::OpAdd, std::move(expr), std::make_unique<expression::NumberLiteral>(int64_t { 1 }));
+		}
+		return expr;
+	}
+
+	// a program of a million nodes in a thousand functions
+	std::unique_ptr<Program> wide_program() {
+		DeclarationList body;
+		for (auto i = 0; i < 1000; i++) {
+			statement::StatementList statements;
+			for (auto j = 0; j < 110; j++) {
+				auto sum = std::make_unique<expression::BinaryExpression>(seam::TokenType::OpAdd,
+					std::make_unique<expression::Identifier>("a"), std::make_unique<expression::NumberLiteral>(int64_t { j }));
+				auto cond = std::make_unique<expression::BinaryExpression>(seam::TokenType::OpEq, std::move(sum),
+					std::make_unique<expression::Identifier>("b"));
+
+				statement::StatementList then;
+				then.push_back(std::make_unique<statement::ReturnStatement>(std::make_unique<expression::Identifier>("a")));
+				statements.push_back(std::make_unique<statement::IfStatement>(std::move(cond),
+					std::make_unique<statement::StatementBlock>(std::move(then))));
+			}
+			body.push_back(std::make_unique<FunctionDeclaration>("f" + std::to_string(i), ParameterList {}, "i64",
+				std::make_unique<statement::StatementBlock>(std::move(statements))));
+		}
+		return std::make_unique<Program>(std::move(body));
+	}
+}
+
+TEST_CASE("destroying a million node tree") {
+	BENCHMARK_ADVANCED("balanced expression")(Catch::Benchmark::Chronometer meter) {
+		std::vector<std::unique_ptr<expression::Expression>> trees(meter.runs());
+		for (auto& tree : trees) {
+			tree = balanced_tree(20);
+		}
+		meter.measure([&](const int run) { trees[run].reset(); });
+	};
+
+	BENCHMARK_ADVANCED("deep expression")(Catch::Benchmark::Chronometer meter) {
+		std::vector<std::unique_ptr<expression::Expression>> trees(meter.runs());
+		for (auto& tree : trees) {
+			tree = deep_tree();
+		}
+		meter.measure([&](const int run) { trees[run].reset(); });
+	};
+
+	BENCHMARK_ADVANCED("wide program")(Catch::Benchmark::Chronometer meter) {
+		std::vector<std::unique_ptr<Program>> programs(meter.runs());
+		for (auto& program : programs) {
+			program = wide_program();
+		}
+		meter.measure([&](const int run) { programs[run].reset(); });
+	};
+}
@@ -0,0 +1,124 @@
+#include <catch2/catch.hpp>
+#include <backend/x86_64/code_generator.h>
+#include <ir/interpreter.h>
+#include <ir/lowering.h>
+#include <ir/passes.h>
+#include <jit/executable_memory.h>
+#include <jit/tiered_executor.h>
+#include <parser/parser.h>
+#include <semantic/name_resolver.h>
+#include <semantic/type_checker.h>
+
+#if defined(__x86_64__) && !defined(_WIN32)
+namespace {
+	const auto program = R"(
+		fn fib(n: i64) -> i64 {
+			if (n == 0) {
+				return 0
+			}
+			if (n == 1) {
+				return 1
+			}
+			return fib(n - 1) + fib(n - 2)
+		}
+
+		fn step(x: i64, i: i64) -> i64 {
+			return x * 3 + i
+		}
+
+		fn loop(n: i64, a: i64, b: i64) -> i64 {
+			let total := 0
+			let i := 0
+			while (i == n == false) {
+				total += step(a * b + i, i) / 7 - a * b
+				i++
+			}
+			return total
+		}
+	)";
+
+	seam::ir::Module lower(const std::string& raw_source) {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+		const auto program = parser.parse();
+
+		seam::semantic::Context context;
+		seam::semantic::NameResolver resolver(context);
+		program->accept(resolver);
+		seam::semantic::TypeChecker checker(context, 1);
+		program->accept(checker);
+
+		seam::ir::AstLowering lowering(context);
+		return lowering.lower(*program);
+	}
+}
+
+TEST_CASE("native code against the interpreter") {
+	auto module = lower(program);
+	auto manager = seam::ir::PassManager::standard_pipeline();
+	manager.run(module);
+
+	const auto object = seam::backend::x86_64::CodeGenerator().generate(module);
+	const seam::jit::ExecutableMemory code(object.text);
+
+	using Fib = int64_t(*)(int64_t);
+	using Loop = int64_t(*)(int64_t, int64_t, int64_t);
+	const auto native_fib = reinterpret_cast<Fib>(code.address(*object.find("fib")));
+	const auto native_loop = reinterpret_cast<Loop>(code.address(*object.find("loop")));
+
+	BENCHMARK("fib(20), interpreted") {
+		seam::ir::Interpreter interpreter(module);
+		return interpreter.call(*module.find("fib"), { { 20 } }).i64;
+	};
+
+	BENCHMARK("fib(20), native") {
+		return native_fib(20);
+	};
+
+	BENCHMARK("loop(10000), interpreted") {
+		seam::ir::Interpreter interpreter(module);
+		return interpreter.call(*module.find("loop"), { { 10000 }, { 3 }, { 5 } }).i64;
+	};
+
+	BENCHMARK("loop(10000), native") {
+		return native_loop(10000, 3, 5);
+	};
+
+	BENCHMARK("generating code") {
+		return seam::backend::x86_64::CodeGenerator().generate(module).text.size();
+	};
+}
+
+TEST_CASE("tiered execution") {
+	const auto module = lower(program);
+	const auto fib = *module.find("fib");
+	const auto loop = *module.find("loop");
+
+	// short scripts never reach the threshold and pay nothing for tiering
+	BENCHMARK("short run, interpreted") {
+		seam::ir::Interpreter interpreter(module);
+		return interpreter.call(loop, { { 50 }, { 3 }, { 5 } }).i64;
+	};
+
+	BENCHMARK("short run, tiered") {
+		seam::jit::TieredExecutor executor(module);
+		return executor.call(loop, { { 50 }, { 3 }, { 5 } }).i64;
+	};
+
+	BENCHMARK("short run, compiled up front") {
+		const auto object = seam::backend::x86_64::CodeGenerator().generate(module);
+		const seam::jit::ExecutableMemory code(object.text);
+		return reinterpret_cast<int64_t(*)(int64_t, int64_t, int64_t)>(code.address(*object.find("loop")))(50, 3, 5);
+	};
+
+	BENCHMARK("fib(22), interpreted") {
+		seam::ir::Interpreter interpreter(module);
+		return interpreter.call(fib, { { 22 } }).i64;
+	};
+
+	BENCHMARK("fib(22), tiered") {
+		seam::jit::TieredExecutor executor(module);
+		return executor.call(fib, { { 22 } }).i64;
+	};
+}
+#endif
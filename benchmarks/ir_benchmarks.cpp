@@ -0,0 +1,80 @@
+#include <catch2/catch.hpp>
+#include <ir/interpreter.h>
+#include <ir/lowering.h>
+#include <ir/passes.h>
+#include <parser/parser.h>
+#include <semantic/name_resolver.h>
+#include <semantic/type_checker.h>
+
+#include <string>
+
+namespace {
+	// loops full of invariant arithmetic calling small helpers
+	std::string generate_program(const int helpers) {
+		std::string source;
+
+		for (auto i = 0; i < helpers; i++) {
+			const auto index = std::to_string(i);
+			source += "fn helper" + index + "(x: i64, y: i64) -> i64 {\n"
+				"\treturn x * y + " + index + "\n"
+				"}\n";
+		}
+
+		source += "fn run(n: i64, a: i64, b: i64) -> i64 {\n"
+			"\tlet total := 0\n"
+			"\tlet i := 0\n"
+			"\twhile (i == n == false) {\n";
+		for (auto i = 0; i < helpers; i++) {
+			source += "\t\ttotal += helper" + std::to_string(i) + "(a * b + a, i) + a * b\n";
+		}
+		source += "\t\ti++\n"
+			"\t}\n"
+			"\treturn total\n"
+			"}\n";
+
+		return source;
+	}
+
+	seam::ir::Module lower(const std::string& raw_source) {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+		const auto program = parser.parse();
+
+		seam::semantic::Context context;
+		seam::semantic::NameResolver resolver(context);
+		program->accept(resolver);
+		seam::semantic::TypeChecker checker(context, 1);
+		program->accept(checker);
+
+		seam::ir::AstLowering lowering(context);
+		return lowering.lower(*program);
+	}
+}
+
+TEST_CASE("optimisation pipeline") {
+	const auto source = generate_program(16);
+	const auto unoptimised = lower(source);
+
+	auto optimised = lower(source);
+	auto manager = seam::ir::PassManager::standard_pipeline();
+	manager.run(optimised);
+
+	const auto run = *unoptimised.find("run");
+	const std::vector<seam::ir::Value> arguments { { 2000 }, { 3 }, { 5 } };
+
+	BENCHMARK("interpreting unoptimised") {
+		seam::ir::Interpreter interpreter(unoptimised);
+		return interpreter.call(run, arguments).i64;
+	};
+
+	BENCHMARK("interpreting optimised") {
+		seam::ir::Interpreter interpreter(optimised);
+		return interpreter.call(run, arguments).i64;
+	};
+
+	BENCHMARK("running the pipeline") {
+		auto module = unoptimised;
+		auto pipeline = seam::ir::PassManager::standard_pipeline();
+		return pipeline.run(module);
+	};
+}
@@ -0,0 +1,57 @@
+#include <catch2/catch.hpp>
+#include <parser/literal_decoder.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+	std::vector<std::string> generate_literals(const bool floating_point) {
+		std::vector<std::string> literals;
+		literals.reserve(10000);
+
+		for (auto i = 0; i < 10000; i++) {
+			literals.emplace_back(floating_point
+				? std::to_string(i) + "." + std::to_string(i * 7919 % 100000)
+				: std::to_string(static_cast<int64_t>(i) * 104729));
+		}
+
+		return literals;
+	}
+}
+
+TEST_CASE("number literal decoding") {
+	const auto floats = generate_literals(true);
+	const auto integers = generate_literals(false);
+
+	BENCHMARK("std::stod floats") {
+		double sum = 0;
+		for (const auto& literal : floats) {
+			sum += std::stod(literal);
+		}
+		return sum;
+	};
+
+	BENCHMARK("decode_number_literal floats") {
+		double sum = 0;
+		for (const auto& literal : floats) {
+			sum += seam::decode_number_literal(literal).value.f64;
+		}
+		return sum;
+	};
+
+	BENCHMARK("std::stoll integers") {
+		int64_t sum = 0;
+		for (const auto& literal : integers) {
+			sum += std::stoll(literal);
+		}
+		return sum;
+	};
+
+	BENCHMARK("decode_number_literal integers") {
+		int64_t sum = 0;
+		for (const auto& literal : integers) {
+			sum += seam::decode_number_literal(literal).value.i64;
+		}
+		return sum;
+	};
+}
@@ -0,0 +1,51 @@
+#include <catch2/catch.hpp>
+#include <lsp/document.h>
+
+#include <string>
+
+namespace {
+	std::string generate_module(const int functions) {
+		std::string source;
+		for (auto i = 0; i < functions; i++) {
+			source += "fn f" + std::to_string(i) + "(a: i64) -> i64 {\n";
+			source += "\t// step " + std::to_string(i) + "\n";
+			source += "\tlet x := a * 2 + " + std::to_string(i) + "\n";
+			source += "\tif (x == a) { return " + (i ? "f" + std::to_string(i - 1) + "(x)" : "x") + " }\n";
+			source += "\treturn x\n}\n";
+		}
+		return source;
+	}
+}
+
+TEST_CASE("editing a 20k line document") {
+	// six lines per function
+	const auto text = generate_module(20000 / 6);
+
+	BENCHMARK("opening") {
+		seam::lsp::Document document(text);
+		return document.diagnostics().size();
+	};
+
+	// analysed once up front, the generated module is free of errors
+	seam::lsp::Document document(text);
+	REQUIRE(document.diagnostics().empty());
+
+	const seam::lsp::Position position { 10000, 2 };
+	const seam::lsp::Position after { 10000, 3 };
+
+	BENCHMARK("keystroke") {
+		document.edit({ position, position }, "x");
+		document.edit({ position, after }, "");
+		return document.reparsed_declarations();
+	};
+
+	BENCHMARK("keystroke with diagnostics") {
+		document.edit({ position, position }, "x");
+		document.edit({ position, after }, "");
+		return document.diagnostics().size();
+	};
+
+	BENCHMARK("hover after analysis") {
+		return document.symbol_at({ 10002, 6 }).has_value();
+	};
+}
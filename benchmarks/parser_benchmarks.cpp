@@ -0,0 +1,66 @@
+#include <catch2/catch.hpp>
+#include <parser/parallel_lexer.h>
+#include <parser/parser.h>
+#include <parser/streaming_lexer.h>
+
+#include <string>
+
+namespace {
+	std::string generate_source(const int functions) {
+		std::string source;
+
+		for (auto i = 0; i < functions; i++) {
+			source += "fn f" + std::to_string(i) + "(a: i64, b: f64) -> i64 {\n";
+			for (auto j = 0; j < 20; j++) {
+				source += "\t// step " + std::to_string(j) + "\n";
+				source += "\tlet x" + std::to_string(j) + " := a * " + std::to_string(j) + " + 0x1F\n";
+				source += "\tif (x" + std::to_string(j) + " == a && true) { b = b + 1.5 }\n";
+			}
+			source += "\treturn a\n}\n";
+		}
+
+		return source;
+	}
+}
+
+TEST_CASE("parsing large sources") {
+	// a few megabytes of source
+	const auto source = std::make_unique<seam::Source>(generate_source(5000));
+
+	BENCHMARK("synchronous lexer") {
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+		return parser.parse()->body.size();
+	};
+
+	BENCHMARK("streaming lexer") {
+		seam::Parser parser(std::make_unique<seam::StreamingLexer>(source.get()));
+		return parser.parse()->body.size();
+	};
+
+	BENCHMARK("parallel declarations") {
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+		return parser.parse_parallel()->body.size();
+	};
+}
+
+TEST_CASE("lexing large sources") {
+	const auto source = std::make_unique<seam::Source>(generate_source(5000));
+
+	BENCHMARK("sequential") {
+		seam::Lexer lexer(source.get());
+		size_t count = 0;
+		while (lexer.next()->type != seam::TokenType::None) {
+			count++;
+		}
+		return count;
+	};
+
+	BENCHMARK("parallel") {
+		seam::ParallelLexer lexer(source.get());
+		size_t count = 0;
+		while (lexer.next()->type != seam::TokenType::None) {
+			count++;
+		}
+		return count;
+	};
+}
@@ -0,0 +1,47 @@
+#include <catch2/catch.hpp>
+#include <parser/parser.h>
+#include <semantic/name_resolver.h>
+#include <semantic/type_checker.h>
+
+#include <string>
+#include <thread>
+
+namespace {
+	std::string generate_module(const int functions) {
+		std::string source;
+
+		for (auto i = 0; i < functions; i++) {
+			const auto name = "f" + std::to_string(i);
+			source += "fn " + name + "(a: i64, b: f64) -> i64 {\n";
+			for (auto j = 0; j < 20; j++) {
+				source += "\tlet x" + std::to_string(j) + " := a * " + std::to_string(j) + " + 1\n";
+				source += "\tif (x" + std::to_string(j) + " == a && true) { b = b + 1.5 }\n";
+			}
+			source += i ? "\treturn f" + std::to_string(i - 1) + "(a, b)\n}\n" : "\treturn a\n}\n";
+		}
+
+		return source;
+	}
+}
+
+TEST_CASE("type checking") {
+	const auto source = std::make_unique<seam::Source>(generate_module(2000));
+	seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+	const auto program = parser.parse();
+
+	seam::semantic::Context context;
+	seam::semantic::NameResolver resolver(context);
+	program->accept(resolver);
+
+	BENCHMARK("one thread") {
+		seam::semantic::TypeChecker checker(context, 1);
+		program->accept(checker);
+		return context.has_errors();
+	};
+
+	BENCHMARK("one thread per core") {
+		seam::semantic::TypeChecker checker(context, std::thread::hardware_concurrency());
+		program->accept(checker);
+		return context.has_errors();
+	};
+}
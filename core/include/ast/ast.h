@@ -1,15 +1,19 @@
 #pragma once
 
+#include <cstdint>
 #include <utility>
 #include <vector>
 #include <memory>
 
 #include <exception.h>
 #include <tokens.h>
+#include <type/type.h>
+#include <parser/literal_decoder.h>
+#include <symbol.h>
 
-namespace seam::ast {
-	class PrintVisitor;
+#include "visitor.h"
 
+namespace seam::ast {
 	template <typename... Visitors>
 	struct Node;
 
@@ -23,7 +27,8 @@ namespace seam::ast {
 	template<typename Derived, typename Visitor>
 	struct Node<Derived, Visitor> : virtual Node<Visitor> {
 		void accept(Visitor& visitor) override {
-			visitor.visit(dynamic_cast<Derived&>(*this));
+			// a direct, non-virtual base of Derived, so no lookup is needed
+			visitor.visit(static_cast<Derived&>(*this));
 		}
 	};
 
@@ -37,19 +42,76 @@ namespace seam::ast {
 		}
 	};
 
+	namespace detail {
+		// nesting destroyed by plain recursion, deeper subtrees are set aside
+		constexpr size_t max_teardown_depth = 256;
+		inline thread_local size_t teardown_depth = 0;
+
+		void defer_teardown(std::unique_ptr<Node<AstVisitor>> node);
+		void finish_teardown();
+	}
+
+	template <typename T>
+	void destroy_child(const bool recurse, std::unique_ptr<T>& child) {
+		if (!child) {
+			return;
+		}
+		if (recurse) {
+			child.reset();
+		} else {
+			detail::defer_teardown(std::move(child));
+		}
+	}
+
+	template <typename T>
+	void destroy_child(const bool recurse, std::vector<std::unique_ptr<T>>& list) {
+		for (auto& child : list) {
+			destroy_child(recurse, child);
+		}
+	}
+
+	/**
+	 * Destroys the children of a node, called from the destructor of
+	 * every node that has them. Children are passed in the order the
+	 * members would be destroyed, last declared first, so nodes are
+	 * freed in the same order as by the implicit destructors.
+	 *
+	 * Shallow subtrees are destroyed recursively, as the members would
+	 * be. Past a fixed depth children are set aside instead and destroyed
+	 * from a work list once the outermost node is done, so tearing down
+	 * a tree of any depth takes bounded stack.
+	 */
+	template <typename... Children>
+	void destroy_children(Children&... children) {
+		const auto recurse = detail::teardown_depth++ < detail::max_teardown_depth;
+		(destroy_child(recurse, children), ...);
+		if (--detail::teardown_depth == 0) {
+			detail::finish_teardown();
+		}
+	}
+
 	struct Parameter {
-		std::wstring name;
-		std::wstring type;
+		std::string name;
+		std::string type;
+		SourcePosition position { 0, 0 };
+
+		// set by name resolution
+		symbol::Symbol* symbol = nullptr;
 	};
 	using ParameterList = std::vector<Parameter>;
 
 	namespace expression {
-		struct Expression : virtual Node<PrintVisitor> { };
+		struct Expression : virtual Node<AstVisitor> {
+			SourcePosition position { 0, 0 };
+
+			// set by the type checker
+			type::TypeId type_id = type::unresolved_type;
+		};
 
 		using ExpressionList = std::vector<std::unique_ptr<Expression>>;
 
 		template<typename T>
-		struct Literal : Expression, virtual Node<PrintVisitor> {
+		struct Literal : Expression, virtual Node<AstVisitor> {
 			T value;
 
 		protected:
@@ -59,86 +121,136 @@ namespace seam::ast {
 				: value(std::move(value)) {}
 		};
 
-		struct UnaryExpression : Expression, Node<UnaryExpression, PrintVisitor> {
+		struct UnaryExpression : Expression, Node<UnaryExpression, AstVisitor> {
 			TokenType op;
 			std::unique_ptr<Expression> expr;
 
 			explicit UnaryExpression(const TokenType op, std::unique_ptr<Expression> expr)
 				: op(op), expr(std::move(expr)) {}
+
+			~UnaryExpression() override { destroy_children(expr); }
 		};
 
-		struct BinaryExpression : Expression, Node<BinaryExpression, PrintVisitor> {
+		struct BinaryExpression : Expression, Node<BinaryExpression, AstVisitor> {
 			TokenType op;
 			std::unique_ptr<Expression> lhs;
 			std::unique_ptr<Expression> rhs;
 
 			explicit BinaryExpression(const TokenType op, std::unique_ptr<Expression> lhs, std::unique_ptr<Expression> rhs)
 				: op(op), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+
+			~BinaryExpression() override { destroy_children(rhs, lhs); }
 		};
 
-		struct PostfixExpression : Expression, Node<PostfixExpression, PrintVisitor> {
+		struct PostfixExpression : Expression, Node<PostfixExpression, AstVisitor> {
 			TokenType op;
 			std::unique_ptr<Expression> rhs;
 
 			explicit PostfixExpression(const TokenType op, std::unique_ptr<Expression> rhs)
 				: op(op), rhs(std::move(rhs)) {}
+
+			~PostfixExpression() override { destroy_children(rhs); }
 		};
 
-		struct StringLiteral : Literal<std::wstring>, Node<StringLiteral, PrintVisitor> {
-			explicit StringLiteral(std::wstring value)
+		struct StringLiteral : Literal<std::string>, Node<StringLiteral, AstVisitor> {
+			explicit StringLiteral(std::string value)
 				: Literal(std::move(value)) {}
 		};
 
-		struct NumberLiteral : Literal<std::wstring>, Node<NumberLiteral, PrintVisitor> {
-			explicit NumberLiteral(std::wstring value)
+		struct NumberLiteral : Literal<std::string>, Node<NumberLiteral, AstVisitor> {
+			// decoded value, type is None if the literal was never decoded
+			type::BuiltIn type = type::BuiltIn::None;
+			union {
+				int64_t i64;
+				double f64;
+			} constant { 0 };
+
+			explicit NumberLiteral(std::string value)
 				: Literal(std::move(value)) {}
+
+			NumberLiteral(std::string value, const DecodedNumber& decoded)
+				: Literal(std::move(value)), type(decoded.type) {
+				if (is_float()) {
+					constant.f64 = decoded.value.f64;
+				} else {
+					constant.i64 = decoded.value.i64;
+				}
+			}
+
+			explicit NumberLiteral(const int64_t value)
+				: Literal(std::to_string(value)), type(type::BuiltIn::i64) {
+				constant.i64 = value;
+			}
+
+			explicit NumberLiteral(const double value)
+				: Literal(fmt::format("{}", value)), type(type::BuiltIn::f64) {
+				constant.f64 = value;
+			}
+
+			[[nodiscard]] bool is_integer() const { return type == type::BuiltIn::i64; }
+			[[nodiscard]] bool is_float() const { return type == type::BuiltIn::f64; }
 		};
 
-		struct BooleanLiteral : Literal<bool>, Node<BooleanLiteral, PrintVisitor> {
+		struct BooleanLiteral : Literal<bool>, Node<BooleanLiteral, AstVisitor> {
 			explicit BooleanLiteral(const bool value)
 				: Literal(value) {}
 		};
 
-		struct Identifier : Expression, Node<Identifier, PrintVisitor> {
-			std::wstring identifier;
+		struct Identifier : Expression, Node<Identifier, AstVisitor> {
+			std::string identifier;
+
+			// declaration this identifier refers to, set by name resolution
+			symbol::Symbol* symbol = nullptr;
 
-			explicit Identifier(std::wstring identifier)
-				: identifier(std::move(identifier)) {}
+			explicit Identifier(std::string identifier, const SourcePosition position = { 0, 0 })
+				: identifier(std::move(identifier)) {
+				this->position = position;
+			}
 		};
 
-		struct FunctionCall : Expression, Node<FunctionCall, PrintVisitor> {
+		struct FunctionCall : Expression, Node<FunctionCall, AstVisitor> {
 			std::unique_ptr<Expression> function;
 			ExpressionList args;
 
 			explicit FunctionCall(std::unique_ptr<Expression> func, ExpressionList args)
 				: function(std::move(func)), args(std::move(args)) {}
+
+			~FunctionCall() override { destroy_children(args, function); }
 		};
 	}
 	
 	namespace statement {
-		struct Statement : virtual Node<PrintVisitor> {
+		struct Statement : virtual Node<AstVisitor> {
 
 		};
 		using StatementList = std::vector<std::unique_ptr<Statement>>;
 
-		struct LetStatement : Statement, Node<LetStatement, PrintVisitor> {
-			std::wstring name;
-			std::wstring type;
+		struct LetStatement : Statement, Node<LetStatement, AstVisitor> {
+			std::string name;
+			std::string type;
 			std::unique_ptr<expression::Expression> expr;
+			SourcePosition position;
+
+			// set by name resolution
+			symbol::Symbol* symbol = nullptr;
+
+			LetStatement(std::string name, std::string type, std::unique_ptr<expression::Expression> expr, const SourcePosition position = { 0, 0 })
+				: name(std::move(name)), type(std::move(type)), expr(std::move(expr)), position(position) {}
 
-			LetStatement(std::wstring name, std::wstring type, std::unique_ptr<expression::Expression> expr)
-				: name(std::move(name)), type(std::move(type)), expr(std::move(expr)) {}
+			~LetStatement() override { destroy_children(expr); }
 		};
 
-		struct StatementBlock : Statement, Node<StatementBlock, PrintVisitor> {
+		struct StatementBlock : Statement, Node<StatementBlock, AstVisitor> {
 			StatementList statements;
 
 			StatementBlock(
 				StatementList list
 			) : statements(std::move(list)) {}
+
+			~StatementBlock() override { destroy_children(statements); }
 		};
 
-		struct IfStatement : Statement, Node<IfStatement, PrintVisitor> {
+		struct IfStatement : Statement, Node<IfStatement, AstVisitor> {
 			std::unique_ptr<expression::Expression> cond;
 			std::unique_ptr<StatementBlock> body;
 			std::unique_ptr<StatementBlock> else_body;
@@ -148,9 +260,33 @@ namespace seam::ast {
 				std::unique_ptr<StatementBlock> body,
 				std::unique_ptr<StatementBlock> else_body = nullptr
 			) : cond(std::move(condition)), body(std::move(body)), else_body(std::move(else_body)) {}
+
+			~IfStatement() override { destroy_children(else_body, body, cond); }
+
+			/**
+			 * The if statement an elseif parses to, the sole statement of
+			 * the else block, or null. Passes follow elseif chains in a
+			 * loop rather than recursing once per branch.
+			 */
+			[[nodiscard]] IfStatement* else_if() const {
+				return else_body && else_body->statements.size() == 1
+					? dynamic_cast<IfStatement*>(else_body->statements.front().get())
+					: nullptr;
+			}
 		};
 
-		struct WhileStatement : Statement, Node<WhileStatement, PrintVisitor> {
+		struct ReturnStatement : Statement, Node<ReturnStatement, AstVisitor> {
+			// null for a bare return
+			std::unique_ptr<expression::Expression> expr;
+			SourcePosition position;
+
+			explicit ReturnStatement(std::unique_ptr<expression::Expression> expr, const SourcePosition position = { 0, 0 })
+				: expr(std::move(expr)), position(position) {}
+
+			~ReturnStatement() override { destroy_children(expr); }
+		};
+
+		struct WhileStatement : Statement, Node<WhileStatement, AstVisitor> {
 			std::unique_ptr<expression::Expression> cond;
 			std::unique_ptr<StatementBlock> body;
 
@@ -158,46 +294,75 @@ namespace seam::ast {
 				std::unique_ptr<expression::Expression> cond,
 				std::unique_ptr<StatementBlock> body
 			) : cond(std::move(cond)), body(std::move(body)) {}
+
+			~WhileStatement() override { destroy_children(body, cond); }
 		};
 	}
 
-	struct Declaration : virtual Node<PrintVisitor> { };
+	struct Declaration : virtual Node<AstVisitor> { };
 	using DeclarationList = std::vector<std::unique_ptr<Declaration>>;
 
-	struct FunctionDeclaration : Declaration, Node<FunctionDeclaration, PrintVisitor> {
-		std::wstring name;
+	struct FunctionDeclaration : Declaration, Node<FunctionDeclaration, AstVisitor> {
+		std::string name;
 		ParameterList params;
-		std::wstring return_type;
+		std::string return_type;
+		// null for functions defined in another module
 		std::unique_ptr<statement::StatementBlock> body;
+		SourcePosition position;
+
+		// set by name resolution
+		symbol::Symbol* symbol = nullptr;
 
 		FunctionDeclaration(
-			std::wstring name,
+			std::string name,
 			ParameterList params,
-			std::wstring return_type,
-			std::unique_ptr<statement::StatementBlock> block)
-				: name(std::move(name)), params(std::move(params)), return_type(std::move(return_type)), body(std::move(block)){}
+			std::string return_type,
+			std::unique_ptr<statement::StatementBlock> block,
+			const SourcePosition position = { 0, 0 })
+				: name(std::move(name)), params(std::move(params)), return_type(std::move(return_type)), body(std::move(block)), position(position) {}
+
+		~FunctionDeclaration() override { destroy_children(body); }
 	};
 
-	struct TypeDeclaration : Declaration, Node<TypeDeclaration, PrintVisitor> {
-        std::wstring name;
+	struct TypeDeclaration : Declaration, Node<TypeDeclaration, AstVisitor> {
+        std::string name;
         DeclarationList body;
+        SourcePosition position;
 
-        TypeDeclaration(std::wstring name, DeclarationList body)
-            : name(std::move(name)), body(std::move(body)) {}
+        TypeDeclaration(std::string name, DeclarationList body, const SourcePosition position = { 0, 0 })
+            : name(std::move(name)), body(std::move(body)), position(position) {}
+
+        ~TypeDeclaration() override { destroy_children(body); }
 	};
 
-	struct TypeAliasDeclaration : Declaration, Node<TypeAliasDeclaration, PrintVisitor> {
-        std::wstring alias;
-        std::wstring type;
+	struct TypeAliasDeclaration : Declaration, Node<TypeAliasDeclaration, AstVisitor> {
+        std::string alias;
+        std::string type;
+        SourcePosition position;
+
+        TypeAliasDeclaration(std::string alias, std::string type, const SourcePosition position = { 0, 0 })
+            : alias(std::move(alias)), type(std::move(type)), position(position) {}
+	};
 
-        TypeAliasDeclaration(std::wstring alias, std::wstring type)
-            : alias(std::move(alias)), type(std::move(type)) {}
+	/**
+	 * Import of another module by its dotted name, e.g. "geometry.shapes".
+	 */
+	struct Import {
+		std::string module;
+		SourcePosition position { 0, 0 };
 	};
+	using ImportList = std::vector<Import>;
 
-	struct Program : Node<Program, PrintVisitor> {
+	struct Program : Node<Program, AstVisitor> {
+		ImportList imports;
 		DeclarationList body;
 
 		Program(DeclarationList body)
 			: body(std::move(body)) {}
+
+		Program(ImportList imports, DeclarationList body)
+			: imports(std::move(imports)), body(std::move(body)) {}
+
+		~Program() override { destroy_children(body); }
 	};
 }
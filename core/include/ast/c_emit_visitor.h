@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "ast.h"
+#include "visitor.h"
+#include "semantic/context.h"
+
+namespace seam::ast {
+	/**
+	 * C Source Emitter.
+	 *
+	 * Translates a resolved and type checked program into C11, builtin
+	 * types map to the fixed-width C types. Integer arithmetic keeps the
+	 * width of its type and wraps when the output is compiled with
+	 * -fwrapv; integer division by zero aborts.
+	 *
+	 * Functions are named seam_ followed by the names of their enclosing
+	 * types and their own, each prefixed by its length, so fn square is
+	 * seam_6square to C and cannot meet a libc or helper name. Locals and
+	 * parameters are numbered, which keeps shadowed names apart.
+	 * Strings and records cannot be emitted and raise a LoweringException.
+	 */
+	class CEmitVisitor final : public AstVisitor {
+		const semantic::Context& context_;
+		std::string output_;
+		// expression translated last
+		std::string result_;
+		size_t depth_ = 0;
+
+		std::unordered_map<const symbol::Symbol*, std::string> names_;
+		std::unordered_map<const symbol::Symbol*, std::string> functions_;
+
+		void line(const std::string& text);
+		std::string emit(expression::Expression& expr);
+		std::string name(const symbol::Symbol* symbol, const std::string& base);
+		std::string signature(const FunctionDeclaration& func);
+
+		[[nodiscard]] std::string c_type(type::TypeId type, SourcePosition position) const;
+	public:
+		explicit CEmitVisitor(const semantic::Context& context)
+			: context_(context) {}
+
+		void visit(Program& program) override;
+		void visit(FunctionDeclaration& func) override;
+		void visit(TypeDeclaration& decl) override;
+		void visit(TypeAliasDeclaration& decl) override;
+		void visit(statement::LetStatement& stat) override;
+		void visit(statement::StatementBlock& block) override;
+		void visit(statement::IfStatement& stat) override;
+		void visit(statement::WhileStatement& stat) override;
+		void visit(statement::ReturnStatement& stat) override;
+		void visit(expression::StringLiteral& expr) override;
+		void visit(expression::NumberLiteral& expr) override;
+		void visit(expression::BooleanLiteral& expr) override;
+		void visit(expression::UnaryExpression& expr) override;
+		void visit(expression::BinaryExpression& expr) override;
+		void visit(expression::PostfixExpression& expr) override;
+		void visit(expression::Identifier& expr) override;
+		void visit(expression::FunctionCall& expr) override;
+
+		[[nodiscard]] const std::string& str() const { return output_; }
+	};
+}
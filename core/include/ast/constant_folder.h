@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+
+#include "ast.h"
+
+namespace seam::ast {
+	/**
+	 * Constant Folding Pass.
+	 *
+	 * Folds unary and binary expressions over constants (number literals are
+	 * decoded by the parser), applies simple algebraic identities and
+	 * removes if/while statements whose condition is a constant.
+	 */
+	class ConstantFolder final : public AstVisitor {
+		// replacement for the expression currently being visited
+		std::unique_ptr<expression::Expression> folded_expression_;
+
+		// replacement for the statement currently being visited
+		std::unique_ptr<statement::Statement> folded_statement_;
+
+		// set when the statement currently being visited should be dropped
+		bool remove_statement_ = false;
+
+		// number of nodes replaced so far
+		size_t folded_count_ = 0;
+
+		/**
+		 * Folds an expression in place.
+		 *
+		 * @param expr expression to fold, replaced if it folds.
+		 */
+		void fold(std::unique_ptr<expression::Expression>& expr);
+
+		/**
+		 * Folds every statement in a list, replacing and removing
+		 * statements as required.
+		 *
+		 * @param statements statement list to fold.
+		 */
+		void fold(statement::StatementList& statements);
+
+		void replace_expression(std::unique_ptr<expression::Expression> expr);
+		void replace_statement(std::unique_ptr<statement::Statement> stat);
+		void remove_statement();
+	public:
+		void visit(Program& program) override;
+		void visit(FunctionDeclaration& func) override;
+		void visit(TypeDeclaration& decl) override;
+		void visit(TypeAliasDeclaration& decl) override;
+		void visit(statement::LetStatement& stat) override;
+		void visit(statement::StatementBlock& block) override;
+		void visit(statement::IfStatement& stat) override;
+		void visit(statement::WhileStatement& stat) override;
+		void visit(statement::ReturnStatement& stat) override;
+		void visit(expression::StringLiteral& expr) override;
+		void visit(expression::NumberLiteral& expr) override;
+		void visit(expression::BooleanLiteral& expr) override;
+		void visit(expression::UnaryExpression& expr) override;
+		void visit(expression::BinaryExpression& expr) override;
+		void visit(expression::PostfixExpression& expr) override;
+		void visit(expression::Identifier& expr) override;
+		void visit(expression::FunctionCall& expr) override;
+
+		[[nodiscard]] size_t folded_count() const { return folded_count_; }
+	};
+}
@@ -2,65 +2,24 @@
 
 #include <stack>
 #include <string>
-#include "visitor.h"
+#include "recursive_visitor.h"
 
 namespace seam::ast {
-	namespace expression {
-		struct Expression;
-		struct StringLiteral;
-		struct NumberLiteral;
-		struct BooleanLiteral;
-		struct UnaryExpression;
-		struct BinaryExpression;
-		struct PostfixExpression;
-		struct FunctionExpression;
-		struct FunctionCall;
-	}
-
-	struct Declaration;
-	struct Program;
-	struct FunctionDeclaration;
-    struct TypeDeclaration;
-    struct TypeAliasDeclaration;
-	namespace statement {
-		struct Statement;
-		struct LetStatement;
-		struct StatementBlock;
-		struct IfStatement;
-	}
-
-	class PrintVisitor final : Visitor <
-		Program,
-		statement::StatementBlock,
-		expression::StringLiteral,
-		expression::NumberLiteral,
-		expression::BooleanLiteral,
-		expression::UnaryExpression,
-		FunctionDeclaration,
-		statement::LetStatement,
-		statement::IfStatement,
-		statement::WhileStatement,
-		TypeDeclaration,
-		TypeAliasDeclaration,
-		expression::Identifier,
-		expression::BinaryExpression,
-		expression::PostfixExpression,
-		expression::FunctionExpression,
-		expression::FunctionCall> {
+	class PrintVisitor final : public RecursiveVisitor<PrintVisitor> {
 		size_t node_count_ = 0;
-		std::wstring output_string_;
+		std::string output_string_;
 
-		std::stack<std::wstring> parent_;
+		std::stack<std::string> parent_;
 
 		void push_i_parent(const size_t node) {
-			push_parent(std::to_wstring(node));
+			push_parent(std::to_string(node));
 		}
 
-		void push_parent(std::wstring node_name) {
+		void push_parent(std::string node_name) {
 			parent_.push(std::move(node_name));
 		}
-		std::wstring current_parent() { return parent_.top(); }
-		std::wstring pop_parent() {
+		std::string current_parent() { return parent_.top(); }
+		std::string pop_parent() {
 			auto result = current_parent();
 			parent_.pop();
 			return result;
@@ -68,38 +27,64 @@ namespace seam::ast {
 
 		size_t new_code_count() { return node_count_++; }
 
-		void append(const std::wstring& str) {
-			output_string_ += str + L"\n";
+		void append(const std::string& str) {
+			output_string_ += str + "\n";
 		}
 
-		void append_pointer(const std::wstring& lhs, size_t from, size_t to) {
+		void append_pointer(const std::string& lhs, size_t from, size_t to) {
 			for (auto i = from; i < to; i++) {
-				append(fmt::format(L"{} -> {}", lhs, to));
+				append(fmt::format("{} -> {}", lhs, to));
 			}
 		}
 
 		void draw_parent(size_t node) {
-			append(fmt::format(L"{} -> {}", current_parent(), node));
+			append(fmt::format("{} -> {}", current_parent(), node));
+		}
+
+		// a node with children is drawn under its parent once they are done
+		void enter_parent(const std::string& label) {
+			const auto this_node = ++node_count_;
+			append(fmt::format("{} {}", this_node, label));
+			push_i_parent(this_node);
+		}
+
+		void leave_parent() {
+			const auto this_node = pop_parent();
+			append(fmt::format("{} -> {}", current_parent(), this_node));
+		}
+
+		void leaf(const std::string& label) {
+			const auto this_node = ++node_count_;
+			append(fmt::format("{} {}", this_node, label));
+			draw_parent(this_node);
 		}
 	public:
-		void visit(Program& program) override;
-		void visit(statement::LetStatement& stat) override;
-		void visit(FunctionDeclaration& func) override;
-		void visit(expression::StringLiteral& expr) override;
-		void visit(expression::NumberLiteral& expr) override;
-		void visit(expression::BooleanLiteral& expr) override;
-		void visit(expression::UnaryExpression& expr) override;
-		void visit(statement::StatementBlock& block) override;
-		void visit(statement::IfStatement& stat) override;
-		void visit(statement::WhileStatement& stat) override;
-		void visit(expression::Identifier& expr) override;
-		void visit(expression::BinaryExpression& expr) override;
-		void visit(expression::PostfixExpression& expr) override;
-		void visit(expression::FunctionExpression& expr) override;
-		void visit(expression::FunctionCall& expr) override;
-		void visit(TypeDeclaration& stat) override;
-		void visit(TypeAliasDeclaration& stat) override;
+		void enter(Program& program);
+		void leave(Program& program);
+		void enter(FunctionDeclaration& func);
+		void leave(FunctionDeclaration& func) { leave_parent(); }
+		bool enter(TypeDeclaration& decl) { return false; }
+		bool enter(TypeAliasDeclaration& decl) { return false; }
+		void enter(statement::LetStatement& stat);
+		void leave(statement::LetStatement& stat);
+		void enter(statement::IfStatement& stat);
+		void leave(statement::IfStatement& stat) { leave_parent(); }
+		void enter(statement::WhileStatement& stat);
+		void leave(statement::WhileStatement& stat) { leave_parent(); }
+		void enter(statement::ReturnStatement& stat);
+		void leave(statement::ReturnStatement& stat) { leave_parent(); }
+		void enter(expression::StringLiteral& expr);
+		void enter(expression::NumberLiteral& expr);
+		void enter(expression::BooleanLiteral& expr);
+		void enter(expression::UnaryExpression& expr);
+		void leave(expression::UnaryExpression& expr) { leave_parent(); }
+		void enter(expression::BinaryExpression& expr);
+		void leave(expression::BinaryExpression& expr) { leave_parent(); }
+		bool enter(expression::PostfixExpression& expr) { return false; }
+		void enter(expression::Identifier& expr);
+		void enter(expression::FunctionCall& expr);
+		void leave(expression::FunctionCall& expr) { leave_parent(); }
 
-		[[nodiscard]] std::wstring str() const { return output_string_; };
+		[[nodiscard]] std::string str() const { return output_string_; };
 	};
 }
\ No newline at end of file
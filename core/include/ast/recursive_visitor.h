@@ -0,0 +1,160 @@
+#pragma once
+
+#include <concepts>
+#include <type_traits>
+#include <vector>
+
+#include "ast.h"
+
+namespace seam::ast {
+	/**
+	 * Recursive Visitor.
+	 *
+	 * Walks a tree in source order, calling the pass's enter hook for a
+	 * node before its children and its leave hook after them:
+	 *
+	 *     class Counter final : public RecursiveVisitor<Counter> {
+	 *     public:
+	 *         size_t calls = 0;
+	 *         void enter(expression::FunctionCall& call) { calls++; }
+	 *     };
+	 *
+	 * Hooks are public members, found at compile time, so a pass only
+	 * writes the ones it needs and unhooked nodes cost no calls. An enter
+	 * hook returning false skips the node's children and its leave hook.
+	 *
+	 * The walk keeps its own stack of nodes rather than recursing, so the
+	 * depth of a tree costs no native stack.
+	 */
+	template <typename Derived>
+	class RecursiveVisitor : public AstVisitor {
+		/**
+		 * Node waiting to be entered, or left once its children are done.
+		 */
+		struct Frame {
+			Node<AstVisitor>* node;
+			bool leave;
+		};
+
+		std::vector<Frame> stack_;
+		bool walking_ = false;
+		bool leaving_ = false;
+
+		template <typename T>
+		static constexpr bool is_leaf = std::is_same_v<T, expression::StringLiteral> || std::is_same_v<T, expression::NumberLiteral>
+			|| std::is_same_v<T, expression::BooleanLiteral> || std::is_same_v<T, expression::Identifier>
+			|| std::is_same_v<T, TypeAliasDeclaration>;
+
+		template <typename T>
+		void push(const std::unique_ptr<T>& child) {
+			if (child) {
+				stack_.push_back({ child.get(), false });
+			}
+		}
+
+		template <typename T>
+		void push(const std::vector<std::unique_ptr<T>>& children) {
+			for (auto it = children.rbegin(); it != children.rend(); ++it) {
+				push(*it);
+			}
+		}
+
+		// children go on in reverse, so the first is entered first
+		void push_children(Program& program) { push(program.body); }
+		void push_children(FunctionDeclaration& func) { push(func.body); }
+		void push_children(TypeDeclaration& decl) { push(decl.body); }
+		void push_children(statement::LetStatement& stat) { push(stat.expr); }
+		void push_children(statement::StatementBlock& block) { push(block.statements); }
+		void push_children(statement::IfStatement& stat) { push(stat.else_body); push(stat.body); push(stat.cond); }
+		void push_children(statement::WhileStatement& stat) { push(stat.body); push(stat.cond); }
+		void push_children(statement::ReturnStatement& stat) { push(stat.expr); }
+		void push_children(expression::UnaryExpression& expr) { push(expr.expr); }
+		void push_children(expression::BinaryExpression& expr) { push(expr.rhs); push(expr.lhs); }
+		void push_children(expression::PostfixExpression& expr) { push(expr.rhs); }
+		void push_children(expression::FunctionCall& expr) { push(expr.args); push(expr.function); }
+
+		// named apart from the hooks, so a pass without one never finds these
+		template <typename T>
+		bool call_enter(T& node) {
+			auto& derived = static_cast<Derived&>(*this);
+			if constexpr (requires { { derived.enter(node) } -> std::same_as<bool>; }) {
+				return derived.enter(node);
+			} else if constexpr (requires { derived.enter(node); }) {
+				derived.enter(node);
+			}
+			return true;
+		}
+
+		template <typename T>
+		void call_leave(T& node) {
+			auto& derived = static_cast<Derived&>(*this);
+			if constexpr (requires { derived.leave(node); }) {
+				derived.leave(node);
+			}
+		}
+
+		/**
+		 * Steps the walk at a node, the node's accept() lands here with
+		 * its type known.
+		 */
+		template <typename T>
+		void step(T& node) {
+			if (!walking_) {
+				walk(node);
+				return;
+			}
+			if (leaving_) {
+				call_leave(node);
+				return;
+			}
+			if (!call_enter(node)) {
+				return;
+			}
+
+			if constexpr (is_leaf<T>) {
+				call_leave(node);
+			} else {
+				stack_.push_back({ &node, true });
+				push_children(node);
+			}
+		}
+
+		void walk(Node<AstVisitor>& root) {
+			// a pass that throws out of a hook leaves the visitor ready for another walk
+			struct Reset {
+				RecursiveVisitor& visitor;
+				~Reset() {
+					visitor.walking_ = false;
+					visitor.stack_.clear();
+				}
+			} reset { *this };
+
+			walking_ = true;
+			stack_.push_back({ &root, false });
+			while (!stack_.empty()) {
+				const auto frame = stack_.back();
+				stack_.pop_back();
+				leaving_ = frame.leave;
+				frame.node->accept(*this);
+			}
+		}
+	public:
+		void visit(Program& program) final { step(program); }
+		void visit(FunctionDeclaration& func) final { step(func); }
+		void visit(TypeDeclaration& decl) final { step(decl); }
+		void visit(TypeAliasDeclaration& decl) final { step(decl); }
+		void visit(statement::LetStatement& stat) final { step(stat); }
+		void visit(statement::StatementBlock& block) final { step(block); }
+		void visit(statement::IfStatement& stat) final { step(stat); }
+		void visit(statement::WhileStatement& stat) final { step(stat); }
+		void visit(statement::ReturnStatement& stat) final { step(stat); }
+		void visit(expression::StringLiteral& expr) final { step(expr); }
+		void visit(expression::NumberLiteral& expr) final { step(expr); }
+		void visit(expression::BooleanLiteral& expr) final { step(expr); }
+		void visit(expression::UnaryExpression& expr) final { step(expr); }
+		void visit(expression::BinaryExpression& expr) final { step(expr); }
+		void visit(expression::PostfixExpression& expr) final { step(expr); }
+		void visit(expression::Identifier& expr) final { step(expr); }
+		void visit(expression::FunctionCall& expr) final { step(expr); }
+	};
+}
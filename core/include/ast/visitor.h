@@ -18,4 +18,51 @@ namespace seam::ast {
 
         virtual void visit(T& visitable) = 0;
     };
-}
\ No newline at end of file
+
+    namespace expression {
+        struct StringLiteral;
+        struct NumberLiteral;
+        struct BooleanLiteral;
+        struct UnaryExpression;
+        struct BinaryExpression;
+        struct PostfixExpression;
+        struct Identifier;
+        struct FunctionCall;
+    }
+
+    namespace statement {
+        struct LetStatement;
+        struct StatementBlock;
+        struct IfStatement;
+        struct WhileStatement;
+        struct ReturnStatement;
+    }
+
+    struct Program;
+    struct FunctionDeclaration;
+    struct TypeDeclaration;
+    struct TypeAliasDeclaration;
+
+    /**
+     * Visitor over every AST node type. Passes derive from this so that
+     * adding a pass does not touch the node definitions.
+     */
+    using AstVisitor = Visitor<
+        Program,
+        FunctionDeclaration,
+        TypeDeclaration,
+        TypeAliasDeclaration,
+        statement::LetStatement,
+        statement::StatementBlock,
+        statement::IfStatement,
+        statement::WhileStatement,
+        statement::ReturnStatement,
+        expression::StringLiteral,
+        expression::NumberLiteral,
+        expression::BooleanLiteral,
+        expression::UnaryExpression,
+        expression::BinaryExpression,
+        expression::PostfixExpression,
+        expression::Identifier,
+        expression::FunctionCall>;
+}
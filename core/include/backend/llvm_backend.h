@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ir/ir.h"
+
+namespace seam::backend {
+	/**
+	 * LLVM Backend.
+	 *
+	 * Translates the IR to LLVM IR, runs LLVM's default pipeline for the
+	 * optimisation level and emits code for the host. Only available when
+	 * built with SEAM_ENABLE_LLVM, the default build does not depend on
+	 * LLVM.
+	 *
+	 * Generated functions behave like the interpreter's: integer
+	 * arithmetic wraps and division by zero traps.
+	 */
+	class LlvmBackend {
+		unsigned optimisation_level_;
+	public:
+		/**
+		 * @param optimisation_level 0 to 3, like -O.
+		 */
+		explicit LlvmBackend(const unsigned optimisation_level = 2)
+			: optimisation_level_(optimisation_level) {}
+
+		/**
+		 * Returns the optimised LLVM IR as text.
+		 */
+		[[nodiscard]] std::string emit_ir(const ir::Module& module) const;
+
+		/**
+		 * Returns a relocatable object for the host target.
+		 */
+		[[nodiscard]] std::vector<uint8_t> emit_object(const ir::Module& module) const;
+	};
+}
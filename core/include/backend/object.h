@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace seam::backend {
+	struct ObjectSymbol {
+		std::string name;
+		size_t offset;
+		size_t size;
+	};
+
+	/**
+	 * Call to a function of another module, to be resolved by the linker.
+	 */
+	struct ObjectRelocation {
+		// offset of the call's rel32 field
+		size_t offset;
+		std::string symbol;
+	};
+
+	/**
+	 * Position independent machine code with one symbol per function.
+	 * Calls between functions of the module are already resolved, only
+	 * calls to functions of other modules need relocations.
+	 */
+	struct ObjectCode {
+		std::vector<uint8_t> text;
+		std::vector<ObjectSymbol> symbols;
+		std::vector<ObjectRelocation> relocations;
+
+		[[nodiscard]] std::optional<size_t> find(const std::string& name) const {
+			for (const auto& symbol : symbols) {
+				if (symbol.name == name) {
+					return symbol.offset;
+				}
+			}
+			return std::nullopt;
+		}
+	};
+
+	/**
+	 * Writes an ELF64 relocatable object for x86-64 Linux containing the
+	 * code in .text, a global function symbol per function and an
+	 * undefined symbol per function of another module it calls.
+	 */
+	[[nodiscard]] std::vector<uint8_t> write_elf_object(const ObjectCode& object);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace seam::backend::x86_64 {
+	enum class Register : uint8_t {
+		Rax, Rcx, Rdx, Rbx, Rsp, Rbp, Rsi, Rdi,
+		R8, R9, R10, R11, R12, R13, R14, R15,
+	};
+
+	enum class XmmRegister : uint8_t {
+		Xmm0, Xmm1, Xmm2, Xmm3, Xmm4, Xmm5, Xmm6, Xmm7,
+	};
+
+	enum class Condition : uint8_t {
+		AboveOrEqual = 0x3,
+		Equal = 0x4,
+		NotEqual = 0x5,
+		NotParity = 0xb,
+	};
+
+	enum class SseOperation : uint8_t {
+		Add = 0x58,
+		Mul = 0x59,
+		Sub = 0x5c,
+		Div = 0x5e,
+	};
+
+	using Label = uint32_t;
+
+	/**
+	 * x86-64 Assembler.
+	 *
+	 * Encodes the handful of instructions the code generator selects into
+	 * a flat buffer. Every integer instruction operates on 64 bits, memory
+	 * operands are relative to rbp except for load_indirect. Jumps and calls to labels are
+	 * patched once the label is bound.
+	 */
+	class Assembler {
+		struct Fixup {
+			size_t offset; // of the rel32 field
+			Label label;
+		};
+
+		std::vector<uint8_t> code_;
+		std::vector<size_t> labels_;
+		std::vector<Fixup> fixups_;
+
+		void emit(uint8_t byte) { code_.push_back(byte); }
+		void emit32(uint32_t value);
+		void emit64(uint64_t value);
+
+		void rex(bool wide, uint8_t reg, uint8_t rm);
+		void modrm_register(uint8_t reg, uint8_t rm);
+		void modrm_frame(uint8_t reg, int32_t displacement);
+		void rel32(Label label);
+	public:
+		[[nodiscard]] Label create_label();
+		void bind(Label label);
+		[[nodiscard]] size_t offset(const Label label) const { return labels_[label]; }
+
+		/**
+		 * Resolves all jumps and returns the encoded code.
+		 */
+		[[nodiscard]] std::vector<uint8_t> finish();
+
+		[[nodiscard]] size_t size() const { return code_.size(); }
+
+		// data movement
+		void mov(Register destination, Register source);
+		void mov(Register destination, int64_t immediate);
+		void load(Register destination, int32_t frame_offset);
+		// destination = [address]
+		void load_indirect(Register destination, Register address);
+		void store(int32_t frame_offset, Register source);
+		void push(Register reg);
+		void pop(Register reg);
+		void lea_frame(Register destination, int32_t frame_offset);
+
+		// integer arithmetic
+		void add(Register destination, Register source);
+		void sub(Register destination, Register source);
+		void imul(Register destination, Register source);
+		void and_(Register destination, Register source);
+		void xor_(Register destination, Register source);
+		void neg(Register reg);
+		void cqo();
+		void idiv(Register divisor);
+		void sub(Register destination, int32_t immediate);
+
+		// comparisons
+		void cmp(Register lhs, Register rhs);
+		void cmp(Register lhs, int8_t immediate);
+		void test(Register lhs, Register rhs);
+		void setcc(Condition condition, Register destination);
+		void movzx_byte(Register destination, Register source);
+		void and_byte(Register destination, Register source);
+
+		// scalar doubles
+		void movq(XmmRegister destination, Register source);
+		void movq(Register destination, XmmRegister source);
+		void sse(SseOperation operation, XmmRegister destination, XmmRegister source);
+		void ucomisd(XmmRegister lhs, XmmRegister rhs);
+
+		// control flow
+		void jmp(Label label);
+		void jcc(Condition condition, Label label);
+		void call(Label label);
+		void call(Register target);
+
+		/**
+		 * Calls code outside the buffer, the rel32 field is left zero.
+		 *
+		 * @returns offset of the rel32 field, to relocate.
+		 */
+		[[nodiscard]] size_t call_external();
+		void ret();
+		void ud2();
+	};
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "backend/object.h"
+#include "ir/ir.h"
+
+namespace seam::backend::x86_64 {
+	/**
+	 * x86-64 Code Generator.
+	 *
+	 * Selects instructions for every function of a module and follows the
+	 * System V calling convention, so generated functions can be called
+	 * from C: integers and bools are passed in rdi, rsi, rdx, rcx, r8 and
+	 * r9, doubles in xmm0 to xmm7, and results return in rax or xmm0.
+	 * Functions taking more arguments than fit in registers are rejected.
+	 *
+	 * Integer division by zero executes ud2.
+	 */
+	class CodeGenerator {
+	public:
+		/**
+		 * Stack check on entry to every generated function, for code
+		 * loaded into the running process.
+		 */
+		struct StackLimit {
+			// lowest address rsp may reach, read on every entry
+			const uintptr_t* limit;
+			// called with the context when rsp is below the limit, must not return
+			void (*exceeded)(void* context);
+			void* context;
+		};
+	private:
+		std::optional<StackLimit> stack_limit_;
+	public:
+		CodeGenerator() = default;
+
+		explicit CodeGenerator(const StackLimit& stack_limit)
+			: stack_limit_(stack_limit) {}
+
+		[[nodiscard]] ObjectCode generate(const ir::Module& module);
+
+		/**
+		 * Generates only the given functions and every function they may
+		 * call, directly or not.
+		 *
+		 * @param entries address of each function already in memory, or
+		 * null. Those functions are called at that address rather than
+		 * generated again, so the code can only run where it is loaded.
+		 */
+		[[nodiscard]] ObjectCode generate(const ir::Module& module, const std::vector<ir::FunctionId>& roots,
+			const std::vector<const void*>& entries = {});
+	};
+}
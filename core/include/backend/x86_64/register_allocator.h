@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+#include "backend/x86_64/assembler.h"
+#include "ir/ir.h"
+
+namespace seam::backend::x86_64 {
+	/**
+	 * Where a value lives for its whole lifetime.
+	 */
+	struct Location {
+		enum class Kind : uint8_t {
+			None, // values of type none, or never placed
+			Register,
+			Stack,
+		};
+
+		Kind kind = Kind::None;
+		Register reg = Register::Rax;
+		// index of the spill slot
+		uint32_t slot = 0;
+
+		bool operator==(const Location& other) const = default;
+	};
+
+	struct Allocation {
+		// reachable blocks in the order their code is laid out
+		std::vector<ir::BlockId> order;
+		std::vector<Location> locations;
+		size_t spill_slots = 0;
+		// callee-saved registers handed out, to be preserved by the prologue
+		std::vector<Register> used_registers;
+	};
+
+	/**
+	 * Registers the allocator hands out. Only callee-saved registers are
+	 * used, so values survive calls without being saved around them; the
+	 * caller-saved registers are left as scratch for instruction selection.
+	 */
+	constexpr Register allocatable_registers[] {
+		Register::Rbx, Register::R12, Register::R13, Register::R14, Register::R15,
+	};
+
+	/**
+	 * Linear Scan Register Allocation.
+	 *
+	 * Lays the blocks out in reverse postorder, computes one live interval
+	 * per value from block liveness and assigns registers in order of
+	 * interval start, spilling the interval that ends last when none is
+	 * free (Poletto and Sarkar). Phi operands are live to the end of their
+	 * predecessor, phis start at the beginning of their block.
+	 */
+	[[nodiscard]] Allocation allocate_registers(const ir::Function& function);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+
+#include "source_position.h"
+
+namespace seam {
+	/**
+	 * Diagnostic Codes.
+	 *
+	 * Errors are recorded as a code plus a short argument and are only
+	 * formatted into a message once they are actually rendered.
+	 */
+	enum class DiagnosticCode {
+		None,
+
+		// lexical errors
+		UnexpectedEof, // argument: expected terminator
+		MalformedNumberLiteral,
+		ExpectedHexDigit, // argument: offending character
+		ExpectedDigit, // argument: offending character
+		MalformedFloatTwoPoints,
+		UnknownSymbol, // argument: offending character
+
+		// literal decoding errors
+		IntegerLiteralOverflow, // argument: literal
+		FloatLiteralOverflow, // argument: literal
+
+		// name resolution errors
+		UndefinedIdentifier, // argument: identifier
+		Redeclaration, // argument: identifier
+		NotCallable, // argument: identifier
+
+		// type errors
+		UnknownType, // argument: type name
+		TypeMismatch, // argument: expected type, second: actual type
+		InvalidOperands, // argument: operator, second: operand type
+		NotAssignable, // argument: expression description
+		ArgumentCountMismatch, // argument: function, second: expected count
+		CyclicTypeAlias, // argument: alias name
+	};
+
+	/**
+	 * Formats a diagnostic into a human readable message.
+	 *
+	 * @param code diagnostic code.
+	 * @param argument argument recorded alongside the code.
+	 * @param second_argument second argument for codes that take two.
+	 *
+	 * @returns formatted message.
+	 */
+	std::string format_diagnostic(DiagnosticCode code, const std::string& argument = "", const std::string& second_argument = "");
+
+	/**
+	 * Recorded Diagnostic.
+	 */
+	struct Diagnostic {
+		DiagnosticCode code;
+		SourcePosition position;
+		std::string argument;
+		std::string second_argument;
+
+		[[nodiscard]] std::string message() const { return format_diagnostic(code, argument, second_argument); }
+	};
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "driver/compiler.h"
+#include "driver/time_report.h"
+
+namespace seam::driver {
+	struct BuildOptions {
+		// source files, and directories searched for .seam files
+		std::vector<std::filesystem::path> inputs;
+		std::filesystem::path output_directory = "build";
+		// empty for a cache inside the output directory
+		std::filesystem::path cache_directory;
+		CompileOptions compile;
+		// units compiled at once, 0 to use every core
+		size_t threads = 0;
+	};
+
+	struct BuildResult {
+		// skipped because the stamps of every input matched
+		size_t unchanged = 0;
+		// stamps changed but the content hashed the same
+		size_t rehashed = 0;
+		// copied from the object store
+		size_t restored = 0;
+		size_t compiled = 0;
+		size_t failed = 0;
+		std::vector<std::string> diagnostics;
+
+		[[nodiscard]] bool succeeded() const { return failed == 0; }
+	};
+
+	/**
+	 * Source of a module and the output it is compiled to.
+	 */
+	struct ModuleFile {
+		std::filesystem::path source;
+		std::filesystem::path output;
+		// interface file next to the output, read by importers instead of the source
+		std::filesystem::path interface;
+		// path below its input directory with dots for separators, e.g. "geometry.shapes"
+		std::string name;
+	};
+
+	/**
+	 * Finds the modules of a project, raising a DriverException for
+	 * missing inputs and modules that would share an output.
+	 */
+	[[nodiscard]] std::vector<ModuleFile> find_modules(const BuildOptions& options);
+
+	/**
+	 * Content address of a module's output: the hash of the options,
+	 * the source and the interface of every import.
+	 *
+	 * @param imports name and interface hash of each import, empty if it was not found.
+	 */
+	[[nodiscard]] std::string module_key(const std::string& fingerprint, const std::string& hash,
+		const std::vector<std::pair<std::string, std::string>>& imports);
+
+	/**
+	 * Builds a project into its output directory, one output per module.
+	 *
+	 * Outputs are recorded in a manifest in the output directory. A module
+	 * whose source, imported sources and output still have their recorded
+	 * stamps is done after a stat per file; otherwise its source is hashed
+	 * and its output is looked up in the object store by its key. Only
+	 * modules missing from the store are compiled, in parallel, against
+	 * the interfaces of the modules they import. Each module's interface
+	 * is written to an interface file, so importing an unchanged module
+	 * maps its interface file instead of parsing its source.
+	 *
+	 * Unreadable inputs and unwritable outputs raise a DriverException,
+	 * compile errors are returned in the result.
+	 */
+	[[nodiscard]] BuildResult build(const BuildOptions& options, TimeReport& report);
+}
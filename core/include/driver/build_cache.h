@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace seam::driver {
+	/**
+	 * What a stat reveals about a file, enough to tell that it has not
+	 * changed without reading it.
+	 */
+	struct FileStamp {
+		uint64_t size = 0;
+		// nanoseconds on the file clock, unknown_time if it must not be trusted
+		int64_t modified = 0;
+
+		static constexpr int64_t unknown_time = -1;
+
+		bool operator==(const FileStamp&) const = default;
+
+		/**
+		 * @returns stamp of the file, or nothing if it is missing.
+		 */
+		[[nodiscard]] static std::optional<FileStamp> of(const std::filesystem::path& path);
+
+		/**
+		 * Files modified just before a build may change again without
+		 * their stamp changing, given a coarse file system clock.
+		 *
+		 * @param racy_since time from racy_since().
+		 *
+		 * @returns the stamp, its time unknown if it is that recent.
+		 */
+		[[nodiscard]] FileStamp trusted(int64_t racy_since) const;
+
+		/**
+		 * @returns time on the file clock after which stamps are not trusted.
+		 */
+		[[nodiscard]] static int64_t racy_since();
+
+		/**
+		 * @returns whether a file still has the recorded stamp, known times only.
+		 */
+		[[nodiscard]] static bool matches(const std::optional<FileStamp>& stamp, const FileStamp& recorded);
+	};
+
+	/**
+	 * Input a cached output was built from.
+	 */
+	struct Dependency {
+		std::filesystem::path path;
+		FileStamp stamp;
+		// SHA-256 of the content
+		std::string hash;
+	};
+
+	struct ManifestEntry {
+		std::filesystem::path output;
+		FileStamp output_stamp;
+		// compile options fingerprint the output was built under
+		std::string fingerprint;
+		// content address of the output in the object store
+		std::string key;
+		// hash of the module's interface
+		std::string interface;
+		// modules imported by the source
+		std::vector<std::string> imports;
+		// the source first, then the source of every import found
+		std::vector<Dependency> dependencies;
+	};
+
+	/**
+	 * Build Manifest.
+	 *
+	 * Records, for every output of the last build, the inputs it was
+	 * built from and their stamps, so a build whose inputs all still
+	 * have the same stamps can skip the output without reading them.
+	 * What was derived from a source, its imports and interface, is
+	 * recorded as well and holds for as long as the source's hash.
+	 */
+	class Manifest {
+		std::map<std::string, ManifestEntry> entries_;
+	public:
+		/**
+		 * Loads a manifest, a missing or unreadable one is empty.
+		 */
+		[[nodiscard]] static Manifest load(const std::filesystem::path& path);
+		void save(const std::filesystem::path& path) const;
+
+		[[nodiscard]] const ManifestEntry* find(const std::filesystem::path& output) const;
+		void set(ManifestEntry entry);
+		void erase(const std::filesystem::path& output);
+
+		[[nodiscard]] size_t size() const { return entries_.size(); }
+	};
+
+	/**
+	 * Content-Addressed Object Store.
+	 *
+	 * Keeps every output it is given under its key, the hash of all it
+	 * was built from. Stores can be shared by any number of builds.
+	 */
+	class ObjectStore {
+		std::filesystem::path directory_;
+
+		[[nodiscard]] std::filesystem::path path_of(const std::string& key) const;
+	public:
+		explicit ObjectStore(std::filesystem::path directory)
+			: directory_(std::move(directory)) {}
+
+		[[nodiscard]] std::optional<std::string> load(const std::string& key) const;
+		void store(const std::string& key, std::string_view contents) const;
+	};
+
+	/**
+	 * Read-only file mapped into memory, read without a copy. Files are
+	 * replaced by a rename, never written in place, so a mapping stays
+	 * valid while it is open.
+	 */
+	class MappedFile {
+		const char* data_ = nullptr;
+		size_t size_ = 0;
+#ifdef _WIN32
+		// read into memory instead
+		std::string contents_;
+#endif
+
+		MappedFile() = default;
+		void release();
+	public:
+		/**
+		 * @returns the mapped file, nothing if it cannot be opened.
+		 */
+		[[nodiscard]] static std::optional<MappedFile> open(const std::filesystem::path& path);
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		~MappedFile();
+
+		[[nodiscard]] std::string_view data() const { return { data_, size_ }; }
+	};
+
+	[[nodiscard]] std::string read_file(const std::filesystem::path& path);
+
+	/**
+	 * Writes a file through a temporary and a rename, so readers never
+	 * see it half written.
+	 */
+	void write_file(const std::filesystem::path& path, std::string_view contents);
+}
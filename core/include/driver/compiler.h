@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ast/ast.h"
+#include "driver/module_interface.h"
+#include "driver/time_report.h"
+#include "source.h"
+
+namespace seam::driver {
+	enum class EmitKind {
+		// ELF64 relocatable object for x86-64 Linux
+		Object,
+		// C11 source
+		C,
+		// printed IR, after optimisation
+		Ir,
+	};
+
+	struct CompileOptions {
+		EmitKind emit = EmitKind::Object;
+		bool optimise = true;
+
+		/**
+		 * Describes the compiler and every option that shapes the output,
+		 * cached outputs are only reused under the same fingerprint.
+		 */
+		[[nodiscard]] std::string fingerprint() const;
+	};
+
+	/**
+	 * @returns file extension of outputs, including the dot.
+	 */
+	[[nodiscard]] const char* output_extension(EmitKind emit);
+
+	struct ParsedUnit {
+		std::string path;
+		std::unique_ptr<Source> source;
+		// null if parsing failed
+		std::unique_ptr<ast::Program> program;
+		// rendered as "path:line:column: error: message"
+		std::vector<std::string> diagnostics;
+	};
+
+	struct CompileResult {
+		// null if the unit had errors
+		std::optional<std::string> output;
+		// rendered as "path:line:column: error: message"
+		std::vector<std::string> diagnostics;
+	};
+
+	/**
+	 * Parses one unit.
+	 *
+	 * @param path path of the unit, only used in diagnostics.
+	 * @param text UTF-8 source text.
+	 * @param report receives phase timings.
+	 */
+	[[nodiscard]] ParsedUnit parse(const std::string& path, std::string_view text, TimeReport& report);
+
+	/**
+	 * Compiles a parsed unit: resolves names, type checks and emits.
+	 * The program is left as it was, so it can be compiled again.
+	 * Each phase is timed into the report.
+	 *
+	 * @param unit successfully parsed unit.
+	 * @param imports interface of each import of the program, in order, null if there is no such module.
+	 * @param options compile options.
+	 * @param report receives phase timings.
+	 *
+	 * @returns output, or the diagnostics that prevented it.
+	 */
+	[[nodiscard]] CompileResult compile(const ParsedUnit& unit, const std::vector<const ModuleInterface*>& imports,
+		const CompileOptions& options, TimeReport& report);
+
+	/**
+	 * Parses and compiles a unit that imports nothing.
+	 */
+	[[nodiscard]] CompileResult compile(const std::string& path, std::string_view text, const CompileOptions& options, TimeReport& report);
+}
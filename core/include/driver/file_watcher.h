@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <vector>
+
+namespace seam::driver {
+	/**
+	 * File Watcher.
+	 *
+	 * Watches directories, and every directory below them, for files
+	 * being written, created, moved or deleted. Built on inotify, on
+	 * other systems construction raises a DriverException.
+	 */
+	class FileWatcher {
+		int descriptor_ = -1;
+		std::vector<std::filesystem::path> roots_;
+		// watch descriptor to directory
+		std::map<int, std::filesystem::path> watches_;
+
+		void watch(const std::filesystem::path& directory);
+		void read_events(std::vector<std::filesystem::path>& changed);
+	public:
+		explicit FileWatcher(const std::vector<std::filesystem::path>& directories);
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		/**
+		 * Waits for a change, then collects changes until none came for
+		 * the settle time, so that saving several files is one batch.
+		 * A directory among the changes stands for anything below it,
+		 * e.g. when events were lost.
+		 *
+		 * @param timeout longest wait for a first change, negative to wait for good.
+		 * @param settle quiet time that ends a batch.
+		 *
+		 * @returns changed paths, empty if the wait timed out.
+		 */
+		[[nodiscard]] std::vector<std::filesystem::path> wait(std::chrono::milliseconds timeout,
+			std::chrono::milliseconds settle = std::chrono::milliseconds(20));
+	};
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace seam::driver {
+	/**
+	 * SHA-256.
+	 *
+	 * Names build cache entries by their content, so collisions must be
+	 * out of the question.
+	 */
+	class Sha256 {
+		std::array<uint32_t, 8> state_;
+		std::array<uint8_t, 64> block_ {};
+		size_t block_size_ = 0;
+		uint64_t length_ = 0;
+
+		void compress(const uint8_t* block);
+	public:
+		Sha256();
+
+		void update(std::string_view data);
+
+		/**
+		 * Finishes the digest, the hasher must not be used afterwards.
+		 *
+		 * @returns digest as 64 lower case hex digits.
+		 */
+		[[nodiscard]] std::string hex();
+	};
+
+	[[nodiscard]] std::string sha256(std::string_view data);
+}
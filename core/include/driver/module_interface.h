@@ -0,0 +1,74 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ast/ast.h"
+
+namespace seam::driver {
+	/**
+	 * Module Interface.
+	 *
+	 * What importers see of a module: its top-level functions, without
+	 * their bodies, and its type aliases. Importers are compiled against
+	 * the interface only, so they are compiled again only when it
+	 * changes, and modules may import each other.
+	 */
+	struct ModuleInterface {
+		struct Function {
+			std::string name;
+			ast::ParameterList params;
+			std::string return_type;
+		};
+
+		struct Alias {
+			std::string alias;
+			std::string type;
+		};
+
+		std::vector<Function> functions;
+		std::vector<Alias> aliases;
+
+		[[nodiscard]] static ModuleInterface of(const ast::Program& program);
+
+		/**
+		 * Hashes what importers depend on, parameter names and positions
+		 * are left out.
+		 *
+		 * @returns SHA-256 as hex digits.
+		 */
+		[[nodiscard]] std::string hash() const;
+
+		/**
+		 * Encodes the interface for an interface file: its hash, then a
+		 * table of the names it uses, each once, and the functions and
+		 * aliases as indices into it. Numbers are 32-bit little-endian.
+		 */
+		[[nodiscard]] std::string encode() const;
+
+		/**
+		 * @param hash expected hash of the interface.
+		 *
+		 * @returns the decoded interface, nothing if the data is malformed or another interface's.
+		 */
+		[[nodiscard]] static std::optional<ModuleInterface> decode(std::string_view data, std::string_view hash);
+
+		/**
+		 * Maps an interface file and decodes it, importers need not parse
+		 * the module's source.
+		 *
+		 * @returns the interface, nothing if the file is missing, malformed or out of date.
+		 */
+		[[nodiscard]] static std::optional<ModuleInterface> load(const std::filesystem::path& path, std::string_view hash);
+
+		/**
+		 * Creates declarations for an importer, functions without bodies.
+		 *
+		 * @param position where they are reported, the import.
+		 */
+		[[nodiscard]] ast::DeclarationList declarations(SourcePosition position) const;
+	};
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace seam::driver {
+	/**
+	 * Time Report.
+	 *
+	 * Sums how long each phase of a build took, in the order the phases
+	 * first ran. Units compiled in parallel add up their times, so a
+	 * phase can take longer than the whole build.
+	 */
+	class TimeReport {
+		struct Phase {
+			std::string name;
+			std::chrono::nanoseconds time {};
+			size_t count = 0;
+		};
+
+		mutable std::mutex mutex_;
+		std::vector<Phase> phases_;
+	public:
+		/**
+		 * Times a phase until it goes out of scope.
+		 */
+		class Timer {
+			TimeReport& report_;
+			const char* phase_;
+			std::chrono::steady_clock::time_point start_;
+		public:
+			Timer(TimeReport& report, const char* phase)
+				: report_(report), phase_(phase), start_(std::chrono::steady_clock::now()) {}
+			~Timer() { report_.add(phase_, std::chrono::steady_clock::now() - start_); }
+
+			Timer(const Timer&) = delete;
+			Timer& operator=(const Timer&) = delete;
+		};
+
+		void add(const std::string& phase, std::chrono::nanoseconds time);
+
+		[[nodiscard]] std::chrono::nanoseconds time(const std::string& phase) const;
+		[[nodiscard]] size_t count(const std::string& phase) const;
+
+		/**
+		 * Renders the phases as a table, followed by the wall clock time.
+		 */
+		[[nodiscard]] std::string render(std::chrono::nanoseconds total) const;
+	};
+}
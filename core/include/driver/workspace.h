@@ -0,0 +1,73 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "driver/build.h"
+#include "driver/build_cache.h"
+#include "driver/compiler.h"
+#include "driver/module_interface.h"
+
+namespace seam::driver {
+	/**
+	 * Resident Workspace.
+	 *
+	 * Keeps every module of a project parsed, with its interface and its
+	 * imports, for watch mode. After a change only the changed modules
+	 * are parsed again, and only they and the modules importing a changed
+	 * interface are compiled again. Outputs, the object store and the
+	 * manifest are kept as build() keeps them, so a later build of the
+	 * same project has nothing to do.
+	 */
+	class Workspace {
+		struct Module {
+			ModuleFile file;
+			FileStamp source_stamp;
+			std::string hash;
+			ParsedUnit parsed;
+			// null if the module does not parse
+			std::optional<ModuleInterface> interface;
+			std::string interface_hash;
+			std::vector<std::string> imports;
+		};
+
+		BuildOptions options_;
+		std::string fingerprint_;
+		ObjectStore store_;
+		std::filesystem::path manifest_path_;
+		Manifest manifest_;
+
+		std::map<std::string, Module> modules_;
+		// source path to module name
+		std::map<std::filesystem::path, std::string> sources_;
+
+		void load(Module& module, TimeReport& report);
+		void rescan(std::set<std::string>& added, std::set<std::string>& removed, TimeReport& report);
+		void compile(const std::vector<Module*>& modules, BuildResult& result, TimeReport& report);
+	public:
+		explicit Workspace(BuildOptions options);
+
+		/**
+		 * Builds the project with build(), then parses every module.
+		 */
+		BuildResult load(TimeReport& report);
+
+		/**
+		 * Catches up with changed files: sources written, created or
+		 * deleted. A directory among them, or a source not seen before,
+		 * has the inputs searched for modules again.
+		 */
+		BuildResult update(const std::vector<std::filesystem::path>& changed, TimeReport& report);
+
+		/**
+		 * @returns directories holding the sources, to watch for changes.
+		 */
+		[[nodiscard]] std::vector<std::filesystem::path> directories() const;
+
+		[[nodiscard]] size_t size() const { return modules_.size(); }
+	};
+}
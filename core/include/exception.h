@@ -1,32 +1,28 @@
 #pragma once
 
-#include <codecvt>
 #include <exception>
 #include <stdexcept>
+#include <string>
 #include <utility>
 #include <fmt/format.h>
-#include <locale>
 
 #include "source_position.h"
-#ifndef _WIN32
-#include <fmt/xchar.h>
-#endif
 
 namespace seam {
 	template<class T, typename... Args>
-	T generate_exception(const SourcePosition source_position, std::wstring exception_message, Args&&... args) {
-		return T(source_position, fmt::format(exception_message.c_str(), args...));
+	T generate_exception(const SourcePosition source_position, std::string exception_message, Args&&... args) {
+		return T(source_position, fmt::format(fmt::runtime(exception_message), args...));
 	}
 
 	class SeamException : public std::runtime_error {
 		const SourcePosition pos_;
 	protected:
-		SeamException(const SourcePosition source_position, const std::wstring& exception_message)
-			: std::runtime_error(std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>>().to_bytes(exception_message)),
+		SeamException(const SourcePosition source_position, const std::string& exception_message)
+			: std::runtime_error(exception_message),
 			  pos_(source_position) {}
 	public:
-		SeamException(const std::wstring& exception_message)
-			: std::runtime_error(std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>>().to_bytes(exception_message)),
+		SeamException(const std::string& exception_message)
+			: std::runtime_error(exception_message),
 			pos_({ 0, 0 }) {}
 	public:
 		[[nodiscard]] SourcePosition position() const { return pos_; }
@@ -34,13 +30,43 @@ namespace seam {
 	
 	class LexicalException final : public SeamException {
 	public:
-		LexicalException(const SourcePosition source_position, std::wstring exception_message)
+		LexicalException(const SourcePosition source_position, std::string exception_message)
 			: SeamException(source_position, std::move(exception_message)) {}
 	};
 
 	class ParserException final : public SeamException {
 	public:
-		ParserException(const SourcePosition source_position, std::wstring exception_message)
+		ParserException(const SourcePosition source_position, std::string exception_message)
 			: SeamException(source_position, std::move(exception_message)) {}
 	};
+
+	class RuntimeException final : public SeamException {
+	public:
+		explicit RuntimeException(const std::string& exception_message)
+			: SeamException(exception_message) {}
+	};
+
+	class LoweringException final : public SeamException {
+	public:
+		LoweringException(const SourcePosition source_position, std::string exception_message)
+			: SeamException(source_position, std::move(exception_message)) {}
+	};
+
+	class CodegenException final : public SeamException {
+	public:
+		explicit CodegenException(const std::string& exception_message)
+			: SeamException(exception_message) {}
+	};
+
+	class ProtocolException final : public SeamException {
+	public:
+		explicit ProtocolException(const std::string& exception_message)
+			: SeamException(exception_message) {}
+	};
+
+	class DriverException final : public SeamException {
+	public:
+		explicit DriverException(const std::string& exception_message)
+			: SeamException(exception_message) {}
+	};
 }
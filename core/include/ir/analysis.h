@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+#include "ir/ir.h"
+
+namespace seam::ir {
+	constexpr BlockId no_block = UINT32_MAX;
+
+	/**
+	 * Returns the blocks a terminator may transfer control to.
+	 */
+	[[nodiscard]] std::vector<BlockId> successors(const Block& block);
+
+	/**
+	 * Returns the block each value is placed in, no_block for values that
+	 * are no longer part of the function.
+	 */
+	[[nodiscard]] std::vector<BlockId> value_blocks(const Function& function);
+
+	/**
+	 * Dominator Tree.
+	 *
+	 * Built with the iterative algorithm of Cooper, Harvey and Kennedy over
+	 * the reverse postorder of the blocks reachable from the entry. Each
+	 * block is numbered on entering and leaving it in a walk of the tree,
+	 * so dominance is answered without walking up the tree.
+	 */
+	class DominatorTree {
+		std::vector<BlockId> order_;
+		std::vector<BlockId> idom_;
+		std::vector<std::vector<BlockId>> children_;
+		std::vector<uint32_t> enter_;
+		std::vector<uint32_t> leave_;
+	public:
+		explicit DominatorTree(const Function& function);
+
+		[[nodiscard]] const std::vector<BlockId>& reverse_postorder() const { return order_; }
+		[[nodiscard]] bool reachable(const BlockId block) const { return idom_[block] != no_block; }
+		[[nodiscard]] BlockId idom(const BlockId block) const { return idom_[block]; }
+		[[nodiscard]] const std::vector<BlockId>& children(const BlockId block) const { return children_[block]; }
+		[[nodiscard]] bool dominates(BlockId dominator, BlockId block) const;
+	};
+
+	/**
+	 * Natural Loop.
+	 */
+	struct Loop {
+		BlockId header;
+		// member blocks in reverse postorder, header first
+		std::vector<BlockId> blocks;
+		std::vector<bool> contains;
+	};
+
+	/**
+	 * Finds the natural loops of a function, back edges sharing a header
+	 * form one loop. Inner loops come before the loops enclosing them.
+	 */
+	[[nodiscard]] std::vector<Loop> find_loops(const Function& function, const DominatorTree& dominators);
+}
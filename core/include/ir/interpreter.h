@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+
+#include "ir/ir.h"
+
+namespace seam::ir {
+	/**
+	 * Runtime Value.
+	 *
+	 * Booleans are stored as 0 or 1 in i64.
+	 */
+	union Value {
+		int64_t i64;
+		double f64;
+	};
+
+	/**
+	 * Execution counts of one function, used to find hot code.
+	 */
+	struct FunctionProfile {
+		size_t calls = 0;
+		// jumps to a block created before the current one, the lowering creates loop headers before their bodies
+		size_t back_edges = 0;
+	};
+
+	/**
+	 * Offered every call an interpreter makes, may execute it elsewhere.
+	 */
+	class CallHandler {
+	public:
+		virtual ~CallHandler() = default;
+
+		/**
+		 * @returns true if the call was executed and the result stored.
+		 */
+		virtual bool handle(FunctionId function, const std::vector<Value>& arguments, Value& result) = 0;
+	};
+
+	/**
+	 * IR Interpreter.
+	 *
+	 * Executes a module directly. Integer arithmetic wraps around, integer
+	 * division by zero raises a RuntimeException.
+	 */
+	class Interpreter {
+		const Module& module_;
+		size_t depth_ = 0;
+		size_t max_depth_;
+
+		// number of instructions executed so far
+		size_t executed_ = 0;
+		std::vector<FunctionProfile> profiles_;
+		CallHandler* handler_ = nullptr;
+	public:
+		/**
+		 * @param module module to execute, must outlive the interpreter.
+		 * @param max_depth deepest call nesting before execution is aborted.
+		 */
+		explicit Interpreter(const Module& module, size_t max_depth = 10000);
+
+		/**
+		 * Calls a function.
+		 *
+		 * @param function function to call.
+		 * @param arguments one value per parameter.
+		 *
+		 * @returns returned value, unspecified for functions returning none.
+		 */
+		Value call(FunctionId function, const std::vector<Value>& arguments);
+
+		[[nodiscard]] size_t executed() const { return executed_; }
+		[[nodiscard]] const FunctionProfile& profile(const FunctionId function) const { return profiles_[function]; }
+
+		/**
+		 * Offers calls made by interpreted code to a handler first.
+		 */
+		void set_call_handler(CallHandler* handler) { handler_ = handler; }
+	};
+}
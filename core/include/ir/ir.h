@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace seam::ir {
+	using ValueId = uint32_t;
+	using BlockId = uint32_t;
+	using FunctionId = uint32_t;
+
+	constexpr ValueId no_value = UINT32_MAX;
+
+	/**
+	 * IR Value Types.
+	 *
+	 * Every integer type is lowered to 64 bits.
+	 */
+	enum class Type : uint8_t {
+		None,
+		Bool,
+		I64,
+		F64,
+	};
+
+	enum class Opcode : uint8_t {
+		Const, // immediate holds the value
+		Param, // immediate holds the parameter index
+		Undef, // read of a variable with no reaching definition
+		Phi, // one operand per block predecessor, in predecessor order
+
+		Neg,
+		Add,
+		Sub,
+		Mul,
+		Div,
+		And,
+		Eq,
+
+		Call, // immediate holds the callee, operands are the arguments
+
+		Removed, // trivial phi, forwards to its single operand
+	};
+
+	struct Instruction {
+		Opcode op;
+		Type type;
+		std::vector<ValueId> operands;
+
+		union {
+			int64_t i64;
+			double f64;
+			uint32_t index;
+		} immediate { 0 };
+	};
+
+	enum class TerminatorKind : uint8_t {
+		None, // block is still being built
+		Jump,
+		Branch, // value is the condition, targets are the true and false blocks
+		Return, // value is no_value for functions returning none
+	};
+
+	struct Terminator {
+		TerminatorKind kind = TerminatorKind::None;
+		ValueId value = no_value;
+		BlockId targets[2] { 0, 0 };
+	};
+
+	/**
+	 * Basic Block.
+	 *
+	 * Phi nodes always come first in the instruction list.
+	 */
+	struct Block {
+		std::vector<ValueId> instructions;
+		size_t phi_count = 0;
+
+		std::vector<BlockId> predecessors;
+		Terminator terminator;
+	};
+
+	/**
+	 * SSA Function.
+	 *
+	 * Values and blocks are stored contiguously and referred to by index;
+	 * block 0 is the entry block. A function without blocks is defined
+	 * in another module and only declared.
+	 */
+	struct Function {
+		std::string name;
+		std::vector<Type> params;
+		Type result = Type::None;
+
+		std::vector<Instruction> values;
+		std::vector<Block> blocks;
+
+		ValueId add_value(Instruction instruction) {
+			values.push_back(std::move(instruction));
+			return static_cast<ValueId>(values.size() - 1);
+		}
+
+		BlockId add_block() {
+			blocks.emplace_back();
+			return static_cast<BlockId>(blocks.size() - 1);
+		}
+	};
+
+	struct Module {
+		std::vector<Function> functions;
+
+		[[nodiscard]] std::optional<FunctionId> find(const std::string& name) const;
+	};
+
+	/**
+	 * Rewrites every use of a value according to a replacement table,
+	 * following chains of replacements. Entries equal to their own index
+	 * are left alone.
+	 */
+	void replace_uses(Function& function, std::vector<ValueId>& replacements);
+
+	/**
+	 * Checks the structural invariants of a function: terminated blocks,
+	 * leading phis with one operand per predecessor, consistent edges and
+	 * operands that are placed in some block.
+	 *
+	 * @returns description of the first violation, empty if well formed.
+	 */
+	[[nodiscard]] std::string verify(const Function& function);
+
+	[[nodiscard]] const char* type_name(Type type);
+	[[nodiscard]] const char* opcode_name(Opcode op);
+
+	/**
+	 * Renders a function or module as text, for tests and debugging.
+	 */
+	[[nodiscard]] std::string print(const Module& module, const Function& function);
+	[[nodiscard]] std::string print(const Module& module);
+}
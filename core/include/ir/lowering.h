@@ -0,0 +1,103 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "ast/ast.h"
+#include "ir/ir.h"
+#include "semantic/context.h"
+
+namespace seam::ir {
+	/**
+	 * AST to IR Lowering.
+	 *
+	 * Lowers a resolved and type checked program into SSA form. Phi nodes
+	 * are placed while the blocks are filled (Braun et al., "Simple and
+	 * Efficient Construction of Static Single Assignment Form"): reading a
+	 * variable walks up the predecessors, blocks whose predecessors are
+	 * not all known yet receive placeholder phis that are completed once
+	 * the block is sealed, and trivial phis are removed again.
+	 */
+	class AstLowering final : public ast::AstVisitor {
+		using Variable = uint32_t;
+
+		const semantic::Context& context_;
+		Module module_;
+		std::unordered_map<const symbol::Symbol*, FunctionId> functions_;
+
+		// state of the function being lowered
+		Function* function_ = nullptr;
+		BlockId block_ = 0;
+		ValueId result_ = no_value;
+
+		std::unordered_map<const symbol::Symbol*, Variable> variables_;
+		std::vector<Type> variable_types_;
+
+		// per block: current definition of each variable
+		std::vector<std::unordered_map<Variable, ValueId>> definitions_;
+		// per block: phis waiting for the block to be sealed
+		std::vector<std::vector<std::pair<Variable, ValueId>>> incomplete_phis_;
+		std::vector<bool> sealed_;
+		std::unordered_map<ValueId, BlockId> phi_blocks_;
+
+		void collect_functions(const ast::DeclarationList& decls, std::vector<ast::FunctionDeclaration*>& functions);
+		void lower_function(ast::FunctionDeclaration& func, FunctionId id);
+		void finish_function();
+
+		BlockId new_block();
+		void seal_block(BlockId block);
+		[[nodiscard]] bool terminated() const;
+		void jump(BlockId target);
+		void branch(ValueId condition, BlockId on_true, BlockId on_false);
+
+		Variable variable(const symbol::Symbol* symbol);
+		Variable new_variable(Type type);
+		void write_variable(Variable variable, BlockId block, ValueId value);
+		ValueId read_variable(Variable variable, BlockId block);
+		ValueId new_phi(BlockId block, Type type);
+		ValueId add_phi_operands(Variable variable, ValueId phi);
+		ValueId try_remove_trivial_phi(ValueId phi);
+
+		/**
+		 * Follows removed phis to the value that replaced them.
+		 */
+		[[nodiscard]] ValueId resolve(ValueId value) const;
+
+		ValueId emit(Opcode op, Type type, std::vector<ValueId> operands = {});
+		ValueId undef(Type type);
+		ValueId lower(ast::expression::Expression& expr);
+		Variable assigned_variable(const ast::expression::Expression& expr);
+
+		[[nodiscard]] Type type_of(type::TypeId type, SourcePosition position) const;
+	public:
+		explicit AstLowering(const semantic::Context& context);
+
+		/**
+		 * Lowers every function of a program, including functions declared
+		 * inside type declarations.
+		 *
+		 * @param program program that passed name resolution and type checking.
+		 *
+		 * @returns lowered module.
+		 */
+		Module lower(ast::Program& program);
+
+		void visit(ast::Program& program) override;
+		void visit(ast::FunctionDeclaration& func) override;
+		void visit(ast::TypeDeclaration& decl) override;
+		void visit(ast::TypeAliasDeclaration& decl) override;
+		void visit(ast::statement::LetStatement& stat) override;
+		void visit(ast::statement::StatementBlock& block) override;
+		void visit(ast::statement::IfStatement& stat) override;
+		void visit(ast::statement::WhileStatement& stat) override;
+		void visit(ast::statement::ReturnStatement& stat) override;
+		void visit(ast::expression::StringLiteral& expr) override;
+		void visit(ast::expression::NumberLiteral& expr) override;
+		void visit(ast::expression::BooleanLiteral& expr) override;
+		void visit(ast::expression::UnaryExpression& expr) override;
+		void visit(ast::expression::BinaryExpression& expr) override;
+		void visit(ast::expression::PostfixExpression& expr) override;
+		void visit(ast::expression::Identifier& expr) override;
+		void visit(ast::expression::FunctionCall& expr) override;
+	};
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ir/ir.h"
+
+namespace seam::ir {
+	/**
+	 * IR Transformation Pass.
+	 */
+	class Pass {
+	public:
+		virtual ~Pass() = default;
+
+		[[nodiscard]] virtual const char* name() const = 0;
+
+		/**
+		 * Runs the pass over a module.
+		 *
+		 * @returns whether the module changed.
+		 */
+		virtual bool run(Module& module) = 0;
+	};
+
+	/**
+	 * Pass transforming each function on its own.
+	 */
+	class FunctionPass : public Pass {
+	public:
+		bool run(Module& module) override;
+
+		virtual bool run_on_function(Module& module, Function& function) = 0;
+	};
+
+	struct PassStatistics {
+		std::string name;
+		size_t runs = 0;
+		size_t changes = 0;
+		std::chrono::nanoseconds time { 0 };
+	};
+
+	/**
+	 * Pass Manager.
+	 *
+	 * Runs a pipeline of passes in order and records how often each pass
+	 * ran, how often it changed the module and how long it took.
+	 */
+	class PassManager {
+		std::vector<std::unique_ptr<Pass>> passes_;
+		std::vector<PassStatistics> statistics_;
+	public:
+		/**
+		 * Creates the default optimisation pipeline.
+		 */
+		static PassManager standard_pipeline();
+
+		template<typename T, typename... Args>
+		T& add(Args&&... args) {
+			auto& pass = passes_.emplace_back(std::make_unique<T>(std::forward<Args>(args)...));
+			statistics_.push_back(PassStatistics { pass->name() });
+			return static_cast<T&>(*pass);
+		}
+
+		/**
+		 * Runs every pass once, in the order they were added.
+		 *
+		 * @returns whether any pass changed the module.
+		 */
+		bool run(Module& module);
+
+		[[nodiscard]] const std::vector<PassStatistics>& statistics() const { return statistics_; }
+
+		/**
+		 * Renders the statistics as a table.
+		 */
+		[[nodiscard]] std::string report() const;
+	};
+}
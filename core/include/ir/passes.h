@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ir/pass_manager.h"
+
+namespace seam::ir {
+	/**
+	 * Dead Code Elimination.
+	 *
+	 * Removes every value that no terminator, call or live value depends
+	 * on, including cycles of phis that only feed each other. Integer
+	 * divisions that may trap are kept, their trap is an effect.
+	 */
+	class DeadCodeElimination final : public FunctionPass {
+	public:
+		[[nodiscard]] const char* name() const override { return "dce"; }
+		bool run_on_function(Module& module, Function& function) override;
+	};
+
+	/**
+	 * Global Value Numbering.
+	 *
+	 * Walks the dominator tree with a scoped table of pure instructions
+	 * and replaces an instruction with an equivalent one that dominates
+	 * it. Operands of commutative operators are ordered first.
+	 */
+	class ValueNumbering final : public FunctionPass {
+	public:
+		[[nodiscard]] const char* name() const override { return "gvn"; }
+		bool run_on_function(Module& module, Function& function) override;
+	};
+
+	/**
+	 * Loop Invariant Code Motion.
+	 *
+	 * Moves pure instructions whose operands are defined outside a loop
+	 * into the loop's preheader, inner loops first. Divisions may trap and
+	 * calls may have effects, so neither is moved.
+	 */
+	class LoopInvariantCodeMotion final : public FunctionPass {
+	public:
+		[[nodiscard]] const char* name() const override { return "licm"; }
+		bool run_on_function(Module& module, Function& function) override;
+	};
+
+	/**
+	 * Function Inliner.
+	 *
+	 * Replaces calls to small functions with a copy of the callee's body.
+	 * Callees larger than the budget and recursive calls are left alone.
+	 */
+	class Inliner final : public Pass {
+		size_t budget_;
+	public:
+		/**
+		 * @param budget largest callee, in instructions, that is inlined.
+		 */
+		explicit Inliner(const size_t budget = 32)
+			: budget_(budget) {}
+
+		[[nodiscard]] const char* name() const override { return "inline"; }
+		bool run(Module& module) override;
+	};
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace seam::jit {
+	/**
+	 * Executable Memory.
+	 *
+	 * Owns pages holding a copy of machine code. The pages are writable
+	 * only while the code is copied in, then readable and executable.
+	 */
+	class ExecutableMemory {
+		void* memory_ = nullptr;
+		size_t size_ = 0;
+	public:
+		explicit ExecutableMemory(const std::vector<uint8_t>& code);
+		~ExecutableMemory();
+
+		ExecutableMemory(const ExecutableMemory&) = delete;
+		ExecutableMemory& operator=(const ExecutableMemory&) = delete;
+		ExecutableMemory(ExecutableMemory&& other) noexcept;
+		ExecutableMemory& operator=(ExecutableMemory&& other) noexcept;
+
+		[[nodiscard]] const void* address(const size_t offset) const { return static_cast<const uint8_t*>(memory_) + offset; }
+		[[nodiscard]] size_t size() const { return size_; }
+	};
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <csetjmp>
+#include <cstdint>
+#include <vector>
+
+#include "ir/interpreter.h"
+#include "jit/executable_memory.h"
+
+namespace seam::jit {
+	/**
+	 * Tiered Executor.
+	 *
+	 * Starts every function in the interpreter and compiles it to native
+	 * code once its calls and loop iterations reach a threshold, together
+	 * with every function it calls that is not native yet. Later calls,
+	 * from the host or from interpreted code, run the native code.
+	 *
+	 * Promotion takes effect on the next call, a running interpreted call
+	 * is not replaced. Native code would trap on integer division by zero
+	 * where the interpreter raises a RuntimeException, so functions that
+	 * may divide by zero, themselves or through a callee, stay
+	 * interpreted. Native code checks the stack on every call and bails
+	 * out once it has used native_stack_budget bytes, the call then runs
+	 * again in the interpreter, which enforces its call depth limit.
+	 * Without a supported host every function stays interpreted.
+	 */
+	class TieredExecutor final : ir::CallHandler {
+		const ir::Module& module_;
+		ir::Interpreter interpreter_;
+		size_t threshold_;
+
+		// entry point of each compiled function
+		std::vector<const void*> entries_;
+		// functions that cannot be compiled, tried once
+		std::vector<bool> rejected_;
+		std::vector<ExecutableMemory> code_;
+
+		// lowest stack address native code may reach, and where it bails out to below it
+		uintptr_t stack_limit_ = 0;
+		std::jmp_buf escape_;
+		// a call is being run again in the interpreter, nothing runs natively until it returns
+		bool interpreting_ = false;
+
+		[[nodiscard]] bool may_trap(ir::FunctionId function) const;
+		void compile(ir::FunctionId function);
+
+		/**
+		 * @returns false if the native code ran out of stack.
+		 */
+		[[nodiscard]] bool run_native(ir::FunctionId function, const std::vector<ir::Value>& arguments, ir::Value& result);
+
+		bool handle(ir::FunctionId function, const std::vector<ir::Value>& arguments, ir::Value& result) override;
+	public:
+		// stack native code may use below the host's call
+		static constexpr size_t native_stack_budget = 256 * 1024;
+
+		/**
+		 * @param module module to execute, must outlive the executor.
+		 * @param threshold calls plus loop iterations before a function is compiled.
+		 */
+		explicit TieredExecutor(const ir::Module& module, size_t threshold = 1000);
+
+		TieredExecutor(const TieredExecutor&) = delete;
+		TieredExecutor& operator=(const TieredExecutor&) = delete;
+
+		/**
+		 * Calls a function in whichever tier it has reached.
+		 */
+		ir::Value call(ir::FunctionId function, const std::vector<ir::Value>& arguments);
+
+		[[nodiscard]] bool is_compiled(const ir::FunctionId function) const { return entries_[function] != nullptr; }
+
+		// number of times code was generated
+		[[nodiscard]] size_t compilations() const { return code_.size(); }
+
+		[[nodiscard]] const ir::Interpreter& interpreter() const { return interpreter_; }
+	};
+}
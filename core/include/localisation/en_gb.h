@@ -2,13 +2,32 @@
 
 #include <string>
 
-const std::wstring LEX_UNEXPECTED_WEOF_EXCEPTION_FMT = L"expected {} but got WEOF";
+const std::string LEX_UNEXPECTED_EOF_EXCEPTION_FMT = "expected {} but got EOF";
 
-const std::wstring EXPECTED_BUT_GOT = L"expected {} but got '{}'";
+const std::string EXPECTED_BUT_GOT = "expected {} but got '{}'";
 
 // Number Lexing Exception String
-const std::wstring LEX_MALFORMED_NUMBER_LITERAL = L"malformed number literal";
-const std::wstring LEX_MALFORMED_HEX_NUMBER_LITERAL = L"malformed hex number literal";
-const std::wstring LEX_MALFORMED_FLOATING_POINT_NUMBER_LITERAL = L"malformed floating point number: {}";
+const std::string LEX_MALFORMED_NUMBER_LITERAL = "malformed number literal";
+const std::string LEX_MALFORMED_HEX_NUMBER_LITERAL = "malformed hex number literal";
+const std::string LEX_MALFORMED_FLOATING_POINT_NUMBER_LITERAL = "malformed floating point number: {}";
 
-const std::wstring LEX_MALFORMED_FLOAT_TWO_POINTS = L"a float can only have one point";
\ No newline at end of file
+const std::string LEX_MALFORMED_FLOAT_TWO_POINTS = "a float can only have one point";
+
+const std::string LEX_UNKNOWN_SYMBOL = "unknown symbol found {}";
+
+// Literal Decoding Exception Strings
+const std::string LITERAL_INTEGER_OVERFLOW = "integer literal {} does not fit in i64";
+const std::string LITERAL_FLOAT_OVERFLOW = "floating point literal {} does not fit in f64";
+
+// Semantic Analysis Exception Strings
+const std::string SEMA_UNDEFINED_IDENTIFIER = "use of undeclared identifier '{}'";
+const std::string SEMA_REDECLARATION = "redeclaration of '{}'";
+const std::string SEMA_NOT_CALLABLE = "'{}' is not a function";
+
+// Type Checking Exception Strings
+const std::string TYPE_UNKNOWN_TYPE = "unknown type '{}'";
+const std::string TYPE_MISMATCH = "expected {} but got {}";
+const std::string TYPE_INVALID_OPERANDS = "operator {} cannot be applied to {}";
+const std::string TYPE_NOT_ASSIGNABLE = "cannot assign to {}";
+const std::string TYPE_ARGUMENT_COUNT_MISMATCH = "'{}' expects {} argument(s)";
+const std::string TYPE_CYCLIC_ALIAS = "type alias '{}' refers to itself";
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "ast/ast.h"
+#include "semantic/context.h"
+#include "source.h"
+
+namespace seam::lsp {
+	/**
+	 * Unit characters in a Position are counted in, as negotiated with
+	 * the client.
+	 */
+	enum class PositionEncoding {
+		// UTF-16 code units, the protocol's default
+		Utf16,
+		// code points
+		Utf32
+	};
+
+	/**
+	 * Position in a document, zero-based line and character, characters
+	 * being counted in the document's PositionEncoding.
+	 */
+	struct Position {
+		size_t line = 0;
+		size_t character = 0;
+	};
+
+	struct Range {
+		Position start;
+		Position end;
+	};
+
+	/**
+	 * Rendered diagnostic, parse errors and semantic errors alike.
+	 */
+	struct DocumentDiagnostic {
+		SourcePosition position;
+		std::string message;
+	};
+
+	/**
+	 * Name found at a position, for hover and go-to-definition.
+	 */
+	struct SymbolInfo {
+		// the name as written, and where
+		SourcePosition reference;
+		// rendered declaration, e.g. "let x: i64"
+		std::string description;
+		SourcePosition definition;
+	};
+
+	/**
+	 * Open Document.
+	 *
+	 * Keeps the text split into top-level declarations, each parsed on
+	 * its own. An edit re-lexes from the first declaration it touches
+	 * until the token stream lines up with an untouched declaration
+	 * again, and only the declarations in between are parsed again;
+	 * later declarations keep their trees and have their positions
+	 * shifted once they are next needed.
+	 *
+	 * Semantic analysis runs over the whole program, lazily, and its
+	 * results are cached until the next edit.
+	 */
+	class Document {
+		struct Slice {
+			// offset the slice starts at, it runs up to the next slice
+			size_t begin;
+			// null if parsing failed
+			std::unique_ptr<ast::Declaration> decl;
+			std::optional<DocumentDiagnostic> error;
+			// offset not yet applied to the declaration's positions
+			ptrdiff_t shift = 0;
+		};
+
+		std::unique_ptr<Source> source_;
+		PositionEncoding encoding_;
+		std::vector<size_t> line_starts_;
+		std::vector<Slice> slices_;
+
+		// semantic results, null until analysed and after every edit
+		std::unique_ptr<semantic::Context> context_;
+		std::vector<DocumentDiagnostic> diagnostics_;
+
+		size_t reparsed_ = 0;
+
+		void index_lines();
+
+		/**
+		 * Replaces slices [first, last) by parsing from an offset until
+		 * the tokens line up with a later slice, at or past min_end.
+		 */
+		void reparse(size_t first, size_t last, size_t begin, size_t min_end);
+
+		void analyse();
+
+		[[nodiscard]] size_t slice_at(size_t offset) const;
+	public:
+		explicit Document(std::string text, PositionEncoding encoding = PositionEncoding::Utf16);
+
+		/**
+		 * Replaces a range of the text.
+		 */
+		void edit(const Range& range, const std::string& text);
+
+		/**
+		 * Replaces the whole text.
+		 */
+		void replace(std::string text);
+
+		[[nodiscard]] const std::string& text() const { return source_->get(); }
+
+		[[nodiscard]] size_t offset(const Position& position) const;
+		[[nodiscard]] Position position(size_t offset) const;
+
+		/**
+		 * Returns parse and semantic diagnostics, in source order.
+		 */
+		[[nodiscard]] const std::vector<DocumentDiagnostic>& diagnostics();
+
+		/**
+		 * Finds the name at a position.
+		 */
+		[[nodiscard]] std::optional<SymbolInfo> symbol_at(const Position& position);
+
+		/**
+		 * Returns the number of declarations parsed by the last edit.
+		 */
+		[[nodiscard]] size_t reparsed_declarations() const { return reparsed_; }
+	};
+}
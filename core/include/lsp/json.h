@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace seam::lsp {
+	/**
+	 * JSON Value.
+	 *
+	 * Just enough JSON for the language server protocol. Strings are
+	 * UTF-8, numbers are doubles and object keys are kept sorted, so
+	 * serialised output is deterministic.
+	 */
+	class Json {
+	public:
+		using Array = std::vector<Json>;
+		using Object = std::map<std::string, Json, std::less<>>;
+	private:
+		std::variant<std::nullptr_t, bool, double, std::string, Array, Object> value_;
+
+		void dump(std::string& out) const;
+	public:
+		Json() : value_(nullptr) {}
+		Json(std::nullptr_t) : value_(nullptr) {}
+		Json(const bool value) : value_(value) {}
+		Json(const int value) : value_(static_cast<double>(value)) {}
+		Json(const int64_t value) : value_(static_cast<double>(value)) {}
+		Json(const size_t value) : value_(static_cast<double>(value)) {}
+		Json(const double value) : value_(value) {}
+		Json(const char* value) : value_(std::string(value)) {}
+		Json(std::string value) : value_(std::move(value)) {}
+		Json(Array value) : value_(std::move(value)) {}
+		Json(Object value) : value_(std::move(value)) {}
+
+		/**
+		 * Parses a JSON document.
+		 *
+		 * @param text UTF-8 encoded document.
+		 *
+		 * @returns parsed value.
+		 *
+		 * @throws ProtocolException if the document is malformed.
+		 */
+		static Json parse(std::string_view text);
+
+		/**
+		 * Serialises the value without whitespace.
+		 */
+		[[nodiscard]] std::string dump() const;
+
+		[[nodiscard]] bool is_null() const { return std::holds_alternative<std::nullptr_t>(value_); }
+		[[nodiscard]] bool is_bool() const { return std::holds_alternative<bool>(value_); }
+		[[nodiscard]] bool is_number() const { return std::holds_alternative<double>(value_); }
+		[[nodiscard]] bool is_string() const { return std::holds_alternative<std::string>(value_); }
+		[[nodiscard]] bool is_array() const { return std::holds_alternative<Array>(value_); }
+		[[nodiscard]] bool is_object() const { return std::holds_alternative<Object>(value_); }
+
+		// accessors fall back to an empty value of the requested kind
+		[[nodiscard]] bool as_bool() const;
+		[[nodiscard]] double as_number() const;
+		[[nodiscard]] int64_t as_int() const { return static_cast<int64_t>(as_number()); }
+		[[nodiscard]] const std::string& as_string() const;
+		[[nodiscard]] const Array& as_array() const;
+		[[nodiscard]] const Object& as_object() const;
+
+		/**
+		 * Looks up an object member.
+		 *
+		 * @returns the member, or null if this is not an object or has no such member.
+		 */
+		[[nodiscard]] const Json& operator[](std::string_view key) const;
+
+		/**
+		 * Returns whether an object has a member.
+		 */
+		[[nodiscard]] bool contains(std::string_view key) const;
+
+		bool operator==(const Json& other) const = default;
+	};
+}
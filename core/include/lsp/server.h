@@ -0,0 +1,91 @@
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <set>
+#include <string>
+
+#include "lsp/document.h"
+#include "lsp/json.h"
+
+namespace seam::lsp {
+	/**
+	 * Reads one message framed by a Content-Length header.
+	 *
+	 * @returns the message body, or nothing at the end of input.
+	 *
+	 * @throws ProtocolException if the header is malformed.
+	 */
+	std::optional<std::string> read_message(std::istream& in);
+
+	/**
+	 * Writes one message with its Content-Length header.
+	 */
+	void write_message(std::ostream& out, const std::string& body);
+
+	/**
+	 * Language Server.
+	 *
+	 * Handles decoded LSP messages and keeps one Document per open
+	 * file. Text is synchronised incrementally; hover, go-to-definition
+	 * and diagnostics are served from each document's cached analysis.
+	 * Diagnostics are only published from idle(), so a burst of edits
+	 * is analysed once.
+	 *
+	 * Positions are counted in code points if the client offers the
+	 * utf-32 position encoding, and in UTF-16 code units otherwise.
+	 */
+	class Server {
+		std::function<void(const Json&)> send_;
+		PositionEncoding encoding_ = PositionEncoding::Utf16;
+
+		std::map<std::string, Document, std::less<>> documents_;
+		// documents edited since their diagnostics were last published
+		std::set<std::string, std::less<>> stale_;
+
+		bool shutdown_ = false;
+		std::optional<int> exit_code_;
+
+		void respond(const Json& id, Json result);
+		void respond_error(const Json& id, int code, const std::string& message);
+
+		[[nodiscard]] Json range(Document& document, SourcePosition position) const;
+		[[nodiscard]] Document* find(const Json& params);
+
+		Json initialize(const Json& params);
+		void did_open(const Json& params);
+		void did_change(const Json& params);
+		void did_close(const Json& params);
+		Json hover(const Json& params);
+		Json definition(const Json& params);
+	public:
+		/**
+		 * Constructor.
+		 *
+		 * @param send called with every response and notification.
+		 */
+		explicit Server(std::function<void(const Json&)> send);
+
+		/**
+		 * Handles one request or notification.
+		 */
+		void handle(const Json& message);
+
+		/**
+		 * Publishes diagnostics for documents edited since the last call.
+		 */
+		void idle();
+
+		/**
+		 * Runs the server over a framed stream until the client exits.
+		 *
+		 * @returns process exit code.
+		 */
+		int run(std::istream& in, std::ostream& out);
+
+		[[nodiscard]] const std::optional<int>& exit_code() const { return exit_code_; }
+	};
+}
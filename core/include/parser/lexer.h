@@ -2,9 +2,10 @@
 
 #include <unordered_map>
 #include <memory>
+#include <optional>
 
 #include "source.h"
-#include "tokens.h"
+#include "token_source.h"
 
 namespace seam {
 	/**
@@ -12,7 +13,7 @@ namespace seam {
 	 *
 	 * Takes in a Source and generates tokens.
 	 */
-	class Lexer {
+	class Lexer : public TokenSource {
 		// reference to source
 		SourceReader source_reader_;
 
@@ -34,7 +35,7 @@ namespace seam {
 		 *
 		 * @note this does <b>NOT</b> step the state of the lexer.
 		 */
-		[[nodiscard]] wchar_t peek_character(size_t num_characters_ahead = 0) const;
+		[[nodiscard]] int peek_character(size_t num_characters_ahead = 0) const;
 
 		/**
 		 * Returns the next character from the lexer.
@@ -43,7 +44,15 @@ namespace seam {
 		 *
 		 * @note this steps the state of the lexer.
 		 */
-		wchar_t next_character();
+		int next_character();
+
+		/**
+		 * Returns the character at the read position with all of its
+		 * bytes, for diagnostics.
+		 *
+		 * @note this does <b>NOT</b> step the state of the lexer.
+		 */
+		[[nodiscard]] std::string peek_character_text() const;
 
 		/**
 		 * Consumes the current characters in the lexer and returns them
@@ -51,7 +60,7 @@ namespace seam {
 		 *
 		 * @returns string containing characters currently stored in buffer.
 		 */
-		std::wstring consume();
+		std::string consume();
 
 		/**
 		 * Returns current start and end position.
@@ -65,9 +74,24 @@ namespace seam {
 		 *
 		 * @param character character to halt on.
 		 *
-		 * @returns read and consumed string.
+		 * @returns read and consumed string, or nothing if EOF was hit
+		 * (in which case an error token has been emitted).
+		 */
+		std::optional<std::string> read_until(char character);
+
+		/**
+		 * Emits an error token at the current position.
+		 *
+		 * @param code diagnostic code.
+		 * @param argument diagnostic argument.
+		 */
+		void tokenize_error(DiagnosticCode code, std::string argument = "");
+
+		/**
+		 * Skips the remainder of a malformed literal so lexing
+		 * can resume after it.
 		 */
-		std::wstring read_until(wchar_t character);
+		void skip_malformed_literal();
 
 		/**
 		 * Returns symbol from map if peek character match is found,
@@ -78,10 +102,10 @@ namespace seam {
 		 *
 		 * @returns symbol type.
 		 */
-		TokenType check_next(const std::unordered_map<wchar_t, TokenType>& map, TokenType default_symbol);
+		TokenType check_next(const std::unordered_map<int, TokenType>& map, TokenType default_symbol);
 
 		/**
-		 * Lex a comment.
+		 * Lex a comment. Only emits a token if the comment is unterminated.
 		 */
 		void tokenize_comment();
 
@@ -114,21 +138,29 @@ namespace seam {
 		 * Constructor.
 		 *
 		 * @param source source object to lex.
+		 * @param start offset to start lexing at.
+		 */
+		explicit Lexer(const Source* source, size_t start = 0);
+
+		/**
+		 * Returns the offset the next token is lexed from.
+		 *
+		 * @returns offset in source, only meaningful when no token is peeked.
 		 */
-		explicit Lexer(const Source* source);
+		[[nodiscard]] size_t offset() const { return source_reader_.current_pos(); }
 
 		/**
 		 * Peeks next token.
 		 *
 		 * @returns peeked token.
 		 */
-		[[nodiscard]] TokenType peek();
+		[[nodiscard]] TokenType peek() override;
 
 		/**
 		 * Returns next token.
 		 *
 		 * @returns next token.
 		 */
-		[[maybe_unused]] std::unique_ptr<Token> next();
+		[[maybe_unused]] std::unique_ptr<Token> next() override;
 	};
 }
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "diagnostic.h"
+#include "type/type.h"
+
+namespace seam {
+	/**
+	 * Decoded Number Literal.
+	 */
+	struct DecodedNumber {
+		// i64 or f64, None if decoding failed
+		type::BuiltIn type = type::BuiltIn::None;
+		union {
+			int64_t i64;
+			double f64;
+		} value { 0 };
+		// reason decoding failed
+		DiagnosticCode error = DiagnosticCode::None;
+	};
+
+	/**
+	 * Decodes a decimal, hex or floating point number lexeme.
+	 *
+	 * Works directly on the lexeme's characters without allocating
+	 * or consulting the locale.
+	 *
+	 * @param lexeme lexeme produced by the lexer.
+	 *
+	 * @returns decoded number or the reason it could not be decoded.
+	 */
+	[[nodiscard]] DecodedNumber decode_number_literal(std::string_view lexeme);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+
+#include "lexer.h"
+
+namespace seam {
+	/**
+	 * Parallel Lexer.
+	 *
+	 * Splits the source into chunks at whitespace and lexes each chunk
+	 * speculatively on a worker, as if no token crossed its start. A
+	 * sequential fix-up pass then stitches the chunks: between tokens
+	 * the lexer only carries its offset, so a chunk is taken over from
+	 * the first token it lexed from the offset the previous chunk ended
+	 * at. Where a string or comment straddles a boundary the offsets
+	 * disagree, and the fix-up re-lexes from the true offset until the
+	 * chunk's tokens line up again.
+	 *
+	 * Produces exactly the tokens a Lexer over the same source would.
+	 * The whole source is lexed on construction.
+	 */
+	class ParallelLexer final : public TokenSource {
+		/**
+		 * Token lexed speculatively.
+		 */
+		struct ChunkToken {
+			// offset the token was lexed from, past any whitespace
+			size_t offset;
+			std::unique_ptr<Token> token;
+		};
+
+		/**
+		 * Tokens lexed from one chunk.
+		 */
+		struct Chunk {
+			size_t start;
+			size_t end;
+			std::vector<ChunkToken> tokens;
+			// offset after the last token, at or past the end
+			size_t exit = 0;
+		};
+
+		const Source* source_;
+
+		std::vector<std::unique_ptr<Token>> tokens_;
+		size_t index_ = 0;
+
+		/**
+		 * Skips whitespace from an offset, lexing from either offset
+		 * gives the same tokens.
+		 */
+		[[nodiscard]] size_t skip_whitespace(size_t offset) const;
+
+		/**
+		 * Lexes a chunk speculatively.
+		 */
+		void lex_chunk(Chunk& chunk) const;
+
+		/**
+		 * Stitches the chunks into the token stream, re-lexing where
+		 * a chunk does not line up with its predecessor.
+		 */
+		void stitch(std::vector<Chunk>& chunks);
+	public:
+		/**
+		 * Constructor, lexes the source.
+		 *
+		 * @param source source object to lex.
+		 * @param threads workers, 0 picks one per core.
+		 * @param min_chunk_size smallest chunk worth a worker, in characters.
+		 */
+		explicit ParallelLexer(const Source* source, size_t threads = 0, size_t min_chunk_size = 1 << 16);
+
+		[[nodiscard]] TokenType peek() override;
+		[[maybe_unused]] std::unique_ptr<Token> next() override;
+	};
+}
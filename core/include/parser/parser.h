@@ -4,20 +4,61 @@
 #include "lexer.h"
 
 namespace seam {
+	/**
+	 * Nesting of blocks, types and expressions parsed before the parser
+	 * gives up with a ParserException. Deeper than any written program
+	 * needs, and shallow enough for parsing and the passes after it to
+	 * stay within a 256 KB stack.
+	 */
+	constexpr size_t default_max_parse_depth = 256;
+
 	class Parser {
-		std::unique_ptr<Lexer> lexer_;
-		size_t last_binding_power_ = 0;
+		std::unique_ptr<TokenSource> lexer_;
+
+		// nesting limit, and the nesting at the token being parsed
+		size_t max_depth_;
+		size_t depth_ = 0;
+
+		/**
+		 * Holds one level of nesting for as long as it lives.
+		 */
+		struct DepthGuard {
+			size_t& depth;
+
+			explicit DepthGuard(size_t& depth) : depth(++depth) {}
+			DepthGuard(const DepthGuard&) = delete;
+			~DepthGuard() { depth--; }
+		};
+
+		/**
+		 * Enters a level of nesting, raising a ParserException at the
+		 * next token once the limit is reached.
+		 */
+		[[nodiscard]] DepthGuard nest();
+
+		/**
+		 * Peeks the next token type, raising any lexical error
+		 * the lexer recorded in place of the token.
+		 */
+		[[nodiscard]] TokenType peek() const {
+			const auto type = lexer_->peek();
+			if (type == TokenType::Error) {
+				const auto token = lexer_->next();
+				throw LexicalException(token->position, format_diagnostic(token->error, token->lexeme));
+			}
+			return type;
+		}
 		
 		template <TokenType T>
 		void expect(const bool consume = true) const {
 
-			if (const TokenType type = lexer_->peek(); T != type) {
+			if (const TokenType type = peek(); T != type) {
 				const auto token = lexer_->next();
 
 				constexpr auto symb_name = token_type_to_name_cexpr<T>();
 				throw generate_exception<ParserException>(
                         token->position,
-                        L"expected {}, got {}",
+                        "expected {}, got {}",
                         symb_name,
                         token_type_to_name(type)
 					);
@@ -32,30 +73,34 @@ namespace seam {
 		[[nodiscard]] auto consume_token() const {
 			expect<TT>(false);
 
-			const auto token = lexer_->next();
-			if constexpr (std::is_same_v<T, std::wstring>) {
+			auto token = lexer_->next();
+			if constexpr (std::is_same_v<T, std::string>) {
 				return token->lexeme;
-			} else if constexpr (std::is_same_v<T, double>) {
-				return std::stod(token->lexeme);
-			}
-
-			if constexpr (std::is_same_v<T, int>) {
-				return 1; // TODO: parse numbers
+			} else if constexpr (std::is_same_v<T, Token>) {
+				return token;
+			} else if constexpr (std::is_same_v<T, DecodedNumber>) {
+				const auto decoded = decode_number_literal(token->lexeme);
+				if (decoded.error != DiagnosticCode::None) {
+					throw ParserException(token->position, format_diagnostic(decoded.error, token->lexeme));
+				}
+				return std::make_tuple(token->lexeme, decoded, token->position);
 			}
 		}
 
 		void discard() const { lexer_->next(); }
 
-		std::wstring try_parse_type();
+		std::string try_parse_type();
 		ast::ParameterList parse_parameter_list();
 
 		ast::expression::ExpressionList parse_arg_list();
 
 		std::unique_ptr<ast::expression::Expression> parse_primary_expression();
-		std::unique_ptr<ast::expression::Expression> parse_expression(std::unique_ptr<ast::expression::Expression> expr, size_t right_binding_power = 0);
-		std::unique_ptr<ast::expression::Expression> parse_expression();
+		std::unique_ptr<ast::expression::Expression> parse_operand(TokenType op, size_t min_binding_power);
+		std::unique_ptr<ast::expression::Expression> parse_expression(size_t min_binding_power = 0);
 
 		std::unique_ptr<ast::statement::WhileStatement> parse_while_statement();
+		std::unique_ptr<ast::statement::ReturnStatement> parse_return_statement();
+		std::unique_ptr<ast::statement::IfStatement> parse_if_branch();
 		std::unique_ptr<ast::statement::IfStatement> parse_if_statement();
 		std::unique_ptr<ast::statement::Statement> parse_statement();
 
@@ -65,10 +110,62 @@ namespace seam {
 		std::unique_ptr<ast::FunctionDeclaration> parse_function_declaration();
 		std::unique_ptr<ast::Declaration> parse_type_decl();
 
+		std::unique_ptr<ast::Declaration> parse_declaration();
 		ast::DeclarationList parse_declaration_list();
+
+		ast::Import parse_import();
+		ast::ImportList parse_import_list();
+
+		/**
+		 * Top-level declaration, as a half-open range of token indices.
+		 */
+		struct DeclarationRange {
+			size_t begin;
+			size_t end;
+		};
+
+		/**
+		 * Finds the top-level declarations by matching braces, each
+		 * starts at an fn or type keyword outside of any braces.
+		 */
+		static std::vector<DeclarationRange> split_declarations(const std::vector<std::unique_ptr<Token>>& tokens);
 	public:
-		Parser(std::unique_ptr<Lexer> lexer);
+		/**
+		 * Constructor.
+		 *
+		 * @param lexer tokens to parse.
+		 * @param max_depth nesting parsed before giving up.
+		 */
+		Parser(std::unique_ptr<TokenSource> lexer, size_t max_depth = default_max_parse_depth);
 
 		std::unique_ptr<ast::Program> parse();
+
+		/**
+		 * Parses one top-level declaration out of a stream split by
+		 * declaration, raising what parse() would raise on the tokens
+		 * up to the next declaration.
+		 *
+		 * @returns the declaration.
+		 */
+		std::unique_ptr<ast::Declaration> parse_top_level_declaration();
+
+		/**
+		 * Parses one import out of a stream split by declaration, like
+		 * parse_top_level_declaration().
+		 *
+		 * @returns the import.
+		 */
+		ast::Import parse_top_level_import();
+
+		/**
+		 * Parses the top-level declarations concurrently.
+		 *
+		 * Lexes the whole input first, then splits it into declarations
+		 * with a brace-matching pre-scan and parses each on a worker.
+		 * The program and the first error raised match parse().
+		 *
+		 * @param threads worker threads, 0 picks one per core.
+		 */
+		std::unique_ptr<ast::Program> parse_parallel(size_t threads = 0);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace seam {
+	/**
+	 * Bounded Single-Producer/Single-Consumer Ring Buffer.
+	 *
+	 * Lock-free: the producer only writes the tail and the consumer
+	 * only writes the head, each publishing its slots with release
+	 * stores. Exactly one thread may push and one thread may pop.
+	 * Either side can block until the other makes progress, waiting
+	 * on the index the other side moves.
+	 *
+	 * @tparam T element type, moved in and out.
+	 * @tparam Capacity number of slots, a power of two.
+	 */
+	template<typename T, size_t Capacity>
+	class SpscRingBuffer {
+		static_assert(Capacity && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+		// head and tail on separate cache lines, so the threads do not contend
+		alignas(64) std::atomic<size_t> head_ = 0;
+		alignas(64) std::atomic<size_t> tail_ = 0;
+		alignas(64) std::array<T, Capacity> slots_;
+	public:
+		/**
+		 * Pushes an element, called from the producer only.
+		 *
+		 * @returns false, leaving the value untouched, if the buffer is full.
+		 */
+		bool try_push(T& value) {
+			const auto tail = tail_.load(std::memory_order_relaxed);
+			if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+				return false;
+			}
+
+			slots_[tail & (Capacity - 1)] = std::move(value);
+			tail_.store(tail + 1, std::memory_order_release);
+			tail_.notify_one();
+			return true;
+		}
+
+		/**
+		 * Pops an element, called from the consumer only.
+		 *
+		 * @returns the element, or nothing if the buffer is empty.
+		 */
+		std::optional<T> try_pop() {
+			const auto head = head_.load(std::memory_order_relaxed);
+			if (head == tail_.load(std::memory_order_acquire)) {
+				return std::nullopt;
+			}
+
+			auto value = std::move(slots_[head & (Capacity - 1)]);
+			head_.store(head + 1, std::memory_order_release);
+			head_.notify_one();
+			return value;
+		}
+
+		/**
+		 * Blocks until the buffer has a free slot, called from the producer only.
+		 */
+		void wait_for_space() const {
+			const auto tail = tail_.load(std::memory_order_relaxed);
+			head_.wait(tail - Capacity, std::memory_order_acquire);
+		}
+
+		/**
+		 * Blocks until the buffer has an element, called from the consumer only.
+		 */
+		void wait_for_element() const {
+			const auto head = head_.load(std::memory_order_relaxed);
+			tail_.wait(head, std::memory_order_acquire);
+		}
+	};
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "lexer.h"
+#include "ring_buffer.h"
+
+namespace seam {
+	/**
+	 * Pipelined Lexer.
+	 *
+	 * Lexes on a producer thread and hands tokens to the parser in
+	 * batches through a bounded SPSC ring buffer, so lexing overlaps
+	 * parsing on large sources. Produces exactly the tokens a Lexer
+	 * over the same source would.
+	 *
+	 * The source must outlive the lexer. Destroying it before the
+	 * input is exhausted stops the producer early.
+	 */
+	class StreamingLexer final : public TokenSource {
+		using Batch = std::vector<std::unique_ptr<Token>>;
+
+		// batches in flight, bounds the memory held ahead of the parser
+		static constexpr size_t queue_capacity = 64;
+
+		SpscRingBuffer<Batch, queue_capacity> queue_;
+		std::atomic<bool> stop_ = false;
+		// set by the producer before it pushes its final batch
+		std::exception_ptr error_;
+
+		// batch being consumed and the next token in it
+		Batch batch_;
+		size_t index_ = 0;
+		// the end of input the producer delivered, repeated from then on
+		std::unique_ptr<Token> end_;
+
+		std::thread producer_;
+
+		/**
+		 * Lexes the source until the end of input or until stopped.
+		 */
+		void produce(const Source* source, size_t batch_size);
+
+		/**
+		 * Makes the next token available, waiting for the producer.
+		 */
+		void fill();
+	public:
+		/**
+		 * Constructor, starts the producer thread.
+		 *
+		 * @param source source object to lex.
+		 * @param batch_size tokens handed over at a time.
+		 */
+		explicit StreamingLexer(const Source* source, size_t batch_size = 256);
+		~StreamingLexer() override;
+
+		StreamingLexer(const StreamingLexer&) = delete;
+		StreamingLexer& operator=(const StreamingLexer&) = delete;
+
+		[[nodiscard]] TokenType peek() override;
+		[[maybe_unused]] std::unique_ptr<Token> next() override;
+	};
+}
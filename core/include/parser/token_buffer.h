@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+#include "token_source.h"
+
+namespace seam {
+	/**
+	 * Token Buffer.
+	 *
+	 * Replays tokens lexed ahead of time.
+	 */
+	class TokenBuffer final : public TokenSource {
+		std::vector<std::unique_ptr<Token>> tokens_;
+		size_t index_ = 0;
+	public:
+		/**
+		 * Constructor.
+		 *
+		 * @param tokens tokens to replay, followed by the end of input.
+		 */
+		explicit TokenBuffer(std::vector<std::unique_ptr<Token>> tokens)
+			: tokens_(std::move(tokens)) {}
+
+		[[nodiscard]] TokenType peek() override {
+			return index_ < tokens_.size() ? tokens_[index_]->type : TokenType::None;
+		}
+
+		[[maybe_unused]] std::unique_ptr<Token> next() override {
+			if (index_ < tokens_.size()) {
+				return std::move(tokens_[index_++]);
+			}
+			return std::make_unique<Token>(TokenType::None, "", SourcePosition { 0, 0 });
+		}
+	};
+}
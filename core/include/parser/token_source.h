@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+
+#include "tokens.h"
+
+namespace seam {
+	/**
+	 * Token Source.
+	 *
+	 * The stream of tokens the parser consumes. Once the input is
+	 * exhausted every further token is TokenType::None.
+	 */
+	class TokenSource {
+	public:
+		virtual ~TokenSource() = default;
+
+		/**
+		 * Peeks next token.
+		 *
+		 * @returns peeked token.
+		 */
+		[[nodiscard]] virtual TokenType peek() = 0;
+
+		/**
+		 * Returns next token.
+		 *
+		 * @returns next token.
+		 */
+		[[maybe_unused]] virtual std::unique_ptr<Token> next() = 0;
+	};
+}
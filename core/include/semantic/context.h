@@ -0,0 +1,48 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "diagnostic.h"
+#include "semantic/interner.h"
+#include "type/type_table.h"
+
+namespace seam::semantic {
+	/**
+	 * Semantic Analysis Context.
+	 *
+	 * Owns everything the semantic passes produce for a program: interned
+	 * names, types, declared symbols and diagnostics. AST nodes point into it, so it
+	 * must outlive the analysed program's use.
+	 */
+	class Context {
+		Interner interner_;
+		type::TypeTable types_;
+
+		// deque keeps symbol addresses stable
+		std::deque<symbol::Symbol> symbols_;
+
+		std::vector<Diagnostic> diagnostics_;
+	public:
+		[[nodiscard]] Interner& interner() { return interner_; }
+		[[nodiscard]] const Interner& interner() const { return interner_; }
+
+		[[nodiscard]] type::TypeTable& types() { return types_; }
+		[[nodiscard]] const type::TypeTable& types() const { return types_; }
+
+		symbol::Symbol* create_symbol(const symbol::SymbolType type, const symbol::SymbolId name, const SourcePosition position) {
+			return &symbols_.emplace_back(symbol::Symbol { type, name, position });
+		}
+
+		void report(const DiagnosticCode code, const SourcePosition position, std::string argument = "", std::string second_argument = "") {
+			diagnostics_.push_back(Diagnostic { code, position, std::move(argument), std::move(second_argument) });
+		}
+
+		void report(Diagnostic diagnostic) {
+			diagnostics_.push_back(std::move(diagnostic));
+		}
+
+		[[nodiscard]] const std::vector<Diagnostic>& diagnostics() const { return diagnostics_; }
+		[[nodiscard]] bool has_errors() const { return !diagnostics_.empty(); }
+	};
+}
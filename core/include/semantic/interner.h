@@ -0,0 +1,44 @@
+#pragma once
+
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "symbol.h"
+
+namespace seam::semantic {
+	/**
+	 * String Interner.
+	 *
+	 * Maps each distinct name to a dense symbol id so later phases
+	 * compare and hash names as integers.
+	 */
+	class Interner {
+		// stable storage for interned names, views below point into it
+		std::deque<std::string> names_;
+		std::unordered_map<std::string_view, symbol::SymbolId> ids_;
+	public:
+		/**
+		 * Interns a name.
+		 *
+		 * @param name name to intern.
+		 *
+		 * @returns id of the name, the same id for equal names.
+		 */
+		symbol::SymbolId intern(std::string_view name);
+
+		/**
+		 * Finds a name without interning it.
+		 *
+		 * @param name name to look up.
+		 *
+		 * @returns id of the name if it has been interned.
+		 */
+		[[nodiscard]] std::optional<symbol::SymbolId> find(std::string_view name) const;
+
+		[[nodiscard]] std::string_view name(const symbol::SymbolId id) const { return names_[id]; }
+		[[nodiscard]] size_t size() const { return names_.size(); }
+	};
+}
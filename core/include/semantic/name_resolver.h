@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ast/recursive_visitor.h"
+#include "semantic/context.h"
+#include "semantic/symbol_table.h"
+
+namespace seam::semantic {
+	/**
+	 * Name Resolution Pass.
+	 *
+	 * Binds every identifier to the symbol it refers to and reports
+	 * undeclared, redeclared and non-callable names.
+	 */
+	class NameResolver final : public ast::RecursiveVisitor<NameResolver> {
+		Context& context_;
+		ScopedSymbolTable table_;
+		// callee of the call being entered, it is the call's first child
+		const ast::expression::Identifier* callee_ = nullptr;
+		// body of the function being resolved, which opens no scope of its own
+		const ast::statement::StatementBlock* body_ = nullptr;
+
+		symbol::Symbol* declare(symbol::SymbolType type, const std::string& name, SourcePosition position);
+		void declare_members(const ast::DeclarationList& decls);
+	public:
+		explicit NameResolver(Context& context);
+
+		void enter(ast::Program& program);
+		void enter(ast::FunctionDeclaration& func);
+		void leave(ast::FunctionDeclaration& func);
+		void enter(ast::TypeDeclaration& decl);
+		void leave(ast::TypeDeclaration& decl);
+		void leave(ast::statement::LetStatement& stat);
+		void enter(ast::statement::StatementBlock& block);
+		void leave(ast::statement::StatementBlock& block);
+		void enter(ast::expression::Identifier& expr);
+		void enter(ast::expression::FunctionCall& expr);
+	};
+}
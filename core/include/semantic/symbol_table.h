@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "symbol.h"
+
+namespace seam::semantic {
+	/**
+	 * Scoped Symbol Table.
+	 *
+	 * A single flat open-addressing table maps symbol ids to their innermost
+	 * binding. Entering a scope only records the undo log length, declaring
+	 * logs the binding it shadows, and leaving a scope replays the log back
+	 * to the recorded length. No per scope allocation happens.
+	 */
+	class ScopedSymbolTable {
+		static constexpr symbol::SymbolId empty_slot = UINT32_MAX;
+
+		struct Slot {
+			symbol::SymbolId name = empty_slot;
+			symbol::Symbol* symbol = nullptr;
+			// scope depth the binding was declared at
+			uint32_t depth = 0;
+		};
+
+		struct UndoEntry {
+			symbol::SymbolId name;
+			symbol::Symbol* previous_symbol;
+			uint32_t previous_depth;
+		};
+
+		// power of two sized, names are never removed (unbound names keep a null symbol)
+		std::vector<Slot> slots_;
+		size_t used_slots_ = 0;
+
+		std::vector<UndoEntry> undo_log_;
+		std::vector<size_t> scope_marks_;
+
+		[[nodiscard]] size_t find_slot(symbol::SymbolId name) const;
+		void grow();
+	public:
+		ScopedSymbolTable();
+
+		void push_scope();
+		void pop_scope();
+
+		/**
+		 * Binds a name in the current scope.
+		 *
+		 * @param name interned name.
+		 * @param symbol symbol to bind.
+		 *
+		 * @returns symbol already bound to the name in the current scope,
+		 * in which case nothing is bound, otherwise nullptr.
+		 */
+		symbol::Symbol* declare(symbol::SymbolId name, symbol::Symbol* symbol);
+
+		/**
+		 * Finds the innermost binding of a name.
+		 *
+		 * @param name interned name.
+		 *
+		 * @returns bound symbol or nullptr.
+		 */
+		[[nodiscard]] symbol::Symbol* lookup(symbol::SymbolId name) const;
+
+		[[nodiscard]] uint32_t depth() const { return static_cast<uint32_t>(scope_marks_.size()); }
+	};
+}
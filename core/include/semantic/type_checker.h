@@ -0,0 +1,176 @@
+#pragma once
+
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "ast/ast.h"
+#include "semantic/context.h"
+
+namespace seam::semantic {
+	class BodyChecker;
+
+	/**
+	 * Type Checking Pass.
+	 *
+	 * Runs after name resolution in two steps. Type declarations, aliases
+	 * and function signatures are collected sequentially; function bodies
+	 * are then independent of each other and are checked on worker threads,
+	 * each with its own diagnostics, merged back in declaration order so
+	 * the output does not depend on scheduling.
+	 */
+	class TypeChecker final : public ast::AstVisitor {
+		friend class BodyChecker;
+
+		struct TypeBinding {
+			// TypeDeclaration or TypeAliasDeclaration naming the type
+			const ast::Declaration* decl;
+			// scope the declaration lives in
+			size_t scope;
+			type::TypeId type = type::unresolved_type;
+			bool resolving = false;
+		};
+
+		struct TypeScope {
+			// enclosing scope, the root scope is its own parent
+			size_t parent;
+			std::unordered_map<symbol::SymbolId, TypeBinding> bindings;
+		};
+
+		struct FunctionBody {
+			ast::FunctionDeclaration* func;
+			// scope the function is declared in
+			size_t scope;
+			type::TypeId return_type;
+		};
+
+		Context& context_;
+		type::TypeTable& types_;
+		size_t threads_;
+
+		// declaration scopes, read-only once collection is done
+		std::deque<TypeScope> scopes_;
+		size_t scope_ = 0;
+
+		// bodies left to check once every signature is known
+		std::vector<FunctionBody> bodies_;
+
+		void collect_declarations(const ast::DeclarationList& decls);
+		void declare_signature(ast::FunctionDeclaration& func);
+		void check_bodies();
+
+		/**
+		 * Finds the binding a type name refers to as seen from a scope.
+		 */
+		[[nodiscard]] const TypeBinding* find_binding(symbol::SymbolId name, size_t scope) const;
+		TypeBinding* find_binding(symbol::SymbolId name, size_t scope);
+
+		/**
+		 * Resolves a type name during collection, resolving aliases on first
+		 * use and reporting unknown names and alias cycles.
+		 *
+		 * @param name type name, empty for none.
+		 * @param position position to report errors at.
+		 * @param scope scope the name is looked up from.
+		 *
+		 * @returns resolved type, the error type if it cannot be resolved.
+		 */
+		type::TypeId resolve_type(const std::string& name, SourcePosition position, size_t scope);
+		type::TypeId resolve_binding(TypeBinding& binding);
+
+		/**
+		 * Looks up a type name once collection is done, without modifying
+		 * any shared state.
+		 *
+		 * @returns resolved type, unresolved_type if the name is unknown.
+		 */
+		[[nodiscard]] type::TypeId lookup_type(const std::string& name, size_t scope) const;
+	public:
+		/**
+		 * @param context semantic context of the program.
+		 * @param threads worker threads for body checking, 0 picks one per core.
+		 */
+		explicit TypeChecker(Context& context, size_t threads = 0);
+
+		void visit(ast::Program& program) override;
+		void visit(ast::FunctionDeclaration& func) override;
+		void visit(ast::TypeDeclaration& decl) override;
+		void visit(ast::TypeAliasDeclaration& decl) override;
+		void visit(ast::statement::LetStatement& stat) override {}
+		void visit(ast::statement::StatementBlock& block) override {}
+		void visit(ast::statement::IfStatement& stat) override {}
+		void visit(ast::statement::WhileStatement& stat) override {}
+		void visit(ast::statement::ReturnStatement& stat) override {}
+		void visit(ast::expression::StringLiteral& expr) override {}
+		void visit(ast::expression::NumberLiteral& expr) override {}
+		void visit(ast::expression::BooleanLiteral& expr) override {}
+		void visit(ast::expression::UnaryExpression& expr) override {}
+		void visit(ast::expression::BinaryExpression& expr) override {}
+		void visit(ast::expression::PostfixExpression& expr) override {}
+		void visit(ast::expression::Identifier& expr) override {}
+		void visit(ast::expression::FunctionCall& expr) override {}
+	};
+
+	/**
+	 * Function Body Checker.
+	 *
+	 * Checks the statements of a single function against the collected
+	 * signatures. Only reads shared state, so bodies may be checked
+	 * concurrently, and records diagnostics locally.
+	 */
+	class BodyChecker final : public ast::AstVisitor {
+		const TypeChecker& checker_;
+		const type::TypeTable& types_;
+		size_t scope_;
+
+		std::vector<Diagnostic> diagnostics_;
+
+		// declared result of the function being checked
+		type::TypeId return_type_;
+
+		// type the enclosing context expects of the expression being checked
+		type::TypeId expected_ = type::unresolved_type;
+
+		/**
+		 * Checks an expression.
+		 *
+		 * @param expr expression to check.
+		 * @param expected type the context expects, used to type literals.
+		 *
+		 * @returns type of the expression.
+		 */
+		type::TypeId check(ast::expression::Expression& expr, type::TypeId expected = type::unresolved_type);
+
+		/**
+		 * Reports a mismatch unless the types agree or either is the error type.
+		 */
+		void expect_type(type::TypeId expected, type::TypeId actual, SourcePosition position);
+		void report_operands(TokenType op, type::TypeId operand, SourcePosition position);
+		void report(DiagnosticCode code, SourcePosition position, std::string argument = "", std::string second_argument = "");
+		[[nodiscard]] std::string type_name(type::TypeId type) const;
+
+		[[nodiscard]] static bool is_error(const type::TypeId type) { return type == type::TypeTable::error_type; }
+	public:
+		BodyChecker(const TypeChecker& checker, size_t scope, type::TypeId return_type);
+
+		[[nodiscard]] std::vector<Diagnostic>& diagnostics() { return diagnostics_; }
+
+		void visit(ast::Program& program) override {}
+		void visit(ast::FunctionDeclaration& func) override;
+		void visit(ast::TypeDeclaration& decl) override {}
+		void visit(ast::TypeAliasDeclaration& decl) override {}
+		void visit(ast::statement::LetStatement& stat) override;
+		void visit(ast::statement::StatementBlock& block) override;
+		void visit(ast::statement::IfStatement& stat) override;
+		void visit(ast::statement::WhileStatement& stat) override;
+		void visit(ast::statement::ReturnStatement& stat) override;
+		void visit(ast::expression::StringLiteral& expr) override;
+		void visit(ast::expression::NumberLiteral& expr) override;
+		void visit(ast::expression::BooleanLiteral& expr) override;
+		void visit(ast::expression::UnaryExpression& expr) override;
+		void visit(ast::expression::BinaryExpression& expr) override;
+		void visit(ast::expression::PostfixExpression& expr) override;
+		void visit(ast::expression::Identifier& expr) override;
+		void visit(ast::expression::FunctionCall& expr) override;
+	};
+}
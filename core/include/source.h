@@ -1,15 +1,27 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace seam {
-	// contains source
+	// true for the bytes that continue a UTF-8 sequence, rather than start a character
+	[[nodiscard]] constexpr bool is_utf8_continuation(const char byte) {
+		return (static_cast<unsigned char>(byte) & 0xc0) == 0x80;
+	}
+
+	// checks UTF-8 is well formed, without overlong forms, surrogates or code points past U+10FFFF
+	[[nodiscard]] bool is_valid_utf8(std::string_view text);
+
+	// contains source, as UTF-8
 	class Source {
-		std::wstring string_src_;
+		std::string string_src_;
 	public:
-		explicit Source(std::wstring source);
+		explicit Source(std::string source);
 		
-		[[nodiscard]] const std::wstring& get() const { return string_src_; }
+		[[nodiscard]] const std::string& get() const { return string_src_; }
+
+		// replaces a range of the source, readers must not be in use
+		void replace(size_t start, size_t length, const std::string& text);
 
 		friend class SourceReader;
 	};
@@ -20,20 +32,18 @@ namespace seam {
 		size_t start_pointer_ = 0;
 		size_t read_pointer_ = 0;
 
-		std::wstring buffer_;
-		
 		const Source* source_;
 	public:
-		explicit SourceReader(const Source* source);
+		explicit SourceReader(const Source* source, size_t start = 0);
 
 		[[nodiscard]] size_t length() const { return source_->string_src_.length(); }
 
-		// character read methods
-		[[nodiscard]] wchar_t get_char(size_t pos) const;
-		[[nodiscard]] wchar_t peek_char(size_t num_chars_ahead = 0) const;
-		[[nodiscard]] wchar_t next_char();
+		// character read methods, bytes as unsigned char values and EOF past the end
+		[[nodiscard]] int get_char(size_t pos) const;
+		[[nodiscard]] int peek_char(size_t num_chars_ahead = 0) const;
+		[[nodiscard]] int next_char();
 
-		[[nodiscard]] std::wstring consume();
+		[[nodiscard]] std::string consume();
 		
 		void discard();
 		void discard(size_t num_characters);
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstddef>
+
 namespace seam {
 	struct SourcePosition {
-		const size_t start_idx;
-		const size_t end_idx;
+		size_t start_idx;
+		size_t end_idx;
 	};
 }
\ No newline at end of file
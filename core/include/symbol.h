@@ -1,7 +1,30 @@
-#pramga once
+#pragma once
+
+#include <cstdint>
+
+#include "source_position.h"
+#include "type/type.h"
 
 namespace seam::symbol {
+    // interned name, see semantic::Interner
+    using SymbolId = uint32_t;
+
     enum class SymbolType {
-        Type
-    }
-}
\ No newline at end of file
+        Type,
+        Function,
+        Parameter,
+        Variable,
+    };
+
+    /**
+     * Declared Symbol.
+     */
+    struct Symbol {
+        SymbolType type;
+        SymbolId name;
+        // declaration position
+        SourcePosition position;
+        // declared or inferred type, set by the type checker
+        type::TypeId type_id = type::unresolved_type;
+    };
+}
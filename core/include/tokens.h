@@ -1,5 +1,8 @@
 	#pragma once
 
+#include <string>
+
+#include "diagnostic.h"
 #include "source_position.h"
 
 namespace seam {
@@ -8,6 +11,7 @@ namespace seam {
 	 */
 	enum class TokenType {
 		None,
+		Error,
 		Identifier,
 		StringLiteral,
 		NumberLiteral,
@@ -32,6 +36,7 @@ namespace seam {
 		OpenBrace, // {
 		CloseBrace, // }
 		Comma, // ,
+		Dot, // .
 		
 
 		KeywordLet,
@@ -45,87 +50,97 @@ namespace seam {
 		KeywordIf,
 		KeywordElse,
 		KeywordElseIf,
+		KeywordReturn,
 	};
 
+	// number of token types, keep in sync with the last enumerator
+	constexpr size_t token_type_count = static_cast<size_t>(TokenType::KeywordReturn) + 1;
+
 
 	static auto token_type_to_name(const TokenType type) {
 		switch (type) {
-		case TokenType::None: return L"<none>";
-		case TokenType::Identifier: return L"<identifier>";
-		case TokenType::StringLiteral: return L"<string_literal>";
-		case TokenType::NumberLiteral: return L"<number_literal>";
-		case TokenType::OpAdd: return L"+";
-		case TokenType::OpAddEq: return L"+=";
-		case TokenType::OpIncrement: return L"++";
-		case TokenType::OpSub: return L"-";
-		case TokenType::OpSubEq: return L"-=";
-		case TokenType::OpDecrement: return L"--";
-		case TokenType::OpDiv: return L"/";
-		case TokenType::OpMul: return L"*";
-		case TokenType::OpAssign: return L"=";
-		case TokenType::OpEq: return L"==";
-		case TokenType::OpBitwiseAnd: return L"&";
-		case TokenType::OpLogicalAnd: return L"&&";
-		case TokenType::Arrow: return L"->";
-		case TokenType::Colon: return L":";
-		case TokenType::ColonEquals: return L":=";
-		case TokenType::OpenParen: return L"(";
-		case TokenType::CloseParen: return L")";
-		case TokenType::OpenBrace: return L"{";
-		case TokenType::CloseBrace: return L"}";
-		case TokenType::Comma: return L",";
-		case TokenType::KeywordLet: return L"let";
-		case TokenType::KeywordFn: return L"fn";
-		case TokenType::KeywordType: return L"type";
-		case TokenType::KeywordWhile: return L"while";
-		case TokenType::KeywordFor: return L"for";
-		case TokenType::KeywordTrue: return L"true";
-		case TokenType::KeywordFalse: return L"false";
-		case TokenType::KeywordImport: return L"import";
-		case TokenType::KeywordIf: return L"if";
-		case TokenType::KeywordElse: return L"else";
-		case TokenType::KeywordElseIf: return L"elseif";
+		case TokenType::None: return "<none>";
+		case TokenType::Error: return "<error>";
+		case TokenType::Identifier: return "<identifier>";
+		case TokenType::StringLiteral: return "<string_literal>";
+		case TokenType::NumberLiteral: return "<number_literal>";
+		case TokenType::OpAdd: return "+";
+		case TokenType::OpAddEq: return "+=";
+		case TokenType::OpIncrement: return "++";
+		case TokenType::OpSub: return "-";
+		case TokenType::OpSubEq: return "-=";
+		case TokenType::OpDecrement: return "--";
+		case TokenType::OpDiv: return "/";
+		case TokenType::OpMul: return "*";
+		case TokenType::OpAssign: return "=";
+		case TokenType::OpEq: return "==";
+		case TokenType::OpBitwiseAnd: return "&";
+		case TokenType::OpLogicalAnd: return "&&";
+		case TokenType::Arrow: return "->";
+		case TokenType::Colon: return ":";
+		case TokenType::ColonEquals: return ":=";
+		case TokenType::OpenParen: return "(";
+		case TokenType::CloseParen: return ")";
+		case TokenType::OpenBrace: return "{";
+		case TokenType::CloseBrace: return "}";
+		case TokenType::Comma: return ",";
+		case TokenType::Dot: return ".";
+		case TokenType::KeywordLet: return "let";
+		case TokenType::KeywordFn: return "fn";
+		case TokenType::KeywordType: return "type";
+		case TokenType::KeywordWhile: return "while";
+		case TokenType::KeywordFor: return "for";
+		case TokenType::KeywordTrue: return "true";
+		case TokenType::KeywordFalse: return "false";
+		case TokenType::KeywordImport: return "import";
+		case TokenType::KeywordIf: return "if";
+		case TokenType::KeywordElse: return "else";
+		case TokenType::KeywordElseIf: return "elseif";
+		case TokenType::KeywordReturn: return "return";
 		}
 	}
 
 	template<const TokenType T>
 	constexpr auto token_type_to_name_cexpr() {
 		switch (T) {
-		case TokenType::None: return L"<none>";
-		case TokenType::Identifier: return L"<identifier>";
-		case TokenType::StringLiteral: return L"<string_literal>";
-		case TokenType::NumberLiteral: return L"<number_literal>";
-		case TokenType::OpAdd: return L"+";
-		case TokenType::OpAddEq: return L"+=";
-		case TokenType::OpIncrement: return L"++";
-		case TokenType::OpSub: return L"-";
-		case TokenType::OpSubEq: return L"-=";
-		case TokenType::OpDecrement: return L"--";
-		case TokenType::OpDiv: return L"/";
-		case TokenType::OpMul: return L"*";
-		case TokenType::OpAssign: return L"=";
-		case TokenType::OpEq: return L"==";
-		case TokenType::OpBitwiseAnd: return L"&";
-		case TokenType::OpLogicalAnd: return L"&&";
-		case TokenType::Arrow: return L"->";
-		case TokenType::Colon: return L":";
-		case TokenType::ColonEquals: return L":=";
-		case TokenType::OpenParen: return L"(";
-		case TokenType::CloseParen: return L")";
-		case TokenType::OpenBrace: return L"{";
-		case TokenType::CloseBrace: return L"}";
-		case TokenType::Comma: return L",";
-		case TokenType::KeywordLet: return L"let";
-		case TokenType::KeywordFn: return L"fn";
-		case TokenType::KeywordType: return L"type";
-		case TokenType::KeywordWhile: return L"while";
-		case TokenType::KeywordFor: return L"for";
-		case TokenType::KeywordTrue: return L"true";
-		case TokenType::KeywordFalse: return L"false";
-		case TokenType::KeywordImport: return L"import";
-		case TokenType::KeywordIf: return L"if";
-		case TokenType::KeywordElse: return L"else";
-		case TokenType::KeywordElseIf: return L"elseif";
+		case TokenType::None: return "<none>";
+		case TokenType::Error: return "<error>";
+		case TokenType::Identifier: return "<identifier>";
+		case TokenType::StringLiteral: return "<string_literal>";
+		case TokenType::NumberLiteral: return "<number_literal>";
+		case TokenType::OpAdd: return "+";
+		case TokenType::OpAddEq: return "+=";
+		case TokenType::OpIncrement: return "++";
+		case TokenType::OpSub: return "-";
+		case TokenType::OpSubEq: return "-=";
+		case TokenType::OpDecrement: return "--";
+		case TokenType::OpDiv: return "/";
+		case TokenType::OpMul: return "*";
+		case TokenType::OpAssign: return "=";
+		case TokenType::OpEq: return "==";
+		case TokenType::OpBitwiseAnd: return "&";
+		case TokenType::OpLogicalAnd: return "&&";
+		case TokenType::Arrow: return "->";
+		case TokenType::Colon: return ":";
+		case TokenType::ColonEquals: return ":=";
+		case TokenType::OpenParen: return "(";
+		case TokenType::CloseParen: return ")";
+		case TokenType::OpenBrace: return "{";
+		case TokenType::CloseBrace: return "}";
+		case TokenType::Comma: return ",";
+		case TokenType::Dot: return ".";
+		case TokenType::KeywordLet: return "let";
+		case TokenType::KeywordFn: return "fn";
+		case TokenType::KeywordType: return "type";
+		case TokenType::KeywordWhile: return "while";
+		case TokenType::KeywordFor: return "for";
+		case TokenType::KeywordTrue: return "true";
+		case TokenType::KeywordFalse: return "false";
+		case TokenType::KeywordImport: return "import";
+		case TokenType::KeywordIf: return "if";
+		case TokenType::KeywordElse: return "else";
+		case TokenType::KeywordElseIf: return "elseif";
+		case TokenType::KeywordReturn: return "return";
 		}
 	}
 
@@ -139,11 +154,20 @@ namespace seam {
         // token type
         const TokenType type;
         // token lexeme
-        const std::wstring lexeme;
+        const std::string lexeme;
         // token position
         const SourcePosition position;
+        // error code, only set on TokenType::Error tokens
+        const DiagnosticCode error = DiagnosticCode::None;
 
-        Token(const TokenType type, std::wstring lexeme, const SourcePosition position)
+        Token(const TokenType type, std::string lexeme, const SourcePosition position)
                 : type(type), lexeme(std::move(lexeme)), position(position) {}
+
+        /**
+         * Constructs an error token. The lexeme holds the diagnostic argument,
+         * the message is only formatted once it is rendered.
+         */
+        Token(const DiagnosticCode error, std::string argument, const SourcePosition position)
+                : type(TokenType::Error), lexeme(std::move(argument)), position(position), error(error) {}
     };
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 namespace seam::type {
     enum class BuiltIn {
         None, // No assigned type
@@ -16,6 +18,11 @@ namespace seam::type {
         u64, // 8 byte (64 bit) unsigned integer
         f32, // 4 byte (32 bit) float
         f64, // 8 byte (64 bit) float
+    };
+
+    // index into a TypeTable, builtin types share the value of their BuiltIn
+    using TypeId = uint32_t;
 
-    }
-}
\ No newline at end of file
+    // type of a node the type checker has not reached
+    constexpr TypeId unresolved_type = UINT32_MAX;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "symbol.h"
+#include "type/type.h"
+
+namespace seam::semantic {
+	class Interner;
+}
+
+namespace seam::type {
+	enum class TypeKind : uint8_t {
+		BuiltIn,
+		Error, // type of an ill-typed expression, never reported twice
+		Function,
+		Record,
+	};
+
+	/**
+	 * Type Representation.
+	 */
+	struct Type {
+		TypeKind kind;
+		BuiltIn builtin = BuiltIn::None;
+		// record name
+		symbol::SymbolId name = 0;
+		// function result
+		TypeId result = 0;
+		// function parameter types
+		std::vector<TypeId> elements;
+	};
+
+	/**
+	 * Hash-consed Type Table.
+	 *
+	 * Every distinct type is stored once, so two types are equal exactly
+	 * when their ids are equal. Builtin types occupy the ids matching their
+	 * BuiltIn value.
+	 */
+	class TypeTable {
+		struct KeyHash {
+			size_t operator()(const std::vector<uint32_t>& key) const;
+		};
+
+		std::vector<Type> types_;
+		std::unordered_map<std::vector<uint32_t>, TypeId, KeyHash> interned_;
+
+		TypeId intern(std::vector<uint32_t> key, Type type);
+	public:
+		static constexpr TypeId error_type = static_cast<TypeId>(BuiltIn::f64) + 1;
+
+		TypeTable();
+
+		[[nodiscard]] static constexpr TypeId builtin(const BuiltIn type) { return static_cast<TypeId>(type); }
+
+		/**
+		 * Returns the builtin type spelled by a name, e.g. "i64".
+		 */
+		[[nodiscard]] static std::optional<BuiltIn> builtin_from_name(std::string_view name);
+
+		/**
+		 * Returns the function type with the given signature.
+		 */
+		TypeId function(const std::vector<TypeId>& params, TypeId result);
+
+		/**
+		 * Creates the record type of a type declaration. Records are
+		 * nominal, so every call is a new type, even under a name seen
+		 * before, and callers keep the id of each declaration.
+		 */
+		TypeId record(symbol::SymbolId name);
+
+		[[nodiscard]] const Type& get(const TypeId id) const { return types_[id]; }
+		[[nodiscard]] size_t size() const { return types_.size(); }
+
+		[[nodiscard]] bool is_integer(TypeId id) const;
+		[[nodiscard]] bool is_float(TypeId id) const;
+		[[nodiscard]] bool is_numeric(const TypeId id) const { return is_integer(id) || is_float(id); }
+
+		/**
+		 * Renders a type for diagnostics.
+		 */
+		[[nodiscard]] std::string name(TypeId id, const semantic::Interner& interner) const;
+	};
+}
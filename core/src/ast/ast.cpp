@@ -1,5 +1,27 @@
 #include <ast/ast.h>
 #include <ast/print_visitor.h>
 
-namespace seam::ast {
-}
\ No newline at end of file
+namespace seam::ast::detail {
+	namespace {
+		thread_local std::vector<std::unique_ptr<Node<AstVisitor>>> pending;
+		thread_local bool draining = false;
+	}
+
+	void defer_teardown(std::unique_ptr<Node<AstVisitor>> node) {
+		pending.push_back(std::move(node));
+	}
+
+	void finish_teardown() {
+		// nodes destroyed here finish a teardown of their own, only the outermost drains
+		if (draining) {
+			return;
+		}
+
+		draining = true;
+		while (!pending.empty()) {
+			const auto node = std::move(pending.back());
+			pending.pop_back();
+		}
+		draining = false;
+	}
+}
@@ -0,0 +1,320 @@
+#include <ast/ast.h>
+#include <ast/c_emit_visitor.h>
+#include <fmt/format.h>
+
+namespace seam::ast {
+	namespace {
+		struct CType {
+			type::BuiltIn builtin;
+			const char* name;
+			// suffix of the division helper, null for non-integers
+			const char* division;
+			bool is_signed;
+		};
+
+		constexpr CType c_types[] = {
+			{ type::BuiltIn::None, "void", nullptr, false },
+			{ type::BuiltIn::Bool, "bool", nullptr, false },
+			{ type::BuiltIn::Char, "char", nullptr, false },
+			{ type::BuiltIn::i8, "int8_t", "i8", true },
+			{ type::BuiltIn::i16, "int16_t", "i16", true },
+			{ type::BuiltIn::i32, "int32_t", "i32", true },
+			{ type::BuiltIn::i64, "int64_t", "i64", true },
+			{ type::BuiltIn::u8, "uint8_t", "u8", false },
+			{ type::BuiltIn::u16, "uint16_t", "u16", false },
+			{ type::BuiltIn::u32, "uint32_t", "u32", false },
+			{ type::BuiltIn::u64, "uint64_t", "u64", false },
+			{ type::BuiltIn::f32, "float", nullptr, false },
+			{ type::BuiltIn::f64, "double", nullptr, false },
+		};
+
+		const CType* find_c_type(const type::TypeId type) {
+			for (const auto& c_type : c_types) {
+				if (type::TypeTable::builtin(c_type.builtin) == type) {
+					return &c_type;
+				}
+			}
+			return nullptr;
+		}
+
+		// names are length prefixed after the enclosing types, so no two
+		// functions, nor a function and a helper or libc name, can meet
+		void collect_functions(const DeclarationList& decls, const std::string& prefix,
+			std::vector<std::pair<FunctionDeclaration*, std::string>>& functions) {
+			for (const auto& decl : decls) {
+				if (const auto func = dynamic_cast<FunctionDeclaration*>(decl.get())) {
+					functions.emplace_back(func, fmt::format("{}{}{}", prefix, func->name.size(), func->name));
+				} else if (const auto type = dynamic_cast<TypeDeclaration*>(decl.get())) {
+					collect_functions(type->body, fmt::format("{}{}{}", prefix, type->name.size(), type->name), functions);
+				}
+			}
+		}
+	}
+
+	void CEmitVisitor::line(const std::string& text) {
+		output_.append(depth_, '\t');
+		output_ += text;
+		output_ += '\n';
+	}
+
+	std::string CEmitVisitor::emit(expression::Expression& expr) {
+		expr.accept(*this);
+		return std::move(result_);
+	}
+
+	std::string CEmitVisitor::name(const symbol::Symbol* symbol, const std::string& base) {
+		const auto [it, added] = names_.try_emplace(symbol, "");
+		if (added) {
+			it->second = fmt::format("{}_{}", base, names_.size());
+		}
+		return it->second;
+	}
+
+	std::string CEmitVisitor::c_type(const type::TypeId type, const SourcePosition position) const {
+		if (const auto c_type = find_c_type(type)) {
+			return c_type->name;
+		}
+		if (type == type::unresolved_type || type == type::TypeTable::error_type) {
+			throw generate_exception<LoweringException>(position, "cannot emit an ill-typed program");
+		}
+		throw generate_exception<LoweringException>(position, "values of type {} cannot be emitted as C",
+			context_.types().name(type, context_.interner()));
+	}
+
+	std::string CEmitVisitor::signature(const FunctionDeclaration& func) {
+		const auto& type = context_.types().get(func.symbol->type_id);
+
+		std::string params;
+		for (const auto& param : func.params) {
+			if (!params.empty()) {
+				params += ", ";
+			}
+			params += c_type(param.symbol->type_id, param.position) + " " + name(param.symbol, param.name);
+		}
+
+		return fmt::format("{} {}({})", c_type(type.result, func.position), functions_.at(func.symbol), params.empty() ? "void" : params);
+	}
+
+	void CEmitVisitor::visit(Program& program) {
+		std::vector<std::pair<FunctionDeclaration*, std::string>> functions;
+		collect_functions(program.body, "seam_", functions);
+		for (const auto& [func, c_name] : functions) {
+			functions_.emplace(func->symbol, c_name);
+		}
+
+		line("#include <stdbool.h>");
+		line("#include <stdint.h>");
+		line("#include <stdlib.h>");
+		line("");
+
+		// division aborts on zero and wraps the one overflowing quotient
+		for (const auto& c_type : c_types) {
+			if (c_type.division) {
+				const auto overflow = c_type.is_signed ? fmt::format("b == -1 ? ({}) -a : ", c_type.name) : "";
+				line(fmt::format("static inline {0} seam_div_{1}({0} a, {0} b) {{ if (b == 0) abort(); return {2}({0}) (a / b); }}",
+					c_type.name, c_type.division, overflow));
+			}
+		}
+		line("");
+
+		// prototypes first, calls may refer to later functions
+		for (const auto& [func, c_name] : functions) {
+			line(signature(*func) + ";");
+		}
+
+		// functions of other modules are only declared
+		for (const auto& [func, c_name] : functions) {
+			if (func->body) {
+				line("");
+				func->accept(*this);
+			}
+		}
+	}
+
+	void CEmitVisitor::visit(FunctionDeclaration& func) {
+		line(signature(func) + " {");
+		depth_++;
+		for (const auto& stat : func.body->statements) {
+			stat->accept(*this);
+		}
+
+		// falling off the end returns a zero value, like the lowering's undefined value
+		const auto result = context_.types().get(func.symbol->type_id).result;
+		const auto returns = !func.body->statements.empty() && dynamic_cast<statement::ReturnStatement*>(func.body->statements.back().get());
+		if (result != type::TypeTable::builtin(type::BuiltIn::None) && !returns) {
+			line(fmt::format("return ({}) 0;", c_type(result, func.position)));
+		}
+
+		depth_--;
+		line("}");
+	}
+
+	void CEmitVisitor::visit(TypeDeclaration& decl) {
+		for (const auto& member : decl.body) {
+			member->accept(*this);
+		}
+	}
+
+	void CEmitVisitor::visit(TypeAliasDeclaration& decl) {}
+
+	void CEmitVisitor::visit(statement::LetStatement& stat) {
+		const auto value = emit(*stat.expr);
+
+		if (!stat.symbol) {
+			line(value + ";");
+			return;
+		}
+		line(fmt::format("{} {} = {};", c_type(stat.symbol->type_id, stat.position), name(stat.symbol, stat.name), value));
+	}
+
+	void CEmitVisitor::visit(statement::StatementBlock& block) {
+		line("{");
+		depth_++;
+		for (const auto& stat : block.statements) {
+			stat->accept(*this);
+		}
+		depth_--;
+		line("}");
+	}
+
+	void CEmitVisitor::visit(statement::IfStatement& stat) {
+		// an elseif chain is emitted flat, as else if
+		auto branch = &stat;
+		line(fmt::format("if ({}) {{", emit(*branch->cond)));
+		while (true) {
+			depth_++;
+			for (const auto& nested : branch->body->statements) {
+				nested->accept(*this);
+			}
+			depth_--;
+
+			const auto next = branch->else_if();
+			if (!next) {
+				break;
+			}
+			branch = next;
+			line(fmt::format("}} else if ({}) {{", emit(*branch->cond)));
+		}
+
+		if (branch->else_body) {
+			line("} else {");
+			depth_++;
+			for (const auto& nested : branch->else_body->statements) {
+				nested->accept(*this);
+			}
+			depth_--;
+		}
+		line("}");
+	}
+
+	void CEmitVisitor::visit(statement::WhileStatement& stat) {
+		line(fmt::format("while ({}) {{", emit(*stat.cond)));
+		depth_++;
+		for (const auto& nested : stat.body->statements) {
+			nested->accept(*this);
+		}
+		depth_--;
+		line("}");
+	}
+
+	void CEmitVisitor::visit(statement::ReturnStatement& stat) {
+		if (stat.expr) {
+			line(fmt::format("return {};", emit(*stat.expr)));
+		} else {
+			line("return;");
+		}
+	}
+
+	void CEmitVisitor::visit(expression::StringLiteral& expr) {
+		throw generate_exception<LoweringException>(expr.position, "string values cannot be emitted as C");
+	}
+
+	void CEmitVisitor::visit(expression::NumberLiteral& expr) {
+		const auto type = c_type(expr.type_id, expr.position);
+
+		if (context_.types().is_float(expr.type_id)) {
+			// integer literals may have been typed as floats
+			const auto value = expr.is_float() ? expr.constant.f64 : static_cast<double>(expr.constant.i64);
+			auto digits = fmt::format("{:.17g}", value);
+			if (digits.find_first_of(".en") == std::string::npos) {
+				digits += ".0";
+			}
+			result_ = fmt::format("(({}) {})", type, digits);
+			return;
+		}
+
+		if (expr.type_id == type::TypeTable::builtin(type::BuiltIn::u64)) {
+			result_ = fmt::format("UINT64_C({})", static_cast<uint64_t>(expr.constant.i64));
+		} else {
+			result_ = fmt::format("(({}) INT64_C({}))", type, expr.constant.i64);
+		}
+	}
+
+	void CEmitVisitor::visit(expression::BooleanLiteral& expr) {
+		result_ = expr.value ? "true" : "false";
+	}
+
+	void CEmitVisitor::visit(expression::UnaryExpression& expr) {
+		const auto operand = emit(*expr.expr);
+		result_ = fmt::format("(({}) -{})", c_type(expr.type_id, expr.position), operand);
+	}
+
+	void CEmitVisitor::visit(expression::BinaryExpression& expr) {
+		const auto lhs = emit(*expr.lhs);
+		const auto rhs = emit(*expr.rhs);
+		const auto type = c_type(expr.type_id, expr.position);
+
+		// narrow operands are promoted to int, results are converted back to their type
+		switch (expr.op) {
+			case TokenType::OpAssign: result_ = fmt::format("({} = {})", lhs, rhs); return;
+			case TokenType::OpAddEq: result_ = fmt::format("({0} = ({1}) ({0} + {2}))", lhs, type, rhs); return;
+			case TokenType::OpSubEq: result_ = fmt::format("({0} = ({1}) ({0} - {2}))", lhs, type, rhs); return;
+			case TokenType::OpLogicalAnd: result_ = fmt::format("({} && {})", lhs, rhs); return;
+			case TokenType::OpEq: result_ = fmt::format("({} == {})", lhs, rhs); return;
+			case TokenType::OpAdd: result_ = fmt::format("(({}) ({} + {}))", type, lhs, rhs); return;
+			case TokenType::OpSub: result_ = fmt::format("(({}) ({} - {}))", type, lhs, rhs); return;
+			case TokenType::OpMul: result_ = fmt::format("(({}) ({} * {}))", type, lhs, rhs); return;
+			case TokenType::OpBitwiseAnd: result_ = fmt::format("(({}) ({} & {}))", type, lhs, rhs); return;
+			case TokenType::OpDiv: {
+				if (const auto c_type = find_c_type(expr.type_id); c_type && c_type->division) {
+					result_ = fmt::format("seam_div_{}({}, {})", c_type->division, lhs, rhs);
+				} else {
+					result_ = fmt::format("({} / {})", lhs, rhs);
+				}
+				return;
+			}
+			default: {
+				throw generate_exception<LoweringException>(expr.position, "operator {} cannot be emitted as C",
+					std::string(token_type_to_name(expr.op)));
+			}
+		}
+	}
+
+	void CEmitVisitor::visit(expression::PostfixExpression& expr) {
+		const auto operand = emit(*expr.rhs);
+		result_ = fmt::format("({}{})", operand, expr.op == TokenType::OpIncrement ? "++" : "--");
+	}
+
+	void CEmitVisitor::visit(expression::Identifier& expr) {
+		if (!expr.symbol || expr.symbol->type == symbol::SymbolType::Function || expr.symbol->type == symbol::SymbolType::Type) {
+			throw generate_exception<LoweringException>(expr.position, "'{}' is not a value", expr.identifier);
+		}
+		result_ = name(expr.symbol, expr.identifier);
+	}
+
+	void CEmitVisitor::visit(expression::FunctionCall& expr) {
+		const auto callee = dynamic_cast<expression::Identifier*>(expr.function.get());
+		if (!callee || !callee->symbol || callee->symbol->type != symbol::SymbolType::Function) {
+			throw generate_exception<LoweringException>(expr.position, "only named functions can be called");
+		}
+
+		std::string args;
+		for (const auto& arg : expr.args) {
+			if (!args.empty()) {
+				args += ", ";
+			}
+			args += emit(*arg);
+		}
+		result_ = fmt::format("{}({})", functions_.at(callee->symbol), args);
+	}
+}
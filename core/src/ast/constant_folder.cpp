@@ -0,0 +1,305 @@
+#include <ast/constant_folder.h>
+
+#include <limits>
+
+namespace seam::ast {
+	namespace {
+		using expression::BooleanLiteral;
+		using expression::NumberLiteral;
+
+		NumberLiteral* as_constant(const std::unique_ptr<expression::Expression>& expr) {
+			const auto literal = dynamic_cast<NumberLiteral*>(expr.get());
+			return literal && literal->type != type::BuiltIn::None ? literal : nullptr;
+		}
+
+		BooleanLiteral* as_boolean(const std::unique_ptr<expression::Expression>& expr) {
+			return dynamic_cast<BooleanLiteral*>(expr.get());
+		}
+
+		bool is_integer(const NumberLiteral* literal, const int64_t value) {
+			return literal && literal->is_integer() && literal->constant.i64 == value;
+		}
+
+		// portable overflow checks, the results are only computed when they fit
+		constexpr auto min_i64 = std::numeric_limits<int64_t>::min();
+		constexpr auto max_i64 = std::numeric_limits<int64_t>::max();
+
+		bool add_overflows(const int64_t lhs, const int64_t rhs) {
+			return rhs > 0 ? lhs > max_i64 - rhs : lhs < min_i64 - rhs;
+		}
+
+		bool sub_overflows(const int64_t lhs, const int64_t rhs) {
+			return rhs < 0 ? lhs > max_i64 + rhs : lhs < min_i64 + rhs;
+		}
+
+		bool mul_overflows(const int64_t lhs, const int64_t rhs) {
+			if (lhs == 0 || rhs == 0) {
+				return false;
+			}
+			if (lhs > 0) {
+				return rhs > 0 ? lhs > max_i64 / rhs : rhs < min_i64 / lhs;
+			}
+			return rhs > 0 ? lhs < min_i64 / rhs : lhs < max_i64 / rhs;
+		}
+
+		std::unique_ptr<expression::Expression> fold_integers(const TokenType op, const int64_t lhs, const int64_t rhs) {
+			int64_t result;
+
+			switch (op) {
+				case TokenType::OpAdd: {
+					if (add_overflows(lhs, rhs)) return nullptr;
+					result = lhs + rhs;
+					break;
+				}
+				case TokenType::OpSub: {
+					if (sub_overflows(lhs, rhs)) return nullptr;
+					result = lhs - rhs;
+					break;
+				}
+				case TokenType::OpMul: {
+					if (mul_overflows(lhs, rhs)) return nullptr;
+					result = lhs * rhs;
+					break;
+				}
+				case TokenType::OpDiv: {
+					if (rhs == 0 || (lhs == min_i64 && rhs == -1)) return nullptr;
+					result = lhs / rhs;
+					break;
+				}
+				case TokenType::OpBitwiseAnd: result = lhs & rhs; break;
+				case TokenType::OpEq: return std::make_unique<BooleanLiteral>(lhs == rhs);
+				default: return nullptr;
+			}
+
+			return std::make_unique<NumberLiteral>(result);
+		}
+
+		std::unique_ptr<expression::Expression> fold_floats(const TokenType op, const double lhs, const double rhs) {
+			switch (op) {
+				case TokenType::OpAdd: return std::make_unique<NumberLiteral>(lhs + rhs);
+				case TokenType::OpSub: return std::make_unique<NumberLiteral>(lhs - rhs);
+				case TokenType::OpMul: return std::make_unique<NumberLiteral>(lhs * rhs);
+				case TokenType::OpDiv: return std::make_unique<NumberLiteral>(lhs / rhs);
+				case TokenType::OpEq: return std::make_unique<BooleanLiteral>(lhs == rhs);
+				default: return nullptr;
+			}
+		}
+
+		std::unique_ptr<expression::Expression> fold_booleans(const TokenType op, const bool lhs, const bool rhs) {
+			switch (op) {
+				case TokenType::OpLogicalAnd:
+				case TokenType::OpBitwiseAnd: return std::make_unique<BooleanLiteral>(lhs && rhs);
+				case TokenType::OpEq: return std::make_unique<BooleanLiteral>(lhs == rhs);
+				default: return nullptr;
+			}
+		}
+	}
+
+	void ConstantFolder::fold(std::unique_ptr<expression::Expression>& expr) {
+		if (!expr) {
+			return;
+		}
+
+		expr->accept(*this);
+
+		if (folded_expression_) {
+			// freshly built constants take over the folded node's position and type
+			if (folded_expression_->type_id == type::unresolved_type) {
+				folded_expression_->type_id = expr->type_id;
+				folded_expression_->position = expr->position;
+			}
+			expr = std::move(folded_expression_);
+		}
+	}
+
+	void ConstantFolder::fold(statement::StatementList& statements) {
+		size_t kept = 0;
+
+		for (auto& stat : statements) {
+			stat->accept(*this);
+
+			if (remove_statement_) {
+				remove_statement_ = false;
+				continue;
+			}
+
+			if (folded_statement_) {
+				stat = std::move(folded_statement_);
+			}
+
+			statements[kept++] = std::move(stat);
+		}
+
+		statements.resize(kept);
+	}
+
+	void ConstantFolder::replace_expression(std::unique_ptr<expression::Expression> expr) {
+		folded_expression_ = std::move(expr);
+		folded_count_++;
+	}
+
+	void ConstantFolder::replace_statement(std::unique_ptr<statement::Statement> stat) {
+		folded_statement_ = std::move(stat);
+		folded_count_++;
+	}
+
+	void ConstantFolder::remove_statement() {
+		remove_statement_ = true;
+		folded_count_++;
+	}
+
+	void ConstantFolder::visit(Program& program) {
+		for (const auto& decl : program.body) {
+			decl->accept(*this);
+		}
+	}
+
+	void ConstantFolder::visit(FunctionDeclaration& func) {
+		if (func.body) {
+			func.body->accept(*this);
+		}
+	}
+
+	void ConstantFolder::visit(TypeDeclaration& decl) {
+		for (const auto& member : decl.body) {
+			member->accept(*this);
+		}
+	}
+
+	void ConstantFolder::visit(TypeAliasDeclaration& decl) {}
+
+	void ConstantFolder::visit(statement::LetStatement& stat) {
+		fold(stat.expr);
+	}
+
+	void ConstantFolder::visit(statement::StatementBlock& block) {
+		fold(block.statements);
+	}
+
+	void ConstantFolder::visit(statement::IfStatement& stat) {
+		fold(stat.cond);
+		stat.body->accept(*this);
+		if (stat.else_body) {
+			stat.else_body->accept(*this);
+		}
+
+		if (const auto cond = as_boolean(stat.cond)) {
+			if (cond->value) {
+				replace_statement(std::move(stat.body));
+			} else if (stat.else_body) {
+				replace_statement(std::move(stat.else_body));
+			} else {
+				remove_statement();
+			}
+		}
+	}
+
+	void ConstantFolder::visit(statement::WhileStatement& stat) {
+		fold(stat.cond);
+		stat.body->accept(*this);
+
+		if (const auto cond = as_boolean(stat.cond); cond && !cond->value) {
+			remove_statement();
+		}
+	}
+
+	void ConstantFolder::visit(statement::ReturnStatement& stat) {
+		fold(stat.expr);
+	}
+
+	void ConstantFolder::visit(expression::StringLiteral& expr) {}
+
+	void ConstantFolder::visit(expression::NumberLiteral& expr) {}
+
+	void ConstantFolder::visit(expression::BooleanLiteral& expr) {}
+
+	void ConstantFolder::visit(expression::UnaryExpression& expr) {
+		fold(expr.expr);
+
+		if (expr.op != TokenType::OpSub) {
+			return;
+		}
+
+		if (const auto operand = as_constant(expr.expr)) {
+			if (operand->is_float()) {
+				replace_expression(std::make_unique<NumberLiteral>(-operand->constant.f64));
+			} else if (operand->constant.i64 != min_i64) {
+				replace_expression(std::make_unique<NumberLiteral>(-operand->constant.i64));
+			}
+		}
+	}
+
+	void ConstantFolder::visit(expression::BinaryExpression& expr) {
+		fold(expr.lhs);
+		fold(expr.rhs);
+
+		const auto lhs = as_constant(expr.lhs);
+		const auto rhs = as_constant(expr.rhs);
+
+		if (lhs && rhs) {
+			auto folded = lhs->is_integer() && rhs->is_integer()
+				? fold_integers(expr.op, lhs->constant.i64, rhs->constant.i64)
+				: fold_floats(expr.op,
+					lhs->is_float() ? lhs->constant.f64 : static_cast<double>(lhs->constant.i64),
+					rhs->is_float() ? rhs->constant.f64 : static_cast<double>(rhs->constant.i64));
+
+			if (folded) {
+				replace_expression(std::move(folded));
+			}
+			return;
+		}
+
+		const auto lhs_bool = as_boolean(expr.lhs);
+		const auto rhs_bool = as_boolean(expr.rhs);
+
+		if (lhs_bool && rhs_bool) {
+			if (auto folded = fold_booleans(expr.op, lhs_bool->value, rhs_bool->value)) {
+				replace_expression(std::move(folded));
+			}
+			return;
+		}
+
+		// algebraic identities, integer literals only combine with integer operands
+		switch (expr.op) {
+			case TokenType::OpAdd: {
+				if (is_integer(lhs, 0)) replace_expression(std::move(expr.rhs));
+				else if (is_integer(rhs, 0)) replace_expression(std::move(expr.lhs));
+				break;
+			}
+			case TokenType::OpSub: {
+				if (is_integer(rhs, 0)) replace_expression(std::move(expr.lhs));
+				break;
+			}
+			case TokenType::OpMul: {
+				if (is_integer(lhs, 1)) replace_expression(std::move(expr.rhs));
+				else if (is_integer(rhs, 1)) replace_expression(std::move(expr.lhs));
+				break;
+			}
+			case TokenType::OpDiv: {
+				if (is_integer(rhs, 1)) replace_expression(std::move(expr.lhs));
+				break;
+			}
+			case TokenType::OpLogicalAnd: {
+				// false && x never evaluates x, true && x is x
+				if (lhs_bool) {
+					replace_expression(lhs_bool->value ? std::move(expr.rhs) : std::move(expr.lhs));
+				} else if (rhs_bool && rhs_bool->value) {
+					replace_expression(std::move(expr.lhs));
+				}
+				break;
+			}
+			default: break;
+		}
+	}
+
+	void ConstantFolder::visit(expression::PostfixExpression& expr) {}
+
+	void ConstantFolder::visit(expression::Identifier& expr) {}
+
+	void ConstantFolder::visit(expression::FunctionCall& expr) {
+		fold(expr.function);
+		for (auto& arg : expr.args) {
+			fold(arg);
+		}
+	}
+}
@@ -0,0 +1,180 @@
+#include "backend/object.h"
+
+#include <algorithm>
+
+namespace seam::backend {
+	namespace {
+		class ByteWriter {
+			std::vector<uint8_t> bytes_;
+		public:
+			void u8(const uint8_t value) { bytes_.push_back(value); }
+
+			void u16(const uint16_t value) {
+				for (auto i = 0; i < 2; i++) u8(static_cast<uint8_t>(value >> (i * 8)));
+			}
+
+			void u32(const uint32_t value) {
+				for (auto i = 0; i < 4; i++) u8(static_cast<uint8_t>(value >> (i * 8)));
+			}
+
+			void u64(const uint64_t value) {
+				for (auto i = 0; i < 8; i++) u8(static_cast<uint8_t>(value >> (i * 8)));
+			}
+
+			void bytes(const std::vector<uint8_t>& data) { bytes_.insert(bytes_.end(), data.begin(), data.end()); }
+			void string(const std::string& data) { bytes_.insert(bytes_.end(), data.begin(), data.end()); }
+
+			void align(const size_t alignment) {
+				while (bytes_.size() % alignment != 0) u8(0);
+			}
+
+			[[nodiscard]] size_t size() const { return bytes_.size(); }
+			[[nodiscard]] std::vector<uint8_t> take() { return std::move(bytes_); }
+		};
+
+		// section header types and flags, symbol bindings and types
+		constexpr uint32_t sht_progbits = 1, sht_symtab = 2, sht_strtab = 3, sht_rela = 4;
+		constexpr uint64_t shf_alloc = 0x2, shf_execinstr = 0x4, shf_info_link = 0x40;
+		constexpr uint8_t stb_local = 0, stb_global = 1;
+		constexpr uint8_t stt_notype = 0, stt_func = 2, stt_section = 3;
+		constexpr uint32_t r_x86_64_plt32 = 4;
+
+		constexpr uint16_t text_index = 1, symtab_index = 3, strtab_index = 4, shstrtab_index = 5, rela_index = 6, section_count = 7;
+
+		constexpr size_t header_size = 64, section_header_size = 64, symbol_size = 24, relocation_size = 24;
+
+		struct Section {
+			uint32_t name;
+			uint32_t type;
+			uint64_t flags;
+			uint64_t offset;
+			uint64_t size;
+			uint32_t link;
+			uint32_t info;
+			uint64_t alignment;
+			uint64_t entry_size;
+		};
+
+		void symbol(ByteWriter& out, const uint32_t name, const uint8_t binding, const uint8_t type, const uint16_t section, const uint64_t value, const uint64_t size) {
+			out.u32(name);
+			out.u8(static_cast<uint8_t>(binding << 4 | type));
+			out.u8(0);
+			out.u16(section);
+			out.u64(value);
+			out.u64(size);
+		}
+	}
+
+	std::vector<uint8_t> write_elf_object(const ObjectCode& object) {
+		// section names, each offset is where the name starts
+		constexpr char section_table[] = "\0.text\0.note.GNU-stack\0.symtab\0.strtab\0.shstrtab\0.rela.text";
+		const std::string section_names(section_table, sizeof(section_table));
+		constexpr uint32_t text_name = 1, note_name = 7, symtab_name = 23, strtab_name = 31, shstrtab_name = 39, rela_name = 49;
+
+		std::string names(1, '\0');
+		std::vector<uint32_t> name_offsets;
+		for (const auto& symbol : object.symbols) {
+			name_offsets.push_back(static_cast<uint32_t>(names.size()));
+			names += symbol.name;
+			names += '\0';
+		}
+
+		// one undefined symbol per called function of another module
+		std::vector<std::string> externals;
+		std::vector<uint32_t> external_offsets;
+		std::vector<uint32_t> relocation_symbols;
+		for (const auto& relocation : object.relocations) {
+			auto it = std::find(externals.begin(), externals.end(), relocation.symbol);
+			if (it == externals.end()) {
+				external_offsets.push_back(static_cast<uint32_t>(names.size()));
+				names += relocation.symbol;
+				names += '\0';
+				it = externals.insert(externals.end(), relocation.symbol);
+			}
+			relocation_symbols.push_back(static_cast<uint32_t>(2 + object.symbols.size() + (it - externals.begin())));
+		}
+
+		ByteWriter out;
+		// the header is written last, once the section offsets are known
+		for (size_t i = 0; i < header_size; i++) out.u8(0);
+
+		std::vector<Section> sections(section_count, Section {});
+
+		out.align(16);
+		sections[text_index] = Section { text_name, sht_progbits, shf_alloc | shf_execinstr, out.size(), object.text.size(), 0, 0, 16, 0 };
+		out.bytes(object.text);
+
+		// an empty note marks the stack as not executable
+		sections[2] = Section { note_name, sht_progbits, 0, out.size(), 0, 0, 0, 1, 0 };
+
+		out.align(8);
+		const auto symtab_offset = out.size();
+		symbol(out, 0, stb_local, 0, 0, 0, 0);
+		symbol(out, 0, stb_local, stt_section, text_index, 0, 0);
+		for (size_t i = 0; i < object.symbols.size(); i++) {
+			const auto& function = object.symbols[i];
+			symbol(out, name_offsets[i], stb_global, stt_func, text_index, function.offset, function.size);
+		}
+		for (const auto offset : external_offsets) {
+			symbol(out, offset, stb_global, stt_notype, 0, 0, 0);
+		}
+		// info holds the index of the first global symbol
+		sections[symtab_index] = Section { symtab_name, sht_symtab, 0, symtab_offset, out.size() - symtab_offset, strtab_index, 2, 8, symbol_size };
+
+		// calls are pc relative to the end of their rel32 field
+		const auto rela_offset = out.size();
+		for (size_t i = 0; i < object.relocations.size(); i++) {
+			out.u64(object.relocations[i].offset);
+			out.u64(static_cast<uint64_t>(relocation_symbols[i]) << 32 | r_x86_64_plt32);
+			out.u64(static_cast<uint64_t>(-4));
+		}
+		sections[rela_index] = Section { rela_name, sht_rela, shf_info_link, rela_offset, out.size() - rela_offset, symtab_index, text_index, 8, relocation_size };
+
+		sections[strtab_index] = Section { strtab_name, sht_strtab, 0, out.size(), names.size(), 0, 0, 1, 0 };
+		out.string(names);
+
+		sections[shstrtab_index] = Section { shstrtab_name, sht_strtab, 0, out.size(), section_names.size(), 0, 0, 1, 0 };
+		out.string(section_names);
+
+		out.align(8);
+		const auto section_headers = out.size();
+		for (const auto& section : sections) {
+			out.u32(section.name);
+			out.u32(section.type);
+			out.u64(section.flags);
+			out.u64(0);
+			out.u64(section.offset);
+			out.u64(section.size);
+			out.u32(section.link);
+			out.u32(section.info);
+			out.u64(section.alignment);
+			out.u64(section.entry_size);
+		}
+
+		ByteWriter header;
+		header.string(std::string("\x7f" "ELF", 4));
+		header.u8(2); // 64 bit
+		header.u8(1); // little endian
+		header.u8(1); // version
+		header.u8(0); // System V ABI
+		header.align(16);
+		header.u16(1); // relocatable
+		header.u16(62); // x86-64
+		header.u32(1);
+		header.u64(0); // entry
+		header.u64(0); // program headers
+		header.u64(section_headers);
+		header.u32(0); // flags
+		header.u16(header_size);
+		header.u16(0);
+		header.u16(0);
+		header.u16(section_header_size);
+		header.u16(section_count);
+		header.u16(shstrtab_index);
+
+		auto bytes = out.take();
+		const auto written = header.take();
+		std::copy(written.begin(), written.end(), bytes.begin());
+		return bytes;
+	}
+}
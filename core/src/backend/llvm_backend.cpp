@@ -0,0 +1,271 @@
+#include "backend/llvm_backend.h"
+
+#include <memory>
+
+#include <fmt/format.h>
+
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/MC/TargetRegistry.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Target/TargetOptions.h>
+
+#include "exception.h"
+#include "ir/analysis.h"
+
+namespace seam::backend {
+	namespace {
+		/**
+		 * Translates one module, a block of the IR may end up as several
+		 * LLVM blocks when divisions are guarded.
+		 */
+		class Translator {
+			llvm::LLVMContext& context_;
+			llvm::Module& target_;
+			llvm::IRBuilder<> builder_;
+			const ir::Module& module_;
+			std::vector<llvm::Function*> functions_;
+
+			llvm::Type* type(const ir::Type type) {
+				switch (type) {
+					case ir::Type::None: return builder_.getVoidTy();
+					case ir::Type::Bool: return builder_.getInt1Ty();
+					case ir::Type::I64: return builder_.getInt64Ty();
+					case ir::Type::F64: return builder_.getDoubleTy();
+				}
+				return nullptr;
+			}
+
+			/**
+			 * Division traps on zero and wraps the one overflowing quotient,
+			 * both are undefined for sdiv.
+			 */
+			llvm::Value* divide(llvm::Function* function, llvm::Value* lhs, llvm::Value* rhs) {
+				auto* trap = llvm::BasicBlock::Create(context_, "division_by_zero", function);
+				auto* divide = llvm::BasicBlock::Create(context_, "divide", function);
+
+				builder_.CreateCondBr(builder_.CreateICmpEQ(rhs, builder_.getInt64(0)), trap, divide);
+
+				builder_.SetInsertPoint(trap);
+				builder_.CreateCall(llvm::Intrinsic::getDeclaration(&target_, llvm::Intrinsic::trap));
+				builder_.CreateUnreachable();
+
+				builder_.SetInsertPoint(divide);
+				auto* minus_one = builder_.CreateICmpEQ(rhs, builder_.getInt64(-1));
+				auto* quotient = builder_.CreateSDiv(lhs, builder_.CreateSelect(minus_one, builder_.getInt64(1), rhs));
+				return builder_.CreateSelect(minus_one, builder_.CreateSub(builder_.getInt64(0), lhs), quotient);
+			}
+
+			llvm::Value* instruction(llvm::Function* function, const ir::Function& source, const ir::Instruction& instruction, const std::vector<llvm::Value*>& values) {
+				const auto operand = [&](const size_t index) { return values[instruction.operands[index]]; };
+				const auto is_float = instruction.type == ir::Type::F64;
+
+				switch (instruction.op) {
+					case ir::Opcode::Const: {
+						if (is_float) return llvm::ConstantFP::get(builder_.getDoubleTy(), instruction.immediate.f64);
+						return llvm::ConstantInt::get(type(instruction.type), static_cast<uint64_t>(instruction.immediate.i64), true);
+					}
+					case ir::Opcode::Param: return function->getArg(instruction.immediate.index);
+					case ir::Opcode::Undef: return llvm::Constant::getNullValue(type(instruction.type));
+					case ir::Opcode::Neg: return is_float ? builder_.CreateFNeg(operand(0)) : builder_.CreateNeg(operand(0));
+					case ir::Opcode::Add: return is_float ? builder_.CreateFAdd(operand(0), operand(1)) : builder_.CreateAdd(operand(0), operand(1));
+					case ir::Opcode::Sub: return is_float ? builder_.CreateFSub(operand(0), operand(1)) : builder_.CreateSub(operand(0), operand(1));
+					case ir::Opcode::Mul: return is_float ? builder_.CreateFMul(operand(0), operand(1)) : builder_.CreateMul(operand(0), operand(1));
+					case ir::Opcode::Div: return is_float ? builder_.CreateFDiv(operand(0), operand(1)) : divide(function, operand(0), operand(1));
+					case ir::Opcode::And: return builder_.CreateAnd(operand(0), operand(1));
+					case ir::Opcode::Eq: {
+						if (source.values[instruction.operands[0]].type == ir::Type::F64) return builder_.CreateFCmpOEQ(operand(0), operand(1));
+						return builder_.CreateICmpEQ(operand(0), operand(1));
+					}
+					case ir::Opcode::Call: {
+						std::vector<llvm::Value*> arguments;
+						for (const auto argument : instruction.operands) {
+							arguments.push_back(values[argument]);
+						}
+						return builder_.CreateCall(functions_[instruction.immediate.index], arguments);
+					}
+					case ir::Opcode::Phi:
+					case ir::Opcode::Removed: break;
+				}
+				return nullptr;
+			}
+
+			void body(llvm::Function* function, const ir::Function& source) {
+				const ir::DominatorTree dominators(source);
+
+				std::vector<llvm::BasicBlock*> entries(source.blocks.size(), nullptr);
+				// the LLVM block each IR block ends in, phis name it as the predecessor
+				std::vector<llvm::BasicBlock*> exits(source.blocks.size(), nullptr);
+				for (const auto b : dominators.reverse_postorder()) {
+					entries[b] = llvm::BasicBlock::Create(context_, fmt::format("b{}", b), function);
+				}
+
+				// definitions dominate their uses, so operands are translated first in reverse postorder
+				std::vector<llvm::Value*> values(source.values.size(), nullptr);
+				for (const auto b : dominators.reverse_postorder()) {
+					const auto& block = source.blocks[b];
+					builder_.SetInsertPoint(entries[b]);
+
+					for (size_t i = 0; i < block.instructions.size(); i++) {
+						const auto id = block.instructions[i];
+						const auto& value = source.values[id];
+
+						if (i < block.phi_count) {
+							values[id] = builder_.CreatePHI(type(value.type), static_cast<unsigned>(block.predecessors.size()));
+						} else {
+							values[id] = instruction(function, source, value, values);
+						}
+					}
+
+					const auto& terminator = block.terminator;
+					switch (terminator.kind) {
+						case ir::TerminatorKind::Jump: builder_.CreateBr(entries[terminator.targets[0]]); break;
+						case ir::TerminatorKind::Branch: {
+							builder_.CreateCondBr(values[terminator.value], entries[terminator.targets[0]], entries[terminator.targets[1]]);
+							break;
+						}
+						case ir::TerminatorKind::Return: {
+							if (terminator.value == ir::no_value) builder_.CreateRetVoid();
+							else builder_.CreateRet(values[terminator.value]);
+							break;
+						}
+						case ir::TerminatorKind::None: builder_.CreateUnreachable(); break;
+					}
+					exits[b] = builder_.GetInsertBlock();
+				}
+
+				for (const auto b : dominators.reverse_postorder()) {
+					const auto& block = source.blocks[b];
+					for (size_t i = 0; i < block.phi_count; i++) {
+						const auto id = block.instructions[i];
+						auto* phi = llvm::cast<llvm::PHINode>(values[id]);
+
+						for (size_t p = 0; p < block.predecessors.size(); p++) {
+							// edges from unreachable blocks were never translated
+							if (exits[block.predecessors[p]] != nullptr) {
+								phi->addIncoming(values[source.values[id].operands[p]], exits[block.predecessors[p]]);
+							}
+						}
+					}
+				}
+			}
+		public:
+			Translator(llvm::LLVMContext& context, llvm::Module& target, const ir::Module& module)
+				: context_(context), target_(target), builder_(context), module_(module) {}
+
+			void translate() {
+				// declared up front, calls may refer to later functions
+				for (const auto& function : module_.functions) {
+					std::vector<llvm::Type*> params;
+					for (const auto param : function.params) {
+						params.push_back(type(param));
+					}
+
+					auto* signature = llvm::FunctionType::get(type(function.result), params, false);
+					functions_.push_back(llvm::Function::Create(signature, llvm::Function::ExternalLinkage, function.name, target_));
+				}
+
+				// functions of other modules stay external declarations
+				for (size_t i = 0; i < module_.functions.size(); i++) {
+					if (!module_.functions[i].blocks.empty()) {
+						body(functions_[i], module_.functions[i]);
+					}
+				}
+
+				std::string errors;
+				llvm::raw_string_ostream stream(errors);
+				if (llvm::verifyModule(target_, &stream)) {
+					throw CodegenException("invalid LLVM module: " + stream.str());
+				}
+			}
+		};
+
+		llvm::OptimizationLevel optimisation_level(const unsigned level) {
+			switch (level) {
+				case 0: return llvm::OptimizationLevel::O0;
+				case 1: return llvm::OptimizationLevel::O1;
+				case 2: return llvm::OptimizationLevel::O2;
+				default: return llvm::OptimizationLevel::O3;
+			}
+		}
+
+		std::unique_ptr<llvm::TargetMachine> host_machine(const unsigned level) {
+			llvm::InitializeNativeTarget();
+			llvm::InitializeNativeTargetAsmPrinter();
+
+			const auto triple = llvm::sys::getDefaultTargetTriple();
+			std::string error;
+			const auto* target = llvm::TargetRegistry::lookupTarget(triple, error);
+			if (target == nullptr) {
+				throw CodegenException("no LLVM target for the host: " + error);
+			}
+
+			const auto code_level = level == 0 ? llvm::CodeGenOpt::None : level == 1 ? llvm::CodeGenOpt::Less : level == 2 ? llvm::CodeGenOpt::Default : llvm::CodeGenOpt::Aggressive;
+			return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(triple, "generic", "", llvm::TargetOptions(), llvm::Reloc::PIC_, llvm::None, code_level));
+		}
+
+		std::unique_ptr<llvm::Module> build(llvm::LLVMContext& context, const ir::Module& module, llvm::TargetMachine& machine, const unsigned level) {
+			auto target = std::make_unique<llvm::Module>("seam", context);
+			target->setTargetTriple(machine.getTargetTriple().str());
+			target->setDataLayout(machine.createDataLayout());
+
+			Translator(context, *target, module).translate();
+
+			llvm::LoopAnalysisManager loops;
+			llvm::FunctionAnalysisManager functions;
+			llvm::CGSCCAnalysisManager sccs;
+			llvm::ModuleAnalysisManager modules;
+
+			llvm::PassBuilder builder(&machine);
+			builder.registerModuleAnalyses(modules);
+			builder.registerCGSCCAnalyses(sccs);
+			builder.registerFunctionAnalyses(functions);
+			builder.registerLoopAnalyses(loops);
+			builder.crossRegisterProxies(loops, functions, sccs, modules);
+
+			const auto pipeline_level = optimisation_level(level);
+			auto pipeline = pipeline_level == llvm::OptimizationLevel::O0
+				? builder.buildO0DefaultPipeline(pipeline_level)
+				: builder.buildPerModuleDefaultPipeline(pipeline_level);
+			pipeline.run(*target, modules);
+
+			return target;
+		}
+	}
+
+	std::string LlvmBackend::emit_ir(const ir::Module& module) const {
+		llvm::LLVMContext context;
+		const auto machine = host_machine(optimisation_level_);
+		const auto target = build(context, module, *machine, optimisation_level_);
+
+		std::string text;
+		llvm::raw_string_ostream stream(text);
+		target->print(stream, nullptr);
+		return stream.str();
+	}
+
+	std::vector<uint8_t> LlvmBackend::emit_object(const ir::Module& module) const {
+		llvm::LLVMContext context;
+		const auto machine = host_machine(optimisation_level_);
+		const auto target = build(context, module, *machine, optimisation_level_);
+
+		llvm::SmallVector<char, 0> buffer;
+		llvm::raw_svector_ostream stream(buffer);
+
+		llvm::legacy::PassManager emitter;
+		if (machine->addPassesToEmitFile(emitter, stream, nullptr, llvm::CGFT_ObjectFile)) {
+			throw CodegenException("the host target cannot emit object files");
+		}
+		emitter.run(*target);
+
+		return std::vector<uint8_t>(buffer.begin(), buffer.end());
+	}
+}
@@ -0,0 +1,302 @@
+#include "backend/x86_64/assembler.h"
+
+namespace seam::backend::x86_64 {
+	namespace {
+		uint8_t code(const Register reg) {
+			return static_cast<uint8_t>(reg);
+		}
+
+		uint8_t code(const XmmRegister reg) {
+			return static_cast<uint8_t>(reg);
+		}
+
+		constexpr size_t unbound = SIZE_MAX;
+	}
+
+	void Assembler::emit32(const uint32_t value) {
+		for (auto i = 0; i < 4; i++) {
+			emit(static_cast<uint8_t>(value >> (i * 8)));
+		}
+	}
+
+	void Assembler::emit64(const uint64_t value) {
+		for (auto i = 0; i < 8; i++) {
+			emit(static_cast<uint8_t>(value >> (i * 8)));
+		}
+	}
+
+	void Assembler::rex(const bool wide, const uint8_t reg, const uint8_t rm) {
+		emit(static_cast<uint8_t>(0x40 | (wide ? 0x08 : 0) | ((reg >> 3) << 2) | (rm >> 3)));
+	}
+
+	void Assembler::modrm_register(const uint8_t reg, const uint8_t rm) {
+		emit(static_cast<uint8_t>(0xc0 | ((reg & 7) << 3) | (rm & 7)));
+	}
+
+	void Assembler::modrm_frame(const uint8_t reg, const int32_t displacement) {
+		// [rbp + disp32]
+		emit(static_cast<uint8_t>(0x80 | ((reg & 7) << 3) | code(Register::Rbp)));
+		emit32(static_cast<uint32_t>(displacement));
+	}
+
+	void Assembler::rel32(const Label label) {
+		fixups_.push_back(Fixup { code_.size(), label });
+		emit32(0);
+	}
+
+	Label Assembler::create_label() {
+		labels_.push_back(unbound);
+		return static_cast<Label>(labels_.size() - 1);
+	}
+
+	void Assembler::bind(const Label label) {
+		labels_[label] = code_.size();
+	}
+
+	std::vector<uint8_t> Assembler::finish() {
+		for (const auto& fixup : fixups_) {
+			const auto target = static_cast<int64_t>(labels_[fixup.label]);
+			const auto displacement = static_cast<uint32_t>(target - static_cast<int64_t>(fixup.offset + 4));
+			for (auto i = 0; i < 4; i++) {
+				code_[fixup.offset + i] = static_cast<uint8_t>(displacement >> (i * 8));
+			}
+		}
+		fixups_.clear();
+		return std::move(code_);
+	}
+
+	void Assembler::mov(const Register destination, const Register source) {
+		rex(true, code(source), code(destination));
+		emit(0x89);
+		modrm_register(code(source), code(destination));
+	}
+
+	void Assembler::mov(const Register destination, const int64_t immediate) {
+		if (immediate >= INT32_MIN && immediate <= INT32_MAX) {
+			// sign extended imm32
+			rex(true, 0, code(destination));
+			emit(0xc7);
+			modrm_register(0, code(destination));
+			emit32(static_cast<uint32_t>(immediate));
+			return;
+		}
+
+		rex(true, 0, code(destination));
+		emit(static_cast<uint8_t>(0xb8 + (code(destination) & 7)));
+		emit64(static_cast<uint64_t>(immediate));
+	}
+
+	void Assembler::load(const Register destination, const int32_t frame_offset) {
+		rex(true, code(destination), 0);
+		emit(0x8b);
+		modrm_frame(code(destination), frame_offset);
+	}
+
+	void Assembler::load_indirect(const Register destination, const Register address) {
+		rex(true, code(destination), code(address));
+		emit(0x8b);
+
+		// rsp and r12 need a SIB byte, rbp and r13 a displacement
+		const auto rm = static_cast<uint8_t>(code(address) & 7);
+		if (rm == code(Register::Rbp)) {
+			emit(static_cast<uint8_t>(0x40 | ((code(destination) & 7) << 3) | rm));
+			emit(0);
+			return;
+		}
+		emit(static_cast<uint8_t>(((code(destination) & 7) << 3) | rm));
+		if (rm == code(Register::Rsp)) {
+			emit(0x24);
+		}
+	}
+
+	void Assembler::store(const int32_t frame_offset, const Register source) {
+		rex(true, code(source), 0);
+		emit(0x89);
+		modrm_frame(code(source), frame_offset);
+	}
+
+	void Assembler::push(const Register reg) {
+		if (code(reg) >= 8) {
+			emit(0x41);
+		}
+		emit(static_cast<uint8_t>(0x50 + (code(reg) & 7)));
+	}
+
+	void Assembler::pop(const Register reg) {
+		if (code(reg) >= 8) {
+			emit(0x41);
+		}
+		emit(static_cast<uint8_t>(0x58 + (code(reg) & 7)));
+	}
+
+	void Assembler::lea_frame(const Register destination, const int32_t frame_offset) {
+		rex(true, code(destination), 0);
+		emit(0x8d);
+		modrm_frame(code(destination), frame_offset);
+	}
+
+	void Assembler::add(const Register destination, const Register source) {
+		rex(true, code(source), code(destination));
+		emit(0x01);
+		modrm_register(code(source), code(destination));
+	}
+
+	void Assembler::sub(const Register destination, const Register source) {
+		rex(true, code(source), code(destination));
+		emit(0x29);
+		modrm_register(code(source), code(destination));
+	}
+
+	void Assembler::imul(const Register destination, const Register source) {
+		rex(true, code(destination), code(source));
+		emit(0x0f);
+		emit(0xaf);
+		modrm_register(code(destination), code(source));
+	}
+
+	void Assembler::and_(const Register destination, const Register source) {
+		rex(true, code(source), code(destination));
+		emit(0x21);
+		modrm_register(code(source), code(destination));
+	}
+
+	void Assembler::xor_(const Register destination, const Register source) {
+		rex(true, code(source), code(destination));
+		emit(0x31);
+		modrm_register(code(source), code(destination));
+	}
+
+	void Assembler::neg(const Register reg) {
+		rex(true, 0, code(reg));
+		emit(0xf7);
+		modrm_register(3, code(reg));
+	}
+
+	void Assembler::cqo() {
+		emit(0x48);
+		emit(0x99);
+	}
+
+	void Assembler::idiv(const Register divisor) {
+		rex(true, 0, code(divisor));
+		emit(0xf7);
+		modrm_register(7, code(divisor));
+	}
+
+	void Assembler::sub(const Register destination, const int32_t immediate) {
+		rex(true, 0, code(destination));
+		emit(0x81);
+		modrm_register(5, code(destination));
+		emit32(static_cast<uint32_t>(immediate));
+	}
+
+	void Assembler::cmp(const Register lhs, const Register rhs) {
+		rex(true, code(rhs), code(lhs));
+		emit(0x39);
+		modrm_register(code(rhs), code(lhs));
+	}
+
+	void Assembler::cmp(const Register lhs, const int8_t immediate) {
+		rex(true, 0, code(lhs));
+		emit(0x83);
+		modrm_register(7, code(lhs));
+		emit(static_cast<uint8_t>(immediate));
+	}
+
+	void Assembler::test(const Register lhs, const Register rhs) {
+		rex(true, code(rhs), code(lhs));
+		emit(0x85);
+		modrm_register(code(rhs), code(lhs));
+	}
+
+	void Assembler::setcc(const Condition condition, const Register destination) {
+		// a plain rex prefix selects the low byte of every register
+		rex(false, 0, code(destination));
+		emit(0x0f);
+		emit(static_cast<uint8_t>(0x90 + static_cast<uint8_t>(condition)));
+		modrm_register(0, code(destination));
+	}
+
+	void Assembler::movzx_byte(const Register destination, const Register source) {
+		rex(true, code(destination), code(source));
+		emit(0x0f);
+		emit(0xb6);
+		modrm_register(code(destination), code(source));
+	}
+
+	void Assembler::and_byte(const Register destination, const Register source) {
+		rex(false, code(source), code(destination));
+		emit(0x20);
+		modrm_register(code(source), code(destination));
+	}
+
+	void Assembler::movq(const XmmRegister destination, const Register source) {
+		emit(0x66);
+		rex(true, code(destination), code(source));
+		emit(0x0f);
+		emit(0x6e);
+		modrm_register(code(destination), code(source));
+	}
+
+	void Assembler::movq(const Register destination, const XmmRegister source) {
+		emit(0x66);
+		rex(true, code(source), code(destination));
+		emit(0x0f);
+		emit(0x7e);
+		modrm_register(code(source), code(destination));
+	}
+
+	void Assembler::sse(const SseOperation operation, const XmmRegister destination, const XmmRegister source) {
+		emit(0xf2);
+		emit(0x0f);
+		emit(static_cast<uint8_t>(operation));
+		modrm_register(code(destination), code(source));
+	}
+
+	void Assembler::ucomisd(const XmmRegister lhs, const XmmRegister rhs) {
+		emit(0x66);
+		emit(0x0f);
+		emit(0x2e);
+		modrm_register(code(lhs), code(rhs));
+	}
+
+	void Assembler::jmp(const Label label) {
+		emit(0xe9);
+		rel32(label);
+	}
+
+	void Assembler::jcc(const Condition condition, const Label label) {
+		emit(0x0f);
+		emit(static_cast<uint8_t>(0x80 + static_cast<uint8_t>(condition)));
+		rel32(label);
+	}
+
+	void Assembler::call(const Label label) {
+		emit(0xe8);
+		rel32(label);
+	}
+
+	void Assembler::call(const Register target) {
+		if (code(target) >= 8) {
+			emit(0x41);
+		}
+		emit(0xff);
+		modrm_register(2, code(target));
+	}
+
+	size_t Assembler::call_external() {
+		emit(0xe8);
+		const auto offset = code_.size();
+		emit32(0);
+		return offset;
+	}
+
+	void Assembler::ret() {
+		emit(0xc3);
+	}
+
+	void Assembler::ud2() {
+		emit(0x0f);
+		emit(0x0b);
+	}
+}
@@ -0,0 +1,497 @@
+#include "backend/x86_64/code_generator.h"
+
+#include <algorithm>
+#include <bit>
+
+#include <fmt/format.h>
+
+#include "backend/x86_64/assembler.h"
+#include "backend/x86_64/register_allocator.h"
+#include "exception.h"
+#include "ir/analysis.h"
+
+namespace seam::backend::x86_64 {
+	namespace {
+		constexpr Register integer_arguments[] {
+			Register::Rdi, Register::Rsi, Register::Rdx, Register::Rcx, Register::R8, Register::R9,
+		};
+		constexpr size_t float_arguments = 8;
+
+		/**
+		 * Assigns each parameter its argument register, integers and
+		 * doubles are counted separately.
+		 */
+		std::vector<uint8_t> argument_registers(const std::string& function, const std::vector<ir::Type>& types) {
+			std::vector<uint8_t> registers;
+			size_t integers = 0, floats = 0;
+
+			for (const auto type : types) {
+				if (type == ir::Type::F64) {
+					registers.push_back(static_cast<uint8_t>(floats++));
+				} else {
+					registers.push_back(static_cast<uint8_t>(integers++));
+				}
+			}
+
+			if (integers > std::size(integer_arguments) || floats > float_arguments) {
+				throw CodegenException(fmt::format("too many arguments for '{}', stack arguments are not supported", function));
+			}
+			return registers;
+		}
+
+		struct Move {
+			Location source;
+			Location destination;
+		};
+
+		class FunctionEmitter {
+			Assembler& assembler_;
+			const std::vector<Label>& functions_;
+			const std::vector<const void*>& entries_;
+			std::vector<ObjectRelocation>& relocations_;
+			const std::optional<CodeGenerator::StackLimit>& stack_limit_;
+			const ir::Module& module_;
+			const ir::Function& function_;
+			Allocation allocation_;
+
+			std::vector<Label> blocks_;
+			// first temporary used to break cycles of phi moves
+			size_t temporaries_ = 0;
+
+			[[nodiscard]] int32_t frame_offset(const size_t slot) const {
+				// below the saved rbp and callee-saved registers
+				return -static_cast<int32_t>(8 * (allocation_.used_registers.size() + 1 + slot));
+			}
+
+			[[nodiscard]] const Location& location(const ir::ValueId value) const {
+				return allocation_.locations[value];
+			}
+
+			void load(const Register destination, const Location& source) {
+				switch (source.kind) {
+					case Location::Kind::Register: {
+						if (source.reg != destination) {
+							assembler_.mov(destination, source.reg);
+						}
+						break;
+					}
+					case Location::Kind::Stack: assembler_.load(destination, frame_offset(source.slot)); break;
+					case Location::Kind::None: break;
+				}
+			}
+
+			void store(const Location& destination, const Register source) {
+				switch (destination.kind) {
+					case Location::Kind::Register: {
+						if (destination.reg != source) {
+							assembler_.mov(destination.reg, source);
+						}
+						break;
+					}
+					case Location::Kind::Stack: assembler_.store(frame_offset(destination.slot), source); break;
+					case Location::Kind::None: break;
+				}
+			}
+
+			void load(const Register destination, const ir::ValueId value) { load(destination, location(value)); }
+			void store(const ir::ValueId value, const Register source) { store(location(value), source); }
+
+			void move(const Location& destination, const Location& source) {
+				if (destination == source) {
+					return;
+				}
+				if (destination.kind == Location::Kind::Register) {
+					load(destination.reg, source);
+				} else {
+					load(Register::Rax, source);
+					store(destination, Register::Rax);
+				}
+			}
+
+			void check_stack() {
+				const auto& stack_limit = *stack_limit_;
+				const auto enough = assembler_.create_label();
+
+				// rax is no argument register, rdi is only clobbered when the call does not return
+				assembler_.mov(Register::Rax, static_cast<int64_t>(reinterpret_cast<uintptr_t>(stack_limit.limit)));
+				assembler_.load_indirect(Register::Rax, Register::Rax);
+				assembler_.cmp(Register::Rsp, Register::Rax);
+				assembler_.jcc(Condition::AboveOrEqual, enough);
+				assembler_.mov(Register::Rdi, static_cast<int64_t>(reinterpret_cast<uintptr_t>(stack_limit.context)));
+				assembler_.mov(Register::Rax, static_cast<int64_t>(reinterpret_cast<uintptr_t>(stack_limit.exceeded)));
+				assembler_.call(Register::Rax);
+				assembler_.bind(enough);
+			}
+
+			void prologue() {
+				assembler_.push(Register::Rbp);
+				assembler_.mov(Register::Rbp, Register::Rsp);
+				if (stack_limit_) {
+					// rsp is 16 byte aligned after the push
+					check_stack();
+				}
+				for (const auto reg : allocation_.used_registers) {
+					assembler_.push(reg);
+				}
+
+				// keep rsp 16 byte aligned at calls
+				const auto saved = allocation_.used_registers.size();
+				auto locals = allocation_.spill_slots + temporaries_;
+				if ((saved + locals) % 2 != 0) {
+					locals++;
+				}
+				if (locals > 0) {
+					assembler_.sub(Register::Rsp, static_cast<int32_t>(8 * locals));
+				}
+
+				// argument registers are never allocated, so parameters can be stored in any order
+				const auto registers = argument_registers(function_.name, function_.params);
+				for (const auto id : function_.blocks[0].instructions) {
+					const auto& value = function_.values[id];
+					if (value.op != ir::Opcode::Param) {
+						continue;
+					}
+
+					const auto index = registers[value.immediate.index];
+					if (value.type == ir::Type::F64) {
+						assembler_.movq(Register::Rax, static_cast<XmmRegister>(index));
+						store(id, Register::Rax);
+					} else {
+						store(id, integer_arguments[index]);
+					}
+				}
+			}
+
+			void epilogue() {
+				if (!allocation_.used_registers.empty() || allocation_.spill_slots + temporaries_ > 0) {
+					assembler_.lea_frame(Register::Rsp, -static_cast<int32_t>(8 * allocation_.used_registers.size()));
+				}
+				for (auto it = allocation_.used_registers.rbegin(); it != allocation_.used_registers.rend(); ++it) {
+					assembler_.pop(*it);
+				}
+				assembler_.pop(Register::Rbp);
+				assembler_.ret();
+			}
+
+			void binary(const ir::Instruction& instruction) {
+				load(Register::Rax, instruction.operands[0]);
+				load(Register::Rcx, instruction.operands[1]);
+
+				if (instruction.type == ir::Type::F64) {
+					assembler_.movq(XmmRegister::Xmm0, Register::Rax);
+					assembler_.movq(XmmRegister::Xmm1, Register::Rcx);
+					switch (instruction.op) {
+						case ir::Opcode::Add: assembler_.sse(SseOperation::Add, XmmRegister::Xmm0, XmmRegister::Xmm1); break;
+						case ir::Opcode::Sub: assembler_.sse(SseOperation::Sub, XmmRegister::Xmm0, XmmRegister::Xmm1); break;
+						case ir::Opcode::Mul: assembler_.sse(SseOperation::Mul, XmmRegister::Xmm0, XmmRegister::Xmm1); break;
+						default: assembler_.sse(SseOperation::Div, XmmRegister::Xmm0, XmmRegister::Xmm1); break;
+					}
+					assembler_.movq(Register::Rax, XmmRegister::Xmm0);
+					return;
+				}
+
+				switch (instruction.op) {
+					case ir::Opcode::Add: assembler_.add(Register::Rax, Register::Rcx); break;
+					case ir::Opcode::Sub: assembler_.sub(Register::Rax, Register::Rcx); break;
+					case ir::Opcode::Mul: assembler_.imul(Register::Rax, Register::Rcx); break;
+					case ir::Opcode::And: assembler_.and_(Register::Rax, Register::Rcx); break;
+					default: {
+						const auto nonzero = assembler_.create_label();
+						const auto divide = assembler_.create_label();
+						const auto done = assembler_.create_label();
+
+						assembler_.test(Register::Rcx, Register::Rcx);
+						assembler_.jcc(Condition::NotEqual, nonzero);
+						assembler_.ud2();
+
+						// idiv faults on the one overflowing quotient, which wraps instead
+						assembler_.bind(nonzero);
+						assembler_.cmp(Register::Rcx, static_cast<int8_t>(-1));
+						assembler_.jcc(Condition::NotEqual, divide);
+						assembler_.neg(Register::Rax);
+						assembler_.jmp(done);
+
+						assembler_.bind(divide);
+						assembler_.cqo();
+						assembler_.idiv(Register::Rcx);
+						assembler_.bind(done);
+						break;
+					}
+				}
+			}
+
+			void compare(const ir::Instruction& instruction) {
+				load(Register::Rax, instruction.operands[0]);
+				load(Register::Rcx, instruction.operands[1]);
+
+				if (function_.values[instruction.operands[0]].type == ir::Type::F64) {
+					// unordered operands set the parity flag and compare unequal
+					assembler_.movq(XmmRegister::Xmm0, Register::Rax);
+					assembler_.movq(XmmRegister::Xmm1, Register::Rcx);
+					assembler_.ucomisd(XmmRegister::Xmm0, XmmRegister::Xmm1);
+					assembler_.setcc(Condition::Equal, Register::Rax);
+					assembler_.setcc(Condition::NotParity, Register::Rcx);
+					assembler_.and_byte(Register::Rax, Register::Rcx);
+				} else {
+					assembler_.cmp(Register::Rax, Register::Rcx);
+					assembler_.setcc(Condition::Equal, Register::Rax);
+				}
+				assembler_.movzx_byte(Register::Rax, Register::Rax);
+			}
+
+			void call(const ir::ValueId id, const ir::Instruction& instruction) {
+				const auto& callee = module_.functions[instruction.immediate.index];
+				const auto registers = argument_registers(callee.name, callee.params);
+
+				for (size_t i = 0; i < instruction.operands.size(); i++) {
+					if (callee.params[i] == ir::Type::F64) {
+						load(Register::Rax, instruction.operands[i]);
+						assembler_.movq(static_cast<XmmRegister>(registers[i]), Register::Rax);
+					} else {
+						load(integer_arguments[registers[i]], instruction.operands[i]);
+					}
+				}
+
+				if (const auto entry = instruction.immediate.index < entries_.size() ? entries_[instruction.immediate.index] : nullptr) {
+					// rax is free once the arguments are in place
+					assembler_.mov(Register::Rax, static_cast<int64_t>(reinterpret_cast<uintptr_t>(entry)));
+					assembler_.call(Register::Rax);
+				} else if (callee.blocks.empty()) {
+					relocations_.push_back(ObjectRelocation { assembler_.call_external(), callee.name });
+				} else {
+					assembler_.call(functions_[instruction.immediate.index]);
+				}
+
+				if (instruction.type == ir::Type::F64) {
+					assembler_.movq(Register::Rax, XmmRegister::Xmm0);
+				}
+				store(id, Register::Rax);
+			}
+
+			void instruction(const ir::ValueId id) {
+				const auto& instruction = function_.values[id];
+
+				switch (instruction.op) {
+					case ir::Opcode::Const: {
+						assembler_.mov(Register::Rax, instruction.immediate.i64);
+						break;
+					}
+					case ir::Opcode::Undef: {
+						assembler_.mov(Register::Rax, static_cast<int64_t>(0));
+						break;
+					}
+					case ir::Opcode::Neg: {
+						load(Register::Rax, instruction.operands[0]);
+						if (instruction.type == ir::Type::F64) {
+							assembler_.mov(Register::Rcx, std::bit_cast<int64_t>(-0.0));
+							assembler_.xor_(Register::Rax, Register::Rcx);
+						} else {
+							assembler_.neg(Register::Rax);
+						}
+						break;
+					}
+					case ir::Opcode::Add:
+					case ir::Opcode::Sub:
+					case ir::Opcode::Mul:
+					case ir::Opcode::Div:
+					case ir::Opcode::And: binary(instruction); break;
+					case ir::Opcode::Eq: compare(instruction); break;
+					case ir::Opcode::Call: call(id, instruction); return;
+
+					// defined by the prologue and by edges
+					case ir::Opcode::Param:
+					case ir::Opcode::Phi:
+					case ir::Opcode::Removed: return;
+				}
+
+				store(id, Register::Rax);
+			}
+
+			/**
+			 * Copies phi operands along the edge from a block into a target,
+			 * all at once: when a destination is also read by another move
+			 * the sources go through temporaries first.
+			 */
+			void edge(const ir::BlockId from, const ir::BlockId to) {
+				const auto& target = function_.blocks[to];
+				const auto index = static_cast<size_t>(std::find(target.predecessors.begin(), target.predecessors.end(), from) - target.predecessors.begin());
+
+				std::vector<Move> moves;
+				for (size_t i = 0; i < target.phi_count; i++) {
+					const auto phi = target.instructions[i];
+					const auto& source = location(function_.values[phi].operands[index]);
+					if (source != location(phi)) {
+						moves.push_back(Move { source, location(phi) });
+					}
+				}
+
+				const auto overlapping = std::any_of(moves.begin(), moves.end(), [&](const Move& move) {
+					return std::any_of(moves.begin(), moves.end(), [&](const Move& other) { return other.source == move.destination; });
+				});
+
+				if (!overlapping) {
+					for (const auto& move : moves) {
+						this->move(move.destination, move.source);
+					}
+					return;
+				}
+
+				for (size_t i = 0; i < moves.size(); i++) {
+					load(Register::Rax, moves[i].source);
+					assembler_.store(frame_offset(allocation_.spill_slots + i), Register::Rax);
+				}
+				for (size_t i = 0; i < moves.size(); i++) {
+					assembler_.load(Register::Rax, frame_offset(allocation_.spill_slots + i));
+					store(moves[i].destination, Register::Rax);
+				}
+			}
+
+			[[nodiscard]] bool has_moves(const ir::BlockId to) const {
+				return function_.blocks[to].phi_count > 0;
+			}
+
+			void jump(const ir::BlockId to, const ir::BlockId next) {
+				if (to != next) {
+					assembler_.jmp(blocks_[to]);
+				}
+			}
+
+			void terminator(const ir::BlockId b, const ir::BlockId next) {
+				const auto& terminator = function_.blocks[b].terminator;
+
+				switch (terminator.kind) {
+					case ir::TerminatorKind::Jump: {
+						edge(b, terminator.targets[0]);
+						jump(terminator.targets[0], next);
+						break;
+					}
+					case ir::TerminatorKind::Branch: {
+						const auto [taken, fallthrough] = terminator.targets;
+						load(Register::Rax, terminator.value);
+						assembler_.test(Register::Rax, Register::Rax);
+
+						if (has_moves(taken)) {
+							const auto otherwise = assembler_.create_label();
+							assembler_.jcc(Condition::Equal, otherwise);
+							edge(b, taken);
+							assembler_.jmp(blocks_[taken]);
+							assembler_.bind(otherwise);
+						} else {
+							assembler_.jcc(Condition::NotEqual, blocks_[taken]);
+						}
+
+						edge(b, fallthrough);
+						jump(fallthrough, next);
+						break;
+					}
+					case ir::TerminatorKind::Return: {
+						if (terminator.value != ir::no_value) {
+							load(Register::Rax, terminator.value);
+							if (function_.result == ir::Type::F64) {
+								assembler_.movq(XmmRegister::Xmm0, Register::Rax);
+							}
+						}
+						epilogue();
+						break;
+					}
+					case ir::TerminatorKind::None: break;
+				}
+			}
+		public:
+			FunctionEmitter(Assembler& assembler, const std::vector<Label>& functions, const std::vector<const void*>& entries,
+				std::vector<ObjectRelocation>& relocations, const std::optional<CodeGenerator::StackLimit>& stack_limit,
+				const ir::Module& module, const ir::Function& function)
+				: assembler_(assembler), functions_(functions), entries_(entries), relocations_(relocations), stack_limit_(stack_limit),
+				  module_(module), function_(function),
+				  allocation_(allocate_registers(function)) {
+				for (const auto& block : function.blocks) {
+					temporaries_ = std::max(temporaries_, block.phi_count);
+				}
+			}
+
+			void emit() {
+				blocks_.clear();
+				for (size_t i = 0; i < function_.blocks.size(); i++) {
+					blocks_.push_back(assembler_.create_label());
+				}
+
+				prologue();
+
+				const auto& order = allocation_.order;
+				for (size_t i = 0; i < order.size(); i++) {
+					const auto b = order[i];
+					assembler_.bind(blocks_[b]);
+
+					for (const auto id : function_.blocks[b].instructions) {
+						instruction(id);
+					}
+					terminator(b, i + 1 < order.size() ? order[i + 1] : ir::no_block);
+				}
+			}
+		};
+	}
+
+	ObjectCode CodeGenerator::generate(const ir::Module& module) {
+		std::vector<ir::FunctionId> all(module.functions.size());
+		for (ir::FunctionId id = 0; id < all.size(); id++) {
+			all[id] = id;
+		}
+		return generate(module, all);
+	}
+
+	ObjectCode CodeGenerator::generate(const ir::Module& module, const std::vector<ir::FunctionId>& roots,
+		const std::vector<const void*>& entries) {
+		const auto loaded = [&](const ir::FunctionId id) { return id < entries.size() && entries[id]; };
+
+		// calls are resolved within the code, so every callee not yet loaded has to be included
+		std::vector<bool> included(module.functions.size(), false);
+		std::vector<ir::FunctionId> worklist;
+		for (const auto root : roots) {
+			if (!included[root]) {
+				included[root] = true;
+				worklist.push_back(root);
+			}
+		}
+		while (!worklist.empty()) {
+			const auto& function = module.functions[worklist.back()];
+			worklist.pop_back();
+
+			for (const auto& block : function.blocks) {
+				for (const auto id : block.instructions) {
+					const auto& value = function.values[id];
+					if (value.op == ir::Opcode::Call && !included[value.immediate.index] && !loaded(value.immediate.index)) {
+						included[value.immediate.index] = true;
+						worklist.push_back(value.immediate.index);
+					}
+				}
+			}
+		}
+
+		Assembler assembler;
+		ObjectCode object;
+
+		std::vector<Label> functions;
+		for (size_t i = 0; i < module.functions.size(); i++) {
+			functions.push_back(assembler.create_label());
+		}
+
+		for (ir::FunctionId id = 0; id < module.functions.size(); id++) {
+			// functions of other modules are left to the linker
+			const auto& function = module.functions[id];
+			if (!included[id] || function.blocks.empty()) {
+				continue;
+			}
+
+			assembler.bind(functions[id]);
+			const auto start = assembler.size();
+
+			FunctionEmitter emitter(assembler, functions, entries, object.relocations, stack_limit_, module, function);
+			emitter.emit();
+
+			object.symbols.push_back(ObjectSymbol { function.name, start, assembler.size() - start });
+		}
+
+		object.text = assembler.finish();
+		return object;
+	}
+}
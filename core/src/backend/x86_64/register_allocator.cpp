@@ -0,0 +1,218 @@
+#include "backend/x86_64/register_allocator.h"
+
+#include <algorithm>
+
+#include "ir/analysis.h"
+
+namespace seam::backend::x86_64 {
+	namespace {
+		struct Interval {
+			ir::ValueId value;
+			size_t start;
+			size_t end;
+		};
+
+		size_t phi_operand_index(const ir::Block& block, const ir::BlockId predecessor) {
+			return static_cast<size_t>(std::find(block.predecessors.begin(), block.predecessors.end(), predecessor) - block.predecessors.begin());
+		}
+	}
+
+	Allocation allocate_registers(const ir::Function& function) {
+		Allocation allocation;
+		allocation.locations.resize(function.values.size());
+		if (function.blocks.empty()) {
+			return allocation;
+		}
+
+		const ir::DominatorTree dominators(function);
+		allocation.order = dominators.reverse_postorder();
+		const auto& order = allocation.order;
+
+		// number the program points, phis and parameters are defined at their block's start
+		constexpr auto unplaced = SIZE_MAX;
+		std::vector<size_t> block_start(function.blocks.size()), block_end(function.blocks.size());
+		std::vector<size_t> definition(function.values.size(), unplaced);
+
+		size_t position = 0;
+		for (const auto b : order) {
+			const auto& block = function.blocks[b];
+			block_start[b] = position++;
+
+			for (size_t i = 0; i < block.instructions.size(); i++) {
+				const auto id = block.instructions[i];
+				const auto op = function.values[id].op;
+				definition[id] = i < block.phi_count || op == ir::Opcode::Param ? block_start[b] : position++;
+			}
+			block_end[b] = position++;
+		}
+
+		// live-in sets, iterated to a fixed point in reverse layout order. The
+		// sets are sorted lists, a block has far fewer live values than the function has
+		const auto value_count = function.values.size();
+		std::vector<std::vector<ir::ValueId>> live_in(function.blocks.size());
+		std::vector<std::vector<ir::ValueId>> live_out(function.blocks.size());
+
+		// the set being built, cleared again after every block
+		std::vector<bool> live(value_count, false);
+		std::vector<ir::ValueId> members;
+		const auto add = [&](const ir::ValueId value) {
+			if (!live[value]) {
+				live[value] = true;
+				members.push_back(value);
+			}
+		};
+		const auto collect = [&] {
+			std::vector<ir::ValueId> set;
+			for (const auto value : members) {
+				if (live[value]) {
+					set.push_back(value);
+				}
+			}
+			std::sort(set.begin(), set.end());
+			set.erase(std::unique(set.begin(), set.end()), set.end());
+			return set;
+		};
+
+		auto changed = true;
+		while (changed) {
+			changed = false;
+
+			for (auto it = order.rbegin(); it != order.rend(); ++it) {
+				const auto b = *it;
+				const auto& block = function.blocks[b];
+
+				members.clear();
+				for (const auto successor : ir::successors(block)) {
+					const auto& target = function.blocks[successor];
+					for (const auto value : live_in[successor]) {
+						add(value);
+					}
+
+					const auto index = phi_operand_index(target, b);
+					for (size_t i = 0; i < target.phi_count; i++) {
+						add(function.values[target.instructions[i]].operands[index]);
+					}
+				}
+				live_out[b] = collect();
+
+				if (block.terminator.value != ir::no_value) {
+					add(block.terminator.value);
+				}
+				for (auto i = block.instructions.size(); i-- > 0;) {
+					const auto id = block.instructions[i];
+					live[id] = false;
+					if (i >= block.phi_count) {
+						for (const auto operand : function.values[id].operands) {
+							add(operand);
+						}
+					}
+				}
+
+				auto set = collect();
+				for (const auto value : members) {
+					live[value] = false;
+				}
+				if (set != live_in[b]) {
+					live_in[b] = std::move(set);
+					changed = true;
+				}
+			}
+		}
+
+		// one conservative interval per value, holes are not tracked
+		std::vector<Interval> intervals;
+		std::vector<size_t> interval_of(value_count, unplaced);
+		for (ir::ValueId v = 0; v < value_count; v++) {
+			if (definition[v] != unplaced && function.values[v].type != ir::Type::None) {
+				interval_of[v] = intervals.size();
+				intervals.push_back(Interval { v, definition[v], definition[v] });
+			}
+		}
+
+		const auto extend = [&](const ir::ValueId value, const size_t point) {
+			auto& interval = intervals[interval_of[value]];
+			interval.start = std::min(interval.start, point);
+			interval.end = std::max(interval.end, point);
+		};
+
+		for (const auto b : order) {
+			const auto& block = function.blocks[b];
+
+			for (size_t i = block.phi_count; i < block.instructions.size(); i++) {
+				const auto id = block.instructions[i];
+				for (const auto operand : function.values[id].operands) {
+					extend(operand, definition[id]);
+				}
+			}
+			if (block.terminator.value != ir::no_value) {
+				extend(block.terminator.value, block_end[b]);
+			}
+			for (const auto successor : ir::successors(block)) {
+				const auto& target = function.blocks[successor];
+				const auto index = phi_operand_index(target, b);
+				for (size_t i = 0; i < target.phi_count; i++) {
+					extend(function.values[target.instructions[i]].operands[index], block_end[b]);
+				}
+			}
+
+			for (const auto v : live_in[b]) {
+				if (interval_of[v] != unplaced) extend(v, block_start[b]);
+			}
+			for (const auto v : live_out[b]) {
+				if (interval_of[v] != unplaced) extend(v, block_end[b]);
+			}
+		}
+
+		std::sort(intervals.begin(), intervals.end(), [](const Interval& a, const Interval& b) {
+			return a.start != b.start ? a.start < b.start : a.value < b.value;
+		});
+
+		// active intervals ordered by increasing end
+		std::vector<const Interval*> active;
+		std::vector<Register> free(std::rbegin(allocatable_registers), std::rend(allocatable_registers));
+		std::vector<bool> used(16, false);
+
+		const auto spill = [&](const ir::ValueId value) {
+			allocation.locations[value] = Location { Location::Kind::Stack, Register::Rax, static_cast<uint32_t>(allocation.spill_slots++) };
+		};
+		const auto activate = [&](const Interval& interval, const Register reg) {
+			allocation.locations[interval.value] = Location { Location::Kind::Register, reg, 0 };
+			used[static_cast<size_t>(reg)] = true;
+			active.insert(std::upper_bound(active.begin(), active.end(), interval.end,
+				[](const size_t end, const Interval* other) { return end < other->end; }), &interval);
+		};
+
+		for (const auto& interval : intervals) {
+			// an interval ending where another starts keeps its register, values defined together must differ
+			while (!active.empty() && active.front()->end < interval.start) {
+				free.push_back(allocation.locations[active.front()->value].reg);
+				active.erase(active.begin());
+			}
+
+			if (!free.empty()) {
+				const auto reg = free.back();
+				free.pop_back();
+				activate(interval, reg);
+				continue;
+			}
+
+			const auto* last = active.back();
+			if (last->end > interval.end) {
+				const auto reg = allocation.locations[last->value].reg;
+				spill(last->value);
+				active.pop_back();
+				activate(interval, reg);
+			} else {
+				spill(interval.value);
+			}
+		}
+
+		for (const auto reg : allocatable_registers) {
+			if (used[static_cast<size_t>(reg)]) {
+				allocation.used_registers.push_back(reg);
+			}
+		}
+
+		return allocation;
+	}
+}
@@ -0,0 +1,31 @@
+#include "diagnostic.h"
+
+#include <fmt/format.h>
+
+#include "localisation/localisation.h"
+
+namespace seam {
+	std::string format_diagnostic(const DiagnosticCode code, const std::string& argument, const std::string& second_argument) {
+		switch (code) {
+		case DiagnosticCode::None: return "";
+		case DiagnosticCode::UnexpectedEof: return fmt::format(fmt::runtime(LEX_UNEXPECTED_EOF_EXCEPTION_FMT), argument);
+		case DiagnosticCode::MalformedNumberLiteral: return LEX_MALFORMED_NUMBER_LITERAL;
+		case DiagnosticCode::ExpectedHexDigit: return fmt::format(fmt::runtime(EXPECTED_BUT_GOT), "hex-digit", argument);
+		case DiagnosticCode::ExpectedDigit: return fmt::format(fmt::runtime(EXPECTED_BUT_GOT), "digit", argument);
+		case DiagnosticCode::MalformedFloatTwoPoints: return fmt::format(fmt::runtime(LEX_MALFORMED_FLOATING_POINT_NUMBER_LITERAL), LEX_MALFORMED_FLOAT_TWO_POINTS);
+		case DiagnosticCode::UnknownSymbol: return fmt::format(fmt::runtime(LEX_UNKNOWN_SYMBOL), argument);
+		case DiagnosticCode::IntegerLiteralOverflow: return fmt::format(fmt::runtime(LITERAL_INTEGER_OVERFLOW), argument);
+		case DiagnosticCode::FloatLiteralOverflow: return fmt::format(fmt::runtime(LITERAL_FLOAT_OVERFLOW), argument);
+		case DiagnosticCode::UndefinedIdentifier: return fmt::format(fmt::runtime(SEMA_UNDEFINED_IDENTIFIER), argument);
+		case DiagnosticCode::Redeclaration: return fmt::format(fmt::runtime(SEMA_REDECLARATION), argument);
+		case DiagnosticCode::NotCallable: return fmt::format(fmt::runtime(SEMA_NOT_CALLABLE), argument);
+		case DiagnosticCode::UnknownType: return fmt::format(fmt::runtime(TYPE_UNKNOWN_TYPE), argument);
+		case DiagnosticCode::TypeMismatch: return fmt::format(fmt::runtime(TYPE_MISMATCH), argument, second_argument);
+		case DiagnosticCode::InvalidOperands: return fmt::format(fmt::runtime(TYPE_INVALID_OPERANDS), argument, second_argument);
+		case DiagnosticCode::NotAssignable: return fmt::format(fmt::runtime(TYPE_NOT_ASSIGNABLE), argument);
+		case DiagnosticCode::ArgumentCountMismatch: return fmt::format(fmt::runtime(TYPE_ARGUMENT_COUNT_MISMATCH), argument, second_argument);
+		case DiagnosticCode::CyclicTypeAlias: return fmt::format(fmt::runtime(TYPE_CYCLIC_ALIAS), argument);
+		}
+		return "";
+	}
+}
@@ -0,0 +1,365 @@
+#include <driver/build.h>
+#include <driver/build_cache.h>
+#include <driver/hash.h>
+#include <exception.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <thread>
+
+namespace seam::driver {
+	namespace {
+		constexpr auto source_extension = ".seam";
+		constexpr auto interface_extension = ".smi";
+
+		struct Unit {
+			ModuleFile file;
+			// recorded by the last build under the same options
+			const ManifestEntry* entry = nullptr;
+			bool unchanged = false;
+			bool failed = false;
+
+			// stamp taken before the text was read
+			FileStamp source_stamp;
+			std::optional<std::string> text;
+			std::string hash;
+
+			// derived from the source, carried over from the manifest while its hash holds
+			std::vector<std::string> imports;
+			std::string interface_hash;
+
+			std::optional<ParsedUnit> parsed;
+			std::optional<ModuleInterface> interface;
+			std::string key;
+
+			std::vector<const Unit*> imported;
+			CompileResult result;
+		};
+
+		std::string module_name(std::filesystem::path relative) {
+			auto name = relative.replace_extension().generic_string();
+			std::replace(name.begin(), name.end(), '/', '.');
+			return name;
+		}
+
+		bool up_to_date(const ManifestEntry& entry) {
+			if (entry.dependencies.empty()) {
+				return false;
+			}
+			for (const auto& dependency : entry.dependencies) {
+				if (!FileStamp::matches(FileStamp::of(dependency.path), dependency.stamp)) {
+					return false;
+				}
+			}
+			return FileStamp::matches(FileStamp::of(entry.output), entry.output_stamp);
+		}
+
+		void read(Unit& unit, TimeReport& report) {
+			TimeReport::Timer timer(report, "hash");
+
+			const auto stamp = FileStamp::of(unit.file.source);
+			if (!stamp) {
+				throw DriverException("cannot read " + unit.file.source.string());
+			}
+			unit.source_stamp = *stamp;
+			unit.text = read_file(unit.file.source);
+			unit.hash = sha256(*unit.text);
+		}
+
+		void parse(Unit& unit, TimeReport& report) {
+			if (!unit.text) {
+				unit.text = read_file(unit.file.source);
+			}
+			unit.parsed = driver::parse(unit.file.source.string(), *unit.text, report);
+
+			if (const auto& program = unit.parsed->program) {
+				unit.interface = ModuleInterface::of(*program);
+				unit.interface_hash = unit.interface->hash();
+
+				unit.imports.clear();
+				for (const auto& import : program->imports) {
+					unit.imports.push_back(import.module);
+				}
+			}
+		}
+	}
+
+	std::vector<ModuleFile> find_modules(const BuildOptions& options) {
+		const auto extension = output_extension(options.compile.emit);
+
+		std::vector<ModuleFile> modules;
+		const auto add = [&](const std::filesystem::path& source, std::filesystem::path relative) {
+			auto name = module_name(relative);
+			auto output = options.output_directory / relative.replace_extension(extension);
+			auto interface = std::filesystem::path(output).replace_extension(interface_extension);
+			modules.push_back(ModuleFile { source, std::move(output), std::move(interface), std::move(name) });
+		};
+
+		for (const auto& input : options.inputs) {
+			std::error_code error;
+			if (std::filesystem::is_directory(input, error)) {
+				std::vector<std::filesystem::path> sources;
+				for (const auto& entry : std::filesystem::recursive_directory_iterator(input)) {
+					if (entry.is_regular_file() && entry.path().extension() == source_extension) {
+						sources.push_back(entry.path());
+					}
+				}
+				std::sort(sources.begin(), sources.end());
+				for (const auto& source : sources) {
+					add(source, source.lexically_relative(input));
+				}
+			} else if (std::filesystem::is_regular_file(input, error)) {
+				add(input, input.filename());
+			} else {
+				throw DriverException("no such file or directory: " + input.string());
+			}
+		}
+
+		// outputs are named after modules, so clashing outputs are clashing modules
+		std::map<std::filesystem::path, const ModuleFile*> outputs;
+		for (const auto& module : modules) {
+			const auto [it, added] = outputs.emplace(module.output, &module);
+			if (!added) {
+				throw DriverException(it->second->source.string() + " and " + module.source.string()
+					+ " would both be compiled to " + module.output.string());
+			}
+		}
+		return modules;
+	}
+
+	std::string module_key(const std::string& fingerprint, const std::string& hash, const std::vector<std::pair<std::string, std::string>>& imports) {
+		Sha256 hasher;
+		hasher.update(fingerprint);
+		hasher.update(std::string_view("\0", 1));
+		hasher.update(hash);
+		for (const auto& [name, interface] : imports) {
+			hasher.update(std::string_view("\0", 1));
+			hasher.update(name);
+			hasher.update(std::string_view("\0", 1));
+			hasher.update(interface);
+		}
+		return hasher.hex();
+	}
+
+	BuildResult build(const BuildOptions& options, TimeReport& report) {
+		const auto racy_since = FileStamp::racy_since();
+
+		const auto fingerprint = options.compile.fingerprint();
+		const auto state_directory = options.output_directory / ".seamc";
+		const auto manifest_path = state_directory / "manifest";
+		const ObjectStore store(options.cache_directory.empty() ? state_directory / "cache" : options.cache_directory);
+
+		std::vector<Unit> units;
+		std::map<std::string, Unit*> modules;
+		{
+			TimeReport::Timer timer(report, "scan");
+			for (auto& file : find_modules(options)) {
+				units.push_back(Unit { std::move(file) });
+			}
+			for (auto& unit : units) {
+				modules.emplace(unit.file.name, &unit);
+			}
+		}
+
+		Manifest previous;
+		{
+			TimeReport::Timer timer(report, "load");
+			previous = Manifest::load(manifest_path);
+		}
+
+		BuildResult result;
+		Manifest manifest;
+		auto changed = false;
+
+		for (auto& unit : units) {
+			TimeReport::Timer timer(report, "stat");
+
+			const auto entry = previous.find(unit.file.output);
+			unit.entry = entry && entry->fingerprint == fingerprint ? entry : nullptr;
+			if (unit.entry && up_to_date(*unit.entry)) {
+				const auto& source = unit.entry->dependencies.front();
+				unit.unchanged = true;
+				unit.source_stamp = source.stamp;
+				unit.hash = source.hash;
+				unit.imports = unit.entry->imports;
+				unit.interface_hash = unit.entry->interface;
+
+				manifest.set(*unit.entry);
+				result.unchanged++;
+			}
+		}
+
+		// imports and interfaces follow from the source, so they are only parsed out of changed sources
+		for (auto& unit : units) {
+			if (unit.unchanged) {
+				continue;
+			}
+			read(unit, report);
+
+			if (unit.entry && unit.entry->dependencies.front().hash == unit.hash) {
+				unit.imports = unit.entry->imports;
+				unit.interface_hash = unit.entry->interface;
+			} else {
+				parse(unit, report);
+			}
+		}
+
+		const auto record = [&](const Unit& unit) {
+			const auto output_stamp = FileStamp::of(unit.file.output);
+			if (!output_stamp) {
+				throw DriverException("cannot write " + unit.file.output.string());
+			}
+
+			// an interface parsed out of the source is kept for importers in later builds
+			if (unit.interface) {
+				write_file(unit.file.interface, unit.interface->encode());
+			}
+
+			ManifestEntry entry { unit.file.output, *output_stamp, fingerprint, unit.key, unit.interface_hash, unit.imports };
+			entry.dependencies.push_back(Dependency { unit.file.source, unit.source_stamp.trusted(racy_since), unit.hash });
+			for (const auto imported : unit.imported) {
+				entry.dependencies.push_back(Dependency { imported->file.source, imported->source_stamp.trusted(racy_since), imported->hash });
+			}
+			manifest.set(std::move(entry));
+			changed = true;
+		};
+
+		const auto fail = [&](Unit& unit, const std::vector<std::string>& diagnostics) {
+			unit.failed = true;
+			result.failed++;
+			result.diagnostics.insert(result.diagnostics.end(), diagnostics.begin(), diagnostics.end());
+			changed = true;
+		};
+
+		std::vector<Unit*> pending;
+		for (auto& unit : units) {
+			if (unit.unchanged) {
+				continue;
+			}
+			if (unit.parsed && !unit.parsed->program) {
+				fail(unit, unit.parsed->diagnostics);
+				continue;
+			}
+
+			std::vector<std::pair<std::string, std::string>> imports;
+			for (const auto& name : unit.imports) {
+				const auto it = modules.find(name);
+				if (it != modules.end()) {
+					unit.imported.push_back(it->second);
+				}
+				imports.emplace_back(name, it != modules.end() ? it->second->interface_hash : "");
+			}
+			unit.key = module_key(fingerprint, unit.hash, imports);
+
+			if (unit.entry && unit.entry->key == unit.key && FileStamp::matches(FileStamp::of(unit.file.output), unit.entry->output_stamp)) {
+				record(unit);
+				result.rehashed++;
+				continue;
+			}
+
+			{
+				TimeReport::Timer timer(report, "restore");
+				if (const auto cached = store.load(unit.key)) {
+					write_file(unit.file.output, *cached);
+					record(unit);
+					result.restored++;
+					continue;
+				}
+			}
+			pending.push_back(&unit);
+		}
+
+		// modules compiled against an unchanged module need its interface after all, from its interface file if it is there
+		std::vector<std::vector<const ModuleInterface*>> interfaces(pending.size());
+		for (size_t i = 0; i < pending.size(); i++) {
+			auto& unit = *pending[i];
+			if (!unit.parsed) {
+				parse(unit, report);
+			}
+
+			for (const auto& import : unit.parsed->program->imports) {
+				const auto it = modules.find(import.module);
+				if (it == modules.end()) {
+					interfaces[i].push_back(nullptr);
+					continue;
+				}
+
+				auto& imported = *it->second;
+				if (!imported.parsed && !imported.interface) {
+					if (!imported.interface_hash.empty()) {
+						TimeReport::Timer timer(report, "interface");
+						imported.interface = ModuleInterface::load(imported.file.interface, imported.interface_hash);
+					}
+					if (!imported.interface) {
+						parse(imported, report);
+						if (imported.interface) {
+							write_file(imported.file.interface, imported.interface->encode());
+						}
+					}
+				}
+				interfaces[i].push_back(imported.interface ? &*imported.interface : nullptr);
+			}
+		}
+
+		auto threads = options.threads == 0 ? std::max<size_t>(std::thread::hardware_concurrency(), 1) : options.threads;
+		threads = std::min(threads, pending.size());
+
+		std::atomic<size_t> next = 0;
+		std::vector<std::exception_ptr> errors(threads);
+		const auto worker = [&](const size_t index) {
+			try {
+				for (auto i = next++; i < pending.size(); i = next++) {
+					auto& unit = *pending[i];
+					// modules importing a module that does not parse report nothing of their own
+					const auto broken = std::any_of(unit.imported.begin(), unit.imported.end(), [](const Unit* imported) {
+						return !imported->interface;
+					});
+					if (!broken) {
+						unit.result = compile(*unit.parsed, interfaces[i], options.compile, report);
+					}
+				}
+			} catch (...) {
+				errors[index] = std::current_exception();
+			}
+		};
+
+		std::vector<std::thread> pool;
+		for (size_t i = 1; i < threads; i++) {
+			pool.emplace_back(worker, i);
+		}
+		if (threads > 0) {
+			worker(0);
+		}
+		for (auto& thread : pool) {
+			thread.join();
+		}
+		for (const auto& error : errors) {
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+
+		for (const auto unit : pending) {
+			if (!unit->result.output) {
+				fail(*unit, unit->result.diagnostics);
+				continue;
+			}
+
+			TimeReport::Timer timer(report, "write");
+			store.store(unit->key, *unit->result.output);
+			write_file(unit->file.output, *unit->result.output);
+			record(*unit);
+			result.compiled++;
+		}
+
+		// outputs no longer built are dropped from the manifest
+		if (changed || manifest.size() != previous.size()) {
+			TimeReport::Timer timer(report, "save");
+			manifest.save(manifest_path);
+		}
+
+		return result;
+	}
+}
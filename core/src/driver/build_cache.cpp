@@ -0,0 +1,264 @@
+#include <driver/build_cache.h>
+#include <exception.h>
+
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace seam::driver {
+	namespace {
+		constexpr auto manifest_header = "seamc manifest 2";
+
+		constexpr std::chrono::seconds racy_window { 1 };
+
+		std::string describe(const std::filesystem::path& path) {
+			return path.string();
+		}
+	}
+
+	std::optional<FileStamp> FileStamp::of(const std::filesystem::path& path) {
+		std::error_code error;
+		const auto size = std::filesystem::file_size(path, error);
+		if (error) {
+			return std::nullopt;
+		}
+		const auto modified = std::filesystem::last_write_time(path, error);
+		if (error) {
+			return std::nullopt;
+		}
+		return FileStamp { size, std::chrono::duration_cast<std::chrono::nanoseconds>(modified.time_since_epoch()).count() };
+	}
+
+	FileStamp FileStamp::trusted(const int64_t racy_since) const {
+		auto stamp = *this;
+		if (stamp.modified >= racy_since) {
+			stamp.modified = unknown_time;
+		}
+		return stamp;
+	}
+
+	int64_t FileStamp::racy_since() {
+		const auto since = std::filesystem::file_time_type::clock::now() - racy_window;
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(since.time_since_epoch()).count();
+	}
+
+	bool FileStamp::matches(const std::optional<FileStamp>& stamp, const FileStamp& recorded) {
+		return stamp && recorded.modified != unknown_time && *stamp == recorded;
+	}
+
+	Manifest Manifest::load(const std::filesystem::path& path) {
+		Manifest manifest;
+
+		std::ifstream in(path, std::ios::binary);
+		std::string line;
+		if (!std::getline(in, line) || line != manifest_header) {
+			return manifest;
+		}
+
+		// unit <key> <interface> <fingerprint> <size> <modified> <output>, then its imports and dependencies:
+		// import <module> and dep <hash> <size> <modified> <path>; paths come last as they may contain spaces
+		ManifestEntry* current = nullptr;
+		while (std::getline(in, line)) {
+			std::istringstream fields(line);
+			std::string kind;
+			fields >> kind;
+
+			if (kind == "unit") {
+				ManifestEntry entry;
+				fields >> entry.key >> entry.interface >> std::quoted(entry.fingerprint) >> entry.output_stamp.size >> entry.output_stamp.modified;
+				std::string output;
+				fields.ignore(1);
+				if (!std::getline(fields, output) || output.empty()) {
+					return {};
+				}
+				entry.output = output;
+				auto [it, added] = manifest.entries_.insert_or_assign(output, std::move(entry));
+				current = &it->second;
+			} else if (kind == "import" && current) {
+				std::string module;
+				fields >> module;
+				if (module.empty()) {
+					return {};
+				}
+				current->imports.push_back(std::move(module));
+			} else if (kind == "dep" && current) {
+				Dependency dependency;
+				fields >> dependency.hash >> dependency.stamp.size >> dependency.stamp.modified;
+				std::string dependency_path;
+				fields.ignore(1);
+				if (!std::getline(fields, dependency_path) || dependency_path.empty()) {
+					return {};
+				}
+				dependency.path = dependency_path;
+				current->dependencies.push_back(std::move(dependency));
+			} else {
+				return {};
+			}
+		}
+		return manifest;
+	}
+
+	void Manifest::save(const std::filesystem::path& path) const {
+		std::ostringstream out;
+		out << manifest_header << '\n';
+		for (const auto& [output, entry] : entries_) {
+			out << "unit " << entry.key << ' ' << entry.interface << ' ' << std::quoted(entry.fingerprint) << ' '
+				<< entry.output_stamp.size << ' ' << entry.output_stamp.modified << ' ' << output << '\n';
+			for (const auto& module : entry.imports) {
+				out << "import " << module << '\n';
+			}
+			for (const auto& dependency : entry.dependencies) {
+				out << "dep " << dependency.hash << ' ' << dependency.stamp.size << ' ' << dependency.stamp.modified << ' '
+					<< dependency.path.string() << '\n';
+			}
+		}
+		write_file(path, out.str());
+	}
+
+	const ManifestEntry* Manifest::find(const std::filesystem::path& output) const {
+		const auto it = entries_.find(output.string());
+		return it == entries_.end() ? nullptr : &it->second;
+	}
+
+	void Manifest::set(ManifestEntry entry) {
+		auto output = entry.output.string();
+		entries_.insert_or_assign(std::move(output), std::move(entry));
+	}
+
+	void Manifest::erase(const std::filesystem::path& output) {
+		entries_.erase(output.string());
+	}
+
+	std::filesystem::path ObjectStore::path_of(const std::string& key) const {
+		// fan out, so no directory holds every object
+		return directory_ / key.substr(0, 2) / key.substr(2);
+	}
+
+	std::optional<std::string> ObjectStore::load(const std::string& key) const {
+		std::ifstream in(path_of(key), std::ios::binary);
+		if (!in) {
+			return std::nullopt;
+		}
+		std::ostringstream contents;
+		contents << in.rdbuf();
+		return std::move(contents).str();
+	}
+
+	void ObjectStore::store(const std::string& key, const std::string_view contents) const {
+		write_file(path_of(key), contents);
+	}
+
+	std::optional<MappedFile> MappedFile::open(const std::filesystem::path& path) {
+		MappedFile file;
+#ifdef _WIN32
+		std::ifstream in(path, std::ios::binary);
+		if (!in) {
+			return std::nullopt;
+		}
+		std::ostringstream contents;
+		contents << in.rdbuf();
+		file.contents_ = std::move(contents).str();
+		file.data_ = file.contents_.data();
+		file.size_ = file.contents_.size();
+#else
+		const auto descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (descriptor < 0) {
+			return std::nullopt;
+		}
+
+		struct stat status {};
+		if (fstat(descriptor, &status) != 0) {
+			close(descriptor);
+			return std::nullopt;
+		}
+
+		// empty files cannot be mapped, and need not be
+		if (status.st_size > 0) {
+			const auto size = static_cast<size_t>(status.st_size);
+			const auto data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (data == MAP_FAILED) {
+				close(descriptor);
+				return std::nullopt;
+			}
+			file.data_ = static_cast<const char*>(data);
+			file.size_ = size;
+		}
+		close(descriptor);
+#endif
+		return file;
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept {
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			release();
+#ifdef _WIN32
+			contents_ = std::move(other.contents_);
+			data_ = contents_.data();
+#else
+			data_ = std::exchange(other.data_, nullptr);
+#endif
+			size_ = std::exchange(other.size_, 0);
+		}
+		return *this;
+	}
+
+	MappedFile::~MappedFile() {
+		release();
+	}
+
+	void MappedFile::release() {
+#ifndef _WIN32
+		if (data_) {
+			munmap(const_cast<char*>(data_), size_);
+		}
+#endif
+		data_ = nullptr;
+		size_ = 0;
+	}
+
+	std::string read_file(const std::filesystem::path& path) {
+		std::ifstream in(path, std::ios::binary);
+		if (!in) {
+			throw DriverException("cannot read " + describe(path));
+		}
+		std::ostringstream contents;
+		contents << in.rdbuf();
+		return std::move(contents).str();
+	}
+
+	void write_file(const std::filesystem::path& path, const std::string_view contents) {
+		std::error_code error;
+		if (path.has_parent_path()) {
+			std::filesystem::create_directories(path.parent_path(), error);
+		}
+
+		// unique per writer, concurrent builds may write the same object
+		auto temporary = path;
+		temporary += ".tmp" + std::to_string(std::random_device()());
+		{
+			std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+			out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+			if (!out) {
+				throw DriverException("cannot write " + describe(path));
+			}
+		}
+		std::filesystem::rename(temporary, path, error);
+		if (error) {
+			std::filesystem::remove(temporary, error);
+			throw DriverException("cannot write " + describe(path));
+		}
+	}
+}
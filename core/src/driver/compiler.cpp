@@ -0,0 +1,174 @@
+#include <driver/compiler.h>
+
+#include <backend/object.h>
+#include <backend/x86_64/code_generator.h>
+#include <ast/c_emit_visitor.h>
+#include <ir/lowering.h>
+#include <ir/pass_manager.h>
+#include <parser/parser.h>
+#include <semantic/name_resolver.h>
+#include <semantic/type_checker.h>
+
+namespace seam::driver {
+	namespace {
+		// bump whenever the same source and options may produce a different output
+		constexpr auto compiler_version = "seamc 2";
+
+		std::string render(const std::string& path, const std::string& text, const SourcePosition position, const std::string& message) {
+			size_t line = 1, column = 1;
+			for (size_t i = 0; i < position.start_idx && i < text.size(); i++) {
+				if (text[i] == '\n') {
+					line++;
+					column = 1;
+				} else if (!is_utf8_continuation(text[i])) {
+					// columns count characters, not bytes
+					column++;
+				}
+			}
+			return path + ":" + std::to_string(line) + ":" + std::to_string(column) + ": error: " + message;
+		}
+
+		/**
+		 * Puts the declarations of imported modules in front of a
+		 * program's own, for as long as it is in scope.
+		 */
+		class ImportedDeclarations {
+			ast::Program& program_;
+			size_t count_ = 0;
+		public:
+			ImportedDeclarations(ast::Program& program, const std::vector<const ModuleInterface*>& imports)
+				: program_(program) {
+				ast::DeclarationList decls;
+				for (size_t i = 0; i < imports.size(); i++) {
+					auto imported = imports[i]->declarations(program.imports[i].position);
+					decls.insert(decls.end(), std::make_move_iterator(imported.begin()), std::make_move_iterator(imported.end()));
+				}
+				count_ = decls.size();
+				program.body.insert(program.body.begin(), std::make_move_iterator(decls.begin()), std::make_move_iterator(decls.end()));
+			}
+
+			~ImportedDeclarations() {
+				program_.body.erase(program_.body.begin(), program_.body.begin() + static_cast<ptrdiff_t>(count_));
+			}
+
+			ImportedDeclarations(const ImportedDeclarations&) = delete;
+			ImportedDeclarations& operator=(const ImportedDeclarations&) = delete;
+		};
+	}
+
+	std::string CompileOptions::fingerprint() const {
+		return std::string(compiler_version) + " emit=" + output_extension(emit) + (optimise ? " -O1" : " -O0");
+	}
+
+	const char* output_extension(const EmitKind emit) {
+		switch (emit) {
+			case EmitKind::Object: return ".o";
+			case EmitKind::C: return ".c";
+			case EmitKind::Ir: return ".ir";
+		}
+		return "";
+	}
+
+	ParsedUnit parse(const std::string& path, const std::string_view text, TimeReport& report) {
+		ParsedUnit unit { path };
+
+		{
+			TimeReport::Timer timer(report, "validate");
+			if (!is_valid_utf8(text)) {
+				unit.diagnostics.push_back(path + ": error: source is not valid UTF-8");
+				return unit;
+			}
+			unit.source = std::make_unique<Source>(std::string(text));
+		}
+
+		TimeReport::Timer timer(report, "parse");
+		try {
+			Parser parser(std::make_unique<Lexer>(unit.source.get()));
+			unit.program = parser.parse();
+		} catch (const SeamException& e) {
+			unit.diagnostics.push_back(render(path, unit.source->get(), e.position(), e.what()));
+		}
+		return unit;
+	}
+
+	CompileResult compile(const ParsedUnit& unit, const std::vector<const ModuleInterface*>& imports, const CompileOptions& options, TimeReport& report) {
+		CompileResult result;
+		auto& program = *unit.program;
+		const auto& text = unit.source->get();
+
+		for (size_t i = 0; i < program.imports.size(); i++) {
+			if (!imports[i]) {
+				result.diagnostics.push_back(render(unit.path, text, program.imports[i].position,
+					"no module named '" + program.imports[i].module + "'"));
+			}
+		}
+		if (!result.diagnostics.empty()) {
+			return result;
+		}
+
+		try {
+			const ImportedDeclarations imported(program, imports);
+
+			// units are compiled in parallel already
+			semantic::Context context;
+			{
+				TimeReport::Timer timer(report, "resolve");
+				semantic::NameResolver resolver(context);
+				program.accept(resolver);
+			}
+			{
+				TimeReport::Timer timer(report, "check");
+				semantic::TypeChecker checker(context, 1);
+				program.accept(checker);
+			}
+			if (context.has_errors()) {
+				for (const auto& diagnostic : context.diagnostics()) {
+					result.diagnostics.push_back(render(unit.path, text, diagnostic.position, diagnostic.message()));
+				}
+				return result;
+			}
+
+			if (options.emit == EmitKind::C) {
+				TimeReport::Timer timer(report, "emit");
+				ast::CEmitVisitor emitter(context);
+				program.accept(emitter);
+				result.output = emitter.str();
+				return result;
+			}
+
+			ir::Module module;
+			{
+				TimeReport::Timer timer(report, "lower");
+				ir::AstLowering lowering(context);
+				module = lowering.lower(program);
+			}
+			if (options.optimise) {
+				TimeReport::Timer timer(report, "optimise");
+				auto pipeline = ir::PassManager::standard_pipeline();
+				pipeline.run(module);
+			}
+
+			TimeReport::Timer timer(report, "emit");
+			if (options.emit == EmitKind::Ir) {
+				result.output = ir::print(module);
+			} else {
+				const auto object = backend::x86_64::CodeGenerator().generate(module);
+				const auto bytes = backend::write_elf_object(object);
+				result.output = std::string(bytes.begin(), bytes.end());
+			}
+		} catch (const CodegenException& e) {
+			result.diagnostics.push_back(unit.path + ": error: " + e.what());
+		} catch (const SeamException& e) {
+			result.diagnostics.push_back(render(unit.path, text, e.position(), e.what()));
+		}
+		return result;
+	}
+
+	CompileResult compile(const std::string& path, const std::string_view text, const CompileOptions& options, TimeReport& report) {
+		const auto unit = parse(path, text, report);
+		if (!unit.program) {
+			return CompileResult { std::nullopt, unit.diagnostics };
+		}
+		return compile(unit, std::vector<const ModuleInterface*>(unit.program->imports.size(), nullptr), options, report);
+	}
+}
@@ -0,0 +1,117 @@
+#include <driver/file_watcher.h>
+#include <exception.h>
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace seam::driver {
+#ifdef __linux__
+	namespace {
+		constexpr uint32_t watched_events = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+	}
+
+	FileWatcher::FileWatcher(const std::vector<std::filesystem::path>& directories)
+		: descriptor_(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)), roots_(directories) {
+		if (descriptor_ < 0) {
+			throw DriverException("cannot watch files, inotify is not available");
+		}
+		for (const auto& directory : directories) {
+			watch(directory);
+		}
+	}
+
+	FileWatcher::~FileWatcher() {
+		close(descriptor_);
+	}
+
+	void FileWatcher::watch(const std::filesystem::path& directory) {
+		const auto add = [&](const std::filesystem::path& path) {
+			const auto watch = inotify_add_watch(descriptor_, path.c_str(), watched_events);
+			if (watch < 0) {
+				throw DriverException("cannot watch " + path.string());
+			}
+			watches_[watch] = path;
+		};
+
+		add(directory);
+		std::error_code error;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+			if (entry.is_directory()) {
+				add(entry.path());
+			}
+		}
+	}
+
+	void FileWatcher::read_events(std::vector<std::filesystem::path>& changed) {
+		alignas(inotify_event) char buffer[16384];
+
+		while (true) {
+			const auto size = read(descriptor_, buffer, sizeof(buffer));
+			if (size <= 0) {
+				return;
+			}
+
+			for (ssize_t offset = 0; offset < size;) {
+				const auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+				if (event->mask & IN_Q_OVERFLOW) {
+					changed.insert(changed.end(), roots_.begin(), roots_.end());
+					continue;
+				}
+				if (event->mask & IN_IGNORED) {
+					watches_.erase(event->wd);
+					continue;
+				}
+
+				const auto directory = watches_.find(event->wd);
+				if (directory == watches_.end() || event->len == 0) {
+					continue;
+				}
+				const auto path = directory->second / event->name;
+
+				// files may land in a new directory before it is watched, it stands for them
+				if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+					watch(path);
+				}
+				changed.push_back(path);
+			}
+		}
+	}
+
+	std::vector<std::filesystem::path> FileWatcher::wait(const std::chrono::milliseconds timeout, const std::chrono::milliseconds settle) {
+		std::vector<std::filesystem::path> changed;
+
+		pollfd descriptor { descriptor_, POLLIN, 0 };
+		if (poll(&descriptor, 1, static_cast<int>(timeout.count())) <= 0) {
+			return changed;
+		}
+		do {
+			read_events(changed);
+		} while (poll(&descriptor, 1, static_cast<int>(settle.count())) > 0);
+
+		std::sort(changed.begin(), changed.end());
+		changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+		return changed;
+	}
+#else
+	FileWatcher::FileWatcher(const std::vector<std::filesystem::path>& directories) {
+		throw DriverException("watching files needs inotify, which this system does not have");
+	}
+
+	FileWatcher::~FileWatcher() = default;
+
+	void FileWatcher::watch(const std::filesystem::path& directory) {}
+
+	void FileWatcher::read_events(std::vector<std::filesystem::path>& changed) {}
+
+	std::vector<std::filesystem::path> FileWatcher::wait(const std::chrono::milliseconds timeout, const std::chrono::milliseconds settle) {
+		return {};
+	}
+#endif
+}
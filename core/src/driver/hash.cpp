@@ -0,0 +1,124 @@
+#include <driver/hash.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace seam::driver {
+	namespace {
+		constexpr uint32_t round_constants[64] = {
+			0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+			0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+			0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+			0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+			0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+			0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+			0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+			0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+		};
+
+		constexpr uint32_t rotate_right(const uint32_t value, const int bits) {
+			return (value >> bits) | (value << (32 - bits));
+		}
+	}
+
+	Sha256::Sha256()
+		: state_ { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 } {}
+
+	void Sha256::compress(const uint8_t* block) {
+		uint32_t w[64];
+		for (int i = 0; i < 16; i++) {
+			w[i] = static_cast<uint32_t>(block[i * 4]) << 24 | static_cast<uint32_t>(block[i * 4 + 1]) << 16
+				| static_cast<uint32_t>(block[i * 4 + 2]) << 8 | block[i * 4 + 3];
+		}
+		for (int i = 16; i < 64; i++) {
+			const auto s0 = rotate_right(w[i - 15], 7) ^ rotate_right(w[i - 15], 18) ^ (w[i - 15] >> 3);
+			const auto s1 = rotate_right(w[i - 2], 17) ^ rotate_right(w[i - 2], 19) ^ (w[i - 2] >> 10);
+			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+		}
+
+		auto [a, b, c, d, e, f, g, h] = state_;
+		for (int i = 0; i < 64; i++) {
+			const auto s1 = rotate_right(e, 6) ^ rotate_right(e, 11) ^ rotate_right(e, 25);
+			const auto choice = (e & f) ^ (~e & g);
+			const auto t1 = h + s1 + choice + round_constants[i] + w[i];
+			const auto s0 = rotate_right(a, 2) ^ rotate_right(a, 13) ^ rotate_right(a, 22);
+			const auto majority = (a & b) ^ (a & c) ^ (b & c);
+			const auto t2 = s0 + majority;
+
+			h = g;
+			g = f;
+			f = e;
+			e = d + t1;
+			d = c;
+			c = b;
+			b = a;
+			a = t1 + t2;
+		}
+
+		state_[0] += a;
+		state_[1] += b;
+		state_[2] += c;
+		state_[3] += d;
+		state_[4] += e;
+		state_[5] += f;
+		state_[6] += g;
+		state_[7] += h;
+	}
+
+	void Sha256::update(std::string_view data) {
+		length_ += data.size();
+
+		if (block_size_ > 0) {
+			const auto taken = std::min(data.size(), block_.size() - block_size_);
+			std::memcpy(block_.data() + block_size_, data.data(), taken);
+			block_size_ += taken;
+			data.remove_prefix(taken);
+			if (block_size_ < block_.size()) {
+				return;
+			}
+			compress(block_.data());
+			block_size_ = 0;
+		}
+
+		while (data.size() >= block_.size()) {
+			compress(reinterpret_cast<const uint8_t*>(data.data()));
+			data.remove_prefix(block_.size());
+		}
+
+		std::memcpy(block_.data(), data.data(), data.size());
+		block_size_ = data.size();
+	}
+
+	std::string Sha256::hex() {
+		const auto bits = length_ * 8;
+
+		// a one bit, zeros up to 56 bytes into the block and the length
+		block_[block_size_++] = 0x80;
+		if (block_size_ > 56) {
+			std::memset(block_.data() + block_size_, 0, block_.size() - block_size_);
+			compress(block_.data());
+			block_size_ = 0;
+		}
+		std::memset(block_.data() + block_size_, 0, 56 - block_size_);
+		for (int i = 0; i < 8; i++) {
+			block_[56 + i] = static_cast<uint8_t>(bits >> (56 - i * 8));
+		}
+		compress(block_.data());
+
+		constexpr char digits[] = "0123456789abcdef";
+		std::string result;
+		result.reserve(64);
+		for (const auto word : state_) {
+			for (int shift = 28; shift >= 0; shift -= 4) {
+				result += digits[(word >> shift) & 0xf];
+			}
+		}
+		return result;
+	}
+
+	std::string sha256(const std::string_view data) {
+		Sha256 hasher;
+		hasher.update(data);
+		return hasher.hex();
+	}
+}
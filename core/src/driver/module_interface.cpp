@@ -0,0 +1,217 @@
+#include <driver/build_cache.h>
+#include <driver/hash.h>
+#include <driver/module_interface.h>
+#include <source.h>
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace seam::driver {
+	namespace {
+		constexpr std::string_view interface_magic = "seamifc\x01";
+		constexpr size_t hash_length = 64;
+
+		/**
+		 * Interns names while encoding, each is written once.
+		 */
+		class NameTable {
+			std::unordered_map<std::string, uint32_t> indices_;
+			std::vector<const std::string*> names_;
+		public:
+			uint32_t intern(const std::string& name) {
+				const auto [it, added] = indices_.try_emplace(name, static_cast<uint32_t>(names_.size()));
+				if (added) {
+					names_.push_back(&it->first);
+				}
+				return it->second;
+			}
+
+			[[nodiscard]] const std::vector<const std::string*>& names() const { return names_; }
+		};
+
+		void write_u32(std::string& out, const uint32_t value) {
+			for (auto shift = 0; shift < 32; shift += 8) {
+				out += static_cast<char>(value >> shift & 0xff);
+			}
+		}
+
+		/**
+		 * Reads what write_u32() wrote, failing instead of reading past the end.
+		 */
+		class Reader {
+			std::string_view data_;
+		public:
+			explicit Reader(const std::string_view data)
+				: data_(data) {}
+
+			bool u32(uint32_t& value) {
+				if (data_.size() < 4) {
+					return false;
+				}
+				value = 0;
+				for (auto i = 0; i < 4; i++) {
+					value |= static_cast<uint32_t>(static_cast<unsigned char>(data_[i])) << i * 8;
+				}
+				data_.remove_prefix(4);
+				return true;
+			}
+
+			bool bytes(const size_t length, std::string_view& value) {
+				if (data_.size() < length) {
+					return false;
+				}
+				value = data_.substr(0, length);
+				data_.remove_prefix(length);
+				return true;
+			}
+
+			[[nodiscard]] bool done() const { return data_.empty(); }
+		};
+	}
+
+	ModuleInterface ModuleInterface::of(const ast::Program& program) {
+		ModuleInterface interface;
+
+		for (const auto& decl : program.body) {
+			if (const auto func = dynamic_cast<const ast::FunctionDeclaration*>(decl.get()); func && func->body) {
+				auto& function = interface.functions.emplace_back(Function { func->name, {}, func->return_type });
+				for (const auto& param : func->params) {
+					function.params.push_back(ast::Parameter { param.name, param.type });
+				}
+			} else if (const auto alias = dynamic_cast<const ast::TypeAliasDeclaration*>(decl.get())) {
+				interface.aliases.push_back(Alias { alias->alias, alias->type });
+			}
+		}
+		return interface;
+	}
+
+	std::string ModuleInterface::hash() const {
+		std::string text;
+		for (const auto& function : functions) {
+			text += "fn " + function.name + "(";
+			for (const auto& param : function.params) {
+				text += param.type + ",";
+			}
+			text += ")" + function.return_type + "\n";
+		}
+		for (const auto& alias : aliases) {
+			text += "type " + alias.alias + "=" + alias.type + "\n";
+		}
+		return sha256(text);
+	}
+
+	std::string ModuleInterface::encode() const {
+		NameTable table;
+		std::string records;
+		for (const auto& function : functions) {
+			write_u32(records, table.intern(function.name));
+			write_u32(records, table.intern(function.return_type));
+			write_u32(records, static_cast<uint32_t>(function.params.size()));
+			for (const auto& param : function.params) {
+				write_u32(records, table.intern(param.name));
+				write_u32(records, table.intern(param.type));
+			}
+		}
+		for (const auto& alias : aliases) {
+			write_u32(records, table.intern(alias.alias));
+			write_u32(records, table.intern(alias.type));
+		}
+
+		std::string out(interface_magic);
+		out += hash();
+		write_u32(out, static_cast<uint32_t>(table.names().size()));
+		write_u32(out, static_cast<uint32_t>(functions.size()));
+		write_u32(out, static_cast<uint32_t>(aliases.size()));
+
+		for (const auto name : table.names()) {
+			write_u32(out, static_cast<uint32_t>(name->size()));
+			out += *name;
+		}
+		return out + records;
+	}
+
+	std::optional<ModuleInterface> ModuleInterface::decode(const std::string_view data, const std::string_view hash) {
+		// the hash comes first, an interface file of another version of the module is rejected unread
+		if (!data.starts_with(interface_magic) || data.substr(interface_magic.size(), hash_length) != hash) {
+			return std::nullopt;
+		}
+		Reader reader(data.substr(interface_magic.size() + hash_length));
+
+		uint32_t name_count, function_count, alias_count;
+		if (!reader.u32(name_count) || !reader.u32(function_count) || !reader.u32(alias_count)) {
+			return std::nullopt;
+		}
+
+		std::vector<std::string> names;
+		for (uint32_t i = 0; i < name_count; i++) {
+			uint32_t length;
+			std::string_view bytes;
+			if (!reader.u32(length) || !reader.bytes(length, bytes) || !is_valid_utf8(bytes)) {
+				return std::nullopt;
+			}
+			names.emplace_back(bytes);
+		}
+
+		const auto name = [&](std::string& value) {
+			uint32_t index;
+			if (!reader.u32(index) || index >= names.size()) {
+				return false;
+			}
+			value = names[index];
+			return true;
+		};
+
+		ModuleInterface interface;
+		for (uint32_t i = 0; i < function_count; i++) {
+			Function function;
+			uint32_t param_count;
+			if (!name(function.name) || !name(function.return_type) || !reader.u32(param_count)) {
+				return std::nullopt;
+			}
+			for (uint32_t j = 0; j < param_count; j++) {
+				ast::Parameter param;
+				if (!name(param.name) || !name(param.type)) {
+					return std::nullopt;
+				}
+				function.params.push_back(std::move(param));
+			}
+			interface.functions.push_back(std::move(function));
+		}
+		for (uint32_t i = 0; i < alias_count; i++) {
+			Alias alias;
+			if (!name(alias.alias) || !name(alias.type)) {
+				return std::nullopt;
+			}
+			interface.aliases.push_back(std::move(alias));
+		}
+
+		if (!reader.done()) {
+			return std::nullopt;
+		}
+		return interface;
+	}
+
+	std::optional<ModuleInterface> ModuleInterface::load(const std::filesystem::path& path, const std::string_view hash) {
+		const auto file = MappedFile::open(path);
+		if (!file) {
+			return std::nullopt;
+		}
+		return decode(file->data(), hash);
+	}
+
+	ast::DeclarationList ModuleInterface::declarations(const SourcePosition position) const {
+		ast::DeclarationList decls;
+
+		for (const auto& alias : aliases) {
+			decls.push_back(std::make_unique<ast::TypeAliasDeclaration>(alias.alias, alias.type, position));
+		}
+		for (const auto& function : functions) {
+			auto params = function.params;
+			for (auto& param : params) {
+				param.position = position;
+			}
+			decls.push_back(std::make_unique<ast::FunctionDeclaration>(function.name, std::move(params), function.return_type, nullptr, position));
+		}
+		return decls;
+	}
+}
@@ -0,0 +1,55 @@
+#include <driver/time_report.h>
+
+#include <fmt/format.h>
+
+namespace seam::driver {
+	void TimeReport::add(const std::string& phase, const std::chrono::nanoseconds time) {
+		std::lock_guard lock(mutex_);
+
+		for (auto& existing : phases_) {
+			if (existing.name == phase) {
+				existing.time += time;
+				existing.count++;
+				return;
+			}
+		}
+		phases_.push_back(Phase { phase, time, 1 });
+	}
+
+	std::chrono::nanoseconds TimeReport::time(const std::string& phase) const {
+		std::lock_guard lock(mutex_);
+
+		for (const auto& existing : phases_) {
+			if (existing.name == phase) {
+				return existing.time;
+			}
+		}
+		return {};
+	}
+
+	size_t TimeReport::count(const std::string& phase) const {
+		std::lock_guard lock(mutex_);
+
+		for (const auto& existing : phases_) {
+			if (existing.name == phase) {
+				return existing.count;
+			}
+		}
+		return 0;
+	}
+
+	std::string TimeReport::render(const std::chrono::nanoseconds total) const {
+		std::lock_guard lock(mutex_);
+
+		const auto milliseconds = [](const std::chrono::nanoseconds time) {
+			return std::chrono::duration<double, std::milli>(time).count();
+		};
+
+		auto result = fmt::format("{:<12} {:>12} {:>8}\n", "phase", "time (ms)", "runs");
+		for (const auto& phase : phases_) {
+			result += fmt::format("{:<12} {:>12.3f} {:>8}\n", phase.name, milliseconds(phase.time), phase.count);
+		}
+		result += fmt::format("{:<12} {:>12.3f}\n", "total", milliseconds(total));
+		return result;
+	}
+}
@@ -0,0 +1,265 @@
+#include <driver/hash.h>
+#include <driver/workspace.h>
+#include <exception.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+namespace seam::driver {
+	Workspace::Workspace(BuildOptions options)
+		: options_(std::move(options)), fingerprint_(options_.compile.fingerprint()),
+		  store_(options_.cache_directory.empty() ? options_.output_directory / ".seamc" / "cache" : options_.cache_directory),
+		  manifest_path_(options_.output_directory / ".seamc" / "manifest") {}
+
+	void Workspace::load(Module& module, TimeReport& report) {
+		std::string text;
+		{
+			TimeReport::Timer timer(report, "hash");
+			const auto stamp = FileStamp::of(module.file.source);
+			if (!stamp) {
+				throw DriverException("cannot read " + module.file.source.string());
+			}
+			module.source_stamp = *stamp;
+			text = read_file(module.file.source);
+			module.hash = sha256(text);
+		}
+
+		module.parsed = parse(module.file.source.string(), text, report);
+		module.interface.reset();
+		module.interface_hash.clear();
+		module.imports.clear();
+
+		if (const auto& program = module.parsed.program) {
+			module.interface = ModuleInterface::of(*program);
+			module.interface_hash = module.interface->hash();
+
+			for (const auto& import : program->imports) {
+				module.imports.push_back(import.module);
+			}
+		}
+	}
+
+	BuildResult Workspace::load(TimeReport& report) {
+		auto result = build(options_, report);
+		manifest_ = Manifest::load(manifest_path_);
+
+		modules_.clear();
+		sources_.clear();
+		for (auto& file : find_modules(options_)) {
+			auto& module = modules_[file.name];
+			module.file = std::move(file);
+			load(module, report);
+			sources_.emplace(module.file.source.lexically_normal(), module.file.name);
+		}
+		return result;
+	}
+
+	void Workspace::rescan(std::set<std::string>& added, std::set<std::string>& removed, TimeReport& report) {
+		auto files = find_modules(options_);
+
+		std::set<std::string> present;
+		for (auto& file : files) {
+			present.insert(file.name);
+			if (modules_.contains(file.name)) {
+				continue;
+			}
+
+			auto& module = modules_[file.name];
+			module.file = std::move(file);
+			load(module, report);
+			sources_.emplace(module.file.source.lexically_normal(), module.file.name);
+			added.insert(module.file.name);
+		}
+
+		for (auto it = modules_.begin(); it != modules_.end();) {
+			if (present.contains(it->first)) {
+				++it;
+				continue;
+			}
+			sources_.erase(it->second.file.source.lexically_normal());
+			manifest_.erase(it->second.file.output);
+			removed.insert(it->first);
+			it = modules_.erase(it);
+		}
+	}
+
+	BuildResult Workspace::update(const std::vector<std::filesystem::path>& changed, TimeReport& report) {
+		BuildResult result;
+
+		std::set<std::string> touched;
+		auto search = false;
+		for (const auto& path : changed) {
+			const auto it = sources_.find(path.lexically_normal());
+			if (it != sources_.end() && std::filesystem::exists(path)) {
+				touched.insert(it->second);
+			} else if (it != sources_.end() || path.extension() == ".seam" || !path.has_extension()) {
+				// new or deleted sources, or whole directories
+				search = true;
+			}
+		}
+
+		std::set<std::string> added, removed;
+		if (search) {
+			TimeReport::Timer timer(report, "scan");
+			rescan(added, removed, report);
+		}
+
+		// modules importing a changed interface are compiled again, as are those finding or losing an import
+		auto interfaces = added;
+		interfaces.insert(removed.begin(), removed.end());
+
+		std::set<std::string> dirty = added;
+		for (const auto& name : touched) {
+			const auto it = modules_.find(name);
+			if (it == modules_.end()) {
+				continue;
+			}
+
+			auto& module = it->second;
+			if (FileStamp::of(module.file.source) == module.source_stamp) {
+				result.unchanged++;
+				continue;
+			}
+
+			const auto hash = module.hash;
+			const auto interface = module.interface_hash;
+			const auto failed = !module.parsed.program;
+			load(module, report);
+
+			if (module.hash == hash) {
+				result.rehashed++;
+				continue;
+			}
+			dirty.insert(name);
+			if (module.interface_hash != interface || failed != !module.parsed.program) {
+				interfaces.insert(name);
+			}
+		}
+
+		for (const auto& [name, module] : modules_) {
+			const auto imports_changed = std::any_of(module.imports.begin(), module.imports.end(), [&](const std::string& import) {
+				return interfaces.contains(import);
+			});
+			if (imports_changed) {
+				dirty.insert(name);
+			}
+		}
+
+		std::vector<Module*> modules;
+		for (const auto& name : dirty) {
+			modules.push_back(&modules_.at(name));
+		}
+		compile(modules, result, report);
+
+		if (!modules.empty() || !removed.empty()) {
+			TimeReport::Timer timer(report, "save");
+			manifest_.save(manifest_path_);
+		}
+		return result;
+	}
+
+	void Workspace::compile(const std::vector<Module*>& modules, BuildResult& result, TimeReport& report) {
+		const auto racy_since = FileStamp::racy_since();
+
+		// imports are looked up up front, modules are only read while compiling
+		std::vector<std::vector<const ModuleInterface*>> interfaces(modules.size());
+		std::vector<std::vector<const Module*>> imported(modules.size());
+		std::vector<bool> broken(modules.size(), false);
+		for (size_t i = 0; i < modules.size(); i++) {
+			for (const auto& name : modules[i]->imports) {
+				const auto it = modules_.find(name);
+				if (it == modules_.end()) {
+					interfaces[i].push_back(nullptr);
+					continue;
+				}
+				interfaces[i].push_back(it->second.interface ? &*it->second.interface : nullptr);
+				imported[i].push_back(&it->second);
+				// modules importing a module that does not parse report nothing of their own
+				broken[i] = broken[i] || !it->second.interface;
+			}
+		}
+
+		std::vector<CompileResult> results(modules.size());
+		auto threads = options_.threads == 0 ? std::max<size_t>(std::thread::hardware_concurrency(), 1) : options_.threads;
+		threads = std::min(threads, modules.size());
+
+		std::atomic<size_t> next = 0;
+		std::vector<std::exception_ptr> errors(threads);
+		const auto worker = [&](const size_t index) {
+			try {
+				for (auto i = next++; i < modules.size(); i = next++) {
+					const auto& parsed = modules[i]->parsed;
+					if (!parsed.program) {
+						results[i].diagnostics = parsed.diagnostics;
+					} else if (!broken[i]) {
+						results[i] = driver::compile(parsed, interfaces[i], options_.compile, report);
+					}
+				}
+			} catch (...) {
+				errors[index] = std::current_exception();
+			}
+		};
+
+		std::vector<std::thread> pool;
+		for (size_t i = 1; i < threads; i++) {
+			pool.emplace_back(worker, i);
+		}
+		if (threads > 0) {
+			worker(0);
+		}
+		for (auto& thread : pool) {
+			thread.join();
+		}
+		for (const auto& error : errors) {
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+
+		for (size_t i = 0; i < modules.size(); i++) {
+			const auto& module = *modules[i];
+			auto& compiled = results[i];
+			if (!compiled.output) {
+				result.failed++;
+				result.diagnostics.insert(result.diagnostics.end(), compiled.diagnostics.begin(), compiled.diagnostics.end());
+				manifest_.erase(module.file.output);
+				continue;
+			}
+
+			TimeReport::Timer timer(report, "write");
+			std::vector<std::pair<std::string, std::string>> keyed;
+			for (size_t j = 0; j < module.imports.size(); j++) {
+				keyed.emplace_back(module.imports[j], interfaces[i][j] ? modules_.at(module.imports[j]).interface_hash : "");
+			}
+			const auto key = module_key(fingerprint_, module.hash, keyed);
+			store_.store(key, *compiled.output);
+			write_file(module.file.output, *compiled.output);
+			write_file(module.file.interface, module.interface->encode());
+
+			ManifestEntry entry { module.file.output, *FileStamp::of(module.file.output), fingerprint_, key, module.interface_hash, module.imports };
+			entry.dependencies.push_back(Dependency { module.file.source, module.source_stamp.trusted(racy_since), module.hash });
+			for (const auto import : imported[i]) {
+				entry.dependencies.push_back(Dependency { import->file.source, import->source_stamp.trusted(racy_since), import->hash });
+			}
+			manifest_.set(std::move(entry));
+			result.compiled++;
+		}
+	}
+
+	std::vector<std::filesystem::path> Workspace::directories() const {
+		std::vector<std::filesystem::path> directories;
+		for (const auto& input : options_.inputs) {
+			std::error_code error;
+			if (std::filesystem::is_directory(input, error)) {
+				directories.push_back(input);
+			} else {
+				directories.push_back(input.has_parent_path() ? input.parent_path() : ".");
+			}
+		}
+		std::sort(directories.begin(), directories.end());
+		directories.erase(std::unique(directories.begin(), directories.end()), directories.end());
+		return directories;
+	}
+}
@@ -0,0 +1,178 @@
+#include "ir/analysis.h"
+
+#include <algorithm>
+
+namespace seam::ir {
+	std::vector<BlockId> successors(const Block& block) {
+		switch (block.terminator.kind) {
+			case TerminatorKind::Jump: return { block.terminator.targets[0] };
+			case TerminatorKind::Branch: return { block.terminator.targets[0], block.terminator.targets[1] };
+			default: return {};
+		}
+	}
+
+	std::vector<BlockId> value_blocks(const Function& function) {
+		std::vector<BlockId> blocks(function.values.size(), no_block);
+
+		for (BlockId b = 0; b < function.blocks.size(); b++) {
+			for (const auto value : function.blocks[b].instructions) {
+				blocks[value] = b;
+			}
+		}
+
+		return blocks;
+	}
+
+	DominatorTree::DominatorTree(const Function& function)
+		: idom_(function.blocks.size(), no_block), children_(function.blocks.size()) {
+		const auto count = function.blocks.size();
+		if (count == 0) {
+			return;
+		}
+
+		// iterative depth first search for the postorder
+		std::vector<uint32_t> postorder_index(count, UINT32_MAX);
+		std::vector<bool> visited(count, false);
+		std::vector<std::pair<BlockId, std::vector<BlockId>>> stack;
+
+		visited[0] = true;
+		stack.emplace_back(0, successors(function.blocks[0]));
+		while (!stack.empty()) {
+			auto& [block, pending] = stack.back();
+
+			if (pending.empty()) {
+				postorder_index[block] = static_cast<uint32_t>(order_.size());
+				order_.push_back(block);
+				stack.pop_back();
+				continue;
+			}
+
+			const auto next = pending.back();
+			pending.pop_back();
+			if (!visited[next]) {
+				visited[next] = true;
+				stack.emplace_back(next, successors(function.blocks[next]));
+			}
+		}
+		std::reverse(order_.begin(), order_.end());
+
+		const auto intersect = [&](BlockId a, BlockId b) {
+			while (a != b) {
+				while (postorder_index[a] < postorder_index[b]) a = idom_[a];
+				while (postorder_index[b] < postorder_index[a]) b = idom_[b];
+			}
+			return a;
+		};
+
+		idom_[0] = 0;
+		for (auto changed = true; changed;) {
+			changed = false;
+
+			for (const auto block : order_) {
+				if (block == 0) {
+					continue;
+				}
+
+				auto dominator = no_block;
+				for (const auto predecessor : function.blocks[block].predecessors) {
+					if (idom_[predecessor] == no_block) {
+						continue;
+					}
+					dominator = dominator == no_block ? predecessor : intersect(predecessor, dominator);
+				}
+
+				if (idom_[block] != dominator) {
+					idom_[block] = dominator;
+					changed = true;
+				}
+			}
+		}
+
+		for (const auto block : order_) {
+			if (block != 0) {
+				children_[idom_[block]].push_back(block);
+			}
+		}
+
+		// iterative walk of the tree, a block's subtree is numbered within its own numbers
+		enter_.assign(count, 0);
+		leave_.assign(count, 0);
+		uint32_t number = 0;
+		std::vector<std::pair<BlockId, size_t>> walk { { 0, 0 } };
+		enter_[0] = number++;
+		while (!walk.empty()) {
+			auto& [block, next] = walk.back();
+			if (next == children_[block].size()) {
+				leave_[block] = number++;
+				walk.pop_back();
+				continue;
+			}
+
+			const auto child = children_[block][next++];
+			enter_[child] = number++;
+			walk.emplace_back(child, 0);
+		}
+	}
+
+	bool DominatorTree::dominates(const BlockId dominator, const BlockId block) const {
+		if (!reachable(block) || !reachable(dominator)) {
+			return false;
+		}
+		return enter_[dominator] <= enter_[block] && leave_[block] <= leave_[dominator];
+	}
+
+	std::vector<Loop> find_loops(const Function& function, const DominatorTree& dominators) {
+		std::vector<Loop> loops;
+		std::vector<size_t> loop_of_header(function.blocks.size(), SIZE_MAX);
+
+		for (const auto block : dominators.reverse_postorder()) {
+			for (const auto header : successors(function.blocks[block])) {
+				if (!dominators.dominates(header, block)) {
+					continue;
+				}
+
+				// back edge, the loop is everything reaching it without passing the header
+				if (loop_of_header[header] == SIZE_MAX) {
+					loop_of_header[header] = loops.size();
+					auto& loop = loops.emplace_back();
+					loop.header = header;
+					loop.contains.assign(function.blocks.size(), false);
+					loop.contains[header] = true;
+				}
+
+				auto& contains = loops[loop_of_header[header]].contains;
+				std::vector<BlockId> worklist;
+				if (!contains[block]) {
+					contains[block] = true;
+					worklist.push_back(block);
+				}
+
+				while (!worklist.empty()) {
+					const auto current = worklist.back();
+					worklist.pop_back();
+
+					for (const auto predecessor : function.blocks[current].predecessors) {
+						if (!contains[predecessor] && dominators.reachable(predecessor)) {
+							contains[predecessor] = true;
+							worklist.push_back(predecessor);
+						}
+					}
+				}
+			}
+		}
+
+		for (auto& loop : loops) {
+			for (const auto block : dominators.reverse_postorder()) {
+				if (loop.contains[block]) {
+					loop.blocks.push_back(block);
+				}
+			}
+		}
+
+		std::stable_sort(loops.begin(), loops.end(), [](const Loop& lhs, const Loop& rhs) {
+			return lhs.blocks.size() < rhs.blocks.size();
+		});
+
+		return loops;
+	}
+}
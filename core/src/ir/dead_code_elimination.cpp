@@ -0,0 +1,66 @@
+#include "ir/passes.h"
+
+#include <algorithm>
+
+namespace seam::ir {
+	namespace {
+		/**
+		 * Integer division traps on a zero divisor, unless the divisor is a nonzero constant.
+		 */
+		bool may_trap(const Function& function, const Instruction& instruction) {
+			if (instruction.op != Opcode::Div || instruction.type == Type::F64) {
+				return false;
+			}
+
+			const auto& divisor = function.values[instruction.operands[1]];
+			return divisor.op != Opcode::Const || divisor.immediate.i64 == 0;
+		}
+	}
+
+	bool DeadCodeElimination::run_on_function(Module& module, Function& function) {
+		std::vector<bool> live(function.values.size(), false);
+		std::vector<ValueId> worklist;
+
+		const auto mark = [&](const ValueId value) {
+			if (value != no_value && !live[value]) {
+				live[value] = true;
+				worklist.push_back(value);
+			}
+		};
+
+		// roots: values leaving the function or controlling it, calls and divisions that may trap
+		for (const auto& block : function.blocks) {
+			mark(block.terminator.value);
+
+			for (const auto id : block.instructions) {
+				const auto& instruction = function.values[id];
+				if (instruction.op == Opcode::Call || may_trap(function, instruction)) {
+					mark(id);
+				}
+			}
+		}
+
+		while (!worklist.empty()) {
+			const auto value = worklist.back();
+			worklist.pop_back();
+
+			for (const auto operand : function.values[value].operands) {
+				mark(operand);
+			}
+		}
+
+		auto changed = false;
+		for (auto& block : function.blocks) {
+			const auto size = block.instructions.size();
+			const auto phis = std::count_if(block.instructions.begin(), block.instructions.begin() + static_cast<std::ptrdiff_t>(block.phi_count),
+				[&](const ValueId id) { return live[id]; });
+
+			std::erase_if(block.instructions, [&](const ValueId id) { return !live[id]; });
+
+			block.phi_count = static_cast<size_t>(phis);
+			changed |= block.instructions.size() != size;
+		}
+
+		return changed;
+	}
+}
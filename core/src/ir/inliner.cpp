@@ -0,0 +1,197 @@
+#include "ir/passes.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "ir/analysis.h"
+
+namespace seam::ir {
+	namespace {
+		size_t instruction_count(const Function& function) {
+			size_t count = 0;
+			for (const auto& block : function.blocks) {
+				count += block.instructions.size() + 1;
+			}
+			return count;
+		}
+
+		bool calls_itself(const Function& function, const FunctionId id) {
+			for (const auto& block : function.blocks) {
+				for (const auto value : block.instructions) {
+					if (function.values[value].op == Opcode::Call && function.values[value].immediate.index == id) {
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		/**
+		 * Inlines the call at the given position of a block. The block is
+		 * split after the call, the continuation is appended first and the
+		 * callee's blocks after it.
+		 *
+		 * @returns value replacing the call's result.
+		 */
+		ValueId inline_call(Function& function, const BlockId block, const size_t position, const Function& callee) {
+			const auto call = function.blocks[block].instructions[position];
+			const auto arguments = function.values[call].operands;
+			const auto type = function.values[call].type;
+
+			// split the block, the continuation takes over its successors
+			const auto continuation = function.add_block();
+			{
+				auto& head = function.blocks[block];
+				auto& tail = function.blocks[continuation];
+
+				tail.instructions.assign(head.instructions.begin() + static_cast<std::ptrdiff_t>(position) + 1, head.instructions.end());
+				head.instructions.resize(position);
+				tail.terminator = head.terminator;
+
+				for (const auto successor : successors(tail)) {
+					auto& predecessors = function.blocks[successor].predecessors;
+					std::replace(predecessors.begin(), predecessors.end(), block, continuation);
+				}
+			}
+
+			// copy the callee, ids are offset by the size of the caller
+			const auto value_base = static_cast<ValueId>(function.values.size());
+			const auto block_base = static_cast<BlockId>(function.blocks.size());
+
+			for (const auto& value : callee.values) {
+				auto copy = value;
+				for (auto& operand : copy.operands) {
+					operand += value_base;
+				}
+				function.values.push_back(std::move(copy));
+			}
+
+			std::vector<ValueId> returned;
+			for (BlockId b = 0; b < callee.blocks.size(); b++) {
+				const auto& source = callee.blocks[b];
+				const auto copy = function.add_block();
+				auto& target = function.blocks[copy];
+
+				target.phi_count = source.phi_count;
+				for (const auto value : source.instructions) {
+					// parameters become the call's arguments
+					if (callee.values[value].op != Opcode::Param) {
+						target.instructions.push_back(value + value_base);
+					}
+				}
+				for (const auto predecessor : source.predecessors) {
+					target.predecessors.push_back(predecessor + block_base);
+				}
+
+				target.terminator = source.terminator;
+				if (target.terminator.value != no_value) {
+					target.terminator.value += value_base;
+				}
+
+				switch (source.terminator.kind) {
+					case TerminatorKind::Branch: target.terminator.targets[1] += block_base; [[fallthrough]];
+					case TerminatorKind::Jump: target.terminator.targets[0] += block_base; break;
+					case TerminatorKind::Return: {
+						if (target.terminator.value != no_value) {
+							returned.push_back(target.terminator.value);
+						}
+						target.terminator = Terminator { TerminatorKind::Jump, no_value, { continuation, 0 } };
+						function.blocks[continuation].predecessors.push_back(copy);
+						break;
+					}
+					case TerminatorKind::None: break;
+				}
+			}
+
+			function.blocks[block].terminator = Terminator { TerminatorKind::Jump, no_value, { block_base, 0 } };
+			function.blocks[block_base].predecessors.push_back(block);
+
+			// parameters of the copy forward to the arguments
+			for (ValueId value = 0; value < callee.values.size(); value++) {
+				if (callee.values[value].op == Opcode::Param) {
+					auto& param = function.values[value + value_base];
+					param.op = Opcode::Removed;
+					param.operands = { arguments[callee.values[value].immediate.index] };
+				}
+			}
+
+			if (type == Type::None) {
+				return no_value;
+			}
+			if (returned.size() == 1) {
+				return returned[0];
+			}
+
+			// several returns merge in the continuation, none leaves it unreachable
+			const auto merged = function.add_value(Instruction { returned.empty() ? Opcode::Undef : Opcode::Phi, type, returned });
+			auto& tail = function.blocks[continuation];
+			tail.instructions.insert(tail.instructions.begin(), merged);
+			tail.phi_count = returned.empty() ? 0 : 1;
+
+			return merged;
+		}
+	}
+
+	bool Inliner::run(Module& module) {
+		// decided up front, so callees inlined into in this run do not grow the budget
+		std::vector<bool> inlinable(module.functions.size());
+		for (FunctionId id = 0; id < module.functions.size(); id++) {
+			const auto& function = module.functions[id];
+			inlinable[id] = !function.blocks.empty()
+				&& function.blocks[0].predecessors.empty()
+				&& instruction_count(function) <= budget_
+				&& !calls_itself(function, id);
+		}
+
+		auto changed = false;
+		for (FunctionId caller = 0; caller < module.functions.size(); caller++) {
+			auto& function = module.functions[caller];
+			std::vector<ValueId> replacements;
+
+			// copied callee bodies are not scanned again, which bounds mutual recursion
+			std::vector<bool> scan(function.blocks.size(), true);
+
+			for (BlockId block = 0; block < function.blocks.size(); block++) {
+				if (!scan[block]) {
+					continue;
+				}
+
+				for (auto i = function.blocks[block].phi_count; i < function.blocks[block].instructions.size(); i++) {
+					const auto& value = function.values[function.blocks[block].instructions[i]];
+					if (value.op != Opcode::Call || value.immediate.index == caller || !inlinable[value.immediate.index]) {
+						continue;
+					}
+
+					const auto call = function.blocks[block].instructions[i];
+					const auto continuation = static_cast<BlockId>(function.blocks.size());
+					const auto result = inline_call(function, block, i, module.functions[value.immediate.index]);
+
+					// new values start out unreplaced, forwarded parameters point at the arguments
+					const auto old_size = replacements.size();
+					replacements.resize(function.values.size());
+					std::iota(replacements.begin() + static_cast<std::ptrdiff_t>(old_size), replacements.end(), static_cast<ValueId>(old_size));
+					for (auto id = static_cast<ValueId>(old_size); id < function.values.size(); id++) {
+						if (function.values[id].op == Opcode::Removed) {
+							replacements[id] = function.values[id].operands[0];
+						}
+					}
+					if (result != no_value) {
+						replacements[call] = result;
+					}
+
+					// the rest of the block moved to the continuation, scanned next
+					scan.resize(function.blocks.size(), false);
+					scan[continuation] = true;
+					changed = true;
+					break;
+				}
+			}
+
+			if (!replacements.empty()) {
+				replace_uses(function, replacements);
+			}
+		}
+
+		return changed;
+	}
+}
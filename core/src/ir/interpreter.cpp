@@ -0,0 +1,169 @@
+#include "ir/interpreter.h"
+
+#include <algorithm>
+
+#include "exception.h"
+
+namespace seam::ir {
+	namespace {
+		int64_t wrap(const uint64_t value) {
+			return static_cast<int64_t>(value);
+		}
+
+		Value evaluate(const Function& function, const Instruction& instruction, const std::vector<Value>& frame) {
+			const auto operand = [&](const size_t index) { return frame[instruction.operands[index]]; };
+			const auto is_float = instruction.type == Type::F64;
+
+			Value result { 0 };
+			switch (instruction.op) {
+				case Opcode::Neg: {
+					if (is_float) result.f64 = -operand(0).f64;
+					else result.i64 = wrap(0 - static_cast<uint64_t>(operand(0).i64));
+					break;
+				}
+				case Opcode::Add: {
+					if (is_float) result.f64 = operand(0).f64 + operand(1).f64;
+					else result.i64 = wrap(static_cast<uint64_t>(operand(0).i64) + static_cast<uint64_t>(operand(1).i64));
+					break;
+				}
+				case Opcode::Sub: {
+					if (is_float) result.f64 = operand(0).f64 - operand(1).f64;
+					else result.i64 = wrap(static_cast<uint64_t>(operand(0).i64) - static_cast<uint64_t>(operand(1).i64));
+					break;
+				}
+				case Opcode::Mul: {
+					if (is_float) result.f64 = operand(0).f64 * operand(1).f64;
+					else result.i64 = wrap(static_cast<uint64_t>(operand(0).i64) * static_cast<uint64_t>(operand(1).i64));
+					break;
+				}
+				case Opcode::Div: {
+					if (is_float) {
+						result.f64 = operand(0).f64 / operand(1).f64;
+						break;
+					}
+
+					const auto lhs = operand(0).i64;
+					const auto rhs = operand(1).i64;
+					if (rhs == 0) {
+						throw RuntimeException("integer division by zero");
+					}
+					// the one overflowing quotient wraps like the other operators
+					result.i64 = rhs == -1 ? wrap(0 - static_cast<uint64_t>(lhs)) : lhs / rhs;
+					break;
+				}
+				case Opcode::And: result.i64 = operand(0).i64 & operand(1).i64; break;
+				case Opcode::Eq: {
+					// the result is a bool, the operands decide how to compare
+					if (function.values[instruction.operands[0]].type == Type::F64) result.i64 = operand(0).f64 == operand(1).f64;
+					else result.i64 = operand(0).i64 == operand(1).i64;
+					break;
+				}
+				default: break;
+			}
+			return result;
+		}
+
+		/**
+		 * Holds one level of call depth until the frame returns or unwinds.
+		 */
+		class DepthGuard {
+			size_t& depth_;
+		public:
+			explicit DepthGuard(size_t& depth)
+				: depth_(depth) {
+				depth_++;
+			}
+
+			~DepthGuard() { depth_--; }
+
+			DepthGuard(const DepthGuard&) = delete;
+			DepthGuard& operator=(const DepthGuard&) = delete;
+		};
+	}
+
+	Interpreter::Interpreter(const Module& module, const size_t max_depth)
+		: module_(module), max_depth_(max_depth), profiles_(module.functions.size()) {}
+
+	Value Interpreter::call(const FunctionId id, const std::vector<Value>& arguments) {
+		const auto& function = module_.functions[id];
+		if (function.blocks.empty()) {
+			throw RuntimeException(fmt::format("{} is defined in another module", function.name));
+		}
+		auto& profile = profiles_[id];
+		profile.calls++;
+
+		const DepthGuard guard(depth_);
+		if (depth_ > max_depth_) {
+			throw RuntimeException("call depth limit exceeded");
+		}
+
+		std::vector<Value> frame(function.values.size(), Value { 0 });
+		std::vector<Value> incoming;
+
+		BlockId previous = 0;
+		BlockId current = 0;
+
+		while (true) {
+			const auto& block = function.blocks[current];
+
+			// phis read their operands before any of them is written
+			if (block.phi_count) {
+				const auto edge = static_cast<size_t>(std::find(block.predecessors.begin(), block.predecessors.end(), previous) - block.predecessors.begin());
+
+				incoming.clear();
+				for (size_t i = 0; i < block.phi_count; i++) {
+					incoming.push_back(frame[function.values[block.instructions[i]].operands[edge]]);
+				}
+				for (size_t i = 0; i < block.phi_count; i++) {
+					frame[block.instructions[i]] = incoming[i];
+				}
+			}
+
+			for (auto i = block.phi_count; i < block.instructions.size(); i++) {
+				const auto id = block.instructions[i];
+				const auto& instruction = function.values[id];
+
+				switch (instruction.op) {
+					case Opcode::Const: frame[id].i64 = instruction.immediate.i64; break;
+					case Opcode::Param: frame[id] = arguments[instruction.immediate.index]; break;
+					case Opcode::Undef: frame[id].i64 = 0; break;
+					case Opcode::Call: {
+						std::vector<Value> call_arguments;
+						call_arguments.reserve(instruction.operands.size());
+						for (const auto operand : instruction.operands) {
+							call_arguments.push_back(frame[operand]);
+						}
+						if (handler_ == nullptr || !handler_->handle(instruction.immediate.index, call_arguments, frame[id])) {
+							frame[id] = call(instruction.immediate.index, call_arguments);
+						}
+						break;
+					}
+					default: frame[id] = evaluate(function, instruction, frame); break;
+				}
+			}
+			executed_ += block.instructions.size() + 1;
+
+			const auto& terminator = block.terminator;
+			switch (terminator.kind) {
+				case TerminatorKind::Jump: {
+					previous = current;
+					current = terminator.targets[0];
+					profile.back_edges += current <= previous;
+					break;
+				}
+				case TerminatorKind::Branch: {
+					previous = current;
+					current = terminator.targets[frame[terminator.value].i64 ? 0 : 1];
+					profile.back_edges += current <= previous;
+					break;
+				}
+				case TerminatorKind::Return: {
+					return terminator.value == no_value ? Value { 0 } : frame[terminator.value];
+				}
+				case TerminatorKind::None: {
+					throw RuntimeException("reached an unterminated block");
+				}
+			}
+		}
+	}
+}
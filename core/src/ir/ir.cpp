@@ -0,0 +1,210 @@
+#include "ir/ir.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <fmt/format.h>
+
+namespace seam::ir {
+	std::optional<FunctionId> Module::find(const std::string& name) const {
+		for (size_t i = 0; i < functions.size(); i++) {
+			if (functions[i].name == name) {
+				return static_cast<FunctionId>(i);
+			}
+		}
+		return std::nullopt;
+	}
+
+	void replace_uses(Function& function, std::vector<ValueId>& replacements) {
+		const auto resolve = [&](ValueId value) {
+			auto target = value;
+			while (replacements[target] != target) {
+				target = replacements[target];
+			}
+			// compress the chain for later lookups
+			while (replacements[value] != target) {
+				value = std::exchange(replacements[value], target);
+			}
+			return target;
+		};
+
+		for (auto& block : function.blocks) {
+			for (const auto id : block.instructions) {
+				for (auto& operand : function.values[id].operands) {
+					operand = resolve(operand);
+				}
+			}
+			if (block.terminator.value != no_value) {
+				block.terminator.value = resolve(block.terminator.value);
+			}
+		}
+	}
+
+	std::string verify(const Function& function) {
+		std::vector<bool> placed(function.values.size(), false);
+		for (const auto& block : function.blocks) {
+			for (const auto id : block.instructions) {
+				if (id >= function.values.size() || placed[id]) {
+					return fmt::format("value %{} is placed twice or does not exist", id);
+				}
+				placed[id] = true;
+			}
+		}
+
+		for (size_t b = 0; b < function.blocks.size(); b++) {
+			const auto& block = function.blocks[b];
+			const auto& terminator = block.terminator;
+
+			switch (terminator.kind) {
+				case TerminatorKind::None: return fmt::format("b{} is not terminated", b);
+				case TerminatorKind::Branch:
+				case TerminatorKind::Jump: {
+					const auto count = terminator.kind == TerminatorKind::Branch ? 2 : 1;
+					for (auto i = 0; i < count; i++) {
+						const auto target = terminator.targets[i];
+						if (target >= function.blocks.size()) {
+							return fmt::format("b{} jumps to missing block b{}", b, target);
+						}
+						const auto& predecessors = function.blocks[target].predecessors;
+						if (std::find(predecessors.begin(), predecessors.end(), b) == predecessors.end()) {
+							return fmt::format("b{} is not a predecessor of b{}", b, target);
+						}
+					}
+					break;
+				}
+				case TerminatorKind::Return: break;
+			}
+
+			if (terminator.value != no_value && !placed[terminator.value]) {
+				return fmt::format("terminator of b{} uses unplaced value %{}", b, terminator.value);
+			}
+
+			for (size_t i = 0; i < block.instructions.size(); i++) {
+				const auto& value = function.values[block.instructions[i]];
+
+				if ((value.op == Opcode::Phi) != (i < block.phi_count)) {
+					return fmt::format("phis of b{} do not lead the block", b);
+				}
+				if (value.op == Opcode::Phi && value.operands.size() != block.predecessors.size()) {
+					return fmt::format("phi %{} does not match the predecessors of b{}", block.instructions[i], b);
+				}
+				if (value.op == Opcode::Removed) {
+					return fmt::format("removed value %{} is still placed", block.instructions[i]);
+				}
+
+				for (const auto operand : value.operands) {
+					if (operand >= function.values.size() || !placed[operand]) {
+						return fmt::format("%{} uses unplaced value %{}", block.instructions[i], operand);
+					}
+				}
+			}
+		}
+
+		return "";
+	}
+
+	const char* type_name(const Type type) {
+		switch (type) {
+			case Type::None: return "none";
+			case Type::Bool: return "bool";
+			case Type::I64: return "i64";
+			case Type::F64: return "f64";
+		}
+		return "";
+	}
+
+	const char* opcode_name(const Opcode op) {
+		switch (op) {
+			case Opcode::Const: return "const";
+			case Opcode::Param: return "param";
+			case Opcode::Undef: return "undef";
+			case Opcode::Phi: return "phi";
+			case Opcode::Neg: return "neg";
+			case Opcode::Add: return "add";
+			case Opcode::Sub: return "sub";
+			case Opcode::Mul: return "mul";
+			case Opcode::Div: return "div";
+			case Opcode::And: return "and";
+			case Opcode::Eq: return "eq";
+			case Opcode::Call: return "call";
+			case Opcode::Removed: return "removed";
+		}
+		return "";
+	}
+
+	std::string print(const Module& module, const Function& function) {
+		std::string out = (function.blocks.empty() ? "declare fn " : "fn ") + function.name + "(";
+		for (size_t i = 0; i < function.params.size(); i++) {
+			out += (i ? ", " : "") + std::string(type_name(function.params[i]));
+		}
+		if (function.blocks.empty()) {
+			return out + fmt::format(") -> {}\n", type_name(function.result));
+		}
+		out += fmt::format(") -> {} {{\n", type_name(function.result));
+
+		for (size_t b = 0; b < function.blocks.size(); b++) {
+			const auto& block = function.blocks[b];
+			out += fmt::format("b{}:\n", b);
+
+			for (const auto id : block.instructions) {
+				const auto& value = function.values[id];
+				out += fmt::format("\t%{}: {} = {}", id, type_name(value.type), opcode_name(value.op));
+
+				switch (value.op) {
+					case Opcode::Const: {
+						if (value.type == Type::F64) out += fmt::format(" {}", value.immediate.f64);
+						else if (value.type == Type::Bool) out += value.immediate.i64 ? " true" : " false";
+						else out += fmt::format(" {}", value.immediate.i64);
+						break;
+					}
+					case Opcode::Param: out += fmt::format(" {}", value.immediate.index); break;
+					case Opcode::Phi: {
+						for (size_t i = 0; i < value.operands.size(); i++) {
+							out += fmt::format(" [b{} %{}]", block.predecessors[i], value.operands[i]);
+						}
+						break;
+					}
+					case Opcode::Call: {
+						out += " " + module.functions[value.immediate.index].name + "(";
+						for (size_t i = 0; i < value.operands.size(); i++) {
+							out += fmt::format("{}%{}", i ? ", " : "", value.operands[i]);
+						}
+						out += ")";
+						break;
+					}
+					default: {
+						for (size_t i = 0; i < value.operands.size(); i++) {
+							out += fmt::format("{}%{}", i ? ", " : " ", value.operands[i]);
+						}
+						break;
+					}
+				}
+				out += "\n";
+			}
+
+			const auto& terminator = block.terminator;
+			switch (terminator.kind) {
+				case TerminatorKind::None: out += "\t<unterminated>\n"; break;
+				case TerminatorKind::Jump: out += fmt::format("\tjump b{}\n", terminator.targets[0]); break;
+				case TerminatorKind::Branch: {
+					out += fmt::format("\tbranch %{}, b{}, b{}\n", terminator.value, terminator.targets[0], terminator.targets[1]);
+					break;
+				}
+				case TerminatorKind::Return: {
+					out += terminator.value == no_value ? "\treturn\n" : fmt::format("\treturn %{}\n", terminator.value);
+					break;
+				}
+			}
+		}
+
+		return out + "}\n";
+	}
+
+	std::string print(const Module& module) {
+		std::string out;
+		for (const auto& function : module.functions) {
+			out += print(module, function);
+		}
+		return out;
+	}
+}
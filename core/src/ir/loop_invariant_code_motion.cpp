@@ -0,0 +1,86 @@
+#include "ir/passes.h"
+
+#include <algorithm>
+
+#include "ir/analysis.h"
+
+namespace seam::ir {
+	namespace {
+		bool is_hoistable(const Opcode op) {
+			switch (op) {
+				case Opcode::Const:
+				case Opcode::Neg:
+				case Opcode::Add:
+				case Opcode::Sub:
+				case Opcode::Mul:
+				case Opcode::And:
+				case Opcode::Eq: return true;
+				default: return false;
+			}
+		}
+
+		/**
+		 * Returns the single block outside the loop that jumps to its header,
+		 * no_block if the loop is entered from several places.
+		 */
+		BlockId find_preheader(const Function& function, const Loop& loop) {
+			auto preheader = no_block;
+
+			for (const auto predecessor : function.blocks[loop.header].predecessors) {
+				if (loop.contains[predecessor]) {
+					continue;
+				}
+				if (preheader != no_block) {
+					return no_block;
+				}
+				preheader = predecessor;
+			}
+
+			if (preheader == no_block || function.blocks[preheader].terminator.kind != TerminatorKind::Jump) {
+				return no_block;
+			}
+			return preheader;
+		}
+	}
+
+	bool LoopInvariantCodeMotion::run_on_function(Module& module, Function& function) {
+		if (function.blocks.empty()) {
+			return false;
+		}
+
+		const DominatorTree dominators(function);
+		const auto loops = find_loops(function, dominators);
+		auto blocks = value_blocks(function);
+
+		auto changed = false;
+		for (const auto& loop : loops) {
+			const auto preheader = find_preheader(function, loop);
+			if (preheader == no_block) {
+				continue;
+			}
+
+			const auto invariant = [&](const ValueId operand) {
+				return blocks[operand] == no_block || !loop.contains[blocks[operand]];
+			};
+
+			// reverse postorder sees definitions before uses, so one sweep hoists chains
+			for (const auto block : loop.blocks) {
+				auto& instructions = function.blocks[block].instructions;
+
+				std::erase_if(instructions, [&](const ValueId id) {
+					const auto& value = function.values[id];
+					if (!is_hoistable(value.op) || !std::all_of(value.operands.begin(), value.operands.end(), invariant)) {
+						return false;
+					}
+
+					function.blocks[preheader].instructions.push_back(id);
+					blocks[id] = preheader;
+					changed = true;
+					return true;
+				});
+			}
+		}
+
+		return changed;
+	}
+}
@@ -0,0 +1,578 @@
+#include "ir/lowering.h"
+
+namespace seam::ir {
+	AstLowering::AstLowering(const semantic::Context& context)
+		: context_(context) {}
+
+	Module AstLowering::lower(ast::Program& program) {
+		module_ = Module {};
+		functions_.clear();
+
+		program.accept(*this);
+
+		return std::move(module_);
+	}
+
+	void AstLowering::collect_functions(const ast::DeclarationList& decls, std::vector<ast::FunctionDeclaration*>& functions) {
+		for (const auto& decl : decls) {
+			if (const auto func = dynamic_cast<ast::FunctionDeclaration*>(decl.get())) {
+				functions.push_back(func);
+			} else if (const auto type = dynamic_cast<ast::TypeDeclaration*>(decl.get())) {
+				collect_functions(type->body, functions);
+			}
+		}
+	}
+
+	void AstLowering::lower_function(ast::FunctionDeclaration& func, const FunctionId id) {
+		function_ = &module_.functions[id];
+		variables_.clear();
+		variable_types_.clear();
+		definitions_.clear();
+		incomplete_phis_.clear();
+		sealed_.clear();
+		phi_blocks_.clear();
+
+		block_ = new_block();
+		seal_block(block_);
+
+		for (uint32_t i = 0; i < func.params.size(); i++) {
+			const auto value = emit(Opcode::Param, function_->params[i]);
+			function_->values[value].immediate.index = i;
+			write_variable(variable(func.params[i].symbol), block_, value);
+		}
+
+		func.body->accept(*this);
+
+		// falling off the end returns nothing, or an undefined value
+		if (!terminated()) {
+			const auto value = function_->result == Type::None ? no_value : undef(function_->result);
+			function_->blocks[block_].terminator = Terminator { TerminatorKind::Return, value };
+		}
+
+		finish_function();
+		function_ = nullptr;
+	}
+
+	void AstLowering::finish_function() {
+		// phis may only become trivial once their operands were simplified
+		for (auto changed = true; changed;) {
+			changed = false;
+			for (ValueId id = 0; id < function_->values.size(); id++) {
+				if (function_->values[id].op == Opcode::Phi && try_remove_trivial_phi(id) != id) {
+					changed = true;
+				}
+			}
+		}
+
+		for (auto& value : function_->values) {
+			if (value.op != Opcode::Removed) {
+				for (auto& operand : value.operands) {
+					operand = resolve(operand);
+				}
+			}
+		}
+
+		for (auto& block : function_->blocks) {
+			if (block.terminator.value != no_value) {
+				block.terminator.value = resolve(block.terminator.value);
+			}
+
+			std::erase_if(block.instructions, [&](const ValueId id) {
+				return function_->values[id].op == Opcode::Removed;
+			});
+
+			block.phi_count = 0;
+			while (block.phi_count < block.instructions.size()
+				&& function_->values[block.instructions[block.phi_count]].op == Opcode::Phi) {
+				block.phi_count++;
+			}
+		}
+	}
+
+	BlockId AstLowering::new_block() {
+		definitions_.emplace_back();
+		incomplete_phis_.emplace_back();
+		sealed_.push_back(false);
+
+		return function_->add_block();
+	}
+
+	void AstLowering::seal_block(const BlockId block) {
+		// moved out, completing a phi may read variables of this block
+		const auto incomplete = std::move(incomplete_phis_[block]);
+		incomplete_phis_[block].clear();
+
+		for (const auto& [variable, phi] : incomplete) {
+			add_phi_operands(variable, phi);
+		}
+		sealed_[block] = true;
+	}
+
+	bool AstLowering::terminated() const {
+		return function_->blocks[block_].terminator.kind != TerminatorKind::None;
+	}
+
+	void AstLowering::jump(const BlockId target) {
+		// a block ending in a return never reaches the target
+		if (terminated()) {
+			return;
+		}
+
+		function_->blocks[block_].terminator = Terminator { TerminatorKind::Jump, no_value, { target, 0 } };
+		function_->blocks[target].predecessors.push_back(block_);
+	}
+
+	void AstLowering::branch(const ValueId condition, const BlockId on_true, const BlockId on_false) {
+		function_->blocks[block_].terminator = Terminator { TerminatorKind::Branch, condition, { on_true, on_false } };
+		function_->blocks[on_true].predecessors.push_back(block_);
+		function_->blocks[on_false].predecessors.push_back(block_);
+	}
+
+	AstLowering::Variable AstLowering::variable(const symbol::Symbol* symbol) {
+		if (const auto it = variables_.find(symbol); it != variables_.end()) {
+			return it->second;
+		}
+
+		const auto variable = new_variable(type_of(symbol->type_id, symbol->position));
+		variables_.emplace(symbol, variable);
+		return variable;
+	}
+
+	AstLowering::Variable AstLowering::new_variable(const Type type) {
+		variable_types_.push_back(type);
+		return static_cast<Variable>(variable_types_.size() - 1);
+	}
+
+	void AstLowering::write_variable(const Variable variable, const BlockId block, const ValueId value) {
+		definitions_[block][variable] = value;
+	}
+
+	ValueId AstLowering::read_variable(const Variable variable, const BlockId block) {
+		// a block that has to ask its predecessors, with the phi collecting their answers
+		struct Pending {
+			BlockId block;
+			ValueId phi;
+			size_t predecessor;
+		};
+
+		// searches up the predecessors with an explicit stack, long chains of
+		// merges would otherwise cost a frame per block
+		const auto type = variable_types_[variable];
+		std::vector<Pending> pending;
+		auto current = block;
+		ValueId value;
+
+		while (true) {
+			if (const auto it = definitions_[current].find(variable); it != definitions_[current].end()) {
+				value = it->second;
+			} else {
+				const auto& predecessors = function_->blocks[current].predecessors;
+
+				if (!sealed_[current]) {
+					// predecessors still unknown, complete the phi when sealing
+					value = new_phi(current, type);
+					incomplete_phis_[current].emplace_back(variable, value);
+					write_variable(variable, current, value);
+				} else if (predecessors.empty()) {
+					value = undef(type);
+					write_variable(variable, current, value);
+				} else if (predecessors.size() == 1) {
+					pending.push_back(Pending { current, no_value, 0 });
+					current = predecessors[0];
+					continue;
+				} else {
+					// the phi breaks cycles through loops before its operands are read
+					const auto phi = new_phi(current, type);
+					write_variable(variable, current, phi);
+					pending.push_back(Pending { current, phi, 0 });
+					current = predecessors[0];
+					continue;
+				}
+			}
+
+			// hand the value back to the blocks waiting on it
+			while (!pending.empty()) {
+				auto& waiting = pending.back();
+				if (waiting.phi != no_value) {
+					function_->values[waiting.phi].operands.push_back(value);
+
+					// indexed again, reading a variable may add values and blocks
+					const auto& predecessors = function_->blocks[waiting.block].predecessors;
+					if (++waiting.predecessor < predecessors.size()) {
+						current = predecessors[waiting.predecessor];
+						break;
+					}
+					value = try_remove_trivial_phi(waiting.phi);
+				}
+
+				write_variable(variable, waiting.block, value);
+				pending.pop_back();
+			}
+
+			if (pending.empty()) {
+				return value;
+			}
+		}
+	}
+
+	ValueId AstLowering::new_phi(const BlockId block, const Type type) {
+		const auto phi = function_->add_value(Instruction { Opcode::Phi, type });
+		phi_blocks_.emplace(phi, block);
+
+		auto& instructions = function_->blocks[block].instructions;
+		instructions.insert(instructions.begin() + static_cast<std::ptrdiff_t>(function_->blocks[block].phi_count++), phi);
+
+		return phi;
+	}
+
+	ValueId AstLowering::add_phi_operands(const Variable variable, const ValueId phi) {
+		const auto block = phi_blocks_.at(phi);
+
+		// indexed on every iteration, reading a variable may add values and blocks
+		for (size_t i = 0; i < function_->blocks[block].predecessors.size(); i++) {
+			const auto operand = read_variable(variable, function_->blocks[block].predecessors[i]);
+			function_->values[phi].operands.push_back(operand);
+		}
+
+		return try_remove_trivial_phi(phi);
+	}
+
+	ValueId AstLowering::try_remove_trivial_phi(const ValueId phi) {
+		auto same = no_value;
+
+		for (const auto operand : function_->values[phi].operands) {
+			const auto value = resolve(operand);
+			if (value == same || value == phi) {
+				continue;
+			}
+			if (same != no_value) {
+				// merges at least two values
+				return phi;
+			}
+			same = value;
+		}
+
+		if (same == no_value) {
+			// unreachable or only refers to itself
+			same = undef(function_->values[phi].type);
+		}
+
+		auto& value = function_->values[phi];
+		value.op = Opcode::Removed;
+		value.operands = { same };
+
+		return same;
+	}
+
+	ValueId AstLowering::resolve(ValueId value) const {
+		while (function_->values[value].op == Opcode::Removed) {
+			value = function_->values[value].operands[0];
+		}
+		return value;
+	}
+
+	ValueId AstLowering::emit(const Opcode op, const Type type, std::vector<ValueId> operands) {
+		const auto value = function_->add_value(Instruction { op, type, std::move(operands) });
+		function_->blocks[block_].instructions.push_back(value);
+
+		return value;
+	}
+
+	ValueId AstLowering::undef(const Type type) {
+		const auto value = function_->add_value(Instruction { Opcode::Undef, type });
+
+		// the entry block never has phis, so undefined values can lead it
+		auto& entry = function_->blocks[0].instructions;
+		entry.insert(entry.begin(), value);
+
+		return value;
+	}
+
+	ValueId AstLowering::lower(ast::expression::Expression& expr) {
+		expr.accept(*this);
+		return result_;
+	}
+
+	AstLowering::Variable AstLowering::assigned_variable(const ast::expression::Expression& expr) {
+		const auto identifier = dynamic_cast<const ast::expression::Identifier*>(&expr);
+		if (!identifier || !identifier->symbol) {
+			throw generate_exception<LoweringException>(expr.position, "expression is not assignable");
+		}
+		return variable(identifier->symbol);
+	}
+
+	Type AstLowering::type_of(const type::TypeId type, const SourcePosition position) const {
+		const auto& types = context_.types();
+
+		if (type != type::unresolved_type && type != type::TypeTable::error_type) {
+			if (type == type::TypeTable::builtin(type::BuiltIn::None)) return Type::None;
+			if (type == type::TypeTable::builtin(type::BuiltIn::Bool)) return Type::Bool;
+			if (types.is_integer(type)) return Type::I64;
+			if (types.is_float(type)) return Type::F64;
+
+			throw generate_exception<LoweringException>(position, "values of type {} cannot be lowered",
+				types.name(type, context_.interner()));
+		}
+
+		throw generate_exception<LoweringException>(position, "cannot lower an ill-typed program");
+	}
+
+	void AstLowering::visit(ast::Program& program) {
+		std::vector<ast::FunctionDeclaration*> functions;
+		collect_functions(program.body, functions);
+
+		// every signature is known before any body, calls refer to functions by index
+		module_.functions.resize(functions.size());
+		for (FunctionId id = 0; id < functions.size(); id++) {
+			const auto func = functions[id];
+			auto& function = module_.functions[id];
+
+			function.name = func->name;
+			for (const auto& param : func->params) {
+				function.params.push_back(type_of(param.symbol->type_id, param.position));
+			}
+			function.result = type_of(context_.types().get(func->symbol->type_id).result, func->position);
+
+			functions_.emplace(func->symbol, id);
+		}
+
+		// functions of other modules stay declarations without blocks
+		for (FunctionId id = 0; id < functions.size(); id++) {
+			if (functions[id]->body) {
+				lower_function(*functions[id], id);
+			}
+		}
+	}
+
+	void AstLowering::visit(ast::FunctionDeclaration& func) {}
+
+	void AstLowering::visit(ast::TypeDeclaration& decl) {}
+
+	void AstLowering::visit(ast::TypeAliasDeclaration& decl) {}
+
+	void AstLowering::visit(ast::statement::LetStatement& stat) {
+		const auto value = lower(*stat.expr);
+
+		if (stat.symbol) {
+			write_variable(variable(stat.symbol), block_, value);
+		}
+	}
+
+	void AstLowering::visit(ast::statement::StatementBlock& block) {
+		for (const auto& stat : block.statements) {
+			// code after a return is unreachable and not lowered
+			if (terminated()) {
+				break;
+			}
+			stat->accept(*this);
+		}
+	}
+
+	void AstLowering::visit(ast::statement::IfStatement& stat) {
+		// an elseif chain is lowered in a loop into the blocks nested ifs would
+		// give, each branch's merge is created on the way back out
+		std::vector<BlockId> then_ends;
+		auto current = &stat;
+		while (true) {
+			const auto condition = lower(*current->cond);
+
+			const auto then_block = new_block();
+			const auto else_block = new_block();
+			branch(condition, then_block, else_block);
+
+			seal_block(then_block);
+			block_ = then_block;
+			current->body->accept(*this);
+
+			// without an else branch the false edge goes straight to the merge block
+			if (!current->else_body) {
+				jump(else_block);
+				seal_block(else_block);
+				block_ = else_block;
+				break;
+			}
+
+			then_ends.push_back(block_);
+			seal_block(else_block);
+			block_ = else_block;
+
+			const auto next = current->else_if();
+			if (!next) {
+				current->else_body->accept(*this);
+				break;
+			}
+			current = next;
+		}
+
+		while (!then_ends.empty()) {
+			const auto then_end = then_ends.back();
+			then_ends.pop_back();
+			const auto else_end = block_;
+
+			// when both branches return there is nothing to merge
+			if (terminated() && function_->blocks[then_end].terminator.kind != TerminatorKind::None) {
+				continue;
+			}
+
+			const auto merge_block = new_block();
+			block_ = then_end;
+			jump(merge_block);
+			block_ = else_end;
+			jump(merge_block);
+
+			seal_block(merge_block);
+			block_ = merge_block;
+		}
+	}
+
+	void AstLowering::visit(ast::statement::WhileStatement& stat) {
+		// the header stays unsealed until the back edge exists
+		const auto header = new_block();
+		jump(header);
+		block_ = header;
+
+		const auto condition = lower(*stat.cond);
+		const auto body = new_block();
+		const auto exit = new_block();
+		branch(condition, body, exit);
+
+		seal_block(body);
+		block_ = body;
+		stat.body->accept(*this);
+		jump(header);
+
+		seal_block(header);
+		seal_block(exit);
+		block_ = exit;
+	}
+
+	void AstLowering::visit(ast::statement::ReturnStatement& stat) {
+		const auto value = stat.expr ? lower(*stat.expr) : no_value;
+		function_->blocks[block_].terminator = Terminator { TerminatorKind::Return, value };
+	}
+
+	void AstLowering::visit(ast::expression::StringLiteral& expr) {
+		throw generate_exception<LoweringException>(expr.position, "string values cannot be lowered");
+	}
+
+	void AstLowering::visit(ast::expression::NumberLiteral& expr) {
+		const auto type = type_of(expr.type_id, expr.position);
+		result_ = emit(Opcode::Const, type);
+
+		auto& immediate = function_->values[result_].immediate;
+		if (type == Type::F64) {
+			// integer literals may have been typed as floats
+			immediate.f64 = expr.is_float() ? expr.constant.f64 : static_cast<double>(expr.constant.i64);
+		} else {
+			immediate.i64 = expr.constant.i64;
+		}
+	}
+
+	void AstLowering::visit(ast::expression::BooleanLiteral& expr) {
+		result_ = emit(Opcode::Const, Type::Bool);
+		function_->values[result_].immediate.i64 = expr.value;
+	}
+
+	void AstLowering::visit(ast::expression::UnaryExpression& expr) {
+		const auto operand = lower(*expr.expr);
+		result_ = emit(Opcode::Neg, type_of(expr.type_id, expr.position), { operand });
+	}
+
+	void AstLowering::visit(ast::expression::BinaryExpression& expr) {
+		switch (expr.op) {
+			case TokenType::OpAssign: {
+				const auto target = assigned_variable(*expr.lhs);
+				result_ = lower(*expr.rhs);
+				write_variable(target, block_, result_);
+				return;
+			}
+			case TokenType::OpAddEq:
+			case TokenType::OpSubEq: {
+				const auto target = assigned_variable(*expr.lhs);
+				const auto current = read_variable(target, block_);
+				const auto operand = lower(*expr.rhs);
+
+				result_ = emit(expr.op == TokenType::OpAddEq ? Opcode::Add : Opcode::Sub, variable_types_[target], { current, operand });
+				write_variable(target, block_, result_);
+				return;
+			}
+			case TokenType::OpLogicalAnd: {
+				// the result is a temporary assigned on both paths, merged by a phi
+				const auto result = new_variable(Type::Bool);
+				const auto lhs = lower(*expr.lhs);
+				write_variable(result, block_, lhs);
+
+				const auto rhs_block = new_block();
+				const auto merge_block = new_block();
+				branch(lhs, rhs_block, merge_block);
+
+				seal_block(rhs_block);
+				block_ = rhs_block;
+				write_variable(result, block_, lower(*expr.rhs));
+				jump(merge_block);
+
+				seal_block(merge_block);
+				block_ = merge_block;
+				result_ = read_variable(result, block_);
+				return;
+			}
+			default: break;
+		}
+
+		const auto lhs = lower(*expr.lhs);
+		const auto rhs = lower(*expr.rhs);
+
+		Opcode op;
+		switch (expr.op) {
+			case TokenType::OpAdd: op = Opcode::Add; break;
+			case TokenType::OpSub: op = Opcode::Sub; break;
+			case TokenType::OpMul: op = Opcode::Mul; break;
+			case TokenType::OpDiv: op = Opcode::Div; break;
+			case TokenType::OpBitwiseAnd: op = Opcode::And; break;
+			case TokenType::OpEq: op = Opcode::Eq; break;
+			default: {
+				throw generate_exception<LoweringException>(expr.position, "operator {} cannot be lowered",
+					token_type_to_name(expr.op));
+			}
+		}
+
+		result_ = emit(op, type_of(expr.type_id, expr.position), { lhs, rhs });
+	}
+
+	void AstLowering::visit(ast::expression::PostfixExpression& expr) {
+		const auto target = assigned_variable(*expr.rhs);
+		const auto type = variable_types_[target];
+		const auto current = read_variable(target, block_);
+
+		const auto one = emit(Opcode::Const, type);
+		function_->values[one].immediate.i64 = 1;
+
+		write_variable(target, block_, emit(expr.op == TokenType::OpIncrement ? Opcode::Add : Opcode::Sub, type, { current, one }));
+		result_ = current;
+	}
+
+	void AstLowering::visit(ast::expression::Identifier& expr) {
+		if (!expr.symbol || expr.symbol->type == symbol::SymbolType::Function || expr.symbol->type == symbol::SymbolType::Type) {
+			throw generate_exception<LoweringException>(expr.position, "'{}' is not a value", expr.identifier);
+		}
+
+		result_ = read_variable(variable(expr.symbol), block_);
+	}
+
+	void AstLowering::visit(ast::expression::FunctionCall& expr) {
+		const auto callee = dynamic_cast<ast::expression::Identifier*>(expr.function.get());
+		const auto it = callee && callee->symbol ? functions_.find(callee->symbol) : functions_.end();
+		if (it == functions_.end()) {
+			throw generate_exception<LoweringException>(expr.position, "only named functions can be called");
+		}
+
+		std::vector<ValueId> args;
+		args.reserve(expr.args.size());
+		for (const auto& arg : expr.args) {
+			args.push_back(lower(*arg));
+		}
+
+		result_ = emit(Opcode::Call, type_of(expr.type_id, expr.position), std::move(args));
+		function_->values[result_].immediate.index = it->second;
+	}
+}
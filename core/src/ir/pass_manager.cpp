@@ -0,0 +1,60 @@
+#include "ir/pass_manager.h"
+
+#include <fmt/format.h>
+
+#include "ir/passes.h"
+
+namespace seam::ir {
+	bool FunctionPass::run(Module& module) {
+		auto changed = false;
+		for (auto& function : module.functions) {
+			if (!function.blocks.empty()) {
+				changed |= run_on_function(module, function);
+			}
+		}
+		return changed;
+	}
+
+	PassManager PassManager::standard_pipeline() {
+		PassManager manager;
+
+		// inlining first exposes redundancy across the call boundary
+		manager.add<Inliner>();
+		manager.add<ValueNumbering>();
+		manager.add<LoopInvariantCodeMotion>();
+		manager.add<DeadCodeElimination>();
+
+		return manager;
+	}
+
+	bool PassManager::run(Module& module) {
+		auto changed = false;
+
+		for (size_t i = 0; i < passes_.size(); i++) {
+			const auto start = std::chrono::steady_clock::now();
+			const auto pass_changed = passes_[i]->run(module);
+			const auto elapsed = std::chrono::steady_clock::now() - start;
+
+			auto& statistics = statistics_[i];
+			statistics.runs++;
+			statistics.changes += pass_changed;
+			statistics.time += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+
+			changed |= pass_changed;
+		}
+
+		return changed;
+	}
+
+	std::string PassManager::report() const {
+		std::string out = fmt::format("{:<12}{:>8}{:>10}{:>14}\n", "pass", "runs", "changes", "time (us)");
+
+		for (const auto& statistics : statistics_) {
+			out += fmt::format("{:<12}{:>8}{:>10}{:>14.1f}\n",
+				statistics.name, statistics.runs, statistics.changes,
+				static_cast<double>(statistics.time.count()) / 1000.0);
+		}
+
+		return out;
+	}
+}
@@ -0,0 +1,143 @@
+#include "ir/passes.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+#include "ir/analysis.h"
+
+namespace seam::ir {
+	namespace {
+		struct Key {
+			Opcode op;
+			Type type;
+			// constant bits, or the block of a phi
+			int64_t immediate;
+			std::vector<ValueId> operands;
+
+			bool operator==(const Key& other) const = default;
+		};
+
+		struct KeyHash {
+			size_t operator()(const Key& key) const {
+				auto hash = static_cast<size_t>(key.op) * 31 + static_cast<size_t>(key.type);
+				hash ^= static_cast<size_t>(key.immediate) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+				for (const auto operand : key.operands) {
+					hash ^= operand + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+				}
+				return hash;
+			}
+		};
+
+		bool is_numbered(const Opcode op) {
+			switch (op) {
+				case Opcode::Const:
+				case Opcode::Phi:
+				case Opcode::Neg:
+				case Opcode::Add:
+				case Opcode::Sub:
+				case Opcode::Mul:
+				case Opcode::Div:
+				case Opcode::And:
+				case Opcode::Eq: return true;
+				default: return false;
+			}
+		}
+
+		bool is_commutative(const Opcode op) {
+			return op == Opcode::Add || op == Opcode::Mul || op == Opcode::And || op == Opcode::Eq;
+		}
+	}
+
+	bool ValueNumbering::run_on_function(Module& module, Function& function) {
+		if (function.blocks.empty()) {
+			return false;
+		}
+
+		const DominatorTree dominators(function);
+
+		std::vector<ValueId> replacements(function.values.size());
+		std::iota(replacements.begin(), replacements.end(), 0);
+
+		const auto resolve = [&](ValueId value) {
+			while (replacements[value] != value) {
+				value = replacements[value];
+			}
+			return value;
+		};
+
+		// values available in the current dominator subtree, undone on the way out
+		std::unordered_map<Key, ValueId, KeyHash> available;
+		std::vector<const Key*> inserted;
+
+		struct Frame {
+			BlockId block;
+			size_t mark;
+			size_t next_child;
+		};
+		std::vector<Frame> stack;
+		stack.push_back(Frame { 0, 0, 0 });
+
+		auto changed = false;
+		auto entering = true;
+
+		while (!stack.empty()) {
+			auto& frame = stack.back();
+
+			if (entering) {
+				frame.mark = inserted.size();
+				auto& block = function.blocks[frame.block];
+
+				for (const auto id : block.instructions) {
+					const auto& value = function.values[id];
+					if (!is_numbered(value.op)) {
+						continue;
+					}
+
+					Key key { value.op, value.type, value.op == Opcode::Phi ? frame.block : value.immediate.i64, value.operands };
+					for (auto& operand : key.operands) {
+						operand = resolve(operand);
+					}
+					if (is_commutative(value.op)) {
+						std::sort(key.operands.begin(), key.operands.end());
+					}
+
+					if (const auto [it, added] = available.try_emplace(std::move(key), id); added) {
+						inserted.push_back(&it->first);
+					} else {
+						replacements[id] = it->second;
+					}
+				}
+
+				const auto size = block.instructions.size();
+				std::erase_if(block.instructions, [&](const ValueId id) { return replacements[id] != id; });
+				if (block.instructions.size() != size) {
+					changed = true;
+					block.phi_count = static_cast<size_t>(std::count_if(block.instructions.begin(), block.instructions.end(),
+						[&](const ValueId id) { return function.values[id].op == Opcode::Phi; }));
+				}
+			}
+
+			const auto& children = dominators.children(frame.block);
+			if (frame.next_child < children.size()) {
+				const auto child = children[frame.next_child++];
+				stack.push_back(Frame { child, 0, 0 });
+				entering = true;
+				continue;
+			}
+
+			while (inserted.size() > frame.mark) {
+				// copied, the key lives in the node being erased
+				available.erase(Key(*inserted.back()));
+				inserted.pop_back();
+			}
+			stack.pop_back();
+			entering = false;
+		}
+
+		if (changed) {
+			replace_uses(function, replacements);
+		}
+		return changed;
+	}
+}
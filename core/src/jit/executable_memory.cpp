@@ -0,0 +1,70 @@
+#include "jit/executable_memory.h"
+
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "exception.h"
+
+namespace seam::jit {
+	ExecutableMemory::ExecutableMemory(const std::vector<uint8_t>& code)
+		: size_(code.size()) {
+		if (code.empty()) {
+			return;
+		}
+
+#ifdef _WIN32
+		memory_ = VirtualAlloc(nullptr, size_, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+		if (memory_ == nullptr) {
+			throw RuntimeException("could not allocate executable memory");
+		}
+		std::memcpy(memory_, code.data(), size_);
+
+		DWORD previous;
+		VirtualProtect(memory_, size_, PAGE_EXECUTE_READ, &previous);
+		FlushInstructionCache(GetCurrentProcess(), memory_, size_);
+#else
+		memory_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (memory_ == MAP_FAILED) {
+			memory_ = nullptr;
+			throw RuntimeException("could not allocate executable memory");
+		}
+		std::memcpy(memory_, code.data(), size_);
+
+		if (mprotect(memory_, size_, PROT_READ | PROT_EXEC) != 0) {
+			munmap(memory_, size_);
+			memory_ = nullptr;
+			throw RuntimeException("could not make memory executable");
+		}
+#endif
+	}
+
+	ExecutableMemory::~ExecutableMemory() {
+		if (memory_ == nullptr) {
+			return;
+		}
+
+#ifdef _WIN32
+		VirtualFree(memory_, 0, MEM_RELEASE);
+#else
+		munmap(memory_, size_);
+#endif
+	}
+
+	ExecutableMemory::ExecutableMemory(ExecutableMemory&& other) noexcept
+		: memory_(std::exchange(other.memory_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+	ExecutableMemory& ExecutableMemory::operator=(ExecutableMemory&& other) noexcept {
+		if (this != &other) {
+			this->~ExecutableMemory();
+			memory_ = std::exchange(other.memory_, nullptr);
+			size_ = std::exchange(other.size_, 0);
+		}
+		return *this;
+	}
+}
@@ -0,0 +1,178 @@
+#include "jit/tiered_executor.h"
+
+#include "backend/x86_64/code_generator.h"
+#include "exception.h"
+
+namespace seam::jit {
+	namespace {
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(_WIN32)
+		// the generated code follows the System V convention
+		constexpr auto native_supported = true;
+#else
+		constexpr auto native_supported = false;
+#endif
+
+		/**
+		 * Integer and double arguments are assigned registers
+		 * independently, so one signature taking every argument register
+		 * can call any generated function. Unused registers are ignored
+		 * by the callee.
+		 */
+		using IntegerEntry = int64_t(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t,
+			double, double, double, double, double, double, double, double);
+		using FloatEntry = double(*)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t,
+			double, double, double, double, double, double, double, double);
+
+		/**
+		 * Whether a function divides integers by anything but a non-zero
+		 * constant, which native code cannot report the way the
+		 * interpreter does.
+		 */
+		bool may_divide_by_zero(const ir::Function& function) {
+			for (const auto& value : function.values) {
+				if (value.op == ir::Opcode::Div && value.type != ir::Type::F64) {
+					const auto& divisor = function.values[value.operands[1]];
+					if (divisor.op != ir::Opcode::Const || divisor.immediate.i64 == 0) {
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+	}
+
+	TieredExecutor::TieredExecutor(const ir::Module& module, const size_t threshold)
+		: module_(module), interpreter_(module), threshold_(threshold),
+		  entries_(module.functions.size(), nullptr), rejected_(module.functions.size(), !native_supported) {
+		interpreter_.set_call_handler(this);
+	}
+
+	bool TieredExecutor::may_trap(const ir::FunctionId function) const {
+		// compiled functions were checked when they were compiled
+		std::vector<bool> seen(module_.functions.size(), false);
+		std::vector<ir::FunctionId> worklist { function };
+		seen[function] = true;
+
+		while (!worklist.empty()) {
+			const auto& current = module_.functions[worklist.back()];
+			worklist.pop_back();
+			if (may_divide_by_zero(current)) {
+				return true;
+			}
+
+			for (const auto& value : current.values) {
+				if (value.op == ir::Opcode::Call && !seen[value.immediate.index] && entries_[value.immediate.index] == nullptr) {
+					seen[value.immediate.index] = true;
+					worklist.push_back(value.immediate.index);
+				}
+			}
+		}
+		return false;
+	}
+
+	void TieredExecutor::compile(const ir::FunctionId function) {
+		// a division by zero has to raise the interpreter's RuntimeException, not trap
+		if (may_trap(function)) {
+			rejected_[function] = true;
+			return;
+		}
+
+		backend::ObjectCode object;
+		try {
+			// functions compiled before are called where they are
+			const backend::x86_64::CodeGenerator::StackLimit stack_limit {
+				&stack_limit_,
+				[](void* executor) { std::longjmp(static_cast<TieredExecutor*>(executor)->escape_, 1); },
+				this,
+			};
+			object = backend::x86_64::CodeGenerator(stack_limit).generate(module_, { function }, entries_);
+		} catch (const CodegenException&) {
+			// e.g. too many arguments, the function stays interpreted
+			rejected_[function] = true;
+			return;
+		}
+		if (!object.relocations.empty()) {
+			// calls into other modules cannot be linked here
+			rejected_[function] = true;
+			return;
+		}
+
+		const auto& memory = code_.emplace_back(object.text);
+
+		// callees not yet compiled were compiled along with the function
+		for (ir::FunctionId id = 0; id < module_.functions.size(); id++) {
+			if (entries_[id] == nullptr) {
+				if (const auto offset = object.find(module_.functions[id].name)) {
+					entries_[id] = memory.address(*offset);
+				}
+			}
+		}
+	}
+
+	bool TieredExecutor::run_native(const ir::FunctionId function, const std::vector<ir::Value>& arguments, ir::Value& result) {
+		const auto& callee = module_.functions[function];
+
+		int64_t integers[6] {};
+		double floats[8] {};
+		size_t integer_count = 0, float_count = 0;
+		for (size_t i = 0; i < arguments.size(); i++) {
+			if (callee.params[i] == ir::Type::F64) floats[float_count++] = arguments[i].f64;
+			else integers[integer_count++] = arguments[i].i64;
+		}
+
+		// only the generated frames are skipped on the way back, none of them has anything to destroy
+		stack_limit_ = reinterpret_cast<uintptr_t>(&integers) - native_stack_budget;
+		if (setjmp(escape_)) {
+			return false;
+		}
+
+		if (callee.result == ir::Type::F64) {
+			const auto entry = reinterpret_cast<FloatEntry>(entries_[function]);
+			result.f64 = entry(integers[0], integers[1], integers[2], integers[3], integers[4], integers[5],
+				floats[0], floats[1], floats[2], floats[3], floats[4], floats[5], floats[6], floats[7]);
+		} else {
+			const auto entry = reinterpret_cast<IntegerEntry>(entries_[function]);
+			result.i64 = entry(integers[0], integers[1], integers[2], integers[3], integers[4], integers[5],
+				floats[0], floats[1], floats[2], floats[3], floats[4], floats[5], floats[6], floats[7]);
+		}
+		return true;
+	}
+
+	bool TieredExecutor::handle(const ir::FunctionId function, const std::vector<ir::Value>& arguments, ir::Value& result) {
+		if (interpreting_) {
+			return false;
+		}
+		if (entries_[function] == nullptr && !rejected_[function]) {
+			const auto& profile = interpreter_.profile(function);
+			if (profile.calls + profile.back_edges >= threshold_) {
+				compile(function);
+			}
+		}
+
+		if (entries_[function] == nullptr) {
+			return false;
+		}
+		if (run_native(function, arguments, result)) {
+			return true;
+		}
+
+		// unbounded or very deep recursion, the interpreter raises its depth limit or finishes the call
+		interpreting_ = true;
+		try {
+			result = interpreter_.call(function, arguments);
+		} catch (...) {
+			interpreting_ = false;
+			throw;
+		}
+		interpreting_ = false;
+		return true;
+	}
+
+	ir::Value TieredExecutor::call(const ir::FunctionId function, const std::vector<ir::Value>& arguments) {
+		ir::Value result;
+		if (handle(function, arguments, result)) {
+			return result;
+		}
+		return interpreter_.call(function, arguments);
+	}
+}
@@ -0,0 +1,372 @@
+#include <algorithm>
+
+#include "ast/recursive_visitor.h"
+#include "lsp/document.h"
+#include "parser/parser.h"
+#include "parser/token_buffer.h"
+#include "semantic/name_resolver.h"
+#include "semantic/type_checker.h"
+
+namespace seam::lsp {
+	namespace {
+		/**
+		 * Visits every node of a declaration, exposing positions and names.
+		 */
+		class Walker : public ast::RecursiveVisitor<Walker> {
+		protected:
+			virtual void position(SourcePosition& position) {}
+
+			virtual void declaration(const std::string& name, const symbol::Symbol* symbol, SourcePosition& position) {
+				this->position(position);
+			}
+
+			virtual void identifier(ast::expression::Identifier& expr) {
+				position(expr.position);
+			}
+		public:
+			void enter(ast::FunctionDeclaration& func) {
+				declaration(func.name, func.symbol, func.position);
+				for (auto& param : func.params) {
+					declaration(param.name, param.symbol, param.position);
+				}
+			}
+
+			void enter(ast::TypeDeclaration& decl) { position(decl.position); }
+			void enter(ast::TypeAliasDeclaration& decl) { position(decl.position); }
+
+			void leave(ast::statement::LetStatement& stat) {
+				if (stat.name != "<DISCARD>") {
+					declaration(stat.name, stat.symbol, stat.position);
+				} else {
+					position(stat.position);
+				}
+			}
+
+			void enter(ast::statement::ReturnStatement& stat) { position(stat.position); }
+			void enter(ast::expression::StringLiteral& expr) { position(expr.position); }
+			void enter(ast::expression::NumberLiteral& expr) { position(expr.position); }
+			void enter(ast::expression::BooleanLiteral& expr) { position(expr.position); }
+			void enter(ast::expression::UnaryExpression& expr) { position(expr.position); }
+			void enter(ast::expression::BinaryExpression& expr) { position(expr.position); }
+			void enter(ast::expression::PostfixExpression& expr) { position(expr.position); }
+			void enter(ast::expression::Identifier& expr) { identifier(expr); }
+			void enter(ast::expression::FunctionCall& expr) { position(expr.position); }
+		};
+
+		/**
+		 * Moves every position by an offset.
+		 */
+		class Shifter final : public Walker {
+			ptrdiff_t shift_;
+		protected:
+			void position(SourcePosition& position) override {
+				position.start_idx += shift_;
+				position.end_idx += shift_;
+			}
+		public:
+			explicit Shifter(const ptrdiff_t shift)
+				: shift_(shift) {}
+		};
+
+		/**
+		 * Finds the name covering an offset.
+		 */
+		class Finder final : public Walker {
+			size_t offset_;
+
+			[[nodiscard]] bool covers(const SourcePosition& position) const {
+				return position.start_idx <= offset_ && offset_ <= position.end_idx;
+			}
+		protected:
+			void declaration(const std::string& name, const symbol::Symbol* symbol, SourcePosition& position) override {
+				if (covers(position)) {
+					this->name = name;
+					this->symbol = symbol;
+					reference = position;
+				}
+			}
+
+			void identifier(ast::expression::Identifier& expr) override {
+				if (covers(expr.position)) {
+					name = expr.identifier;
+					symbol = expr.symbol;
+					reference = expr.position;
+				}
+			}
+		public:
+			std::string name;
+			const symbol::Symbol* symbol = nullptr;
+			SourcePosition reference { 0, 0 };
+
+			explicit Finder(const size_t offset)
+				: offset_(offset) {}
+		};
+
+		// imports get slices of their own, without a declaration
+		bool starts_declaration(const TokenType type) {
+			return type == TokenType::KeywordFn || type == TokenType::KeywordType || type == TokenType::KeywordImport;
+		}
+
+		// units the character a UTF-8 sequence starts with takes, only those past U+FFFF need a surrogate pair
+		size_t code_units(const char lead, const PositionEncoding encoding) {
+			return encoding == PositionEncoding::Utf16 && static_cast<unsigned char>(lead) >= 0xf0 ? 2 : 1;
+		}
+
+		void track_depth(const TokenType type, size_t& depth) {
+			// unbalanced closing braces are left to the parser, the next declaration still starts a slice
+			if (type == TokenType::OpenBrace) {
+				depth++;
+			} else if (type == TokenType::CloseBrace && depth) {
+				depth--;
+			}
+		}
+	}
+
+	void Document::index_lines() {
+		const auto& text = source_->get();
+
+		line_starts_.assign(1, 0);
+		for (size_t i = 0; i < text.length(); i++) {
+			if (text[i] == '\n') {
+				line_starts_.push_back(i + 1);
+			}
+		}
+	}
+
+	void Document::reparse(const size_t first, size_t last, const size_t begin, const size_t min_end) {
+		Lexer lexer(source_.get(), begin);
+
+		// lex until a declaration keyword at the top level lands where an untouched slice starts
+		std::vector<std::unique_ptr<Token>> tokens;
+		std::unique_ptr<Token> boundary;
+		size_t depth = 0;
+		while (true) {
+			auto token = lexer.next();
+			if (token->type == TokenType::None) {
+				boundary = std::move(token);
+				last = slices_.size();
+				break;
+			}
+
+			const auto start = token->position.start_idx;
+			while (last < slices_.size() && slices_[last].begin < start) {
+				last++;
+			}
+			if (depth == 0 && starts_declaration(token->type) && start >= min_end
+				&& last < slices_.size() && slices_[last].begin == start) {
+				boundary = std::move(token);
+				break;
+			}
+
+			track_depth(token->type, depth);
+			tokens.push_back(std::move(token));
+		}
+
+		// split at the top-level declarations, each followed by the token after it
+		std::vector<size_t> starts { 0 };
+		depth = 0;
+		for (size_t i = 0; i < tokens.size(); i++) {
+			if (i && depth == 0 && starts_declaration(tokens[i]->type)) {
+				starts.push_back(i);
+			}
+			track_depth(tokens[i]->type, depth);
+		}
+		starts.push_back(tokens.size());
+
+		std::vector<Slice> slices;
+		for (size_t range = 0; range + 1 < starts.size(); range++) {
+			const auto from = starts[range];
+			const auto to = starts[range + 1];
+
+			auto& slice = slices.emplace_back(Slice { range ? tokens[from]->position.start_idx : begin });
+			if (from == to) {
+				continue;
+			}
+
+			const auto is_import = tokens[from]->type == TokenType::KeywordImport;
+			std::vector<std::unique_ptr<Token>> buffer;
+			buffer.reserve(to - from + 1);
+			for (auto i = from; i < to; i++) {
+				buffer.push_back(std::move(tokens[i]));
+			}
+			buffer.push_back(std::make_unique<Token>(to < tokens.size() ? *tokens[to] : *boundary));
+
+			try {
+				Parser parser(std::make_unique<TokenBuffer>(std::move(buffer)));
+				if (is_import) {
+					(void) parser.parse_top_level_import();
+				} else {
+					slice.decl = parser.parse_top_level_declaration();
+				}
+			} catch (const SeamException& e) {
+				slice.error = DocumentDiagnostic { e.position(), e.what() };
+			}
+		}
+		reparsed_ = slices.size();
+
+		slices_.erase(slices_.begin() + first, slices_.begin() + last);
+		slices_.insert(slices_.begin() + first, std::make_move_iterator(slices.begin()), std::make_move_iterator(slices.end()));
+	}
+
+	void Document::analyse() {
+		if (context_) {
+			return;
+		}
+
+		ast::DeclarationList decls;
+		std::vector<Slice*> owners;
+		for (auto& slice : slices_) {
+			if (slice.decl) {
+				if (slice.shift) {
+					Shifter shifter(slice.shift);
+					slice.decl->accept(shifter);
+					slice.shift = 0;
+				}
+				decls.push_back(std::move(slice.decl));
+				owners.push_back(&slice);
+			}
+		}
+
+		// the passes run over the whole program, declarations see each other
+		ast::Program program(std::move(decls));
+		context_ = std::make_unique<semantic::Context>();
+		semantic::NameResolver resolver(*context_);
+		program.accept(resolver);
+		semantic::TypeChecker checker(*context_);
+		program.accept(checker);
+
+		for (size_t i = 0; i < owners.size(); i++) {
+			owners[i]->decl = std::move(program.body[i]);
+		}
+
+		diagnostics_.clear();
+		for (const auto& slice : slices_) {
+			if (slice.error) {
+				diagnostics_.push_back(*slice.error);
+			}
+		}
+		for (const auto& diagnostic : context_->diagnostics()) {
+			diagnostics_.push_back({ diagnostic.position, diagnostic.message() });
+		}
+		std::stable_sort(diagnostics_.begin(), diagnostics_.end(), [](const DocumentDiagnostic& lhs, const DocumentDiagnostic& rhs) {
+			return lhs.position.start_idx < rhs.position.start_idx;
+		});
+	}
+
+	size_t Document::slice_at(const size_t offset) const {
+		const auto it = std::upper_bound(slices_.begin(), slices_.end(), offset, [](const size_t value, const Slice& slice) {
+			return value < slice.begin;
+		});
+		return it == slices_.begin() ? 0 : it - slices_.begin() - 1;
+	}
+
+	Document::Document(std::string text, const PositionEncoding encoding)
+		: encoding_(encoding) {
+		replace(std::move(text));
+	}
+
+	void Document::edit(const Range& range, const std::string& text) {
+		const auto start = offset(range.start);
+		const auto end = std::max(start, offset(range.end));
+		const auto shift = static_cast<ptrdiff_t>(text.length()) - static_cast<ptrdiff_t>(end - start);
+
+		// the slice before is parsed against the first token of the edited one, so it goes too
+		const auto first = std::max<size_t>(slice_at(start), 1) - 1;
+		const auto last = slice_at(end) + 1;
+
+		source_->replace(start, end - start, text);
+		index_lines();
+
+		for (auto i = last; i < slices_.size(); i++) {
+			auto& slice = slices_[i];
+			slice.begin += shift;
+			slice.shift += shift;
+			if (slice.error) {
+				slice.error->position.start_idx += shift;
+				slice.error->position.end_idx += shift;
+			}
+		}
+
+		reparse(first, last, slices_[first].begin, start + text.length());
+		context_.reset();
+	}
+
+	void Document::replace(std::string text) {
+		source_ = std::make_unique<Source>(std::move(text));
+		index_lines();
+
+		slices_.clear();
+		reparse(0, 0, 0, 0);
+		context_.reset();
+	}
+
+	size_t Document::offset(const Position& position) const {
+		if (position.line >= line_starts_.size()) {
+			return source_->get().length();
+		}
+
+		const auto& text = source_->get();
+		const auto end = position.line + 1 < line_starts_.size() ? line_starts_[position.line + 1] - 1 : text.length();
+
+		// characters are counted in the negotiated units, the text is UTF-8
+		auto offset = line_starts_[position.line];
+		for (size_t character = 0; character < position.character && offset < end;) {
+			character += code_units(text[offset], encoding_);
+			offset++;
+			while (offset < end && is_utf8_continuation(text[offset])) {
+				offset++;
+			}
+		}
+		return offset;
+	}
+
+	Position Document::position(const size_t offset) const {
+		const auto line = std::upper_bound(line_starts_.begin(), line_starts_.end(), offset) - line_starts_.begin() - 1;
+		const auto& text = source_->get();
+
+		const auto start = line_starts_[line];
+		size_t character = 0;
+		for (auto i = start; i < std::min(offset, text.length()); i++) {
+			if (!is_utf8_continuation(text[i])) {
+				character += code_units(text[i], encoding_);
+			}
+		}
+		return { static_cast<size_t>(line), character };
+	}
+
+	const std::vector<DocumentDiagnostic>& Document::diagnostics() {
+		analyse();
+		return diagnostics_;
+	}
+
+	std::optional<SymbolInfo> Document::symbol_at(const Position& position) {
+		analyse();
+
+		const auto offset = this->offset(position);
+		const auto& slice = slices_[slice_at(offset)];
+		if (!slice.decl) {
+			return std::nullopt;
+		}
+
+		Finder finder(offset);
+		slice.decl->accept(finder);
+		if (!finder.symbol) {
+			return std::nullopt;
+		}
+
+		const auto symbol = finder.symbol;
+		const auto type = symbol->type_id == type::unresolved_type
+			? "?"
+			: context_->types().name(symbol->type_id, context_->interner());
+
+		std::string description;
+		switch (symbol->type) {
+			case symbol::SymbolType::Function: description = "fn " + finder.name + ": " + type; break;
+			case symbol::SymbolType::Variable: description = "let " + finder.name + ": " + type; break;
+			case symbol::SymbolType::Parameter: description = finder.name + ": " + type; break;
+			case symbol::SymbolType::Type: description = "type " + finder.name; break;
+		}
+
+		return SymbolInfo { finder.reference, std::move(description), symbol->position };
+	}
+}
@@ -0,0 +1,353 @@
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "exception.h"
+#include "lsp/json.h"
+
+namespace seam::lsp {
+	namespace {
+		// nesting deeper than this is rejected rather than risking the stack
+		constexpr size_t max_depth = 256;
+
+		class JsonParser {
+			std::string_view text_;
+			size_t index_ = 0;
+
+			[[noreturn]] void fail(const std::string& message) const {
+				throw ProtocolException(fmt::format("malformed JSON at offset {}: {}", index_, message));
+			}
+
+			void skip_whitespace() {
+				while (index_ < text_.length()
+					&& (text_[index_] == ' ' || text_[index_] == '\t' || text_[index_] == '\n' || text_[index_] == '\r')) {
+					index_++;
+				}
+			}
+
+			void expect(const char c) {
+				skip_whitespace();
+				if (index_ == text_.length() || text_[index_] != c) {
+					fail(fmt::format("expected '{}'", c));
+				}
+				index_++;
+			}
+
+			bool consume_literal(const std::string_view literal) {
+				if (text_.substr(index_, literal.length()) != literal) {
+					return false;
+				}
+				index_ += literal.length();
+				return true;
+			}
+
+			uint32_t parse_hex4() {
+				if (index_ + 4 > text_.length()) {
+					fail("truncated escape");
+				}
+
+				uint32_t value = 0;
+				for (auto i = 0; i < 4; i++) {
+					const auto c = text_[index_++];
+					value <<= 4;
+					if (c >= '0' && c <= '9') {
+						value |= c - '0';
+					} else if (c >= 'a' && c <= 'f') {
+						value |= c - 'a' + 10;
+					} else if (c >= 'A' && c <= 'F') {
+						value |= c - 'A' + 10;
+					} else {
+						fail("invalid escape");
+					}
+				}
+				return value;
+			}
+
+			static void append_utf8(std::string& out, const uint32_t code_point) {
+				if (code_point < 0x80) {
+					out += static_cast<char>(code_point);
+				} else if (code_point < 0x800) {
+					out += static_cast<char>(0xC0 | code_point >> 6);
+					out += static_cast<char>(0x80 | (code_point & 0x3F));
+				} else if (code_point < 0x10000) {
+					out += static_cast<char>(0xE0 | code_point >> 12);
+					out += static_cast<char>(0x80 | (code_point >> 6 & 0x3F));
+					out += static_cast<char>(0x80 | (code_point & 0x3F));
+				} else {
+					out += static_cast<char>(0xF0 | code_point >> 18);
+					out += static_cast<char>(0x80 | (code_point >> 12 & 0x3F));
+					out += static_cast<char>(0x80 | (code_point >> 6 & 0x3F));
+					out += static_cast<char>(0x80 | (code_point & 0x3F));
+				}
+			}
+
+			std::string parse_string() {
+				expect('"');
+
+				std::string out;
+				while (true) {
+					if (index_ == text_.length()) {
+						fail("unterminated string");
+					}
+
+					const auto c = text_[index_++];
+					if (c == '"') {
+						return out;
+					}
+					if (static_cast<unsigned char>(c) < 0x20) {
+						fail("control character in string");
+					}
+					if (c != '\\') {
+						out += c;
+						continue;
+					}
+
+					if (index_ == text_.length()) {
+						fail("unterminated string");
+					}
+					switch (text_[index_++]) {
+						case '"': out += '"'; break;
+						case '\\': out += '\\'; break;
+						case '/': out += '/'; break;
+						case 'b': out += '\b'; break;
+						case 'f': out += '\f'; break;
+						case 'n': out += '\n'; break;
+						case 'r': out += '\r'; break;
+						case 't': out += '\t'; break;
+						case 'u': {
+							auto code_point = parse_hex4();
+							// surrogate pairs combine, lone surrogates become U+FFFD
+							if (code_point >= 0xD800 && code_point < 0xDC00 && consume_literal("\\u")) {
+								const auto low = parse_hex4();
+								code_point = low >= 0xDC00 && low < 0xE000
+									? 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00)
+									: 0xFFFD;
+							} else if (code_point >= 0xD800 && code_point < 0xE000) {
+								code_point = 0xFFFD;
+							}
+							append_utf8(out, code_point);
+							break;
+						}
+						default: fail("invalid escape");
+					}
+				}
+			}
+
+			double parse_number() {
+				const auto start = index_;
+				if (index_ < text_.length() && text_[index_] == '-') {
+					index_++;
+				}
+				while (index_ < text_.length() && (std::isdigit(static_cast<unsigned char>(text_[index_]))
+					|| text_[index_] == '.' || text_[index_] == 'e' || text_[index_] == 'E'
+					|| text_[index_] == '+' || text_[index_] == '-')) {
+					index_++;
+				}
+
+				const std::string digits(text_.substr(start, index_ - start));
+				char* end = nullptr;
+				const auto value = std::strtod(digits.c_str(), &end);
+				if (digits.empty() || end != digits.c_str() + digits.length()) {
+					fail("invalid number");
+				}
+				return value;
+			}
+
+			Json parse_value(const size_t depth) {
+				if (depth > max_depth) {
+					fail("nesting too deep");
+				}
+
+				skip_whitespace();
+				if (index_ == text_.length()) {
+					fail("unexpected end of input");
+				}
+
+				switch (text_[index_]) {
+					case '{': {
+						index_++;
+						Json::Object object;
+						skip_whitespace();
+						if (index_ < text_.length() && text_[index_] == '}') {
+							index_++;
+							return object;
+						}
+						while (true) {
+							auto key = parse_string();
+							expect(':');
+							object.insert_or_assign(std::move(key), parse_value(depth + 1));
+
+							skip_whitespace();
+							if (index_ < text_.length() && text_[index_] == ',') {
+								index_++;
+								continue;
+							}
+							expect('}');
+							return object;
+						}
+					}
+					case '[': {
+						index_++;
+						Json::Array array;
+						skip_whitespace();
+						if (index_ < text_.length() && text_[index_] == ']') {
+							index_++;
+							return array;
+						}
+						while (true) {
+							array.push_back(parse_value(depth + 1));
+
+							skip_whitespace();
+							if (index_ < text_.length() && text_[index_] == ',') {
+								index_++;
+								continue;
+							}
+							expect(']');
+							return array;
+						}
+					}
+					case '"': return parse_string();
+					default: {
+						if (consume_literal("null")) {
+							return nullptr;
+						}
+						if (consume_literal("true")) {
+							return true;
+						}
+						if (consume_literal("false")) {
+							return false;
+						}
+						return parse_number();
+					}
+				}
+			}
+		public:
+			explicit JsonParser(const std::string_view text)
+				: text_(text) {}
+
+			Json parse() {
+				auto value = parse_value(0);
+				skip_whitespace();
+				if (index_ != text_.length()) {
+					fail("trailing characters");
+				}
+				return value;
+			}
+		};
+
+		void dump_string(std::string& out, const std::string& value) {
+			out += '"';
+			for (const auto c : value) {
+				switch (c) {
+					case '"': out += "\\\""; break;
+					case '\\': out += "\\\\"; break;
+					case '\n': out += "\\n"; break;
+					case '\r': out += "\\r"; break;
+					case '\t': out += "\\t"; break;
+					default: {
+						if (static_cast<unsigned char>(c) < 0x20) {
+							char escape[8];
+							std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+							out += escape;
+						} else {
+							out += c;
+						}
+					}
+				}
+			}
+			out += '"';
+		}
+
+		const Json null_value;
+		const std::string empty_string;
+		const Json::Array empty_array;
+		const Json::Object empty_object;
+	}
+
+	Json Json::parse(const std::string_view text) {
+		return JsonParser(text).parse();
+	}
+
+	void Json::dump(std::string& out) const {
+		if (is_null()) {
+			out += "null";
+		} else if (const auto boolean = std::get_if<bool>(&value_)) {
+			out += *boolean ? "true" : "false";
+		} else if (const auto number = std::get_if<double>(&value_)) {
+			// integers, like ids and positions, print without a fraction
+			if (!std::isfinite(*number)) {
+				out += "null";
+			} else if (*number == std::floor(*number) && std::abs(*number) < 9007199254740992.0) {
+				out += std::to_string(static_cast<int64_t>(*number));
+			} else {
+				out += fmt::format("{}", *number);
+			}
+		} else if (const auto string = std::get_if<std::string>(&value_)) {
+			dump_string(out, *string);
+		} else if (const auto array = std::get_if<Array>(&value_)) {
+			out += '[';
+			for (size_t i = 0; i < array->size(); i++) {
+				if (i) {
+					out += ',';
+				}
+				(*array)[i].dump(out);
+			}
+			out += ']';
+		} else {
+			out += '{';
+			auto first = true;
+			for (const auto& [key, value] : std::get<Object>(value_)) {
+				if (!first) {
+					out += ',';
+				}
+				first = false;
+				dump_string(out, key);
+				out += ':';
+				value.dump(out);
+			}
+			out += '}';
+		}
+	}
+
+	std::string Json::dump() const {
+		std::string out;
+		dump(out);
+		return out;
+	}
+
+	bool Json::as_bool() const {
+		const auto value = std::get_if<bool>(&value_);
+		return value && *value;
+	}
+
+	double Json::as_number() const {
+		const auto value = std::get_if<double>(&value_);
+		return value ? *value : 0;
+	}
+
+	const std::string& Json::as_string() const {
+		const auto value = std::get_if<std::string>(&value_);
+		return value ? *value : empty_string;
+	}
+
+	const Json::Array& Json::as_array() const {
+		const auto value = std::get_if<Array>(&value_);
+		return value ? *value : empty_array;
+	}
+
+	const Json::Object& Json::as_object() const {
+		const auto value = std::get_if<Object>(&value_);
+		return value ? *value : empty_object;
+	}
+
+	const Json& Json::operator[](const std::string_view key) const {
+		const auto& object = as_object();
+		const auto it = object.find(key);
+		return it == object.end() ? null_value : it->second;
+	}
+
+	bool Json::contains(const std::string_view key) const {
+		return as_object().find(key) != as_object().end();
+	}
+}
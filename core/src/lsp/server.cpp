@@ -0,0 +1,269 @@
+#include "exception.h"
+#include "lsp/server.h"
+
+namespace seam::lsp {
+	namespace {
+		// JSON-RPC error codes
+		constexpr auto parse_error = -32700;
+		constexpr auto method_not_found = -32601;
+		constexpr auto invalid_request = -32600;
+
+		Position to_position(const Json& json) {
+			return { static_cast<size_t>(json["line"].as_int()), static_cast<size_t>(json["character"].as_int()) };
+		}
+
+		Json to_json(const Position& position) {
+			return Json::Object { { "line", position.line }, { "character", position.character } };
+		}
+	}
+
+	std::optional<std::string> read_message(std::istream& in) {
+		std::optional<size_t> length;
+
+		std::string line;
+		while (std::getline(in, line)) {
+			if (!line.empty() && line.back() == '\r') {
+				line.pop_back();
+			}
+			if (line.empty()) {
+				break;
+			}
+
+			constexpr std::string_view header = "Content-Length:";
+			if (line.compare(0, header.length(), header) == 0) {
+				try {
+					length = std::stoul(line.substr(header.length()));
+				} catch (const std::exception&) {
+					throw ProtocolException("malformed Content-Length header");
+				}
+			}
+		}
+
+		if (!in) {
+			return std::nullopt;
+		}
+		if (!length) {
+			throw ProtocolException("message without a Content-Length header");
+		}
+
+		std::string body(*length, '\0');
+		if (!in.read(body.data(), static_cast<std::streamsize>(*length))) {
+			return std::nullopt;
+		}
+		return body;
+	}
+
+	void write_message(std::ostream& out, const std::string& body) {
+		out << "Content-Length: " << body.length() << "\r\n\r\n" << body;
+		out.flush();
+	}
+
+	Server::Server(std::function<void(const Json&)> send)
+		: send_(std::move(send)) {}
+
+	void Server::respond(const Json& id, Json result) {
+		send_(Json::Object { { "jsonrpc", "2.0" }, { "id", id }, { "result", std::move(result) } });
+	}
+
+	void Server::respond_error(const Json& id, const int code, const std::string& message) {
+		send_(Json::Object {
+			{ "jsonrpc", "2.0" },
+			{ "id", id },
+			{ "error", Json::Object { { "code", code }, { "message", message } } }
+		});
+	}
+
+	Json Server::range(Document& document, const SourcePosition position) const {
+		// positions are inclusive, ranges end after the last character
+		return Json::Object {
+			{ "start", to_json(document.position(position.start_idx)) },
+			{ "end", to_json(document.position(std::min(position.end_idx + 1, document.text().length()))) }
+		};
+	}
+
+	Document* Server::find(const Json& params) {
+		const auto it = documents_.find(params["textDocument"]["uri"].as_string());
+		return it == documents_.end() ? nullptr : &it->second;
+	}
+
+	Json Server::initialize(const Json& params) {
+		// utf-16 is the only encoding a client has to support
+		encoding_ = PositionEncoding::Utf16;
+		for (const auto& encoding : params["capabilities"]["general"]["positionEncodings"].as_array()) {
+			if (encoding == Json("utf-32")) {
+				encoding_ = PositionEncoding::Utf32;
+			}
+		}
+
+		return Json::Object {
+			{ "capabilities", Json::Object {
+				{ "positionEncoding", encoding_ == PositionEncoding::Utf32 ? "utf-32" : "utf-16" },
+				{ "textDocumentSync", Json::Object { { "openClose", true }, { "change", 2 } } },
+				{ "hoverProvider", true },
+				{ "definitionProvider", true }
+			} },
+			{ "serverInfo", Json::Object { { "name", "seam-lsp" } } }
+		};
+	}
+
+	void Server::did_open(const Json& params) {
+		const auto& item = params["textDocument"];
+		const auto& uri = item["uri"].as_string();
+
+		documents_.insert_or_assign(uri, Document(item["text"].as_string(), encoding_));
+		stale_.insert(uri);
+	}
+
+	void Server::did_change(const Json& params) {
+		const auto document = find(params);
+		if (!document) {
+			return;
+		}
+
+		for (const auto& change : params["contentChanges"].as_array()) {
+			if (change.contains("range")) {
+				const auto& range = change["range"];
+				document->edit({ to_position(range["start"]), to_position(range["end"]) }, change["text"].as_string());
+			} else {
+				document->replace(change["text"].as_string());
+			}
+		}
+		stale_.insert(params["textDocument"]["uri"].as_string());
+	}
+
+	void Server::did_close(const Json& params) {
+		const auto& uri = params["textDocument"]["uri"].as_string();
+		documents_.erase(uri);
+		stale_.erase(uri);
+
+		// clear what the client still shows
+		send_(Json::Object {
+			{ "jsonrpc", "2.0" },
+			{ "method", "textDocument/publishDiagnostics" },
+			{ "params", Json::Object { { "uri", uri }, { "diagnostics", Json::Array {} } } }
+		});
+	}
+
+	Json Server::hover(const Json& params) {
+		const auto document = find(params);
+		if (!document) {
+			return nullptr;
+		}
+
+		const auto symbol = document->symbol_at(to_position(params["position"]));
+		if (!symbol) {
+			return nullptr;
+		}
+
+		return Json::Object {
+			{ "contents", Json::Object { { "kind", "markdown" }, { "value", "```seam\n" + symbol->description + "\n```" } } },
+			{ "range", range(*document, symbol->reference) }
+		};
+	}
+
+	Json Server::definition(const Json& params) {
+		const auto document = find(params);
+		if (!document) {
+			return nullptr;
+		}
+
+		const auto symbol = document->symbol_at(to_position(params["position"]));
+		if (!symbol) {
+			return nullptr;
+		}
+
+		return Json::Object {
+			{ "uri", params["textDocument"]["uri"] },
+			{ "range", range(*document, symbol->definition) }
+		};
+	}
+
+	void Server::handle(const Json& message) {
+		const auto& method = message["method"].as_string();
+		const auto& params = message["params"];
+		const auto is_request = message.contains("id");
+		const auto& id = message["id"];
+
+		if (method == "exit") {
+			exit_code_ = shutdown_ ? 0 : 1;
+			return;
+		}
+		if (shutdown_ && is_request) {
+			respond_error(id, invalid_request, "server is shutting down");
+			return;
+		}
+
+		if (method == "initialize") {
+			respond(id, initialize(params));
+		} else if (method == "shutdown") {
+			shutdown_ = true;
+			respond(id, nullptr);
+		} else if (method == "textDocument/didOpen") {
+			did_open(params);
+		} else if (method == "textDocument/didChange") {
+			did_change(params);
+		} else if (method == "textDocument/didClose") {
+			did_close(params);
+		} else if (method == "textDocument/hover") {
+			respond(id, hover(params));
+		} else if (method == "textDocument/definition") {
+			respond(id, definition(params));
+		} else if (is_request) {
+			respond_error(id, method_not_found, "unsupported method " + method);
+		}
+		// other notifications, like initialized, need no action
+	}
+
+	void Server::idle() {
+		for (const auto& uri : stale_) {
+			auto& document = documents_.at(uri);
+
+			Json::Array diagnostics;
+			for (const auto& diagnostic : document.diagnostics()) {
+				diagnostics.emplace_back(Json::Object {
+					{ "range", range(document, diagnostic.position) },
+					{ "severity", 1 },
+					{ "source", "seam" },
+					{ "message", diagnostic.message }
+				});
+			}
+
+			send_(Json::Object {
+				{ "jsonrpc", "2.0" },
+				{ "method", "textDocument/publishDiagnostics" },
+				{ "params", Json::Object { { "uri", uri }, { "diagnostics", std::move(diagnostics) } } }
+			});
+		}
+		stale_.clear();
+	}
+
+	int Server::run(std::istream& in, std::ostream& out) {
+		send_ = [&out](const Json& message) {
+			write_message(out, message.dump());
+		};
+
+		while (!exit_code_) {
+			std::optional<std::string> body;
+			try {
+				body = read_message(in);
+			} catch (const ProtocolException&) {
+				return 1;
+			}
+			if (!body) {
+				return 1;
+			}
+
+			try {
+				handle(Json::parse(*body));
+			} catch (const ProtocolException& e) {
+				respond_error(nullptr, parse_error, e.what());
+			}
+
+			// diagnostics wait until the client stops sending
+			if (!exit_code_ && in.rdbuf()->in_avail() <= 0) {
+				idle();
+			}
+		}
+		return *exit_code_;
+	}
+}
@@ -1,36 +1,44 @@
-#include <cwctype>
+#include <cctype>
+#include <cstdio>
 #include <unordered_map>
 
 #include "parser/lexer.h"
-#include "exception.h"
-#include "localisation/localisation.h"
 
 namespace seam {
 	namespace {
-		const std::unordered_map<std::wstring, TokenType> str_to_keyword_map {
-			{ L"let",    TokenType::KeywordLet },
-			{ L"fn",     TokenType::KeywordFn },
-			{ L"type",   TokenType::KeywordType },
-			{ L"while",  TokenType::KeywordWhile },
-			{ L"for",    TokenType::KeywordFor },
-			{ L"true",   TokenType::KeywordTrue },
-			{ L"false",  TokenType::KeywordFalse },
-			{ L"import", TokenType::KeywordImport },
-			{ L"if",     TokenType::KeywordIf },
-			{ L"else",   TokenType::KeywordElse },
-			{ L"elseif", TokenType::KeywordElseIf }
+		const std::unordered_map<std::string, TokenType> str_to_keyword_map {
+			{ "let",    TokenType::KeywordLet },
+			{ "fn",     TokenType::KeywordFn },
+			{ "type",   TokenType::KeywordType },
+			{ "while",  TokenType::KeywordWhile },
+			{ "for",    TokenType::KeywordFor },
+			{ "true",   TokenType::KeywordTrue },
+			{ "false",  TokenType::KeywordFalse },
+			{ "import", TokenType::KeywordImport },
+			{ "if",     TokenType::KeywordIf },
+			{ "else",   TokenType::KeywordElse },
+			{ "elseif", TokenType::KeywordElseIf },
+			{ "return", TokenType::KeywordReturn }
 		};
 	}
 
-	wchar_t Lexer::peek_character(const size_t num_characters_ahead) const {
+	int Lexer::peek_character(const size_t num_characters_ahead) const {
 		return source_reader_.peek_char(num_characters_ahead);
 	}
 
-	wchar_t Lexer::next_character() {
+	int Lexer::next_character() {
 		return source_reader_.next_char();
 	}
 
-	std::wstring Lexer::consume() {
+	std::string Lexer::peek_character_text() const {
+		std::string text(1, static_cast<char>(peek_character()));
+		for (auto next = peek_character(1); next != EOF && is_utf8_continuation(static_cast<char>(next)); next = peek_character(text.size())) {
+			text += static_cast<char>(next);
+		}
+		return text;
+	}
+
+	std::string Lexer::consume() {
 		return source_reader_.consume();
 	}
 
@@ -41,15 +49,13 @@ namespace seam {
 		};
 	}
 
-	std::wstring Lexer::read_until(const wchar_t character) {
+	std::optional<std::string> Lexer::read_until(const char character) {
 		auto current_character = peek_character();
 
 		while (current_character != character) {
-			if (current_character == WEOF) {
-				throw generate_exception<LexicalException>(
-					get_current_pos(),
-					LEX_UNEXPECTED_WEOF_EXCEPTION_FMT,
-					character);
+			if (current_character == EOF) {
+				tokenize_error(DiagnosticCode::UnexpectedEof, std::string(1, character));
+				return std::nullopt;
 			}
 			
 			next_character();
@@ -63,7 +69,22 @@ namespace seam {
 		return lexeme;
 	}
 
-	TokenType Lexer::check_next(const std::unordered_map<wchar_t, TokenType>& map, TokenType default_symbol) {
+	void Lexer::tokenize_error(const DiagnosticCode code, std::string argument) {
+		next_token_ = std::make_unique<Token>(
+			code,
+			std::move(argument),
+			get_current_pos());
+
+		source_reader_.discard();
+	}
+
+	void Lexer::skip_malformed_literal() {
+		while (std::isalnum(peek_character()) || peek_character() == '.') {
+			next_character();
+		}
+	}
+
+	TokenType Lexer::check_next(const std::unordered_map<int, TokenType>& map, TokenType default_symbol) {
 		if (map.find(peek_character()) != map.cend()) {
 			return map.at(next_character());
 		}
@@ -89,15 +110,13 @@ namespace seam {
 					break;
 				}
 
-				if (next_character() == WEOF) {
-					throw generate_exception<LexicalException>(
-						get_current_pos(),
-						LEX_UNEXPECTED_WEOF_EXCEPTION_FMT,
-						L"///");
+				if (next_character() == EOF) {
+					tokenize_error(DiagnosticCode::UnexpectedEof, "///");
+					return;
 				}
 				// TODO: terminate on 3 slashes
 			}
-			else if (const auto next_wchar_t = next_character(); next_wchar_t == '\n' || next_wchar_t == WEOF) {
+			else if (const auto next_char = next_character(); next_char == '\n' || next_char == EOF) {
 				break;
 			}
 		}
@@ -116,48 +135,43 @@ namespace seam {
 			next_character();
 		}
 
-		if (const auto next_char = next_character(); (is_hex && !std::iswxdigit(next_char)) || (!is_hex && !std::iswdigit(next_char))) {
-			throw generate_exception<LexicalException>(
-				get_current_pos(),
-				LEX_MALFORMED_NUMBER_LITERAL);
+		if (const auto next_char = next_character(); (is_hex && !std::isxdigit(next_char)) || (!is_hex && !std::isdigit(next_char))) {
+			skip_malformed_literal();
+			tokenize_error(DiagnosticCode::MalformedNumberLiteral);
+			return;
 		}
 
 		while(true) {
 			const auto peeked_character = peek_character();
-			if (std::iswspace(peeked_character) || peeked_character == WEOF) {
+			if (std::isspace(peeked_character) || peeked_character == EOF) {
 				break; // parse number
 			}
 
 			if (is_hex) {
-				if (!std::iswxdigit(peeked_character)) {
-					throw generate_exception<LexicalException>(
-						get_current_pos(),
-						EXPECTED_BUT_GOT,
-						L"hex-digit",
-						peeked_character
-						);
+				if (!std::isxdigit(peeked_character)) {
+					auto character = peek_character_text();
+					skip_malformed_literal();
+					tokenize_error(DiagnosticCode::ExpectedHexDigit, std::move(character));
+					return;
 				}
 			} else {
 				if (is_float && peeked_character == '.') {
-					throw generate_exception<LexicalException>(
-						get_current_pos(),
-						LEX_MALFORMED_FLOATING_POINT_NUMBER_LITERAL,
-						LEX_MALFORMED_FLOAT_TWO_POINTS);
+					skip_malformed_literal();
+					tokenize_error(DiagnosticCode::MalformedFloatTwoPoints);
+					return;
 				}
 
 				if (!is_float && peeked_character == '.') {
 					is_float = true;
-				} else if (!std::iswdigit(peeked_character)) {
-					if (std::ispunct(peeked_character) || std::iswspace(peeked_character) || peeked_character == WEOF) {
+				} else if (!std::isdigit(peeked_character)) {
+					if (std::ispunct(peeked_character) || std::isspace(peeked_character) || peeked_character == EOF) {
 						break;
 					}
 
-					throw generate_exception<LexicalException>(
-						get_current_pos(),
-						EXPECTED_BUT_GOT,
-						L"digit",
-						peeked_character
-						);
+					auto character = peek_character_text();
+					skip_malformed_literal();
+					tokenize_error(DiagnosticCode::ExpectedDigit, std::move(character));
+					return;
 				}
 			}
 			next_character();
@@ -192,6 +206,12 @@ namespace seam {
                                 TokenType::OpSub);
 			break;
 		}
+		case '&': {
+			symbol = check_next({
+				{ '&', TokenType::OpLogicalAnd } },
+                                TokenType::OpBitwiseAnd);
+			break;
+		}
 		case '/': symbol = TokenType::OpDiv; break;
 		case '*': symbol = TokenType::OpMul; break;
 		case '(': symbol = TokenType::OpenParen; break;
@@ -211,21 +231,25 @@ namespace seam {
 			break;
 		}
 		case ',': symbol = TokenType::Comma; break;
+		case '.': symbol = TokenType::Dot; break;
 		default: {
-			throw generate_exception<LexicalException>(
-				get_current_pos(),
-				L"unknown symbol found {}",
-				c);
+			// the rest of a multibyte character goes with it
+			while (peek_character() != EOF && is_utf8_continuation(static_cast<char>(peek_character()))) {
+				next_character();
+			}
+			tokenize_error(DiagnosticCode::UnknownSymbol, consume());
+			return;
 		}
 		}
 
+		current_end_idx_ = source_reader_.current_pos();
 		source_reader_.discard();
 		next_token_ = std::make_unique<Token>(
 			symbol,
-			L"",
+			"",
 			SourcePosition{
 				current_start_idx_,
-				current_end_idx_
+				current_end_idx_ - 1
 			});
 	}
 	
@@ -234,7 +258,7 @@ namespace seam {
 
 		auto next_char = peek_character();
 		
-		while (std::iswalnum(next_char) || next_char == '_') {
+		while (std::isalnum(next_char) || next_char == '_') {
 			if (!must_be_identifier && next_char == '_') {
 				must_be_identifier = true;
 			}
@@ -248,7 +272,7 @@ namespace seam {
 		if (const auto identifier = consume(); !must_be_identifier && str_to_keyword_map.find(identifier) != str_to_keyword_map.cend()) {
 			next_token_ = std::make_unique<Token>(
 				str_to_keyword_map.at(identifier),
-				L"",
+				"",
 				SourcePosition{ current_start_idx_, current_end_idx_ - 1 });
 		} else {
 			next_token_ = std::make_unique<Token>(
@@ -264,10 +288,13 @@ namespace seam {
 
 		// read until closing tag
 		auto lexeme = read_until('"');
+		if (!lexeme) {
+			return;
+		}
 
 		next_token_ = std::make_unique<Token>(
                 TokenType::StringLiteral,
-                std::move(lexeme),
+                std::move(*lexeme),
                 SourcePosition {
 				current_start_idx_,
 				current_end_idx_ - 1
@@ -275,23 +302,32 @@ namespace seam {
 	}
 	
 	void Lexer::tokenize() {
-		source_reader_.discard_whitespace();
+		// comments emit no token, skip them in a loop so a run of them cannot exhaust the stack
+		while (true) {
+			source_reader_.discard_whitespace();
 
-		// set start read index
-		current_start_idx_ = source_reader_.start_pointer();
+			// set start read index
+			current_start_idx_ = source_reader_.start_pointer();
+
+			if (peek_character() != '/' || peek_character(1) != '/') {
+				break;
+			}
+			source_reader_.discard(2);
+			tokenize_comment();
+
+			if (next_token_) {
+				return;
+			}
+		}
 		
 		if (const auto next_character = peek_character(); next_character == '"') {
 			tokenize_string();
-		} else if (next_character == '/' && peek_character(1) == '/') {
-			source_reader_.discard(2);
-			tokenize_comment();
-			tokenize();
-		} else if (std::iswdigit(next_character)
-			|| next_character == L'.' && std::iswdigit(peek_character(1))) {
+		} else if (std::isdigit(next_character)
+			|| next_character == '.' && std::isdigit(peek_character(1))) {
 			tokenize_number_literal();
-		} else if (std::iswalpha(next_character) || next_character == '_') {
+		} else if (std::isalpha(next_character) || next_character == '_') {
 			tokenize_identifier_or_keyword();
-		} else if (std::iswpunct(next_character)) {
+		} else if (std::ispunct(next_character) || next_character > 0x7f) {
 			tokenize_symbol();
 		} 
 
@@ -299,15 +335,15 @@ namespace seam {
 			// empty?
 			next_token_ = std::make_unique<Token>(
                     TokenType::None,
-                    L"",
+                    "",
                     SourcePosition{
 					0, 0
 				});
 		}
 	}
 
-	Lexer::Lexer(const Source* source)
-		: source_reader_(source) {}
+	Lexer::Lexer(const Source* source, const size_t start)
+		: source_reader_(source, start) {}
 
 	TokenType Lexer::peek() {
 		if (!next_token_) {
@@ -0,0 +1,77 @@
+#include "parser/literal_decoder.h"
+
+#include <charconv>
+#include <limits>
+
+namespace seam {
+	namespace {
+		constexpr uint64_t max_i64 = std::numeric_limits<int64_t>::max();
+
+		int hex_digit_value(const char c) {
+			if (c >= '0' && c <= '9') return c - '0';
+			if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+			if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+			return -1;
+		}
+
+		DecodedNumber error(const DiagnosticCode code) {
+			DecodedNumber result;
+			result.error = code;
+			return result;
+		}
+
+		DecodedNumber decode_integer(const std::string_view digits, const uint64_t base) {
+			if (digits.empty()) {
+				return error(DiagnosticCode::MalformedNumberLiteral);
+			}
+
+			uint64_t value = 0;
+			for (const auto c : digits) {
+				const auto digit = hex_digit_value(c);
+				if (digit < 0 || static_cast<uint64_t>(digit) >= base) {
+					return error(DiagnosticCode::MalformedNumberLiteral);
+				}
+
+				// value * base + digit must stay within i64, checked before it is computed
+				if (value > (max_i64 - static_cast<uint64_t>(digit)) / base) {
+					return error(DiagnosticCode::IntegerLiteralOverflow);
+				}
+				value = value * base + static_cast<uint64_t>(digit);
+			}
+
+			DecodedNumber result;
+			result.type = type::BuiltIn::i64;
+			result.value.i64 = static_cast<int64_t>(value);
+			return result;
+		}
+
+		DecodedNumber decode_float(const char* begin, const char* end) {
+			double value;
+			const auto [ptr, ec] = std::from_chars(begin, end, value);
+
+			if (ec == std::errc::result_out_of_range) {
+				return error(DiagnosticCode::FloatLiteralOverflow);
+			}
+			if (ec != std::errc() || ptr != end) {
+				return error(DiagnosticCode::MalformedNumberLiteral);
+			}
+
+			DecodedNumber result;
+			result.type = type::BuiltIn::f64;
+			result.value.f64 = value;
+			return result;
+		}
+	}
+
+	DecodedNumber decode_number_literal(const std::string_view lexeme) {
+		if (lexeme.size() > 2 && lexeme[0] == '0' && lexeme[1] == 'x') {
+			return decode_integer(lexeme.substr(2), 16);
+		}
+
+		if (lexeme.find('.') == std::string_view::npos) {
+			return decode_integer(lexeme, 10);
+		}
+
+		return decode_float(lexeme.data(), lexeme.data() + lexeme.size());
+	}
+}
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cctype>
+#include <exception>
+#include <thread>
+
+#include "parser/parallel_lexer.h"
+
+namespace seam {
+	size_t ParallelLexer::skip_whitespace(size_t offset) const {
+		const auto& text = source_->get();
+		while (offset < text.length() && std::isspace(static_cast<unsigned char>(text[offset]))) {
+			offset++;
+		}
+		return offset;
+	}
+
+	void ParallelLexer::lex_chunk(Chunk& chunk) const {
+		Lexer lexer(source_, chunk.start);
+
+		// the last token may run past the end, into the next chunk
+		for (auto offset = lexer.offset(); offset < chunk.end; offset = lexer.offset()) {
+			auto token = lexer.next();
+			const auto done = token->type == TokenType::None;
+			chunk.tokens.push_back({ skip_whitespace(offset), std::move(token) });
+
+			if (done) {
+				break;
+			}
+		}
+		chunk.exit = lexer.offset();
+	}
+
+	void ParallelLexer::stitch(std::vector<Chunk>& chunks) {
+		// offset the true token stream continues from
+		size_t offset = 0;
+
+		size_t count = 0;
+		for (const auto& chunk : chunks) {
+			count += chunk.tokens.size();
+		}
+		tokens_.reserve(count);
+
+		// the last chunk reaches the end of input, so the stream always ends in one of them
+		for (auto& chunk : chunks) {
+			std::unique_ptr<Lexer> lexer;
+			auto it = chunk.tokens.begin();
+
+			while (offset < chunk.end) {
+				const auto resume = skip_whitespace(offset);
+				it = std::lower_bound(it, chunk.tokens.end(), resume, [](const ChunkToken& token, const size_t value) {
+					return token.offset < value;
+				});
+
+				if (it != chunk.tokens.end() && it->offset == resume) {
+					// in step, the rest of the chunk is the true stream
+					for (; it != chunk.tokens.end(); ++it) {
+						const auto done = it->token->type == TokenType::None;
+						tokens_.push_back(std::move(it->token));
+						if (done) {
+							return;
+						}
+					}
+					offset = chunk.exit;
+					break;
+				}
+
+				// out of step, lex one token on the true stream
+				if (!lexer) {
+					lexer = std::make_unique<Lexer>(source_, offset);
+				}
+				auto token = lexer->next();
+				const auto done = token->type == TokenType::None;
+				tokens_.push_back(std::move(token));
+				offset = lexer->offset();
+
+				if (done) {
+					return;
+				}
+			}
+		}
+	}
+
+	ParallelLexer::ParallelLexer(const Source* source, const size_t threads, const size_t min_chunk_size)
+		: source_(source) {
+		const auto length = source->get().length();
+		const auto workers = std::max<size_t>(1, threads ? threads : std::thread::hardware_concurrency());
+		const auto count = std::clamp<size_t>(length / std::max<size_t>(min_chunk_size, 1), 1, workers);
+
+		// boundaries on whitespace, so only strings and comments straddle them
+		std::vector<Chunk> chunks;
+		size_t start = 0;
+		for (size_t i = 1; i <= count; i++) {
+			auto end = i == count ? length : std::max(start, length / count * i);
+			while (end < length && !std::isspace(static_cast<unsigned char>(source->get()[end]))) {
+				end++;
+			}
+			if (end > start || i == count) {
+				chunks.push_back({ start, end, {} });
+				start = end;
+			}
+		}
+		// the end of input belongs to the last chunk
+		chunks.back().end = length + 1;
+
+		if (chunks.size() == 1) {
+			// nothing to stitch, lex straight into the stream
+			Lexer lexer(source);
+			do {
+				tokens_.push_back(lexer.next());
+			} while (tokens_.back()->type != TokenType::None);
+			return;
+		}
+
+		std::vector<std::exception_ptr> errors(chunks.size());
+		std::vector<std::thread> pool;
+		pool.reserve(chunks.size());
+
+		for (size_t i = 0; i < chunks.size(); i++) {
+			pool.emplace_back([&, i] {
+				try {
+					lex_chunk(chunks[i]);
+				} catch (...) {
+					errors[i] = std::current_exception();
+				}
+			});
+		}
+
+		for (auto& thread : pool) {
+			thread.join();
+		}
+		for (const auto& error : errors) {
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+
+		stitch(chunks);
+	}
+
+	TokenType ParallelLexer::peek() {
+		if (index_ == tokens_.size()) {
+			return TokenType::None;
+		}
+		return tokens_[index_]->type;
+	}
+
+	std::unique_ptr<Token> ParallelLexer::next() {
+		if (index_ == tokens_.size()) {
+			return std::make_unique<Token>(TokenType::None, "", SourcePosition { 0, 0 });
+		}
+		return std::move(tokens_[index_++]);
+	}
+}
@@ -1,65 +1,92 @@
 #include "parser/parser.h"
 
 #include "exception.h"
+#include "parser/token_buffer.h"
 #include <ast/print_visitor.h>
-#include <unordered_map>
-
-namespace {
-	struct EnumClassHash {
-		template<typename T>
-		size_t operator()(T t) const {
-			return static_cast<size_t>(t);
-		}
-	};
-	template <typename Key>
-	using HashType = typename std::conditional<std::is_enum_v<Key>, EnumClassHash, std::hash<Key>>::type;
-}
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <thread>
 
 namespace seam {
-	bool is_unary_operator(const TokenType symbol) {
-		switch (symbol) {
-			case TokenType::OpSub: {
-				return true;
-			}
-			default: return false;
+	namespace {
+		/**
+		 * How an operator continues an expression once it appears after an operand.
+		 */
+		enum class InfixHandler : uint8_t {
+			None,
+			Binary,
+			Postfix,
+			Call,
+		};
+
+		struct OperatorRule {
+			// binding power when the token starts an expression (0 = not a prefix operator)
+			uint8_t prefix_power = 0;
+			// binding power when the token follows an operand (0 = not an infix/postfix operator)
+			uint8_t infix_power = 0;
+			bool right_assoc = false;
+			InfixHandler handler = InfixHandler::None;
+		};
+
+		constexpr auto operator_rules = [] {
+			std::array<OperatorRule, token_type_count> rules {};
+			const auto set = [&rules](const TokenType type, const OperatorRule rule) {
+				rules[static_cast<size_t>(type)] = rule;
+			};
+
+			set(TokenType::OpAssign,       { 0, 1, true, InfixHandler::Binary });
+			set(TokenType::OpAddEq,        { 0, 1, true, InfixHandler::Binary });
+			set(TokenType::OpSubEq,        { 0, 1, true, InfixHandler::Binary });
+			set(TokenType::OpLogicalAnd,   { 0, 2, false, InfixHandler::Binary });
+			set(TokenType::OpEq,           { 0, 3, false, InfixHandler::Binary });
+			set(TokenType::OpBitwiseAnd,   { 0, 4, false, InfixHandler::Binary });
+			set(TokenType::OpAdd,          { 0, 5, false, InfixHandler::Binary });
+			set(TokenType::OpSub,          { 7, 5, false, InfixHandler::Binary });
+			set(TokenType::OpMul,          { 0, 6, false, InfixHandler::Binary });
+			set(TokenType::OpDiv,          { 0, 6, false, InfixHandler::Binary });
+			set(TokenType::OpIncrement,    { 0, 8, false, InfixHandler::Postfix });
+			set(TokenType::OpDecrement,    { 0, 8, false, InfixHandler::Postfix });
+			set(TokenType::OpenParen,      { 0, 8, false, InfixHandler::Call });
+
+			return rules;
+		}();
+
+		constexpr const OperatorRule& operator_rule(const TokenType type) {
+			return operator_rules[static_cast<size_t>(type)];
 		}
-	}
 
-	bool is_binary_operator(const TokenType type) {
-		switch (type) {
-			case TokenType::OpEq:
-			case TokenType::OpSub:
-			case TokenType::OpMul:
-			case TokenType::OpAdd: {
-				return true;
-			}
-			default: return false;
+		template <typename T>
+		std::unique_ptr<T> with_position(std::unique_ptr<T> expr, const SourcePosition position) {
+			expr->position = position;
+			return expr;
 		}
-	}
 
-	bool is_right_assoc(const TokenType type) {
-		switch (type) {
-			case TokenType::OpMul:
-			case TokenType::OpAdd: {
+		/**
+		 * Calls, assignments and increments are the only expressions
+		 * allowed to stand on their own as a statement.
+		 */
+		bool is_expression_statement(ast::expression::Expression* expr) {
+			if (dynamic_cast<ast::expression::FunctionCall*>(expr)
+				|| dynamic_cast<ast::expression::PostfixExpression*>(expr)) {
 				return true;
 			}
-			default: return false;
-		}
-	}
 
-	bool is_left_assoc(const TokenType type) {
-		switch (type) {
-			case TokenType::OpMul:
-			case TokenType::OpAdd: {
-				return true;
+			if (const auto binary = dynamic_cast<ast::expression::BinaryExpression*>(expr)) {
+				return binary->op == TokenType::OpAssign
+					|| binary->op == TokenType::OpAddEq
+					|| binary->op == TokenType::OpSubEq;
 			}
-			default: return false;
+
+			return false;
 		}
 	}
 
-	std::wstring Parser::try_parse_type() {
+	std::string Parser::try_parse_type() {
 		expect<TokenType::Colon>();
-		return consume_token<TokenType::Identifier, std::wstring>();
+		return consume_token<TokenType::Identifier, std::string>();
 	}
 
 	ast::ParameterList Parser::parse_parameter_list() {
@@ -67,15 +94,21 @@ namespace seam {
 
 		expect<TokenType::OpenParen>();
 
-		while (lexer_->peek() == TokenType::Identifier) {
-			const auto param_name = consume_token<TokenType::Identifier, std::wstring>();
+		while (peek() == TokenType::Identifier) {
+			const auto param_name = consume_token<TokenType::Identifier, Token>();
 			expect<TokenType::Colon>();
-			const auto param_type = consume_token<TokenType::Identifier, std::wstring>();
+			const auto param_type = consume_token<TokenType::Identifier, std::string>();
 
 			params.emplace_back(ast::Parameter {
-				param_name,
-				param_type
+				param_name->lexeme,
+				param_type,
+				param_name->position
 			});
+
+			if (peek() != TokenType::Comma) {
+				break;
+			}
+			discard();
 		}
 
 		expect<TokenType::CloseParen>();
@@ -87,11 +120,11 @@ namespace seam {
 
 		expect<TokenType::OpenParen>();
 
-		if (lexer_->peek() != TokenType::CloseParen) {
+		if (peek() != TokenType::CloseParen) {
 			args.emplace_back(parse_expression());
 		}
 
-		while (lexer_->peek() == TokenType::Comma) {
+		while (peek() == TokenType::Comma) {
 			discard();
 			args.emplace_back(parse_expression());
 		}
@@ -104,7 +137,7 @@ namespace seam {
 	// TODO: add extra information to error exceptions
 
 	std::unique_ptr<ast::expression::Expression> Parser::parse_primary_expression() {
-		switch (lexer_->peek()) {
+		switch (peek()) {
 			case TokenType::OpenParen: {
                 discard();
 				auto expr = parse_expression();
@@ -113,101 +146,103 @@ namespace seam {
 				return std::move(expr);
 			}
 			case TokenType::Identifier: {
-				return std::make_unique<ast::expression::Identifier>(consume_token<TokenType::Identifier, std::wstring>());
+				const auto token = consume_token<TokenType::Identifier, Token>();
+				return std::make_unique<ast::expression::Identifier>(token->lexeme, token->position);
 			}
 			case TokenType::StringLiteral: {
-				return std::make_unique<ast::expression::StringLiteral>(consume_token<TokenType::StringLiteral, std::wstring>());
+				const auto token = consume_token<TokenType::StringLiteral, Token>();
+				return with_position(std::make_unique<ast::expression::StringLiteral>(token->lexeme), token->position);
 			}
 			case TokenType::NumberLiteral: {
-				return std::make_unique<ast::expression::NumberLiteral>(consume_token<TokenType::NumberLiteral, std::wstring>());
+				auto [lexeme, decoded, position] = consume_token<TokenType::NumberLiteral, DecodedNumber>();
+				return with_position(std::make_unique<ast::expression::NumberLiteral>(std::move(lexeme), decoded), position);
 			}
 			case TokenType::KeywordTrue:
 			case TokenType::KeywordFalse: {
-				return std::make_unique<ast::expression::BooleanLiteral>(lexer_->next()->type == TokenType::KeywordTrue);
+				const auto token = lexer_->next();
+				return with_position(std::make_unique<ast::expression::BooleanLiteral>(token->type == TokenType::KeywordTrue), token->position);
 			}
 			default:break;
 		}
 		return nullptr;
 	}
 
-	const std::unordered_map<TokenType, size_t, HashType<TokenType>> binary_priority {
-		{ TokenType::OpEq, 5 },
-        { TokenType::OpAdd, 6 }, { TokenType::OpSub, 6 },
-		{ TokenType::OpMul, 7 }, { TokenType::OpDiv, 7 },
-	};
-	auto get_binary_priority(const TokenType type) {
-		auto search = binary_priority.find(type);
+	std::unique_ptr<ast::expression::Expression> Parser::parse_operand(const TokenType op, const size_t min_binding_power) {
+		auto expr = parse_expression(min_binding_power);
 
-		return search != binary_priority.end() ? search->second : -1;
-	}
-
-	std::unique_ptr<ast::expression::Expression> Parser::parse_expression(std::unique_ptr<ast::expression::Expression> expr, const size_t right_binding_power) {
-		// TODO: Check is unary operator & add operator precedence
+		if (!expr) {
+			const auto token = lexer_->next();
+			throw generate_exception<ParserException>(
+				token->position,
+				"expected expression after {}, got {}",
+				token_type_to_name(op),
+				token_type_to_name(token->type));
+		}
 
-		auto next_token = lexer_->peek();
-		while (is_binary_operator(next_token) && get_binary_priority(next_token) >= right_binding_power) {
-			auto operator_token = lexer_->next();
-			auto rhs = parse_primary_expression();
+		return expr;
+	}
 
-			next_token = lexer_->peek();
-			while (is_binary_operator(next_token) 
-				&& (get_binary_priority(next_token) > get_binary_priority(operator_token->type)) 
-					|| (is_right_assoc(next_token) && get_binary_priority(next_token) == get_binary_priority(operator_token->type))) {
-					rhs = parse_expression(std::move(rhs), get_binary_priority(operator_token->type));
-					next_token = lexer_->peek();
+	std::unique_ptr<ast::expression::Expression> Parser::parse_expression(const size_t min_binding_power) {
+		// parentheses, prefix operators and right operands all nest through here
+		const auto guard = nest();
+		std::unique_ptr<ast::expression::Expression> expr;
+
+		if (const auto& prefix = operator_rule(peek()); prefix.prefix_power != 0) {
+			const auto token = lexer_->next();
+			expr = with_position(
+				std::make_unique<ast::expression::UnaryExpression>(token->type, parse_operand(token->type, prefix.prefix_power)),
+				token->position);
+		} else {
+			expr = parse_primary_expression();
+
+			if (!expr) {
+				return nullptr;
 			}
-
-			expr = std::make_unique<ast::expression::BinaryExpression>(operator_token->type, 
-				std::move(expr), std::move(rhs));
 		}
-		return std::move(expr);
-	}
 
-	std::unique_ptr<ast::expression::Expression> Parser::parse_expression() {
-		if (is_unary_operator(lexer_->peek())) {
-			auto op = lexer_->next()->type;
-			auto expr = parse_expression();
+		while (true) {
+			const auto type = peek();
+			const auto& rule = operator_rule(type);
 
-			return std::make_unique<ast::expression::UnaryExpression>(
-				op,
-				std::move(expr));
-		}
+			if (rule.infix_power == 0 || rule.infix_power <= min_binding_power) {
+				break;
+			}
 
-		const auto shrouded_expression = lexer_->peek() == TokenType::OpenParen;
-		auto expr = parse_primary_expression();
+			switch (rule.handler) {
+				case InfixHandler::Binary: {
+					const auto position = lexer_->next()->position;
 
-		switch (lexer_->peek()) {
-			case TokenType::OpenParen: {
-				if (dynamic_cast<ast::expression::Identifier*>(expr.get()) || shrouded_expression) {
+					// right associative operators let the rhs bind at their own power again
+					auto rhs = parse_operand(type, rule.right_assoc ? rule.infix_power - 1 : rule.infix_power);
+
+					expr = with_position(std::make_unique<ast::expression::BinaryExpression>(type, std::move(expr), std::move(rhs)), position);
+					break;
+				}
+				case InfixHandler::Postfix: {
+					const auto position = lexer_->next()->position;
+					expr = with_position(std::make_unique<ast::expression::PostfixExpression>(type, std::move(expr)), position);
+					break;
+				}
+				case InfixHandler::Call: {
+					const auto position = expr->position;
 					auto arg_list = parse_arg_list();
-					expr = std::make_unique<ast::expression::FunctionCall>(
-						std::move(expr),
-						std::move(arg_list)
-						);
+					expr = with_position(std::make_unique<ast::expression::FunctionCall>(std::move(expr), std::move(arg_list)), position);
+					break;
 				}
-				break;
+				case InfixHandler::None: break;
 			}
-			case TokenType::OpDecrement:
-			case TokenType::OpIncrement: {
-				auto op = lexer_->next()->type;
-				expr = std::make_unique<ast::expression::PostfixExpression>(
-					op,
-					std::move(expr));
-				break;
-			}
-			default: break;
 		}
 
-		return parse_expression(std::move(expr));
+		return expr;
 	}
 
 
 	std::unique_ptr<ast::statement::LetStatement> Parser::parse_let_statement() {
-		const auto var_name = consume_token<TokenType::Identifier, std::wstring>();
+		const auto var_name = consume_token<TokenType::Identifier, Token>();
 
 		// is type
-		std::wstring type;
-		switch (lexer_->peek()) {
+		std::string type;
+		switch (peek()) {
 			case TokenType::Colon: {
 				type = try_parse_type();
 				expect<TokenType::OpAssign>();
@@ -225,7 +260,7 @@ namespace seam {
 
 		auto expr = parse_expression();
 
-		return std::make_unique<ast::statement::LetStatement>(var_name, type, std::move(expr));
+		return std::make_unique<ast::statement::LetStatement>(var_name->lexeme, type, std::move(expr), var_name->position);
 	}
 
 	std::unique_ptr<ast::statement::WhileStatement> Parser::parse_while_statement() {
@@ -242,35 +277,52 @@ namespace seam {
 			std::move(body));
 	}
 
-	std::unique_ptr<ast::statement::IfStatement> Parser::parse_if_statement() {
-		lexer_->next(); // consume if keyword
+	std::unique_ptr<ast::statement::ReturnStatement> Parser::parse_return_statement() {
+		const auto token = lexer_->next();
+
+		return std::make_unique<ast::statement::ReturnStatement>(parse_expression(), token->position);
+	}
+
+	std::unique_ptr<ast::statement::IfStatement> Parser::parse_if_branch() {
+		lexer_->next(); // consume if or elseif keyword
 
 		expect<TokenType::OpenParen>();
 		auto expr = parse_expression();
 		expect<TokenType::CloseParen>();
 
 		auto if_body = parse_statement_block();
-		std::unique_ptr<ast::statement::StatementBlock> else_body;
 
-		if (lexer_->peek() == TokenType::KeywordElseIf) {
-			auto inner_if = parse_if_statement();
+		return std::make_unique<ast::statement::IfStatement>(
+			std::move(expr),
+			std::move(if_body));
+	}
+
+	std::unique_ptr<ast::statement::IfStatement> Parser::parse_if_statement() {
+		auto stat = parse_if_branch();
+
+		// each elseif is the sole statement of the else block before it,
+		// the chain is parsed in a loop so its length costs no stack
+		auto tail = stat.get();
+		while (peek() == TokenType::KeywordElseIf) {
+			auto inner_if = parse_if_branch();
+			const auto next = inner_if.get();
+
 			ast::statement::StatementList list;
 			list.emplace_back(std::move(inner_if));
+			tail->else_body = std::make_unique<ast::statement::StatementBlock>(std::move(list));
+			tail = next;
+		}
 
-			else_body = std::make_unique<ast::statement::StatementBlock>(std::move(list));
-		} else if (lexer_->peek() == TokenType::KeywordElse) {
+		if (peek() == TokenType::KeywordElse) {
 			lexer_->next();
-			else_body = parse_statement_block();
+			tail->else_body = parse_statement_block();
 		}
 
-		return std::make_unique<ast::statement::IfStatement>(
-			std::move(expr),
-			std::move(if_body),
-			std::move(else_body));
+		return stat;
 	}
 
 	std::unique_ptr<ast::statement::Statement> Parser::parse_statement() {
-		switch (lexer_->peek()) {
+		switch (peek()) {
 			case TokenType::KeywordLet: {
 				lexer_->next();
 				return parse_let_statement();
@@ -284,20 +336,23 @@ namespace seam {
 			case TokenType::KeywordWhile: {
 				return parse_while_statement();
 			}
+			case TokenType::KeywordReturn: {
+				return parse_return_statement();
+			}
 			default: {
 				auto expression = parse_expression();
 
-				if (dynamic_cast<ast::expression::FunctionCall*>(expression.get())) {
+				if (is_expression_statement(expression.get())) {
 					return std::make_unique<ast::statement::LetStatement>(
-						L"<DISCARD>",
-						L"<DISCARD>",
+						"<DISCARD>",
+						"<DISCARD>",
 						std::move(expression));
 				}
 
 				if (expression) {
 					throw generate_exception<ParserException>(
 						lexer_->next()->position,
-						L"expected statement, got expression");
+						"expected statement, got expression");
 				}
 				return nullptr; // TODO: Set this
 			}
@@ -308,6 +363,7 @@ namespace seam {
 		ast::statement::StatementList body;
 
 		expect<TokenType::OpenBrace>();
+		const auto guard = nest();
 
 		while (true) {
 			auto statement = parse_statement();
@@ -324,90 +380,257 @@ namespace seam {
 	}
 
 	std::unique_ptr<ast::FunctionDeclaration> Parser::parse_function_declaration() {
-		const auto func_name = consume_token<TokenType::Identifier, std::wstring>();
+		const auto func_name = consume_token<TokenType::Identifier, Token>();
 		const auto param_list = parse_parameter_list();
 
-		std::wstring return_type;
-		if (lexer_->peek() == TokenType::Arrow) {
+		std::string return_type;
+		if (peek() == TokenType::Arrow) {
 			lexer_->next();
-			return_type = consume_token<TokenType::Identifier, std::wstring>();
+			return_type = consume_token<TokenType::Identifier, std::string>();
 		}
 
 		auto body = parse_statement_block();
-		return std::make_unique<ast::FunctionDeclaration>(func_name, param_list, return_type, std::move(body));
+		return std::make_unique<ast::FunctionDeclaration>(func_name->lexeme, param_list, return_type, std::move(body), func_name->position);
 	}
 
     std::unique_ptr<ast::Declaration> Parser::parse_type_decl() {
-	    auto name = consume_token<TokenType::Identifier, std::wstring>();
+	    const auto name = consume_token<TokenType::Identifier, Token>();
 
 	    std::unique_ptr<ast::Declaration> decl;
-	    switch (lexer_->peek()) {
+	    switch (peek()) {
 	        case TokenType::OpAssign: {
 	            expect<TokenType::OpAssign>();
-	            auto type = consume_token<TokenType::Identifier, std::wstring>();
+	            auto type = consume_token<TokenType::Identifier, std::string>();
 	            decl = std::make_unique<ast::TypeAliasDeclaration>(
-	                    std::move(name),
-	                    std::move(type)
+	                    name->lexeme,
+	                    std::move(type),
+	                    name->position
 	                    );
 	            break;
 	        };
 	        case TokenType::OpenBrace: {
 	            expect<TokenType::OpenBrace>();
+	            const auto guard = nest();
 	            auto body = parse_declaration_list();
+	            expect<TokenType::CloseBrace>();
 
 	            decl = std::make_unique<ast::TypeDeclaration>(
-	                    std::move(name),
-	                    std::move(body)
+	                    name->lexeme,
+	                    std::move(body),
+	                    name->position
 	                    );
 	            break;
 	        };
-	        default: break;
+	        default: {
+	            const auto token = lexer_->next();
+	            throw generate_exception<ParserException>(
+	                    token->position,
+	                    "expected = or {{ after type name, got {}",
+	                    token_type_to_name(token->type)
+	                    );
+	        }
 	    }
 
-	    return std::move(decl);
+	    return decl;
+	}
+
+	std::unique_ptr<ast::Declaration> Parser::parse_declaration() {
+		switch (peek()) {
+			case TokenType::KeywordFn: {
+				discard(); // TODO: find better way of discarding...
+				return parse_function_declaration();
+			}
+			case TokenType::KeywordType: {
+				discard();
+				return parse_type_decl();
+			}
+			default: {
+				auto token = lexer_->next();
+				throw generate_exception<ParserException>(
+						token->position,
+						"expected declaration, got {}",
+						token_type_to_name(token->type)
+				);
+			}
+		}
 	}
 
 	ast::DeclarationList Parser::parse_declaration_list() {
 		ast::DeclarationList body;
 
-		while (true) {
-			switch (lexer_->peek()) {
-				case TokenType::KeywordFn: {
-                    discard(); // TODO: find better way of discarding...
-					body.emplace_back(parse_function_declaration());
-					break;
-				}
+		while (peek() != TokenType::None && peek() != TokenType::CloseBrace) {
+			body.emplace_back(parse_declaration());
+		}
+		return body;
+	}
+
+	ast::Import Parser::parse_import() {
+		expect<TokenType::KeywordImport>();
+		const auto name = consume_token<TokenType::Identifier, Token>();
+
+		// nested modules are named by their path, e.g. geometry.shapes
+		auto module = name->lexeme;
+		auto position = name->position;
+		while (peek() == TokenType::Dot) {
+			expect<TokenType::Dot>();
+			const auto segment = consume_token<TokenType::Identifier, Token>();
+			module += '.' + segment->lexeme;
+			position.end_idx = segment->position.end_idx;
+		}
+		return ast::Import { std::move(module), position };
+	}
+
+	ast::ImportList Parser::parse_import_list() {
+		ast::ImportList imports;
+
+		// imports come before any declaration
+		while (peek() == TokenType::KeywordImport) {
+			imports.push_back(parse_import());
+		}
+		return imports;
+	}
+
+	std::vector<Parser::DeclarationRange> Parser::split_declarations(const std::vector<std::unique_ptr<Token>>& tokens) {
+		std::vector<DeclarationRange> ranges;
+		size_t depth = 0;
+
+		for (size_t i = 0; i < tokens.size(); i++) {
+			switch (tokens[i]->type) {
+				case TokenType::KeywordFn:
 				case TokenType::KeywordType: {
-                    discard();
-				    body.emplace_back(parse_type_decl());
+					if (depth == 0) {
+						if (!ranges.empty()) {
+							ranges.back().end = i;
+						}
+						ranges.push_back({ i, tokens.size() });
+					}
 					break;
 				}
-				case TokenType::None: {
-					return body;
-				}
-				default: {
-					auto token = lexer_->next();
-					throw generate_exception<ParserException>(
-                            token->position,
-                            L"expected declaration, got {}",
-                            token_type_to_name(token->type)
-					);
+				case TokenType::OpenBrace: depth++; break;
+				case TokenType::CloseBrace: {
+					if (depth == 0) {
+						// unbalanced, the rest stays with the current declaration
+						return ranges;
+					}
+					depth--;
+					break;
 				}
+				default: break;
 			}
 		}
+		return ranges;
 	}
 
-	Parser::Parser(std::unique_ptr<Lexer> lexer)
-		: lexer_(std::move(lexer)) { }
+	std::unique_ptr<ast::Declaration> Parser::parse_top_level_declaration() {
+		auto decl = parse_declaration();
+
+		// whatever follows inside the range is an error, raised as parse() would raise it
+		if (const auto type = peek(); type == TokenType::CloseBrace) {
+			expect<TokenType::None>();
+		} else if (type != TokenType::KeywordFn && type != TokenType::KeywordType && type != TokenType::None) {
+			parse_declaration();
+		}
+		return decl;
+	}
+
+	ast::Import Parser::parse_top_level_import() {
+		auto import = parse_import();
+
+		if (const auto type = peek(); type == TokenType::CloseBrace) {
+			expect<TokenType::None>();
+		} else if (type != TokenType::KeywordImport && type != TokenType::KeywordFn && type != TokenType::KeywordType && type != TokenType::None) {
+			parse_declaration();
+		}
+		return import;
+	}
+
+	Parser::Parser(std::unique_ptr<TokenSource> lexer, const size_t max_depth)
+		: lexer_(std::move(lexer)), max_depth_(max_depth) { }
+
+	Parser::DepthGuard Parser::nest() {
+		if (depth_ >= max_depth_) {
+			const auto token = lexer_->next();
+			throw generate_exception<ParserException>(token->position, "nesting is deeper than {} levels", max_depth_);
+		}
+		return DepthGuard(depth_);
+	}
 
 	std::unique_ptr<ast::Program> Parser::parse() {
 		if (!lexer_) {
 		    // This should actually never happen, so?
-			throw SeamException(L"no lexer found!"); // throw proper exception
+			throw SeamException("no lexer found!"); // throw proper exception
+		}
+
+		auto imports = parse_import_list();
+		auto body = parse_declaration_list();
+		expect<TokenType::None>();
+
+		return std::make_unique<ast::Program>(std::move(imports), std::move(body));
+	}
+
+	std::unique_ptr<ast::Program> Parser::parse_parallel(size_t threads) {
+		if (!lexer_) {
+			throw SeamException("no lexer found!");
+		}
+
+		std::vector<std::unique_ptr<Token>> tokens;
+		do {
+			tokens.push_back(lexer_->next());
+		} while (tokens.back()->type != TokenType::None);
+
+		const auto ranges = split_declarations(tokens);
+		threads = std::min(threads ? threads : std::max(1u, std::thread::hardware_concurrency()), ranges.size());
+
+		// nothing to split, or the program does not start with a declaration
+		if (threads <= 1 || ranges.front().begin != 0) {
+			lexer_ = std::make_unique<TokenBuffer>(std::move(tokens));
+			return parse();
+		}
+
+		// each range is followed by the token after it, so errors at its end read as they would in one pass
+		std::vector<std::unique_ptr<TokenSource>> sources;
+		sources.reserve(ranges.size());
+		for (const auto& range : ranges) {
+			std::vector<std::unique_ptr<Token>> slice;
+			slice.reserve(range.end - range.begin + 1);
+			for (auto i = range.begin; i < range.end; i++) {
+				slice.push_back(std::move(tokens[i]));
+			}
+			if (range.end < tokens.size()) {
+				slice.push_back(std::make_unique<Token>(*tokens[range.end]));
+			}
+			sources.push_back(std::make_unique<TokenBuffer>(std::move(slice)));
+		}
+
+		ast::DeclarationList body(ranges.size());
+		std::atomic<size_t> next = 0;
+		std::vector<std::exception_ptr> errors(ranges.size());
+		std::vector<std::thread> pool;
+		pool.reserve(threads);
+
+		for (size_t worker = 0; worker < threads; worker++) {
+			pool.emplace_back([&] {
+				for (auto index = next++; index < ranges.size(); index = next++) {
+					try {
+						body[index] = Parser(std::move(sources[index]), max_depth_).parse_top_level_declaration();
+					} catch (...) {
+						errors[index] = std::current_exception();
+					}
+				}
+			});
+		}
+
+		for (auto& thread : pool) {
+			thread.join();
+		}
+
+		// the first error in source order is the one a single pass stops at
+		for (const auto& error : errors) {
+			if (error) {
+				std::rethrow_exception(error);
+			}
 		}
 
-		return std::make_unique<ast::Program>(ast::Program{
-			parse_declaration_list()
-		});
+		return std::make_unique<ast::Program>(std::move(body));
 	}
 }
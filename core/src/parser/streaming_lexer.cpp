@@ -0,0 +1,95 @@
+#include <algorithm>
+
+#include "parser/streaming_lexer.h"
+
+namespace seam {
+	void StreamingLexer::produce(const Source* source, const size_t batch_size) {
+		Batch batch;
+
+		const auto push = [&] {
+			while (!queue_.try_push(batch)) {
+				if (stop_.load(std::memory_order_relaxed)) {
+					return false;
+				}
+				queue_.wait_for_space();
+			}
+			batch = Batch();
+			return true;
+		};
+
+		try {
+			Lexer lexer(source);
+			batch.reserve(batch_size);
+
+			// the end of input is the last token, the consumer repeats it from there
+			while (!stop_.load(std::memory_order_relaxed)) {
+				auto token = lexer.next();
+				const auto done = token->type == TokenType::None;
+				batch.push_back(std::move(token));
+
+				if (done) {
+					push();
+					return;
+				}
+				if (batch.size() == batch_size) {
+					if (!push()) {
+						return;
+					}
+					batch.reserve(batch_size);
+				}
+			}
+		} catch (...) {
+			// an empty batch tells the consumer to raise the error
+			error_ = std::current_exception();
+			batch.clear();
+			push();
+		}
+	}
+
+	void StreamingLexer::fill() {
+		while (index_ == batch_.size()) {
+			if (end_) {
+				batch_.clear();
+				batch_.push_back(std::make_unique<Token>(*end_));
+				index_ = 0;
+				return;
+			}
+
+			auto batch = queue_.try_pop();
+			if (!batch) {
+				queue_.wait_for_element();
+				continue;
+			}
+			if (batch->empty()) {
+				std::rethrow_exception(error_);
+			}
+
+			batch_ = std::move(*batch);
+			index_ = 0;
+			if (batch_.back()->type == TokenType::None) {
+				end_ = std::make_unique<Token>(*batch_.back());
+			}
+		}
+	}
+
+	StreamingLexer::StreamingLexer(const Source* source, const size_t batch_size)
+		: producer_(&StreamingLexer::produce, this, source, std::max<size_t>(batch_size, 1)) {}
+
+	StreamingLexer::~StreamingLexer() {
+		stop_.store(true, std::memory_order_relaxed);
+
+		// a producer waiting on a full queue wakes for the freed slot and sees the stop
+		(void) queue_.try_pop();
+		producer_.join();
+	}
+
+	TokenType StreamingLexer::peek() {
+		fill();
+		return batch_[index_]->type;
+	}
+
+	std::unique_ptr<Token> StreamingLexer::next() {
+		fill();
+		return std::move(batch_[index_++]);
+	}
+}
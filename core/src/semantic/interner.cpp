@@ -0,0 +1,22 @@
+#include "semantic/interner.h"
+
+namespace seam::semantic {
+	symbol::SymbolId Interner::intern(const std::string_view name) {
+		if (const auto it = ids_.find(name); it != ids_.end()) {
+			return it->second;
+		}
+
+		const auto id = static_cast<symbol::SymbolId>(names_.size());
+		const auto& stored = names_.emplace_back(name);
+		ids_.emplace(stored, id);
+
+		return id;
+	}
+
+	std::optional<symbol::SymbolId> Interner::find(const std::string_view name) const {
+		if (const auto it = ids_.find(name); it != ids_.end()) {
+			return it->second;
+		}
+		return std::nullopt;
+	}
+}
@@ -0,0 +1,96 @@
+#include "semantic/name_resolver.h"
+
+#include <utility>
+
+namespace seam::semantic {
+	NameResolver::NameResolver(Context& context)
+		: context_(context) {}
+
+	symbol::Symbol* NameResolver::declare(const symbol::SymbolType type, const std::string& name, const SourcePosition position) {
+		const auto id = context_.interner().intern(name);
+		const auto symbol = context_.create_symbol(type, id, position);
+
+		if (table_.declare(id, symbol)) {
+			context_.report(DiagnosticCode::Redeclaration, position, name);
+		}
+
+		return symbol;
+	}
+
+	void NameResolver::declare_members(const ast::DeclarationList& decls) {
+		// declarations are visible to each other regardless of order
+		for (const auto& decl : decls) {
+			if (const auto func = dynamic_cast<ast::FunctionDeclaration*>(decl.get())) {
+				func->symbol = declare(symbol::SymbolType::Function, func->name, func->position);
+			} else if (const auto type = dynamic_cast<ast::TypeDeclaration*>(decl.get())) {
+				declare(symbol::SymbolType::Type, type->name, type->position);
+			} else if (const auto alias = dynamic_cast<ast::TypeAliasDeclaration*>(decl.get())) {
+				declare(symbol::SymbolType::Type, alias->alias, alias->position);
+			}
+		}
+	}
+
+	void NameResolver::enter(ast::Program& program) {
+		declare_members(program.body);
+	}
+
+	void NameResolver::enter(ast::FunctionDeclaration& func) {
+		// parameters share the body's scope, a let cannot redeclare one
+		table_.push_scope();
+		body_ = func.body.get();
+
+		for (auto& param : func.params) {
+			param.symbol = declare(symbol::SymbolType::Parameter, param.name, param.position);
+		}
+	}
+
+	void NameResolver::leave(ast::FunctionDeclaration& func) {
+		table_.pop_scope();
+	}
+
+	void NameResolver::enter(ast::TypeDeclaration& decl) {
+		table_.push_scope();
+		declare_members(decl.body);
+	}
+
+	void NameResolver::leave(ast::TypeDeclaration& decl) {
+		table_.pop_scope();
+	}
+
+	void NameResolver::leave(ast::statement::LetStatement& stat) {
+		// declared once the initialiser is resolved, it cannot see the variable it initialises
+		if (stat.name != "<DISCARD>") {
+			stat.symbol = declare(symbol::SymbolType::Variable, stat.name, stat.position);
+		}
+	}
+
+	void NameResolver::enter(ast::statement::StatementBlock& block) {
+		if (&block != body_) {
+			table_.push_scope();
+		}
+	}
+
+	void NameResolver::leave(ast::statement::StatementBlock& block) {
+		if (&block != body_) {
+			table_.pop_scope();
+		}
+	}
+
+	void NameResolver::enter(ast::expression::Identifier& expr) {
+		// a name never interned was never declared
+		const auto id = context_.interner().find(expr.identifier);
+		expr.symbol = id ? table_.lookup(*id) : nullptr;
+		const auto called = std::exchange(callee_, nullptr) == &expr;
+
+		if (!expr.symbol) {
+			context_.report(DiagnosticCode::UndefinedIdentifier, expr.position, expr.identifier);
+		} else if (called && expr.symbol->type != symbol::SymbolType::Function) {
+			context_.report(DiagnosticCode::NotCallable, expr.position, expr.identifier);
+		}
+	}
+
+	void NameResolver::enter(ast::expression::FunctionCall& expr) {
+		// the callee is entered next, ahead of the arguments
+		callee_ = dynamic_cast<ast::expression::Identifier*>(expr.function.get());
+	}
+}
@@ -0,0 +1,81 @@
+#include "semantic/symbol_table.h"
+
+namespace seam::semantic {
+	namespace {
+		constexpr size_t initial_capacity = 64;
+
+		size_t hash(const symbol::SymbolId name, const size_t mask) {
+			// fibonacci hashing spreads the dense ids across the table
+			return (static_cast<uint64_t>(name) * 11400714819323198485ull >> 32) & mask;
+		}
+	}
+
+	ScopedSymbolTable::ScopedSymbolTable()
+		: slots_(initial_capacity) {}
+
+	size_t ScopedSymbolTable::find_slot(const symbol::SymbolId name) const {
+		const auto mask = slots_.size() - 1;
+		auto idx = hash(name, mask);
+
+		while (slots_[idx].name != name && slots_[idx].name != empty_slot) {
+			idx = (idx + 1) & mask;
+		}
+
+		return idx;
+	}
+
+	void ScopedSymbolTable::grow() {
+		auto old_slots = std::move(slots_);
+		slots_ = std::vector<Slot>(old_slots.size() * 2);
+
+		for (const auto& slot : old_slots) {
+			if (slot.name != empty_slot) {
+				slots_[find_slot(slot.name)] = slot;
+			}
+		}
+	}
+
+	void ScopedSymbolTable::push_scope() {
+		scope_marks_.push_back(undo_log_.size());
+	}
+
+	void ScopedSymbolTable::pop_scope() {
+		const auto mark = scope_marks_.back();
+		scope_marks_.pop_back();
+
+		while (undo_log_.size() > mark) {
+			const auto& entry = undo_log_.back();
+
+			auto& slot = slots_[find_slot(entry.name)];
+			slot.symbol = entry.previous_symbol;
+			slot.depth = entry.previous_depth;
+
+			undo_log_.pop_back();
+		}
+	}
+
+	symbol::Symbol* ScopedSymbolTable::declare(const symbol::SymbolId name, symbol::Symbol* symbol) {
+		// keep the load factor at or below one half
+		if ((used_slots_ + 1) * 2 > slots_.size()) {
+			grow();
+		}
+
+		auto& slot = slots_[find_slot(name)];
+		if (slot.name == empty_slot) {
+			slot.name = name;
+			used_slots_++;
+		} else if (slot.symbol && slot.depth == depth()) {
+			return slot.symbol;
+		}
+
+		undo_log_.push_back({ name, slot.symbol, slot.depth });
+		slot.symbol = symbol;
+		slot.depth = depth();
+
+		return nullptr;
+	}
+
+	symbol::Symbol* ScopedSymbolTable::lookup(const symbol::SymbolId name) const {
+		return slots_[find_slot(name)].symbol;
+	}
+}
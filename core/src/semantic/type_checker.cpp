@@ -0,0 +1,514 @@
+#include "semantic/type_checker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <utility>
+
+namespace seam::semantic {
+	namespace {
+		using type::BuiltIn;
+		using type::TypeTable;
+
+		bool is_number_literal(const ast::expression::Expression& expr) {
+			if (const auto unary = dynamic_cast<const ast::expression::UnaryExpression*>(&expr)) {
+				return is_number_literal(*unary->expr);
+			}
+			return dynamic_cast<const ast::expression::NumberLiteral*>(&expr) != nullptr;
+		}
+
+		const symbol::Symbol* assignable_symbol(const ast::expression::Expression& expr) {
+			const auto identifier = dynamic_cast<const ast::expression::Identifier*>(&expr);
+			if (!identifier || !identifier->symbol) {
+				return nullptr;
+			}
+
+			const auto type = identifier->symbol->type;
+			return type == symbol::SymbolType::Variable || type == symbol::SymbolType::Parameter ? identifier->symbol : nullptr;
+		}
+	}
+
+	TypeChecker::TypeChecker(Context& context, const size_t threads)
+		: context_(context), types_(context.types()),
+		  threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+	void TypeChecker::collect_declarations(const ast::DeclarationList& decls) {
+		auto& bindings = scopes_[scope_].bindings;
+
+		for (const auto& decl : decls) {
+			if (const auto type = dynamic_cast<ast::TypeDeclaration*>(decl.get())) {
+				// a redeclaration keeps the first binding, and makes no type of its own
+				const auto name = context_.interner().intern(type->name);
+				if (const auto [binding, inserted] = bindings.try_emplace(name, TypeBinding { type, scope_ }); inserted) {
+					binding->second.type = types_.record(name);
+				}
+			} else if (const auto alias = dynamic_cast<ast::TypeAliasDeclaration*>(decl.get())) {
+				bindings.try_emplace(context_.interner().intern(alias->alias), TypeBinding { alias, scope_ });
+			}
+		}
+
+		for (const auto& decl : decls) {
+			decl->accept(*this);
+		}
+	}
+
+	void TypeChecker::declare_signature(ast::FunctionDeclaration& func) {
+		std::vector<type::TypeId> params;
+		params.reserve(func.params.size());
+
+		for (const auto& param : func.params) {
+			const auto type = resolve_type(param.type, param.position, scope_);
+			if (param.symbol) {
+				param.symbol->type_id = type;
+			}
+			params.push_back(type);
+		}
+
+		const auto result = resolve_type(func.return_type, func.position, scope_);
+		if (func.symbol) {
+			func.symbol->type_id = types_.function(params, result);
+		}
+
+		bodies_.push_back(FunctionBody { &func, scope_, result });
+	}
+
+	void TypeChecker::check_bodies() {
+		std::vector<std::vector<Diagnostic>> diagnostics(bodies_.size());
+
+		const auto check_body = [&](const size_t index) {
+			const auto& body = bodies_[index];
+
+			BodyChecker checker(*this, body.scope, body.return_type);
+			body.func->accept(checker);
+
+			diagnostics[index] = std::move(checker.diagnostics());
+		};
+
+		const auto workers = std::min(threads_, bodies_.size());
+		if (workers <= 1) {
+			for (size_t i = 0; i < bodies_.size(); i++) {
+				check_body(i);
+			}
+		} else {
+			std::atomic<size_t> next = 0;
+			std::vector<std::exception_ptr> errors(workers);
+			std::vector<std::thread> pool;
+			pool.reserve(workers);
+
+			for (size_t worker = 0; worker < workers; worker++) {
+				pool.emplace_back([&, worker] {
+					try {
+						for (auto index = next++; index < bodies_.size(); index = next++) {
+							check_body(index);
+						}
+					} catch (...) {
+						errors[worker] = std::current_exception();
+					}
+				});
+			}
+
+			for (auto& thread : pool) {
+				thread.join();
+			}
+			for (const auto& error : errors) {
+				if (error) {
+					std::rethrow_exception(error);
+				}
+			}
+		}
+
+		// merged in declaration order, independent of scheduling
+		for (auto& list : diagnostics) {
+			for (auto& diagnostic : list) {
+				context_.report(std::move(diagnostic));
+			}
+		}
+	}
+
+	const TypeChecker::TypeBinding* TypeChecker::find_binding(const symbol::SymbolId name, const size_t scope) const {
+		for (auto current = scope;; current = scopes_[current].parent) {
+			const auto& bindings = scopes_[current].bindings;
+			if (const auto it = bindings.find(name); it != bindings.end()) {
+				return &it->second;
+			}
+
+			if (scopes_[current].parent == current) {
+				return nullptr;
+			}
+		}
+	}
+
+	TypeChecker::TypeBinding* TypeChecker::find_binding(const symbol::SymbolId name, const size_t scope) {
+		return const_cast<TypeBinding*>(std::as_const(*this).find_binding(name, scope));
+	}
+
+	type::TypeId TypeChecker::resolve_type(const std::string& name, const SourcePosition position, const size_t scope) {
+		if (name.empty()) {
+			return TypeTable::builtin(BuiltIn::None);
+		}
+
+		if (const auto builtin = TypeTable::builtin_from_name(name)) {
+			return TypeTable::builtin(*builtin);
+		}
+
+		if (const auto id = context_.interner().find(name)) {
+			if (const auto binding = find_binding(*id, scope)) {
+				return resolve_binding(*binding);
+			}
+		}
+
+		context_.report(DiagnosticCode::UnknownType, position, name);
+		return TypeTable::error_type;
+	}
+
+	type::TypeId TypeChecker::resolve_binding(TypeBinding& binding) {
+		if (binding.type != type::unresolved_type) {
+			return binding.type;
+		}
+
+		const auto alias = static_cast<const ast::TypeAliasDeclaration*>(binding.decl);
+		if (binding.resolving) {
+			context_.report(DiagnosticCode::CyclicTypeAlias, alias->position, alias->alias);
+			return binding.type = TypeTable::error_type;
+		}
+
+		// aliases resolve in the scope they are declared in, on first use
+		binding.resolving = true;
+		const auto type = resolve_type(alias->type, alias->position, binding.scope);
+		binding.resolving = false;
+
+		// a cycle may already have settled this binding
+		if (binding.type == type::unresolved_type) {
+			binding.type = type;
+		}
+		return binding.type;
+	}
+
+	type::TypeId TypeChecker::lookup_type(const std::string& name, const size_t scope) const {
+		if (name.empty()) {
+			return TypeTable::builtin(BuiltIn::None);
+		}
+
+		if (const auto builtin = TypeTable::builtin_from_name(name)) {
+			return TypeTable::builtin(*builtin);
+		}
+
+		if (const auto id = context_.interner().find(name)) {
+			if (const auto binding = find_binding(*id, scope)) {
+				return binding->type;
+			}
+		}
+
+		return type::unresolved_type;
+	}
+
+	void TypeChecker::visit(ast::Program& program) {
+		scopes_.clear();
+		bodies_.clear();
+
+		scopes_.push_back(TypeScope { 0 });
+		scope_ = 0;
+
+		collect_declarations(program.body);
+		check_bodies();
+	}
+
+	void TypeChecker::visit(ast::FunctionDeclaration& func) {
+		declare_signature(func);
+	}
+
+	void TypeChecker::visit(ast::TypeDeclaration& decl) {
+		const auto outer = scope_;
+
+		scope_ = scopes_.size();
+		scopes_.push_back(TypeScope { outer });
+
+		collect_declarations(decl.body);
+
+		scope_ = outer;
+	}
+
+	void TypeChecker::visit(ast::TypeAliasDeclaration& decl) {
+		// resolve every alias now, bodies only read resolved bindings
+		const auto id = context_.interner().intern(decl.alias);
+		if (const auto it = scopes_[scope_].bindings.find(id); it != scopes_[scope_].bindings.end() && it->second.decl == &decl) {
+			resolve_binding(it->second);
+		}
+	}
+
+	BodyChecker::BodyChecker(const TypeChecker& checker, const size_t scope, const type::TypeId return_type)
+		: checker_(checker), types_(checker.types_), scope_(scope), return_type_(return_type) {}
+
+	type::TypeId BodyChecker::check(ast::expression::Expression& expr, const type::TypeId expected) {
+		const auto outer = expected_;
+		expected_ = expected;
+
+		expr.accept(*this);
+
+		expected_ = outer;
+		return expr.type_id;
+	}
+
+	void BodyChecker::expect_type(const type::TypeId expected, const type::TypeId actual, const SourcePosition position) {
+		if (expected == actual || is_error(expected) || is_error(actual)) {
+			return;
+		}
+
+		report(DiagnosticCode::TypeMismatch, position, type_name(expected), type_name(actual));
+	}
+
+	void BodyChecker::report_operands(const TokenType op, const type::TypeId operand, const SourcePosition position) {
+		if (!is_error(operand)) {
+			report(DiagnosticCode::InvalidOperands, position, std::string(token_type_to_name(op)), type_name(operand));
+		}
+	}
+
+	void BodyChecker::report(const DiagnosticCode code, const SourcePosition position, std::string argument, std::string second_argument) {
+		diagnostics_.push_back(Diagnostic { code, position, std::move(argument), std::move(second_argument) });
+	}
+
+	std::string BodyChecker::type_name(const type::TypeId type) const {
+		return types_.name(type, checker_.context_.interner());
+	}
+
+	void BodyChecker::visit(ast::FunctionDeclaration& func) {
+		if (func.body) {
+			func.body->accept(*this);
+		}
+	}
+
+	void BodyChecker::visit(ast::statement::LetStatement& stat) {
+		if (!stat.symbol) {
+			// expression statement
+			check(*stat.expr);
+			return;
+		}
+
+		if (stat.type.empty()) {
+			auto type = check(*stat.expr);
+			if (type == TypeTable::builtin(BuiltIn::None)) {
+				report(DiagnosticCode::TypeMismatch, stat.position, "a value", type_name(type));
+				type = TypeTable::error_type;
+			}
+			stat.symbol->type_id = type;
+			return;
+		}
+
+		auto declared = checker_.lookup_type(stat.type, scope_);
+		if (declared == type::unresolved_type) {
+			report(DiagnosticCode::UnknownType, stat.position, stat.type);
+			declared = TypeTable::error_type;
+		}
+
+		expect_type(declared, check(*stat.expr, declared), stat.expr->position);
+		stat.symbol->type_id = declared;
+	}
+
+	void BodyChecker::visit(ast::statement::StatementBlock& block) {
+		for (const auto& stat : block.statements) {
+			stat->accept(*this);
+		}
+	}
+
+	void BodyChecker::visit(ast::statement::IfStatement& stat) {
+		const auto boolean = TypeTable::builtin(BuiltIn::Bool);
+
+		auto branch = &stat;
+		while (true) {
+			expect_type(boolean, check(*branch->cond, boolean), branch->cond->position);
+			branch->body->accept(*this);
+
+			if (const auto next = branch->else_if()) {
+				branch = next;
+			} else {
+				break;
+			}
+		}
+
+		if (branch->else_body) {
+			branch->else_body->accept(*this);
+		}
+	}
+
+	void BodyChecker::visit(ast::statement::WhileStatement& stat) {
+		const auto boolean = TypeTable::builtin(BuiltIn::Bool);
+		expect_type(boolean, check(*stat.cond, boolean), stat.cond->position);
+
+		stat.body->accept(*this);
+	}
+
+	void BodyChecker::visit(ast::statement::ReturnStatement& stat) {
+		if (!stat.expr) {
+			expect_type(return_type_, TypeTable::builtin(BuiltIn::None), stat.position);
+			return;
+		}
+
+		expect_type(return_type_, check(*stat.expr, return_type_), stat.expr->position);
+	}
+
+	void BodyChecker::visit(ast::expression::StringLiteral& expr) {
+		expr.type_id = TypeTable::builtin(BuiltIn::String);
+	}
+
+	void BodyChecker::visit(ast::expression::NumberLiteral& expr) {
+		if (expr.type == BuiltIn::None) {
+			// the decoder already reported this literal
+			expr.type_id = TypeTable::error_type;
+		} else if (expr.is_float()) {
+			// float literals adopt an expected float type
+			expr.type_id = types_.is_float(expected_) ? expected_ : TypeTable::builtin(BuiltIn::f64);
+		} else {
+			// integer literals adopt any expected numeric type
+			expr.type_id = types_.is_numeric(expected_) ? expected_ : TypeTable::builtin(BuiltIn::i64);
+		}
+	}
+
+	void BodyChecker::visit(ast::expression::BooleanLiteral& expr) {
+		expr.type_id = TypeTable::builtin(BuiltIn::Bool);
+	}
+
+	void BodyChecker::visit(ast::expression::UnaryExpression& expr) {
+		const auto operand = check(*expr.expr, expected_);
+
+		if (!types_.is_numeric(operand)) {
+			report_operands(expr.op, operand, expr.position);
+			expr.type_id = TypeTable::error_type;
+			return;
+		}
+
+		expr.type_id = operand;
+	}
+
+	void BodyChecker::visit(ast::expression::BinaryExpression& expr) {
+		switch (expr.op) {
+			case TokenType::OpAssign:
+			case TokenType::OpAddEq:
+			case TokenType::OpSubEq: {
+				const auto target = check(*expr.lhs);
+				if (!assignable_symbol(*expr.lhs)) {
+					report(DiagnosticCode::NotAssignable, expr.lhs->position, "this expression");
+				}
+
+				const auto value = check(*expr.rhs, target);
+				expect_type(target, value, expr.rhs->position);
+
+				if (expr.op != TokenType::OpAssign && !types_.is_numeric(target)) {
+					report_operands(expr.op, target, expr.position);
+				}
+
+				expr.type_id = target;
+				return;
+			}
+			case TokenType::OpLogicalAnd: {
+				const auto boolean = TypeTable::builtin(BuiltIn::Bool);
+				expect_type(boolean, check(*expr.lhs, boolean), expr.lhs->position);
+				expect_type(boolean, check(*expr.rhs, boolean), expr.rhs->position);
+
+				expr.type_id = boolean;
+				return;
+			}
+			default: break;
+		}
+
+		// both operands share a type, a literal operand adopts the other's
+		const auto comparison = expr.op == TokenType::OpEq;
+		const auto operand_expected = comparison ? type::unresolved_type : expected_;
+
+		type::TypeId lhs, rhs;
+		if (is_number_literal(*expr.lhs) && !is_number_literal(*expr.rhs)) {
+			rhs = check(*expr.rhs, operand_expected);
+			lhs = check(*expr.lhs, rhs);
+		} else {
+			lhs = check(*expr.lhs, operand_expected);
+			rhs = check(*expr.rhs, lhs);
+		}
+
+		if (is_error(lhs) || is_error(rhs)) {
+			expr.type_id = TypeTable::error_type;
+			return;
+		}
+
+		if (lhs != rhs) {
+			expect_type(lhs, rhs, expr.rhs->position);
+			expr.type_id = TypeTable::error_type;
+			return;
+		}
+
+		bool valid;
+		switch (expr.op) {
+			case TokenType::OpEq: valid = lhs != TypeTable::builtin(BuiltIn::None); break;
+			case TokenType::OpBitwiseAnd: valid = types_.is_integer(lhs) || lhs == TypeTable::builtin(BuiltIn::Bool); break;
+			default: valid = types_.is_numeric(lhs); break;
+		}
+
+		if (!valid) {
+			report_operands(expr.op, lhs, expr.position);
+			expr.type_id = TypeTable::error_type;
+			return;
+		}
+
+		expr.type_id = comparison ? TypeTable::builtin(BuiltIn::Bool) : lhs;
+	}
+
+	void BodyChecker::visit(ast::expression::PostfixExpression& expr) {
+		const auto operand = check(*expr.rhs);
+
+		if (!assignable_symbol(*expr.rhs)) {
+			report(DiagnosticCode::NotAssignable, expr.rhs->position, "this expression");
+		} else if (!types_.is_integer(operand)) {
+			report_operands(expr.op, operand, expr.position);
+			expr.type_id = TypeTable::error_type;
+			return;
+		}
+
+		expr.type_id = operand;
+	}
+
+	void BodyChecker::visit(ast::expression::Identifier& expr) {
+		if (!expr.symbol || expr.symbol->type_id == type::unresolved_type) {
+			// undeclared names were reported by name resolution
+			expr.type_id = TypeTable::error_type;
+			return;
+		}
+
+		expr.type_id = expr.symbol->type_id;
+	}
+
+	void BodyChecker::visit(ast::expression::FunctionCall& expr) {
+		const auto callee = check(*expr.function);
+
+		if (is_error(callee) || types_.get(callee).kind != type::TypeKind::Function) {
+			if (!is_error(callee)) {
+				report(DiagnosticCode::NotCallable, expr.function->position, type_name(callee));
+			}
+
+			for (const auto& arg : expr.args) {
+				check(*arg);
+			}
+			expr.type_id = TypeTable::error_type;
+			return;
+		}
+
+		// copied, checking arguments may intern new types
+		const auto signature = types_.get(callee);
+
+		if (signature.elements.size() != expr.args.size()) {
+			const auto identifier = dynamic_cast<ast::expression::Identifier*>(expr.function.get());
+			report(DiagnosticCode::ArgumentCountMismatch, expr.position,
+				identifier ? identifier->identifier : type_name(callee),
+				std::to_string(signature.elements.size()));
+		}
+
+		for (size_t i = 0; i < expr.args.size(); i++) {
+			if (i < signature.elements.size()) {
+				const auto param = signature.elements[i];
+				expect_type(param, check(*expr.args[i], param), expr.args[i]->position);
+			} else {
+				check(*expr.args[i]);
+			}
+		}
+
+		expr.type_id = signature.result;
+	}
+}
@@ -1,47 +1,88 @@
 #include "source.h"
 
-#include <cwctype>
+#include <cctype>
+#include <cstdio>
 #include <utility>
 
 namespace seam {
-	// TODO: Add WEOF!
-	
-	Source::Source(std::wstring source)
+	bool is_valid_utf8(const std::string_view text) {
+		for (size_t i = 0; i < text.size();) {
+			const auto lead = static_cast<unsigned char>(text[i]);
+			if (lead < 0x80) {
+				i++;
+				continue;
+			}
+
+			// length and smallest code point of the sequence, to reject overlong forms
+			size_t length;
+			char32_t code_point, minimum;
+			if ((lead & 0xe0) == 0xc0) {
+				length = 2, code_point = lead & 0x1f, minimum = 0x80;
+			} else if ((lead & 0xf0) == 0xe0) {
+				length = 3, code_point = lead & 0x0f, minimum = 0x800;
+			} else if ((lead & 0xf8) == 0xf0) {
+				length = 4, code_point = lead & 0x07, minimum = 0x10000;
+			} else {
+				return false;
+			}
+
+			if (i + length > text.size()) {
+				return false;
+			}
+			for (size_t j = 1; j < length; j++) {
+				if (!is_utf8_continuation(text[i + j])) {
+					return false;
+				}
+				code_point = code_point << 6 | (static_cast<unsigned char>(text[i + j]) & 0x3f);
+			}
+			if (code_point < minimum || code_point > 0x10ffff || (code_point >= 0xd800 && code_point <= 0xdfff)) {
+				return false;
+			}
+			i += length;
+		}
+		return true;
+	}
+
+	Source::Source(std::string source)
 		: string_src_(std::move(source)) {
 		
 	}
 
-	SourceReader::SourceReader(const Source* source)
-		: source_(source) {
+	void Source::replace(const size_t start, const size_t length, const std::string& text) {
+		string_src_.replace(start, length, text);
+	}
+
+	SourceReader::SourceReader(const Source* source, const size_t start)
+		: start_pointer_(start), source_(source) {
 		
 	}
 
 	// TODO: write test!
-	wchar_t SourceReader::get_char(const size_t pos) const {
+	int SourceReader::get_char(const size_t pos) const {
 		if (pos >= length()) {
-			return WEOF;
+			return EOF;
 		}
 		
-		return source_->string_src_.at(pos);
+		return static_cast<unsigned char>(source_->string_src_[pos]);
 	}
 
-	wchar_t SourceReader::peek_char(const size_t num_chars_ahead) const {
+	int SourceReader::peek_char(const size_t num_chars_ahead) const {
 		if (start_pointer_ + read_pointer_ + num_chars_ahead >= length()) {
-			return WEOF;
+			return EOF;
 		}
 		
-		return source_->string_src_.at(start_pointer_ + read_pointer_ + num_chars_ahead);
+		return static_cast<unsigned char>(source_->string_src_[start_pointer_ + read_pointer_ + num_chars_ahead]);
 	}
 	
-	wchar_t SourceReader::next_char() {
+	int SourceReader::next_char() {
 		if (start_pointer_ + read_pointer_ >= length()) {
-			return WEOF;
+			return EOF;
 		}
 		
-		return source_->string_src_.at(start_pointer_ + read_pointer_++);
+		return static_cast<unsigned char>(source_->string_src_[start_pointer_ + read_pointer_++]);
 	}
 
-	std::wstring SourceReader::consume() {
+	std::string SourceReader::consume() {
 		auto new_str =  source_->string_src_.substr(start_pointer_, read_pointer_);
 
 		discard();
@@ -59,7 +100,7 @@ namespace seam {
 	}
 
 	void SourceReader::discard_whitespace() {
-		while (std::iswspace(peek_char())) {
+		while (std::isspace(peek_char())) {
 			discard(1);
 		}
 	}
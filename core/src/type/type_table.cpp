@@ -0,0 +1,99 @@
+#include "type/type_table.h"
+
+#include "semantic/interner.h"
+
+namespace seam::type {
+	namespace {
+		constexpr std::pair<std::string_view, BuiltIn> builtin_names[] = {
+			{ "none",   BuiltIn::None },
+			{ "bool",   BuiltIn::Bool },
+			{ "char",   BuiltIn::Char },
+			{ "string", BuiltIn::String },
+			{ "i8",     BuiltIn::i8 },
+			{ "i16",    BuiltIn::i16 },
+			{ "i32",    BuiltIn::i32 },
+			{ "i64",    BuiltIn::i64 },
+			{ "u8",     BuiltIn::u8 },
+			{ "u16",    BuiltIn::u16 },
+			{ "u32",    BuiltIn::u32 },
+			{ "u64",    BuiltIn::u64 },
+			{ "f32",    BuiltIn::f32 },
+			{ "f64",    BuiltIn::f64 },
+		};
+	}
+
+	size_t TypeTable::KeyHash::operator()(const std::vector<uint32_t>& key) const {
+		size_t hash = key.size();
+		for (const auto element : key) {
+			hash ^= element + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+		}
+		return hash;
+	}
+
+	TypeTable::TypeTable() {
+		for (const auto& [name, builtin] : builtin_names) {
+			types_.push_back(Type { TypeKind::BuiltIn, builtin });
+		}
+		types_.push_back(Type { TypeKind::Error });
+	}
+
+	std::optional<BuiltIn> TypeTable::builtin_from_name(const std::string_view name) {
+		for (const auto& [builtin_name, builtin] : builtin_names) {
+			if (builtin_name == name) {
+				return builtin;
+			}
+		}
+		return std::nullopt;
+	}
+
+	TypeId TypeTable::intern(std::vector<uint32_t> key, Type type) {
+		if (const auto it = interned_.find(key); it != interned_.end()) {
+			return it->second;
+		}
+
+		const auto id = static_cast<TypeId>(types_.size());
+		types_.push_back(std::move(type));
+		interned_.emplace(std::move(key), id);
+
+		return id;
+	}
+
+	TypeId TypeTable::function(const std::vector<TypeId>& params, const TypeId result) {
+		std::vector<uint32_t> key { static_cast<uint32_t>(TypeKind::Function), result };
+		key.insert(key.end(), params.begin(), params.end());
+
+		return intern(std::move(key), Type { TypeKind::Function, BuiltIn::None, 0, result, params });
+	}
+
+	TypeId TypeTable::record(const symbol::SymbolId name) {
+		const auto id = static_cast<TypeId>(types_.size());
+		types_.push_back(Type { TypeKind::Record, BuiltIn::None, name });
+		return id;
+	}
+
+	bool TypeTable::is_integer(const TypeId id) const {
+		return id >= builtin(BuiltIn::i8) && id <= builtin(BuiltIn::u64);
+	}
+
+	bool TypeTable::is_float(const TypeId id) const {
+		return id == builtin(BuiltIn::f32) || id == builtin(BuiltIn::f64);
+	}
+
+	std::string TypeTable::name(const TypeId id, const semantic::Interner& interner) const {
+		const auto& type = get(id);
+
+		switch (type.kind) {
+			case TypeKind::BuiltIn: return std::string(builtin_names[id].first);
+			case TypeKind::Error: return "<error>";
+			case TypeKind::Record: return std::string(interner.name(type.name));
+			case TypeKind::Function: {
+				std::string result = "fn(";
+				for (size_t i = 0; i < type.elements.size(); i++) {
+					result += (i ? ", " : "") + name(type.elements[i], interner);
+				}
+				return result + ") -> " + name(type.result, interner);
+			}
+		}
+		return "";
+	}
+}
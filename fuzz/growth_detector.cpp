@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "targets.h"
+
+/*
+ * Slow Input Detector.
+ *
+ * Grows each seed by doubling and measures how the time and peak heap
+ * of the lexer and parser grow with it. Anything growing faster than
+ * n^threshold is flagged, as is a target crashing once the input is
+ * large enough, which is how unbounded recursion shows up.
+ *
+ * A seed is repeated whole, or, where it has regions between lines
+ * `//@repeat` and `//@end`, only those regions are. Nesting is grown
+ * with one region opening it and another closing it.
+ */
+
+namespace {
+	// live heap, counted through the global allocation functions
+	std::atomic<size_t> live_bytes = 0;
+	std::atomic<size_t> peak_bytes = 0;
+
+	// allocations carry their size ahead of them, aligned like malloc
+	constexpr size_t header_size = alignof(std::max_align_t);
+}
+
+void* operator new(const size_t size) {
+	auto* block = static_cast<char*>(std::malloc(size + header_size));
+	if (!block) {
+		throw std::bad_alloc();
+	}
+	std::memcpy(block, &size, sizeof(size));
+
+	const auto live = live_bytes += size;
+	auto peak = peak_bytes.load();
+	while (live > peak && !peak_bytes.compare_exchange_weak(peak, live)) {}
+
+	return block + header_size;
+}
+
+void operator delete(void* pointer) noexcept {
+	if (!pointer) {
+		return;
+	}
+	auto* block = static_cast<char*>(pointer) - header_size;
+	size_t size;
+	std::memcpy(&size, block, sizeof(size));
+	live_bytes -= size;
+	std::free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+	operator delete(pointer);
+}
+
+namespace {
+	struct Options {
+		double threshold = 1.5;
+		// inputs are not grown past this many bytes
+		size_t max_size = 1 << 20;
+		// nor once a single run takes this long
+		double max_seconds = 1.0;
+		// times below this are too noisy to compare
+		double min_seconds = 1e-3;
+		// stack of the thread running the targets, zero for the main thread's
+		size_t stack_size = 0;
+	};
+
+	struct Target {
+		const char* name;
+		void (*run)(std::string_view);
+	};
+
+	constexpr Target targets[] = {
+		{ "lexer", seam::fuzz::lex },
+		{ "parser", seam::fuzz::parse },
+	};
+
+	struct Sample {
+		size_t repeats;
+		size_t bytes;
+		double seconds;
+		// peak live heap, in bytes
+		double peak;
+	};
+
+	/**
+	 * Seed split around its repeated regions, even indices are kept
+	 * once and odd ones are repeated.
+	 */
+	std::vector<std::string> split(const std::string& seed) {
+		std::vector<std::string> parts(1);
+		std::istringstream lines(seed);
+
+		for (std::string line; std::getline(lines, line);) {
+			if (line == "//@repeat" || line == "//@end") {
+				if ((line == "//@repeat") == (parts.size() % 2 == 1)) {
+					parts.emplace_back();
+				}
+				continue;
+			}
+			parts.back() += line;
+			if (!lines.eof()) {
+				parts.back() += '\n';
+			}
+		}
+
+		// no regions, the whole seed repeats
+		if (parts.size() == 1) {
+			return { "", parts.front(), "" };
+		}
+		return parts;
+	}
+
+	std::string grow(const std::vector<std::string>& parts, const size_t repeats) {
+		std::string input;
+		for (size_t i = 0; i < parts.size(); i++) {
+			if (i % 2 == 0) {
+				input += parts[i];
+				continue;
+			}
+			for (size_t j = 0; j < repeats; j++) {
+				input += parts[i];
+			}
+		}
+		return input;
+	}
+
+	/**
+	 * Runs one target over ever larger inputs, writing a line per sample
+	 * to the pipe. A line naming the repeats goes ahead of each run, so
+	 * the parent knows how far a crashed child got.
+	 */
+	void measure(const Target& target, const std::vector<std::string>& parts, const Options& options, const int pipe) {
+		const auto write_line = [pipe](const std::string& line) {
+			const auto written = write(pipe, line.data(), line.size());
+			static_cast<void>(written);
+		};
+
+		for (size_t repeats = 1;; repeats *= 2) {
+			const auto input = grow(parts, repeats);
+			write_line("start " + std::to_string(repeats) + " " + std::to_string(input.size()) + "\n");
+
+			// best of three, the peak is the same every time
+			auto best = std::numeric_limits<double>::max();
+			size_t peak = 0;
+			for (auto i = 0; i < 3; i++) {
+				const auto baseline = live_bytes.load();
+				peak_bytes = baseline;
+				const auto start = std::chrono::steady_clock::now();
+				target.run(input);
+				const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+				best = std::min(best, elapsed.count());
+				peak = peak_bytes - baseline;
+			}
+
+			std::ostringstream line;
+			line << "sample " << repeats << " " << input.size() << " " << best << " " << peak << "\n";
+			write_line(line.str());
+
+			if (input.size() * 2 > options.max_size || best > options.max_seconds) {
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Measures on a thread with the configured stack, as a worker would
+	 * parse on, so running out of it is found at the depth it would be.
+	 */
+	void measure_on_stack(const Target& target, const std::vector<std::string>& parts, const Options& options, const int pipe) {
+		if (!options.stack_size) {
+			measure(target, parts, options, pipe);
+			return;
+		}
+
+		struct Arguments {
+			const Target& target;
+			const std::vector<std::string>& parts;
+			const Options& options;
+			int pipe;
+		} arguments { target, parts, options, pipe };
+
+		pthread_attr_t attributes;
+		pthread_attr_init(&attributes);
+		pthread_attr_setstacksize(&attributes, std::max<size_t>(options.stack_size, PTHREAD_STACK_MIN));
+
+		pthread_t thread;
+		const auto run = [](void* data) -> void* {
+			const auto& [target, parts, options, pipe] = *static_cast<Arguments*>(data);
+			measure(target, parts, options, pipe);
+			return nullptr;
+		};
+		if (pthread_create(&thread, &attributes, run, &arguments) != 0) {
+			std::perror("pthread_create");
+			_exit(2);
+		}
+		pthread_join(thread, nullptr);
+		pthread_attr_destroy(&attributes);
+	}
+
+	/**
+	 * Growth exponent between the largest sample and the one two
+	 * doublings below it, or one doubling if that is all there is.
+	 */
+	double exponent(const std::vector<Sample>& samples, double Sample::* value, const double minimum) {
+		for (size_t back = 2; back >= 1; back--) {
+			if (samples.size() <= back) {
+				continue;
+			}
+			const auto& large = samples.back();
+			const auto& small = samples[samples.size() - 1 - back];
+			if (small.*value < minimum || large.bytes == small.bytes) {
+				continue;
+			}
+			return std::log(large.*value / small.*value) / std::log(static_cast<double>(large.bytes) / static_cast<double>(small.bytes));
+		}
+		return 0;
+	}
+
+	/**
+	 * Runs a target over a seed in a child process, a crash only takes
+	 * the child down. Returns whether the seed passed.
+	 */
+	bool check(const std::filesystem::path& path, const std::vector<std::string>& parts, const Target& target, const Options& options) {
+		int fds[2];
+		if (pipe(fds) != 0) {
+			std::perror("pipe");
+			std::exit(2);
+		}
+
+		std::cout.flush();
+		const auto child = fork();
+		if (child == 0) {
+			close(fds[0]);
+			measure_on_stack(target, parts, options, fds[1]);
+			_exit(0);
+		}
+		close(fds[1]);
+
+		std::string output;
+		char buffer[4096];
+		for (ssize_t count; (count = read(fds[0], buffer, sizeof(buffer))) > 0;) {
+			output.append(buffer, count);
+		}
+		close(fds[0]);
+
+		int status = 0;
+		waitpid(child, &status, 0);
+
+		std::vector<Sample> samples;
+		size_t started_repeats = 0, started_bytes = 0;
+		std::istringstream lines(output);
+		for (std::string kind; lines >> kind;) {
+			if (kind == "start") {
+				lines >> started_repeats >> started_bytes;
+			} else {
+				Sample sample {};
+				lines >> sample.repeats >> sample.bytes >> sample.seconds >> sample.peak;
+				samples.push_back(sample);
+			}
+		}
+
+		const auto name = path.filename().string() + " (" + target.name + ")";
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			const auto reason = WIFSIGNALED(status) ? std::string(strsignal(WTERMSIG(status))) : "exit " + std::to_string(WEXITSTATUS(status));
+			std::cout << "CRASH " << name << ": " << reason << " at " << started_repeats << " repeats, " << started_bytes << " bytes\n";
+			return false;
+		}
+
+		const auto time = exponent(samples, &Sample::seconds, options.min_seconds);
+		// below a few pages the allocator's granularity dominates
+		const auto memory = exponent(samples, &Sample::peak, 1 << 16);
+		const auto& last = samples.back();
+		const auto slow = time > options.threshold || memory > options.threshold;
+
+		std::cout << (slow ? "SLOW  " : "ok    ") << name << std::fixed << std::setprecision(2)
+			<< ": time n^" << time << ", memory n^" << memory << " up to " << last.bytes << " bytes in "
+			<< std::setprecision(1) << last.seconds * 1000 << " ms\n";
+		return !slow;
+	}
+
+	std::string read_file(const std::filesystem::path& path) {
+		std::ifstream file(path, std::ios::binary);
+		return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+	}
+}
+
+int main(const int argc, char** argv) {
+	Options options;
+	std::vector<std::filesystem::path> seeds;
+
+	for (auto i = 1; i < argc; i++) {
+		const std::string argument = argv[i];
+		if (argument == "--threshold" && i + 1 < argc) {
+			options.threshold = std::stod(argv[++i]);
+		} else if (argument == "--max-size" && i + 1 < argc) {
+			options.max_size = std::stoull(argv[++i]);
+		} else if (argument == "--max-seconds" && i + 1 < argc) {
+			options.max_seconds = std::stod(argv[++i]);
+		} else if (argument == "--stack-size" && i + 1 < argc) {
+			options.stack_size = std::stoull(argv[++i]);
+		} else if (std::filesystem::is_directory(argument)) {
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(argument)) {
+				if (entry.is_regular_file()) {
+					seeds.push_back(entry.path());
+				}
+			}
+		} else {
+			seeds.emplace_back(argument);
+		}
+	}
+
+	if (seeds.empty()) {
+		std::cerr << "usage: seam-growth [--threshold n] [--max-size bytes] [--max-seconds s] [--stack-size bytes] <seed or corpus>...\n";
+		return 2;
+	}
+	std::sort(seeds.begin(), seeds.end());
+
+	auto failures = 0;
+	for (const auto& seed : seeds) {
+		const auto parts = split(read_file(seed));
+		for (const auto& target : targets) {
+			failures += !check(seed, parts, target, options);
+		}
+	}
+
+	std::cout << failures << " of " << seeds.size() * std::size(targets) << " checks failed\n";
+	return failures ? 1 : 0;
+}
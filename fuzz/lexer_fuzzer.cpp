@@ -0,0 +1,9 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "targets.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, const size_t size) {
+	seam::fuzz::lex({ reinterpret_cast<const char*>(data), size });
+	return 0;
+}
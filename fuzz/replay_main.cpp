@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+	void replay(const std::filesystem::path& path) {
+		std::ifstream file(path, std::ios::binary);
+		const std::string input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+	}
+}
+
+/**
+ * Stands in for libFuzzer where it is not available, runs the target
+ * once over each input file, or each file of a corpus directory.
+ */
+int main(const int argc, char** argv) {
+	size_t count = 0;
+
+	for (auto i = 1; i < argc; i++) {
+		const std::filesystem::path path(argv[i]);
+		if (!std::filesystem::is_directory(path)) {
+			replay(path);
+			count++;
+			continue;
+		}
+
+		// sorted, so a failing run is reproduced in the same order
+		std::vector<std::filesystem::path> files;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+			if (entry.is_regular_file()) {
+				files.push_back(entry.path());
+			}
+		}
+		std::sort(files.begin(), files.end());
+		for (const auto& file : files) {
+			replay(file);
+			count++;
+		}
+	}
+
+	std::cout << "replayed " << count << " inputs\n";
+	return 0;
+}
@@ -0,0 +1,49 @@
+#include "targets.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception.h>
+#include <parser/parallel_lexer.h>
+#include <parser/parser.h>
+
+namespace seam::fuzz {
+	namespace {
+		// small enough for a short input to straddle several chunks
+		constexpr size_t chunk_size = 16;
+
+		[[noreturn]] void mismatch(const Token& expected, const Token& token) {
+			std::fprintf(stderr, "parallel lexer mismatch at %zu: expected %s, got %s\n", expected.position.start_idx,
+				std::string(token_type_to_name(expected.type)).c_str(), std::string(token_type_to_name(token.type)).c_str());
+			std::abort();
+		}
+	}
+
+	void lex(const std::string_view input) {
+		const auto source = std::make_unique<Source>(std::string(input));
+		Lexer lexer(source.get());
+		ParallelLexer parallel(source.get(), 4, chunk_size);
+
+		while (true) {
+			const auto expected = lexer.next();
+			const auto token = parallel.next();
+			if (token->type != expected->type || token->lexeme != expected->lexeme || token->error != expected->error
+				|| token->position.start_idx != expected->position.start_idx || token->position.end_idx != expected->position.end_idx) {
+				mismatch(*expected, *token);
+			}
+			if (expected->type == TokenType::None) {
+				break;
+			}
+		}
+	}
+
+	void parse(const std::string_view input) {
+		const auto source = std::make_unique<Source>(std::string(input));
+		Parser parser(std::make_unique<Lexer>(source.get()));
+
+		try {
+			parser.parse();
+		} catch (const SeamException&) {
+			// malformed programs are reported, not crashed on
+		}
+	}
+}
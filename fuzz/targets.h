@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string_view>
+
+namespace seam::fuzz {
+	/**
+	 * Lexes an input to the end, and checks a ParallelLexer over
+	 * small chunks produces the same tokens. Aborts on a mismatch.
+	 */
+	void lex(std::string_view input);
+
+	/**
+	 * Parses an input. Errors in the input are expected, anything
+	 * but a SeamException escapes.
+	 */
+	void parse(std::string_view input);
+}
@@ -0,0 +1,11 @@
+#include <iostream>
+
+#include <lsp/server.h>
+
+int main() {
+	// buffered input lets the server see whether more messages are waiting
+	std::ios::sync_with_stdio(false);
+
+	seam::lsp::Server server([](const seam::lsp::Json&) {});
+	return server.run(std::cin, std::cout);
+}
@@ -0,0 +1,155 @@
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <driver/build.h>
+#include <driver/file_watcher.h>
+#include <driver/workspace.h>
+#include <exception.h>
+
+namespace {
+	constexpr auto usage = R"(usage: seamc [options] <file or directory>...
+
+Compiles every source, and every .seam file found in a directory, to one
+output each. Unchanged sources are not compiled again.
+
+options:
+  -o <directory>          output directory (default: build)
+  --emit=<kind>           object, c or ir (default: object)
+  -O0                     skip the optimisation passes
+  --cache-dir <directory> object store, may be shared between projects
+                          (default: <output>/.seamc/cache)
+  -j <count>              units compiled at once (default: every core)
+  --time-report           print how long each phase took
+  --watch                 keep the project loaded and compile changed
+                          modules, and the modules importing them, as
+                          their sources change
+  -h, --help              print this message
+)";
+
+	int fail(const std::string& message) {
+		std::cerr << "seamc: error: " << message << '\n';
+		return 2;
+	}
+
+	void print(const seam::driver::BuildResult& result, const seam::driver::TimeReport& report,
+		const std::chrono::steady_clock::time_point start, const bool time_report) {
+		for (const auto& diagnostic : result.diagnostics) {
+			std::cerr << diagnostic << '\n';
+		}
+
+		if (time_report) {
+			std::cerr << report.render(std::chrono::steady_clock::now() - start);
+			std::cerr << result.compiled << " compiled, " << result.restored << " restored from cache, "
+				<< result.unchanged + result.rehashed << " up to date, " << result.failed << " failed\n";
+		}
+	}
+
+	int watch(const seam::driver::BuildOptions& options, const bool time_report) {
+		seam::driver::Workspace workspace(options);
+
+		auto start = std::chrono::steady_clock::now();
+		seam::driver::TimeReport report;
+		print(workspace.load(report), report, start, time_report);
+		std::cerr << "seamc: watching " << workspace.size() << " modules\n";
+
+		seam::driver::FileWatcher watcher(workspace.directories());
+		while (true) {
+			const auto changed = watcher.wait(std::chrono::milliseconds(-1));
+
+			start = std::chrono::steady_clock::now();
+			seam::driver::TimeReport update_report;
+			try {
+				const auto result = workspace.update(changed, update_report);
+				if (result.compiled + result.failed == 0) {
+					continue;
+				}
+				print(result, update_report, start, time_report);
+
+				const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+				std::cerr << "seamc: " << result.compiled << " compiled, " << result.failed << " failed in "
+					<< std::fixed << std::setprecision(1) << elapsed.count() << " ms\n";
+			} catch (const seam::SeamException& e) {
+				std::cerr << "seamc: error: " << e.what() << '\n';
+			} catch (const std::filesystem::filesystem_error& e) {
+				std::cerr << "seamc: error: " << e.what() << '\n';
+			}
+		}
+	}
+}
+
+int main(const int argc, char* argv[]) {
+	seam::driver::BuildOptions options;
+	auto time_report = false;
+	auto watching = false;
+
+	for (auto i = 1; i < argc; i++) {
+		const std::string argument = argv[i];
+		const auto value = [&]() -> const char* {
+			return i + 1 < argc ? argv[++i] : nullptr;
+		};
+
+		if (argument == "-h" || argument == "--help") {
+			std::cout << usage;
+			return 0;
+		} else if (argument == "-o") {
+			const auto directory = value();
+			if (!directory) {
+				return fail("-o expects a directory");
+			}
+			options.output_directory = directory;
+		} else if (argument == "--cache-dir") {
+			const auto directory = value();
+			if (!directory) {
+				return fail("--cache-dir expects a directory");
+			}
+			options.cache_directory = directory;
+		} else if (argument == "-j") {
+			const auto count = value();
+			if (!count || std::strspn(count, "0123456789") != std::strlen(count) || !*count) {
+				return fail("-j expects a count");
+			}
+			options.threads = std::stoul(count);
+		} else if (argument == "--emit=object") {
+			options.compile.emit = seam::driver::EmitKind::Object;
+		} else if (argument == "--emit=c") {
+			options.compile.emit = seam::driver::EmitKind::C;
+		} else if (argument == "--emit=ir") {
+			options.compile.emit = seam::driver::EmitKind::Ir;
+		} else if (argument == "-O0") {
+			options.compile.optimise = false;
+		} else if (argument == "--time-report") {
+			time_report = true;
+		} else if (argument == "--watch") {
+			watching = true;
+		} else if (argument.starts_with("-")) {
+			return fail("unknown option " + argument + ", see --help");
+		} else {
+			options.inputs.emplace_back(argument);
+		}
+	}
+
+	if (options.inputs.empty()) {
+		std::cerr << usage;
+		return 2;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	seam::driver::TimeReport report;
+	seam::driver::BuildResult result;
+	try {
+		if (watching) {
+			return watch(options, time_report);
+		}
+		result = seam::driver::build(options, report);
+	} catch (const seam::SeamException& e) {
+		return fail(e.what());
+	} catch (const std::filesystem::filesystem_error& e) {
+		return fail(e.what());
+	}
+
+	print(result, report, start, time_report);
+	return result.succeeded() ? 0 : 1;
+}
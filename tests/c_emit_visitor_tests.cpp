@@ -0,0 +1,262 @@
+#include <catch2/catch.hpp>
+#include <ast/c_emit_visitor.h>
+#include <ir/interpreter.h>
+#include <ir/lowering.h>
+#include <parser/parser.h>
+#include <semantic/name_resolver.h>
+#include <semantic/type_checker.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace {
+	struct Emitted {
+		std::string c;
+		seam::ir::Module module;
+	};
+
+	Emitted emit(const std::string& raw_source) {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+		const auto program = parser.parse();
+
+		seam::semantic::Context context;
+		seam::semantic::NameResolver resolver(context);
+		program->accept(resolver);
+		seam::semantic::TypeChecker checker(context, 1);
+		program->accept(checker);
+		REQUIRE_FALSE(context.has_errors());
+
+		seam::ast::CEmitVisitor emitter(context);
+		program->accept(emitter);
+
+		seam::ir::AstLowering lowering(context);
+		return Emitted { emitter.str(), lowering.lower(*program) };
+	}
+
+	bool has_c_compiler() {
+#ifdef _WIN32
+		return false;
+#else
+		return std::system("cc --version > /dev/null 2>&1") == 0;
+#endif
+	}
+
+	/**
+	 * Compiles the emitted C with a driver and returns its output lines.
+	 */
+	std::vector<std::string> compile_and_run(const std::string& c, const std::string& driver) {
+		// a directory per run, tests compile in parallel
+		const auto directory = std::filesystem::temp_directory_path() / ("seam_c_emit_tests_" + std::to_string(std::random_device()()));
+		std::filesystem::create_directories(directory);
+
+		std::ofstream(directory / "program.c") << c;
+		std::ofstream(directory / "driver.c") << "#include <stdbool.h>\n#include <stdint.h>\n#include <stdio.h>\n" << driver;
+
+		const auto executable = directory / "program";
+		const auto command = "cc -std=c11 -O2 -fwrapv -o " + executable.string() + " "
+			+ (directory / "driver.c").string() + " " + (directory / "program.c").string();
+		REQUIRE(std::system(command.c_str()) == 0);
+
+		std::vector<std::string> lines;
+		auto* pipe = popen(executable.string().c_str(), "r");
+		REQUIRE(pipe != nullptr);
+		char line[64];
+		while (fgets(line, sizeof(line), pipe) != nullptr) {
+			lines.emplace_back(line, strcspn(line, "\n"));
+		}
+		REQUIRE(pclose(pipe) == 0);
+
+		std::filesystem::remove_all(directory);
+		return lines;
+	}
+
+	const auto program = R"(
+		fn fib(n: i64) -> i64 {
+			if (n == 0) {
+				return 0
+			}
+			if (n == 1) {
+				return 1
+			}
+			return fib(n - 1) + fib(n - 2)
+		}
+
+		fn sum(n: i64, a: i64) -> i64 {
+			let total := 0
+			let i := 0
+			while (i == n == false) {
+				let i := i * a
+				total += i / 3 - -i
+			}
+			return total
+		}
+
+		fn count(n: i64) -> i64 {
+			let total := 0
+			let i := 0
+			while (i == n == false) {
+				total += i
+				i++
+			}
+			return total
+		}
+
+		fn divide(a: i64, b: i64) -> i64 {
+			return a / b
+		}
+
+		fn scale(x: f64, y: f64) -> f64 {
+			let half: f64 = 2
+			return x * y / half - 0.25
+		}
+
+		fn check(x: f64, a: i64) -> bool {
+			return x == 1.5 && a == 2
+		}
+	)";
+}
+
+TEST_CASE("emitting C") {
+	const auto emitted = emit(R"(
+		fn add(a: i32, b: i32) -> i32 {
+			let c := a + b
+			return c
+		}
+	)");
+
+	REQUIRE(emitted.c.find("int32_t seam_3add(int32_t a_1, int32_t b_2);") != std::string::npos);
+	REQUIRE(emitted.c.find("\tint32_t c_3 = ((int32_t) (a_1 + b_2));\n") != std::string::npos);
+	REQUIRE(emitted.c.find("\treturn c_3;\n") != std::string::npos);
+}
+
+TEST_CASE("shadowed names are kept apart") {
+	const auto emitted = emit(program);
+	// the inner i reads the outer one in its initialiser
+	REQUIRE(emitted.c.find("int64_t i_13 = ((int64_t) (i_12 * a_3));") != std::string::npos);
+}
+
+TEST_CASE("elseif chains are emitted flat") {
+	const auto emitted = emit(R"(
+		fn pick(a: i64) -> i64 {
+			if (a == 0) {
+				return 1
+			} elseif (a == 1) {
+				return 2
+			} else {
+				return 3
+			}
+		}
+	)");
+
+	REQUIRE(emitted.c.find(
+		"\tif ((a_1 == ((int64_t) INT64_C(0)))) {\n"
+		"\t\treturn ((int64_t) INT64_C(1));\n"
+		"\t} else if ((a_1 == ((int64_t) INT64_C(1)))) {\n"
+		"\t\treturn ((int64_t) INT64_C(2));\n"
+		"\t} else {\n"
+		"\t\treturn ((int64_t) INT64_C(3));\n"
+		"\t}\n") != std::string::npos);
+}
+
+TEST_CASE("unsupported values are rejected") {
+	const auto source = std::make_unique<seam::Source>("fn name() -> string { return \"seam\" }");
+	seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+	const auto program = parser.parse();
+
+	seam::semantic::Context context;
+	seam::semantic::NameResolver resolver(context);
+	program->accept(resolver);
+	seam::semantic::TypeChecker checker(context, 1);
+	program->accept(checker);
+
+	seam::ast::CEmitVisitor emitter(context);
+	REQUIRE_THROWS_AS(program->accept(emitter), seam::LoweringException);
+}
+
+TEST_CASE("compiled C matches the interpreter") {
+	if (!has_c_compiler()) {
+		WARN("no C compiler, skipping");
+		return;
+	}
+
+	const auto emitted = emit(program);
+	const auto lines = compile_and_run(emitted.c,
+		"int64_t seam_3fib(int64_t); int64_t seam_5count(int64_t); int64_t seam_6divide(int64_t, int64_t);\n"
+		"double seam_5scale(double, double); bool seam_5check(double, int64_t);\n"
+		"int main(void) {\n"
+		"\tprintf(\"%lld\\n%lld\\n%lld\\n%lld\\n\", (long long) seam_3fib(20), (long long) seam_5count(1000),\n"
+		"\t\t(long long) seam_6divide(-7, 2), (long long) seam_6divide(INT64_MIN, -1));\n"
+		"\tprintf(\"%.17g\\n%d\\n%d\\n\", seam_5scale(3.0, 0.5), seam_5check(1.5, 2), seam_5check(1.5, 3));\n"
+		"\treturn 0;\n}\n");
+	REQUIRE(lines.size() == 7);
+
+	const auto& module = emitted.module;
+	seam::ir::Interpreter interpreter(module);
+	const auto call = [&](const std::string& name, const std::vector<seam::ir::Value>& arguments) {
+		return interpreter.call(*module.find(name), arguments);
+	};
+
+	REQUIRE(lines[0] == std::to_string(call("fib", { { 20 } }).i64));
+	REQUIRE(lines[1] == std::to_string(call("count", { { 1000 } }).i64));
+	REQUIRE(lines[2] == std::to_string(call("divide", { { -7 }, { 2 } }).i64));
+	REQUIRE(lines[3] == std::to_string(call("divide", { { INT64_MIN }, { -1 } }).i64));
+	REQUIRE(std::stod(lines[4]) == call("scale", { { .f64 = 3.0 }, { .f64 = 0.5 } }).f64);
+	REQUIRE(lines[5] == std::to_string(call("check", { { .f64 = 1.5 }, { 2 } }).i64));
+	REQUIRE(lines[6] == std::to_string(call("check", { { .f64 = 1.5 }, { 3 } }).i64));
+}
+
+TEST_CASE("fixed-width types keep their width in C") {
+	if (!has_c_compiler()) {
+		WARN("no C compiler, skipping");
+		return;
+	}
+
+	const auto emitted = emit(R"(
+		fn wrap(x: u8) -> u8 {
+			let one: u8 = 1
+			return x + one
+		}
+
+		fn narrow(x: i32, y: i32) -> i32 {
+			return x * y
+		}
+	)");
+	const auto lines = compile_and_run(emitted.c,
+		"uint8_t seam_4wrap(uint8_t); int32_t seam_6narrow(int32_t, int32_t);\n"
+		"int main(void) { printf(\"%d\\n%d\\n\", seam_4wrap(255), seam_6narrow(65536, 65536)); return 0; }\n");
+
+	REQUIRE(lines == std::vector<std::string> { "0", "0" });
+}
+
+TEST_CASE("function names cannot collide in C") {
+	if (!has_c_compiler()) {
+		WARN("no C compiler, skipping");
+		return;
+	}
+
+	// libc and driver names, and members of the same name in different types
+	const auto emitted = emit(R"(
+		fn main() -> i64 { return abort() + div(7) }
+		fn abort() -> i64 { return 1 }
+		fn div(x: i64) -> i64 { return x / 2 }
+		fn free(x: i64) -> i64 { return x }
+
+		type A { fn f() -> i64 { return 10 } }
+		type B { fn f() -> i64 { return 20 } }
+		type A_1 { fn f() -> i64 { return 30 } }
+	)");
+	REQUIRE(emitted.c.find("int64_t seam_1A1f(void);") != std::string::npos);
+	REQUIRE(emitted.c.find("int64_t seam_3A_11f(void);") != std::string::npos);
+
+	const auto lines = compile_and_run(emitted.c,
+		"int64_t seam_4main(void); int64_t seam_4free(int64_t); int64_t seam_1A1f(void); int64_t seam_1B1f(void); int64_t seam_3A_11f(void);\n"
+		"int main(void) { printf(\"%lld %lld %lld %lld %lld\\n\", (long long) seam_4main(), (long long) seam_4free(5),\n"
+		"\t(long long) seam_1A1f(), (long long) seam_1B1f(), (long long) seam_3A_11f()); return 0; }\n");
+
+	REQUIRE(lines == std::vector<std::string> { "4 5 10 20 30" });
+}
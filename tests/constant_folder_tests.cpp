@@ -0,0 +1,138 @@
+#include <catch2/catch.hpp>
+#include <parser/parser.h>
+#include <ast/constant_folder.h>
+
+#include <limits>
+
+namespace {
+	std::unique_ptr<seam::ast::Program> parse_and_fold(const std::string& raw_source, size_t* folded_count = nullptr) {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+
+		auto program = parser.parse();
+
+		seam::ast::ConstantFolder folder;
+		program->accept(folder);
+
+		if (folded_count) {
+			*folded_count = folder.folded_count();
+		}
+		return program;
+	}
+
+	seam::ast::statement::StatementList& main_body(const std::unique_ptr<seam::ast::Program>& program) {
+		return dynamic_cast<seam::ast::FunctionDeclaration*>(program->body.front().get())->body->statements;
+	}
+
+	seam::ast::expression::Expression* let_expr(const std::unique_ptr<seam::ast::Program>& program, const size_t idx = 0) {
+		return dynamic_cast<seam::ast::statement::LetStatement*>(main_body(program)[idx].get())->expr.get();
+	}
+}
+
+TEST_CASE("folding integer arithmetic") {
+	const auto program = parse_and_fold("fn main() { let x := 1 + 2 * 3 - 0x10 / 4 }");
+
+	const auto literal = dynamic_cast<seam::ast::expression::NumberLiteral*>(let_expr(program));
+	REQUIRE(literal);
+	REQUIRE(literal->type == seam::type::BuiltIn::i64);
+	REQUIRE(literal->constant.i64 == 3);
+}
+
+TEST_CASE("folding floating point arithmetic") {
+	const auto program = parse_and_fold("fn main() { let x := 1.5 * 2 + -.5 }");
+
+	const auto literal = dynamic_cast<seam::ast::expression::NumberLiteral*>(let_expr(program));
+	REQUIRE(literal);
+	REQUIRE(literal->type == seam::type::BuiltIn::f64);
+	REQUIRE(literal->constant.f64 == 2.5);
+}
+
+TEST_CASE("folding comparisons and booleans") {
+	const auto program = parse_and_fold("fn main() { let x := 2 * 2 == 4 && true }");
+
+	const auto literal = dynamic_cast<seam::ast::expression::BooleanLiteral*>(let_expr(program));
+	REQUIRE(literal);
+	REQUIRE(literal->value);
+}
+
+TEST_CASE("folding does not fold unsafe operations") {
+	const auto program = parse_and_fold("fn main() { let x := 1 / 0 let y := 9223372036854775807 + 1 }");
+
+	REQUIRE(dynamic_cast<seam::ast::expression::BinaryExpression*>(let_expr(program, 0)));
+	REQUIRE(dynamic_cast<seam::ast::expression::BinaryExpression*>(let_expr(program, 1)));
+}
+
+TEST_CASE("folding integers up to the edges of i64") {
+	const auto [source, folds, value] = GENERATE(table<std::string, bool, int64_t>({
+		{ "-9223372036854775807 - 1", true, std::numeric_limits<int64_t>::min() },
+		{ "-9223372036854775807 - 2", false, 0 },
+		{ "-9223372036854775807 + -1", true, std::numeric_limits<int64_t>::min() },
+		{ "-9223372036854775807 + -2", false, 0 },
+		{ "3037000499 * 3037000499", true, 9223372030926249001 },
+		{ "3037000500 * 3037000500", false, 0 },
+		{ "-3037000500 * 3037000500", false, 0 },
+		{ "-4611686018427387904 * 2", true, std::numeric_limits<int64_t>::min() },
+		{ "4611686018427387904 * -2", true, std::numeric_limits<int64_t>::min() },
+		{ "-4611686018427387904 * -2", false, 0 },
+	}));
+	const auto program = parse_and_fold("fn main() { let x := " + source + " }");
+
+	INFO(source);
+	const auto literal = dynamic_cast<seam::ast::expression::NumberLiteral*>(let_expr(program));
+	REQUIRE(static_cast<bool>(literal) == folds);
+	if (literal) {
+		REQUIRE(literal->constant.i64 == value);
+	}
+}
+
+TEST_CASE("algebraic simplification") {
+	const auto program = parse_and_fold("fn main() { let x := (a + 0) * 1 let y := false && f() let z := true && b }");
+
+	const auto x = dynamic_cast<seam::ast::expression::Identifier*>(let_expr(program, 0));
+	REQUIRE(x);
+	REQUIRE(x->identifier == "a");
+
+	const auto y = dynamic_cast<seam::ast::expression::BooleanLiteral*>(let_expr(program, 1));
+	REQUIRE(y);
+	REQUIRE_FALSE(y->value);
+
+	const auto z = dynamic_cast<seam::ast::expression::Identifier*>(let_expr(program, 2));
+	REQUIRE(z);
+	REQUIRE(z->identifier == "b");
+}
+
+TEST_CASE("dead branch elimination") {
+	size_t folded_count = 0;
+	const auto program = parse_and_fold(R"(
+		fn main() {
+			if (1 == 2) {
+				a()
+			} elseif (true) {
+				b()
+			} else {
+				c()
+			}
+			while (false) {
+				d()
+			}
+			if (false) {
+				e()
+			}
+		}
+	)", &folded_count);
+
+	auto& body = main_body(program);
+	REQUIRE(body.size() == 1);
+	REQUIRE(folded_count > 0);
+
+	// the if chain collapses into the elseif block holding b()
+	const auto block = dynamic_cast<seam::ast::statement::StatementBlock*>(body.front().get());
+	REQUIRE(block);
+	REQUIRE(block->statements.size() == 1);
+
+	const auto inner = dynamic_cast<seam::ast::statement::StatementBlock*>(block->statements.front().get());
+	REQUIRE(inner);
+	const auto call = dynamic_cast<seam::ast::expression::FunctionCall*>(
+		dynamic_cast<seam::ast::statement::LetStatement*>(inner->statements.front().get())->expr.get());
+	REQUIRE(dynamic_cast<seam::ast::expression::Identifier*>(call->function.get())->identifier == "b");
+}
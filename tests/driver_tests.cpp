@@ -0,0 +1,455 @@
+#include <catch2/catch.hpp>
+#include <driver/build.h>
+#include <driver/build_cache.h>
+#include <driver/file_watcher.h>
+#include <driver/hash.h>
+#include <driver/module_interface.h>
+#include <driver/workspace.h>
+#include <exception.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+
+namespace {
+	using namespace seam::driver;
+
+	/**
+	 * Temporary directory named after the running test, with a random
+	 * suffix so tests running in parallel never share one.
+	 */
+	std::filesystem::path unique_directory() {
+		auto name = Catch::getResultCapture().getCurrentTestName();
+		std::replace_if(name.begin(), name.end(), [](const unsigned char c) { return !std::isalnum(c); }, '_');
+		return std::filesystem::temp_directory_path() / ("seam_driver_tests_" + name + "_" + std::to_string(std::random_device()()));
+	}
+
+	/**
+	 * Project in a fresh temporary directory, removed afterwards.
+	 */
+	struct Project {
+		std::filesystem::path root = unique_directory();
+
+		Project() {
+			std::filesystem::remove_all(root);
+			std::filesystem::create_directories(root / "src");
+		}
+		~Project() { std::filesystem::remove_all(root); }
+
+		// sources are dated back, so their stamps can be trusted straight away
+		void write(const std::string& name, const std::string& text) const {
+			const auto path = root / "src" / name;
+			std::filesystem::create_directories(path.parent_path());
+			std::ofstream(path, std::ios::binary) << text;
+			std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
+		}
+
+		[[nodiscard]] BuildOptions options() const {
+			BuildOptions options;
+			options.inputs = { root / "src" };
+			options.output_directory = root / "build";
+			options.threads = 2;
+			return options;
+		}
+	};
+
+	BuildResult build(const BuildOptions& options) {
+		TimeReport report;
+		return seam::driver::build(options, report);
+	}
+
+	bool has_c_compiler() {
+#ifdef _WIN32
+		return false;
+#else
+		return std::system("cc --version > /dev/null 2>&1") == 0;
+#endif
+	}
+
+	const auto square = "fn square(x: i64) -> i64 { return x * x }\n";
+	const auto quad = "import math\nfn quad(x: i64) -> i64 { return square(square(x)) }\n";
+	const auto cube = "fn cube(x: i64) -> i64 {\n\treturn x * x * x\n}\n";
+}
+
+TEST_CASE("sha-256 digests") {
+	REQUIRE(sha256("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+	REQUIRE(sha256("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+	REQUIRE(sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")
+		== "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+	// fed in pieces that straddle blocks
+	Sha256 hasher;
+	const std::string piece(37, 'a');
+	for (size_t fed = 0; fed < 1000000; fed += piece.size()) {
+		hasher.update(std::string_view(piece).substr(0, std::min(piece.size(), 1000000 - fed)));
+	}
+	REQUIRE(hasher.hex() == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST_CASE("compiling a unit") {
+	TimeReport report;
+
+	SECTION("emits C") {
+		const auto result = compile("square.seam", square, CompileOptions { EmitKind::C }, report);
+		REQUIRE(result.diagnostics.empty());
+		REQUIRE(result.output->find("int64_t seam_6square(int64_t x_1)") != std::string::npos);
+	}
+
+	SECTION("emits an object") {
+		const auto result = compile("square.seam", square, CompileOptions {}, report);
+		REQUIRE(result.output->substr(0, 4) == "\x7f" "ELF");
+		REQUIRE(report.count("parse") == 1);
+		REQUIRE(report.count("optimise") == 1);
+		REQUIRE(report.count("emit") == 1);
+	}
+
+	SECTION("semantic errors are rendered with their line and column") {
+		const auto result = compile("bad.seam", "fn f() -> i64 {\n\treturn y\n}\n", CompileOptions {}, report);
+		REQUIRE_FALSE(result.output);
+		REQUIRE(result.diagnostics == std::vector<std::string> { "bad.seam:2:9: error: use of undeclared identifier 'y'" });
+	}
+
+	SECTION("parse errors stop the unit") {
+		const auto result = compile("bad.seam", "fn f( {", CompileOptions {}, report);
+		REQUIRE_FALSE(result.output);
+		REQUIRE(result.diagnostics.size() == 1);
+		REQUIRE(result.diagnostics[0].starts_with("bad.seam:1:"));
+	}
+
+	SECTION("invalid UTF-8 is rejected") {
+		const auto result = compile("bad.seam", "fn \xff() {}", CompileOptions {}, report);
+		REQUIRE(result.diagnostics == std::vector<std::string> { "bad.seam: error: source is not valid UTF-8" });
+	}
+}
+
+TEST_CASE("manifests round trip") {
+	const Project project;
+	const auto path = project.root / "manifest";
+
+	Manifest manifest;
+	manifest.set(ManifestEntry {
+		"build/with space.o", { 12, 34 }, "seamc 1 emit=.o -O1", "abc", "iface", { "math", "geometry.shapes" },
+		{ Dependency { "src/with space.seam", { 5, FileStamp::unknown_time }, "def" } },
+	});
+	manifest.save(path);
+
+	const auto loaded = Manifest::load(path);
+	REQUIRE(loaded.size() == 1);
+	const auto entry = loaded.find("build/with space.o");
+	REQUIRE(entry);
+	REQUIRE(entry->output_stamp == FileStamp { 12, 34 });
+	REQUIRE(entry->fingerprint == "seamc 1 emit=.o -O1");
+	REQUIRE(entry->key == "abc");
+	REQUIRE(entry->interface == "iface");
+	REQUIRE(entry->imports == std::vector<std::string> { "math", "geometry.shapes" });
+	REQUIRE(entry->dependencies.size() == 1);
+	REQUIRE(entry->dependencies[0].path == "src/with space.seam");
+	REQUIRE(entry->dependencies[0].stamp == FileStamp { 5, FileStamp::unknown_time });
+	REQUIRE(entry->dependencies[0].hash == "def");
+
+	std::ofstream(path) << "seamc manifest 2\nunit truncated";
+	REQUIRE(Manifest::load(path).size() == 0);
+}
+
+TEST_CASE("incremental builds") {
+	const Project project;
+	project.write("square.seam", square);
+	project.write("nested/cube.seam", cube);
+	const auto options = project.options();
+
+	auto result = build(options);
+	REQUIRE(result.compiled == 2);
+	REQUIRE(std::filesystem::exists(project.root / "build" / "square.o"));
+	REQUIRE(std::filesystem::exists(project.root / "build" / "nested" / "cube.o"));
+
+	SECTION("a no-op build only stats") {
+		TimeReport report;
+		result = seam::driver::build(options, report);
+		REQUIRE(result.unchanged == 2);
+		REQUIRE(report.count("hash") == 0);
+		REQUIRE(report.count("save") == 0);
+	}
+
+	SECTION("changed sources are compiled again") {
+		project.write("square.seam", "fn square(x: i64) -> i64 { return x * x + 0 }\n");
+		result = build(options);
+		REQUIRE(result.compiled == 1);
+		REQUIRE(result.unchanged == 1);
+	}
+
+	SECTION("touched sources are hashed, not compiled") {
+		project.write("square.seam", square);
+		result = build(options);
+		REQUIRE(result.rehashed == 1);
+		REQUIRE(result.unchanged == 1);
+		REQUIRE(build(options).unchanged == 2);
+	}
+
+	SECTION("reverted sources come from the cache") {
+		project.write("square.seam", "fn square(x: i64) -> i64 { return 0 }\n");
+		REQUIRE(build(options).compiled == 1);
+		project.write("square.seam", square);
+		result = build(options);
+		REQUIRE(result.restored == 1);
+		REQUIRE(result.compiled == 0);
+	}
+
+	SECTION("deleted outputs are restored") {
+		std::filesystem::remove(project.root / "build" / "square.o");
+		result = build(options);
+		REQUIRE(result.restored == 1);
+		REQUIRE(std::filesystem::exists(project.root / "build" / "square.o"));
+	}
+
+	SECTION("other options are another build") {
+		auto unoptimised = options;
+		unoptimised.compile.optimise = false;
+		REQUIRE(build(unoptimised).compiled == 2);
+		REQUIRE(build(options).restored == 2);
+	}
+
+	SECTION("caches can be shared") {
+		auto shared = options;
+		shared.cache_directory = project.root / "cache";
+		shared.output_directory = project.root / "one";
+		REQUIRE(build(shared).compiled == 2);
+
+		shared.output_directory = project.root / "other";
+		REQUIRE(build(shared).restored == 2);
+	}
+
+	SECTION("failed units are retried") {
+		project.write("square.seam", "fn square(x: i64) -> i64 { return y }\n");
+		result = build(options);
+		REQUIRE(result.failed == 1);
+		REQUIRE_FALSE(result.succeeded());
+		REQUIRE(result.diagnostics.size() == 1);
+		REQUIRE(result.diagnostics[0].ends_with("square.seam:1:35: error: use of undeclared identifier 'y'"));
+		REQUIRE(build(options).failed == 1);
+	}
+
+	SECTION("removed sources leave the manifest") {
+		std::filesystem::remove(project.root / "src" / "square.seam");
+		REQUIRE(build(options).unchanged == 1);
+		REQUIRE(Manifest::load(project.root / "build" / ".seamc" / "manifest").size() == 1);
+	}
+}
+
+TEST_CASE("freshly written sources are hashed next time") {
+	const Project project;
+	std::ofstream(project.root / "src" / "square.seam") << square;
+	const auto options = project.options();
+
+	REQUIRE(build(options).compiled == 1);
+	REQUIRE(build(options).rehashed == 1);
+}
+
+TEST_CASE("bad build inputs") {
+	const Project project;
+	auto options = project.options();
+
+	SECTION("missing inputs") {
+		options.inputs = { project.root / "missing.seam" };
+		REQUIRE_THROWS_AS(build(options), seam::DriverException);
+	}
+
+	SECTION("clashing outputs") {
+		project.write("square.seam", square);
+		options.inputs.push_back(project.root / "src" / "square.seam");
+		REQUIRE_THROWS_AS(build(options), seam::DriverException);
+	}
+}
+
+TEST_CASE("imported modules") {
+	const Project project;
+	project.write("math.seam", square);
+	project.write("app.seam", quad);
+	const auto options = project.options();
+
+	auto result = build(options);
+	REQUIRE(result.diagnostics.empty());
+	REQUIRE(result.compiled == 2);
+
+	SECTION("objects link together") {
+		if (!has_c_compiler()) {
+			WARN("no C compiler, skipping");
+			return;
+		}
+
+		const auto build_directory = project.root / "build";
+		std::ofstream(build_directory / "main.c") << "#include <stdio.h>\nlong quad(long);\nint main(void) { printf(\"%ld\\n\", quad(3)); return 0; }\n";
+		const auto executable = build_directory / "app";
+		const auto command = "cc -o " + executable.string() + " " + (build_directory / "main.c").string() + " "
+			+ (build_directory / "app.o").string() + " " + (build_directory / "math.o").string();
+		REQUIRE(std::system(command.c_str()) == 0);
+
+		auto* pipe = popen(executable.string().c_str(), "r");
+		REQUIRE(pipe != nullptr);
+		char line[16] = {};
+		REQUIRE(fgets(line, sizeof(line), pipe) != nullptr);
+		REQUIRE(pclose(pipe) == 0);
+		REQUIRE(std::string(line) == "81\n");
+	}
+
+	SECTION("changing a body leaves importers alone") {
+		project.write("math.seam", "fn square(y: i64) -> i64 { return y * y + 0 }\n");
+		result = build(options);
+		REQUIRE(result.compiled == 1);
+		REQUIRE(result.rehashed == 1);
+	}
+
+	SECTION("changing an interface compiles importers again") {
+		project.write("math.seam", std::string(square) + "fn half(x: i64) -> i64 { return x / 2 }\n");
+		result = build(options);
+		REQUIRE(result.compiled == 2);
+		REQUIRE(result.failed == 0);
+	}
+
+	SECTION("missing modules are diagnosed") {
+		project.write("app.seam", "import nope\nfn f() {}\n");
+		result = build(options);
+		REQUIRE(result.failed == 1);
+		REQUIRE(result.diagnostics.size() == 1);
+		REQUIRE(result.diagnostics[0].ends_with("error: no module named 'nope'"));
+	}
+
+	SECTION("importers of a broken module fail with it") {
+		project.write("math.seam", "fn square( {");
+		result = build(options);
+		REQUIRE(result.failed == 2);
+		REQUIRE(result.diagnostics.size() == 1);
+	}
+}
+
+TEST_CASE("interface files") {
+	const Project project;
+	project.write("math.seam", "type Int = i64\nfn square(x: Int) -> Int { return x * x }\nfn cube(x: Int) -> Int { return x * square(x) }\n");
+	project.write("app.seam", quad);
+	const auto options = project.options();
+	REQUIRE(build(options).compiled == 2);
+
+	const auto math = project.root / "build" / "math.smi";
+	const auto source = read_file(project.root / "src" / "math.seam");
+	TimeReport report;
+	const auto program = parse("math.seam", source, report).program;
+	const auto interface = ModuleInterface::of(*program);
+	const auto hash = interface.hash();
+
+	SECTION("round trip") {
+		const auto encoded = interface.encode();
+		REQUIRE(read_file(math) == encoded);
+
+		const auto decoded = ModuleInterface::decode(encoded, hash);
+		REQUIRE(decoded);
+		REQUIRE(decoded->hash() == hash);
+		REQUIRE(decoded->functions.size() == 2);
+		REQUIRE(decoded->functions[1].name == "cube");
+		REQUIRE(decoded->functions[1].params[0].name == "x");
+		REQUIRE(decoded->functions[1].params[0].type == "Int");
+		REQUIRE(decoded->aliases.size() == 1);
+		REQUIRE(decoded->aliases[0].type == "i64");
+
+		REQUIRE_FALSE(ModuleInterface::decode(encoded, ModuleInterface {}.hash()));
+		REQUIRE_FALSE(ModuleInterface::decode(encoded.substr(0, encoded.size() - 1), hash));
+		REQUIRE_FALSE(ModuleInterface::decode(encoded + '\0', hash));
+		REQUIRE_FALSE(ModuleInterface::load(project.root / "build" / "missing.smi", hash));
+	}
+
+	SECTION("importers map them instead of parsing") {
+		project.write("app.seam", std::string(quad) + "fn eight() -> i64 { return 8 }\n");
+		TimeReport rebuild;
+		REQUIRE(seam::driver::build(options, rebuild).compiled == 1);
+		REQUIRE(rebuild.count("parse") == 1);
+		REQUIRE(rebuild.count("interface") == 1);
+	}
+
+	SECTION("missing or stale interface files are parsed again") {
+		std::ofstream(math, std::ios::trunc) << "seamifc";
+		project.write("app.seam", std::string(quad) + "fn eight() -> i64 { return 8 }\n");
+		TimeReport rebuild;
+		REQUIRE(seam::driver::build(options, rebuild).compiled == 1);
+		REQUIRE(rebuild.count("parse") == 2);
+		REQUIRE(ModuleInterface::load(math, hash));
+	}
+}
+
+TEST_CASE("nested and mutual imports") {
+	const Project project;
+	project.write("geometry/shapes.seam", "import app\nfn area(x: i64) -> i64 { if (x == 0) { return 0 } return twice(x) }\n");
+	project.write("app.seam", "import geometry.shapes\nfn twice(x: i64) -> i64 { return x + area(0) + x }\n");
+
+	const auto result = build(project.options());
+	REQUIRE(result.diagnostics.empty());
+	REQUIRE(result.compiled == 2);
+}
+
+TEST_CASE("resident workspaces") {
+	const Project project;
+	project.write("math.seam", square);
+	project.write("app.seam", quad);
+	const auto options = project.options();
+	const auto math = project.root / "src" / "math.seam";
+
+	TimeReport report;
+	Workspace workspace(options);
+	REQUIRE(workspace.load(report).compiled == 2);
+	REQUIRE(workspace.size() == 2);
+	REQUIRE(workspace.directories() == std::vector<std::filesystem::path> { project.root / "src" });
+
+	SECTION("a changed body compiles one module") {
+		project.write("math.seam", "fn square(y: i64) -> i64 { return y * y + 0 }\n");
+		const auto result = workspace.update({ math }, report);
+		REQUIRE(result.compiled == 1);
+		REQUIRE(result.diagnostics.empty());
+	}
+
+	SECTION("a changed interface compiles its importers") {
+		project.write("math.seam", std::string(square) + "fn half(x: i64) -> i64 { return x / 2 }\n");
+		const auto result = workspace.update({ math }, report);
+		REQUIRE(result.compiled == 2);
+		REQUIRE(result.failed == 0);
+	}
+
+	SECTION("untouched files are skipped") {
+		REQUIRE(workspace.update({ math }, report).unchanged == 1);
+	}
+
+	SECTION("added and deleted modules") {
+		project.write("extra.seam", "import math\nfn eight() -> i64 { return square(2) * 2 }\n");
+		auto result = workspace.update({ project.root / "src" / "extra.seam" }, report);
+		REQUIRE(result.compiled == 1);
+		REQUIRE(workspace.size() == 3);
+
+		std::filesystem::remove(math);
+		result = workspace.update({ math }, report);
+		REQUIRE(workspace.size() == 2);
+		REQUIRE(result.failed == 2);
+		REQUIRE(result.diagnostics.size() == 2);
+	}
+
+	// whatever the workspace did, a build afterwards agrees with it
+	const auto result = build(options);
+	REQUIRE(result.compiled == 0);
+	REQUIRE(result.restored == 0);
+}
+
+#ifdef __linux__
+TEST_CASE("watching files") {
+	const Project project;
+	FileWatcher watcher({ project.root / "src" });
+
+	REQUIRE(watcher.wait(std::chrono::milliseconds(0)).empty());
+
+	project.write("square.seam", square);
+	REQUIRE(watcher.wait(std::chrono::milliseconds(1000)) == std::vector<std::filesystem::path> { project.root / "src" / "square.seam" });
+
+	std::filesystem::create_directories(project.root / "src" / "nested");
+	REQUIRE(watcher.wait(std::chrono::milliseconds(1000)) == std::vector<std::filesystem::path> { project.root / "src" / "nested" });
+
+	// the new directory is watched as well
+	project.write("nested/cube.seam", cube);
+	REQUIRE(watcher.wait(std::chrono::milliseconds(1000)) == std::vector<std::filesystem::path> { project.root / "src" / "nested" / "cube.seam" });
+}
+#endif
@@ -0,0 +1,250 @@
+#include <catch2/catch.hpp>
+#include <ir/analysis.h>
+#include <ir/interpreter.h>
+#include <ir/lowering.h>
+#include <ir/passes.h>
+#include <parser/parser.h>
+#include <semantic/name_resolver.h>
+#include <semantic/type_checker.h>
+
+namespace {
+	seam::ir::Module lower(const std::string& raw_source) {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+		const auto program = parser.parse();
+
+		seam::semantic::Context context;
+		seam::semantic::NameResolver resolver(context);
+		program->accept(resolver);
+		seam::semantic::TypeChecker checker(context, 1);
+		program->accept(checker);
+		REQUIRE_FALSE(context.has_errors());
+
+		seam::ir::AstLowering lowering(context);
+		return lowering.lower(*program);
+	}
+
+	int64_t run(const seam::ir::Module& module, const std::string& name, const std::vector<int64_t>& arguments) {
+		std::vector<seam::ir::Value> values;
+		for (const auto argument : arguments) {
+			values.push_back(seam::ir::Value { argument });
+		}
+
+		seam::ir::Interpreter interpreter(module);
+		return interpreter.call(*module.find(name), values).i64;
+	}
+
+	void require_valid(const seam::ir::Module& module) {
+		for (const auto& function : module.functions) {
+			REQUIRE(seam::ir::verify(function) == "");
+		}
+	}
+
+	size_t count(const seam::ir::Function& function, const seam::ir::Opcode op) {
+		size_t result = 0;
+		for (const auto& block : function.blocks) {
+			for (const auto value : block.instructions) {
+				result += function.values[value].op == op;
+			}
+		}
+		return result;
+	}
+
+	const auto program = R"(
+		fn square(x: i64) -> i64 {
+			return x * x
+		}
+
+		fn clamp(x: i64, limit: i64) -> i64 {
+			if (x == limit) {
+				return 0
+			}
+			return x
+		}
+
+		fn sum(n: i64, a: i64, b: i64) -> i64 {
+			let total := 0
+			let i := 0
+			while (i == n == false) {
+				let unused := i * 7
+				total += a * b + a * b + square(i) + clamp(i, 3)
+				i++
+			}
+			return total
+		}
+
+		fn fib(n: i64) -> i64 {
+			if (n == 0) {
+				return 0
+			}
+			if (n == 1) {
+				return 1
+			}
+			return fib(n - 1) + fib(n - 2)
+		}
+	)";
+}
+
+TEST_CASE("interpreting lowered programs") {
+	const auto module = lower(program);
+
+	REQUIRE(run(module, "fib", { 15 }) == 610);
+	// 10 * 2 * 3 * 2 + squares of 0..9 + 0..9 with 3 clamped to 0
+	REQUIRE(run(module, "sum", { 10, 2, 3 }) == 120 + 285 + 42);
+
+	const auto divide = lower("fn divide(a: i64, b: i64) -> i64 { return a / b }");
+	REQUIRE(run(divide, "divide", { 7, 2 }) == 3);
+	REQUIRE_THROWS_AS(run(divide, "divide", { 7, 0 }), seam::RuntimeException);
+}
+
+TEST_CASE("a reused interpreter recovers its depth after traps") {
+	const auto module = lower(R"(
+		fn divide(a: i64, b: i64) -> i64 { return a / b }
+		fn nest(n: i64, b: i64) -> i64 {
+			if (n == 0) {
+				return divide(1, b)
+			}
+			return nest(n - 1, b)
+		}
+	)");
+	seam::ir::Interpreter interpreter(module, 16);
+	const auto nest = *module.find("nest");
+
+	// each trap unwinds ten frames, leaking them would hit the limit on the second
+	for (auto i = 0; i < 4; i++) {
+		REQUIRE_THROWS_WITH(interpreter.call(nest, { { 10 }, { 0 } }), "integer division by zero");
+	}
+	REQUIRE_THROWS_WITH(interpreter.call(nest, { { 20 }, { 1 } }), "call depth limit exceeded");
+	REQUIRE(interpreter.call(nest, { { 10 }, { 1 } }).i64 == 1);
+}
+
+TEST_CASE("finding dominators and loops") {
+	const auto module = lower(program);
+	const auto& sum = module.functions[*module.find("sum")];
+
+	const seam::ir::DominatorTree dominators(sum);
+	const auto loops = seam::ir::find_loops(sum, dominators);
+
+	REQUIRE(loops.size() == 1);
+	REQUIRE(dominators.dominates(0, loops[0].header));
+	for (const auto block : loops[0].blocks) {
+		REQUIRE(dominators.dominates(loops[0].header, block));
+	}
+}
+
+TEST_CASE("dead code elimination removes unused values") {
+	auto module = lower(program);
+	auto& sum = module.functions[*module.find("sum")];
+	const auto before = count(sum, seam::ir::Opcode::Mul);
+
+	seam::ir::DeadCodeElimination pass;
+	REQUIRE(pass.run(module));
+	REQUIRE_FALSE(pass.run(module));
+
+	require_valid(module);
+	REQUIRE(count(sum, seam::ir::Opcode::Mul) == before - 1);
+	REQUIRE(run(module, "sum", { 10, 2, 3 }) == 447);
+}
+
+TEST_CASE("dead code elimination keeps divisions that may trap") {
+	auto module = lower(R"(
+		fn f(a: i64, b: i64) -> i64 {
+			let x := a / b
+			let y := a / 2
+			return 1
+		}
+	)");
+	REQUIRE_THROWS_AS(run(module, "f", { 1, 0 }), seam::RuntimeException);
+
+	auto manager = seam::ir::PassManager::standard_pipeline();
+	manager.run(module);
+	require_valid(module);
+
+	// dividing by a nonzero constant cannot trap and goes
+	REQUIRE(count(module.functions[*module.find("f")], seam::ir::Opcode::Div) == 1);
+	REQUIRE_THROWS_AS(run(module, "f", { 1, 0 }), seam::RuntimeException);
+	REQUIRE(run(module, "f", { 1, 3 }) == 1);
+}
+
+TEST_CASE("value numbering removes redundant computations") {
+	auto module = lower(program);
+	auto& sum = module.functions[*module.find("sum")];
+	const auto before = count(sum, seam::ir::Opcode::Mul);
+
+	seam::ir::ValueNumbering pass;
+	REQUIRE(pass.run(module));
+
+	require_valid(module);
+	REQUIRE(count(sum, seam::ir::Opcode::Mul) == before - 1);
+	REQUIRE(run(module, "sum", { 10, 2, 3 }) == 447);
+}
+
+TEST_CASE("loop invariant code motion hoists out of loops") {
+	auto module = lower(program);
+	const auto id = *module.find("sum");
+
+	seam::ir::LoopInvariantCodeMotion pass;
+	REQUIRE(pass.run(module));
+	require_valid(module);
+
+	// a * b moved to the block entering the loop
+	const auto& sum = module.functions[id];
+	const seam::ir::DominatorTree dominators(sum);
+	const auto loops = seam::ir::find_loops(sum, dominators);
+	for (const auto block : loops[0].blocks) {
+		for (const auto value : sum.blocks[block].instructions) {
+			const auto& instruction = sum.values[value];
+			REQUIRE_FALSE((instruction.op == seam::ir::Opcode::Mul && instruction.operands[0] == 1));
+		}
+	}
+
+	REQUIRE(run(module, "sum", { 10, 2, 3 }) == 447);
+}
+
+TEST_CASE("inlining small functions") {
+	auto module = lower(program);
+	const auto id = *module.find("sum");
+
+	seam::ir::Inliner pass;
+	REQUIRE(pass.run(module));
+	require_valid(module);
+
+	REQUIRE(count(module.functions[id], seam::ir::Opcode::Call) == 0);
+	// recursive functions are left alone
+	REQUIRE(count(module.functions[*module.find("fib")], seam::ir::Opcode::Call) == 2);
+
+	REQUIRE(run(module, "sum", { 10, 2, 3 }) == 447);
+	REQUIRE(run(module, "fib", { 15 }) == 610);
+
+	SECTION("budget keeps larger functions") {
+		auto small = lower(program);
+		seam::ir::Inliner tight(4);
+		tight.run(small);
+		REQUIRE(count(small.functions[id], seam::ir::Opcode::Call) == 1);
+	}
+}
+
+TEST_CASE("standard pipeline preserves behaviour and records statistics") {
+	auto module = lower(program);
+
+	auto unoptimised = lower(program);
+	seam::ir::Interpreter baseline(unoptimised);
+	baseline.call(*unoptimised.find("sum"), { { 100 }, { 2 }, { 3 } });
+
+	auto manager = seam::ir::PassManager::standard_pipeline();
+	REQUIRE(manager.run(module));
+	manager.run(module);
+	require_valid(module);
+
+	seam::ir::Interpreter optimised(module);
+	REQUIRE(optimised.call(*module.find("sum"), { { 100 }, { 2 }, { 3 } }).i64
+		== baseline.call(*unoptimised.find("sum"), { { 100 }, { 2 }, { 3 } }).i64);
+	REQUIRE(optimised.executed() < baseline.executed() / 2);
+
+	const auto& statistics = manager.statistics();
+	REQUIRE(statistics.size() == 4);
+	REQUIRE(statistics[0].name == "inline");
+	REQUIRE(statistics[0].runs == 2);
+	REQUIRE(statistics[0].changes >= 1);
+	REQUIRE(manager.report().find("licm") != std::string::npos);
+}
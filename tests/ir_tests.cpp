@@ -0,0 +1,223 @@
+#include <catch2/catch.hpp>
+#include <ir/interpreter.h>
+#include <ir/lowering.h>
+#include <parser/parser.h>
+#include <semantic/name_resolver.h>
+#include <semantic/type_checker.h>
+
+namespace {
+	seam::ir::Module lower(const std::string& raw_source) {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+		const auto program = parser.parse();
+
+		seam::semantic::Context context;
+		seam::semantic::NameResolver resolver(context);
+		program->accept(resolver);
+		seam::semantic::TypeChecker checker(context, 1);
+		program->accept(checker);
+		REQUIRE_FALSE(context.has_errors());
+
+		seam::ir::AstLowering lowering(context);
+		return lowering.lower(*program);
+	}
+
+	// every block is terminated and every phi has one operand per predecessor
+	void require_well_formed(const seam::ir::Function& function) {
+		for (const auto& block : function.blocks) {
+			REQUIRE(block.terminator.kind != seam::ir::TerminatorKind::None);
+
+			for (size_t i = 0; i < block.instructions.size(); i++) {
+				const auto& value = function.values[block.instructions[i]];
+				REQUIRE((value.op == seam::ir::Opcode::Phi) == (i < block.phi_count));
+				if (value.op == seam::ir::Opcode::Phi) {
+					REQUIRE(value.operands.size() == block.predecessors.size());
+				}
+				REQUIRE(value.op != seam::ir::Opcode::Removed);
+			}
+		}
+	}
+}
+
+TEST_CASE("lowering straight line code") {
+	const auto module = lower(R"(
+		fn add(a: i64, b: i64) -> i64 {
+			let c := a + b * 2
+			return c
+		}
+	)");
+
+	REQUIRE(seam::ir::print(module) ==
+		"fn add(i64, i64) -> i64 {\n"
+		"b0:\n"
+		"\t%0: i64 = param 0\n"
+		"\t%1: i64 = param 1\n"
+		"\t%2: i64 = const 2\n"
+		"\t%3: i64 = mul %1, %2\n"
+		"\t%4: i64 = add %0, %3\n"
+		"\treturn %4\n"
+		"}\n");
+}
+
+TEST_CASE("lowering branches places phis at joins") {
+	const auto module = lower(R"(
+		fn select(a: i64, flag: bool) -> i64 {
+			let x := a
+			if (flag) {
+				x = x + 1
+			} else {
+				let unused := 3
+			}
+			return x
+		}
+
+		fn early(a: i64) -> i64 {
+			if (a == 0) {
+				return 1
+			} else {
+				return 2
+			}
+		}
+	)");
+
+	REQUIRE(seam::ir::print(module) ==
+		"fn select(i64, bool) -> i64 {\n"
+		"b0:\n"
+		"\t%0: i64 = param 0\n"
+		"\t%1: bool = param 1\n"
+		"\tbranch %1, b1, b2\n"
+		"b1:\n"
+		"\t%2: i64 = const 1\n"
+		"\t%3: i64 = add %0, %2\n"
+		"\tjump b3\n"
+		"b2:\n"
+		"\t%4: i64 = const 3\n"
+		"\tjump b3\n"
+		"b3:\n"
+		"\t%5: i64 = phi [b1 %3] [b2 %0]\n"
+		"\treturn %5\n"
+		"}\n"
+		"fn early(i64) -> i64 {\n"
+		"b0:\n"
+		"\t%0: i64 = param 0\n"
+		"\t%1: i64 = const 0\n"
+		"\t%2: bool = eq %0, %1\n"
+		"\tbranch %2, b1, b2\n"
+		"b1:\n"
+		"\t%3: i64 = const 1\n"
+		"\treturn %3\n"
+		"b2:\n"
+		"\t%4: i64 = const 2\n"
+		"\treturn %4\n"
+		"}\n");
+}
+
+TEST_CASE("lowering elseif chains joins every branch") {
+	const auto module = lower(R"(
+		fn pick(a: i64) -> i64 {
+			let b := 100
+			if (a == 0) {
+				b = 10
+			} elseif (a == 1) {
+				return 11
+			} elseif (a == 2) {
+				b = b + 12
+			} else {
+				b = 13
+			}
+			return b
+		}
+
+		fn open(a: i64) -> i64 {
+			let b := 0
+			if (a == 0) {
+				b = 1
+			} elseif (a == 1) {
+				b = 2
+			}
+			return b
+		}
+	)");
+	for (const auto& function : module.functions) {
+		require_well_formed(function);
+	}
+
+	seam::ir::Interpreter interpreter(module);
+	const auto pick = *module.find("pick");
+	const auto open = *module.find("open");
+	REQUIRE(interpreter.call(pick, { { 0 } }).i64 == 10);
+	REQUIRE(interpreter.call(pick, { { 1 } }).i64 == 11);
+	REQUIRE(interpreter.call(pick, { { 2 } }).i64 == 112);
+	REQUIRE(interpreter.call(pick, { { 3 } }).i64 == 13);
+	REQUIRE(interpreter.call(open, { { 1 } }).i64 == 2);
+	REQUIRE(interpreter.call(open, { { 5 } }).i64 == 0);
+}
+
+TEST_CASE("lowering loops only keeps phis for variables that change") {
+	const auto module = lower(R"(
+		fn sum(n: i64) -> i64 {
+			let total := 0
+			let i := 0
+			let step := 2
+			while (i == n && true == false) {
+				total += i * step
+				i++
+			}
+			return total
+		}
+	)");
+
+	const auto& function = module.functions[0];
+	require_well_formed(function);
+
+	// total and i get phis in the loop header, step does not
+	const auto& header = function.blocks[1];
+	REQUIRE(header.predecessors.size() == 2);
+	REQUIRE(header.phi_count == 2);
+
+	size_t phis = 0;
+	for (const auto& block : function.blocks) {
+		phis += block.phi_count;
+	}
+	// plus the phi merging the short-circuited condition
+	REQUIRE(phis == 3);
+}
+
+TEST_CASE("lowering nested loops and calls is well formed") {
+	const auto module = lower(R"(
+		fn fib(n: i64) -> i64 {
+			if (n == 0 && true) {
+				return 0
+			}
+			let a := 0
+			let b := 1
+			let i := 1
+			while (i == n == false) {
+				let j := 0
+				while (j == 1 == false) {
+					let c := a + b
+					a = b
+					b = c
+					j++
+				}
+				i++
+			}
+			return b + fib(0)
+		}
+
+		fn scale(x: f64) -> f64 {
+			let y: f64 = 2
+			return -x * y
+		}
+	)");
+
+	for (const auto& function : module.functions) {
+		require_well_formed(function);
+	}
+
+	const auto& scale = module.functions[1];
+	REQUIRE(scale.result == seam::ir::Type::F64);
+	REQUIRE(scale.values[1].op == seam::ir::Opcode::Const);
+	REQUIRE(scale.values[1].type == seam::ir::Type::F64);
+	REQUIRE(scale.values[1].immediate.f64 == 2.0);
+}
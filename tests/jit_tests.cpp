@@ -0,0 +1,235 @@
+#include <catch2/catch.hpp>
+#include <backend/x86_64/assembler.h>
+#include <backend/x86_64/code_generator.h>
+#include <ir/lowering.h>
+#include <jit/executable_memory.h>
+#include <jit/tiered_executor.h>
+#include <parser/parser.h>
+#include <semantic/name_resolver.h>
+#include <semantic/type_checker.h>
+
+namespace {
+	seam::ir::Module lower(const std::string& raw_source) {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+		const auto program = parser.parse();
+
+		seam::semantic::Context context;
+		seam::semantic::NameResolver resolver(context);
+		program->accept(resolver);
+		seam::semantic::TypeChecker checker(context, 1);
+		program->accept(checker);
+		REQUIRE_FALSE(context.has_errors());
+
+		seam::ir::AstLowering lowering(context);
+		return lowering.lower(*program);
+	}
+
+	const auto program = R"(
+		fn fib(n: i64) -> i64 {
+			if (n == 0) {
+				return 0
+			}
+			if (n == 1) {
+				return 1
+			}
+			return fib(n - 1) + fib(n - 2)
+		}
+
+		fn count(n: i64) -> i64 {
+			let total := 0
+			let i := 0
+			while (i == n == false) {
+				total += i * 2
+				i++
+			}
+			return total
+		}
+
+		fn average(a: f64, n: i64, b: f64) -> f64 {
+			if (n == 0) {
+				return a
+			}
+			return (a + b) / 2
+		}
+
+		fn many(a: i64, b: i64, c: i64, d: i64, e: i64, f: i64, g: i64) -> i64 {
+			return a + g
+		}
+	)";
+
+#if defined(__x86_64__) && !defined(_WIN32)
+	constexpr auto native = true;
+#else
+	constexpr auto native = false;
+#endif
+}
+
+TEST_CASE("executable memory runs copied code") {
+	if (!native) return;
+
+	seam::backend::x86_64::Assembler assembler;
+	assembler.mov(seam::backend::x86_64::Register::Rax, static_cast<int64_t>(42));
+	assembler.ret();
+
+	const seam::jit::ExecutableMemory memory(assembler.finish());
+	const auto entry = reinterpret_cast<int64_t(*)()>(memory.address(0));
+	REQUIRE(entry() == 42);
+}
+
+TEST_CASE("hot functions are promoted to native code") {
+	const auto module = lower(program);
+	const auto fib = *module.find("fib");
+
+	seam::jit::TieredExecutor executor(module, 50);
+
+	REQUIRE(executor.call(fib, { { 1 } }).i64 == 1);
+	REQUIRE_FALSE(executor.is_compiled(fib));
+
+	// the recursion crosses the threshold partway through
+	REQUIRE(executor.call(fib, { { 20 } }).i64 == 6765);
+	REQUIRE(executor.is_compiled(fib) == native);
+	REQUIRE(executor.call(fib, { { 25 } }).i64 == 75025);
+
+	if (native) {
+		// once compiled, fib is not interpreted again
+		const auto calls = executor.interpreter().profile(fib).calls;
+		REQUIRE(calls < 60);
+		REQUIRE(executor.compilations() == 1);
+	}
+}
+
+TEST_CASE("loops count towards promotion") {
+	const auto module = lower(program);
+	const auto count = *module.find("count");
+
+	seam::jit::TieredExecutor executor(module, 100);
+
+	REQUIRE(executor.call(count, { { 10 } }).i64 == 90);
+	REQUIRE_FALSE(executor.is_compiled(count));
+
+	// a single long loop is enough, the next call runs natively
+	REQUIRE(executor.call(count, { { 200 } }).i64 == 39800);
+	REQUIRE(executor.call(count, { { 1000 } }).i64 == 999000);
+	REQUIRE(executor.is_compiled(count) == native);
+}
+
+TEST_CASE("native calls pass mixed arguments") {
+	const auto module = lower(program);
+	const auto average = *module.find("average");
+
+	seam::jit::TieredExecutor executor(module, 1);
+	REQUIRE(executor.call(average, { { .f64 = 1.5 }, { 4 }, { .f64 = 2.5 } }).f64 == 2.0);
+	REQUIRE(executor.call(average, { { .f64 = 1.5 }, { 4 }, { .f64 = 2.5 } }).f64 == 2.0);
+	REQUIRE(executor.call(average, { { .f64 = 1.5 }, { 0 }, { .f64 = 2.5 } }).f64 == 1.5);
+	REQUIRE(executor.is_compiled(average) == native);
+}
+
+TEST_CASE("functions the backend rejects stay interpreted") {
+	const auto module = lower(program);
+	const auto many = *module.find("many");
+
+	seam::jit::TieredExecutor executor(module, 0);
+	REQUIRE(executor.call(many, { { 1 }, { 2 }, { 3 }, { 4 }, { 5 }, { 6 }, { 7 } }).i64 == 8);
+	REQUIRE_FALSE(executor.is_compiled(many));
+	REQUIRE(executor.compilations() == 0);
+}
+
+TEST_CASE("division by zero raises the same error in every tier") {
+	const auto module = lower(R"(
+		fn divide(a: i64, b: i64) -> i64 {
+			return a / b
+		}
+
+		fn halve(a: i64) -> i64 {
+			return a / 2
+		}
+
+		fn ratio(a: i64, b: i64) -> i64 {
+			return halve(a) + divide(a, b)
+		}
+	)");
+	const auto divide = *module.find("divide");
+	const auto halve = *module.find("halve");
+	const auto ratio = *module.find("ratio");
+
+	seam::jit::TieredExecutor executor(module, 1);
+	for (auto i = 0; i < 3; i++) {
+		REQUIRE(executor.call(ratio, { { 12 }, { 4 } }).i64 == 9);
+	}
+	REQUIRE_THROWS_AS(executor.call(ratio, { { 12 }, { 0 } }), seam::RuntimeException);
+	REQUIRE_THROWS_AS(executor.call(divide, { { 12 }, { 0 } }), seam::RuntimeException);
+
+	// dividing by a constant cannot trap, so only that function is promoted
+	REQUIRE(executor.is_compiled(halve) == native);
+	REQUIRE_FALSE(executor.is_compiled(divide));
+	REQUIRE_FALSE(executor.is_compiled(ratio));
+}
+
+TEST_CASE("compiled callees are called rather than compiled again") {
+	const auto module = lower(R"(
+		fn twice(x: i64) -> i64 {
+			return x * 2
+		}
+
+		fn quad(x: i64) -> i64 {
+			return twice(twice(x))
+		}
+	)");
+	const auto twice = *module.find("twice");
+	const auto quad = *module.find("quad");
+
+	if (native) {
+		const seam::jit::ExecutableMemory memory(seam::backend::x86_64::CodeGenerator().generate(module, { twice }).text);
+		std::vector<const void*> entries(module.functions.size(), nullptr);
+		entries[twice] = memory.address(0);
+
+		// only quad is generated, and it calls the loaded twice
+		const auto object = seam::backend::x86_64::CodeGenerator().generate(module, { quad }, entries);
+		REQUIRE(object.symbols.size() == 1);
+		REQUIRE(object.symbols.front().name == "quad");
+		REQUIRE(object.relocations.empty());
+
+		const seam::jit::ExecutableMemory code(object.text);
+		REQUIRE(reinterpret_cast<int64_t(*)(int64_t)>(code.address(0))(5) == 20);
+	}
+
+	seam::jit::TieredExecutor executor(module, 1);
+	for (auto i = 0; i < 3; i++) {
+		REQUIRE(executor.call(twice, { { 3 } }).i64 == 6);
+	}
+	for (auto i = 0; i < 3; i++) {
+		REQUIRE(executor.call(quad, { { 3 } }).i64 == 12);
+	}
+	REQUIRE(executor.is_compiled(quad) == native);
+	REQUIRE(executor.compilations() == (native ? 2 : 0));
+}
+
+TEST_CASE("unbounded recursion raises the depth limit in every tier") {
+	const auto module = lower(R"(
+		fn forever(n: i64) -> i64 {
+			return forever(n + 1)
+		}
+
+		fn down(n: i64) -> i64 {
+			if (n == 0) {
+				return 0
+			}
+			return down(n - 1) + 1
+		}
+	)");
+	const auto forever = *module.find("forever");
+	const auto down = *module.find("down");
+
+	// promoted well before the interpreter's depth limit, native code runs out of stack first
+	seam::jit::TieredExecutor executor(module, 100);
+	for (auto i = 0; i < 2; i++) {
+		REQUIRE_THROWS_WITH(executor.call(forever, { { 0 } }), "call depth limit exceeded");
+	}
+	REQUIRE(executor.is_compiled(forever) == native);
+
+	// deep recursion within the limit still finishes, natively or not
+	REQUIRE(executor.call(down, { { 9000 } }).i64 == 9000);
+	REQUIRE(executor.call(down, { { 9000 } }).i64 == 9000);
+	REQUIRE(executor.is_compiled(down) == native);
+}
@@ -0,0 +1,50 @@
+#include <catch2/catch.hpp>
+#include <parser/literal_decoder.h>
+#include <parser/parser.h>
+
+TEST_CASE("decoding integer literals", "[LiteralDecoder]") {
+	SECTION("decimal") {
+		const auto decoded = seam::decode_number_literal("1234567890");
+		REQUIRE(decoded.type == seam::type::BuiltIn::i64);
+		REQUIRE(decoded.value.i64 == 1234567890);
+	}
+
+	SECTION("hex") {
+		const auto decoded = seam::decode_number_literal("0xDEADbeef");
+		REQUIRE(decoded.type == seam::type::BuiltIn::i64);
+		REQUIRE(decoded.value.i64 == 0xDEADBEEF);
+	}
+
+	SECTION("largest i64") {
+		REQUIRE(seam::decode_number_literal("9223372036854775807").value.i64 == 9223372036854775807);
+		REQUIRE(seam::decode_number_literal("0x7FFFFFFFFFFFFFFF").value.i64 == 9223372036854775807);
+	}
+
+	SECTION("overflow") {
+		REQUIRE(seam::decode_number_literal("9223372036854775808").error == seam::DiagnosticCode::IntegerLiteralOverflow);
+		REQUIRE(seam::decode_number_literal("0x8000000000000000").error == seam::DiagnosticCode::IntegerLiteralOverflow);
+		REQUIRE(seam::decode_number_literal("99999999999999999999999").error == seam::DiagnosticCode::IntegerLiteralOverflow);
+	}
+}
+
+TEST_CASE("decoding floating point literals", "[LiteralDecoder]") {
+	REQUIRE(seam::decode_number_literal("123.234").value.f64 == 123.234);
+	REQUIRE(seam::decode_number_literal(".32").value.f64 == .32);
+	REQUIRE(seam::decode_number_literal("0.89").type == seam::type::BuiltIn::f64);
+	REQUIRE(seam::decode_number_literal("1.").value.f64 == 1.0);
+
+	std::string long_literal = "0.";
+	long_literal.append(300, '1');
+	REQUIRE(seam::decode_number_literal(long_literal).type == seam::type::BuiltIn::f64);
+
+	std::string huge_literal(400, '9');
+	huge_literal += ".0";
+	REQUIRE(seam::decode_number_literal(huge_literal).error == seam::DiagnosticCode::FloatLiteralOverflow);
+}
+
+TEST_CASE("parser reports literal overflow") {
+	const auto source = std::make_unique<seam::Source>(R"(fn main() { let x := 9223372036854775808 })");
+	seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+
+	REQUIRE_THROWS_WITH(parser.parse(), "integer literal 9223372036854775808 does not fit in i64");
+}
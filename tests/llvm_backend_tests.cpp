@@ -0,0 +1,114 @@
+#include <catch2/catch.hpp>
+#include <backend/llvm_backend.h>
+#include <ir/interpreter.h>
+#include <ir/lowering.h>
+#include <parser/parser.h>
+#include <semantic/name_resolver.h>
+#include <semantic/type_checker.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+	seam::ir::Module lower(const std::string& raw_source) {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+		const auto program = parser.parse();
+
+		seam::semantic::Context context;
+		seam::semantic::NameResolver resolver(context);
+		program->accept(resolver);
+		seam::semantic::TypeChecker checker(context, 1);
+		program->accept(checker);
+		REQUIRE_FALSE(context.has_errors());
+
+		seam::ir::AstLowering lowering(context);
+		return lowering.lower(*program);
+	}
+
+	const auto program = R"(
+		fn square(x: i64) -> i64 {
+			return x * x
+		}
+
+		fn sum(n: i64) -> i64 {
+			let total := 0
+			let i := 0
+			while (i == n == false) {
+				total += square(i) / 3
+				i++
+			}
+			return total
+		}
+
+		fn divide(a: i64, b: i64) -> i64 {
+			return a / b
+		}
+
+		fn scale(x: f64, y: f64) -> f64 {
+			return -(x * y) + x / y
+		}
+	)";
+
+	std::vector<std::string> run_native(const std::vector<uint8_t>& object) {
+		const auto directory = std::filesystem::temp_directory_path() / "seam_llvm_backend_tests";
+		std::filesystem::create_directories(directory);
+
+		std::ofstream(directory / "program.o", std::ios::binary).write(reinterpret_cast<const char*>(object.data()), static_cast<std::streamsize>(object.size()));
+		std::ofstream(directory / "driver.c") << "#include <stdint.h>\n#include <stdio.h>\n"
+			"int64_t sum(int64_t); int64_t divide(int64_t, int64_t); double scale(double, double);\n"
+			"int main(void) {\n"
+			"\tprintf(\"%lld\\n%lld\\n%lld\\n%.17g\\n\", (long long) sum(1000), (long long) divide(-7, 2), (long long) divide(INT64_MIN, -1), scale(1.5, 4.0));\n"
+			"\treturn 0;\n}\n";
+
+		const auto executable = directory / "program";
+		const auto command = "cc -o " + executable.string() + " " + (directory / "driver.c").string() + " " + (directory / "program.o").string();
+		REQUIRE(std::system(command.c_str()) == 0);
+
+		std::vector<std::string> lines;
+		auto* pipe = popen(executable.string().c_str(), "r");
+		REQUIRE(pipe != nullptr);
+		char line[64];
+		while (fgets(line, sizeof(line), pipe) != nullptr) {
+			lines.emplace_back(line, strcspn(line, "\n"));
+		}
+		REQUIRE(pclose(pipe) == 0);
+
+		std::filesystem::remove_all(directory);
+		return lines;
+	}
+}
+
+TEST_CASE("LLVM optimisation levels") {
+	const auto module = lower(program);
+
+	const auto unoptimised = seam::backend::LlvmBackend(0).emit_ir(module);
+	REQUIRE(unoptimised.find("call i64 @square") != std::string::npos);
+
+	// the O2 pipeline inlines the helper into the loop
+	const auto optimised = seam::backend::LlvmBackend(2).emit_ir(module);
+	REQUIRE(optimised.find("define i64 @sum") != std::string::npos);
+	REQUIRE(optimised.find("call i64 @square") == std::string::npos);
+}
+
+TEST_CASE("LLVM objects match the interpreter") {
+	if (std::system("cc --version > /dev/null 2>&1") != 0) {
+		WARN("no C compiler to link with, skipping");
+		return;
+	}
+
+	const auto module = lower(program);
+	const auto lines = run_native(seam::backend::LlvmBackend(2).emit_object(module));
+	REQUIRE(lines.size() == 4);
+
+	seam::ir::Interpreter interpreter(module);
+	REQUIRE(lines[0] == std::to_string(interpreter.call(*module.find("sum"), { { 1000 } }).i64));
+	REQUIRE(lines[1] == std::to_string(interpreter.call(*module.find("divide"), { { -7 }, { 2 } }).i64));
+	REQUIRE(lines[2] == std::to_string(interpreter.call(*module.find("divide"), { { INT64_MIN }, { -1 } }).i64));
+
+	const auto scaled = interpreter.call(*module.find("scale"), { { .f64 = 1.5 }, { .f64 = 4.0 } }).f64;
+	REQUIRE(std::stod(lines[3]) == scaled);
+}
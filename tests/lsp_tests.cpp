@@ -0,0 +1,309 @@
+#include <catch2/catch.hpp>
+#include <exception.h>
+#include <lsp/server.h>
+
+#include <random>
+#include <sstream>
+
+namespace {
+	std::string generate_module(const int functions) {
+		std::string source;
+		for (auto i = 0; i < functions; i++) {
+			source += "fn f" + std::to_string(i) + "(a: i64) -> i64 {\n";
+			source += "\t// step " + std::to_string(i) + "\n";
+			source += "\tlet x := a * 2 + " + std::to_string(i) + "\n";
+			source += "\tif (x == a) { return " + (i ? "f" + std::to_string(i - 1) + "(x)" : "x") + " }\n";
+			source += "\treturn x\n}\n";
+		}
+		return source;
+	}
+
+	std::vector<std::string> render(seam::lsp::Document& document) {
+		std::vector<std::string> rendered;
+		for (const auto& diagnostic : document.diagnostics()) {
+			rendered.push_back(std::to_string(diagnostic.position.start_idx) + ":" + diagnostic.message);
+		}
+		return rendered;
+	}
+
+	/**
+	 * Scripted client, collects what the server sends.
+	 */
+	struct Client {
+		std::vector<seam::lsp::Json> received;
+		seam::lsp::Server server { [this](const seam::lsp::Json& message) { received.push_back(message); } };
+		int next_id = 1;
+
+		seam::lsp::Json request(const std::string& method, seam::lsp::Json params) {
+			const auto id = next_id++;
+			server.handle(seam::lsp::Json::Object { { "jsonrpc", "2.0" }, { "id", id }, { "method", method }, { "params", std::move(params) } });
+			for (const auto& message : received) {
+				if (message["id"] == seam::lsp::Json(id)) {
+					return message;
+				}
+			}
+			FAIL("no response");
+			return nullptr;
+		}
+
+		void notify(const std::string& method, seam::lsp::Json params) {
+			server.handle(seam::lsp::Json::Object { { "jsonrpc", "2.0" }, { "method", method }, { "params", std::move(params) } });
+		}
+	};
+
+	seam::lsp::Json position(const int line, const int character) {
+		return seam::lsp::Json::Object { { "line", line }, { "character", character } };
+	}
+
+	seam::lsp::Json text_position(const int line, const int character) {
+		return seam::lsp::Json::Object {
+			{ "textDocument", seam::lsp::Json::Object { { "uri", "file:///main.seam" } } },
+			{ "position", position(line, character) }
+		};
+	}
+}
+
+TEST_CASE("json round trips") {
+	const auto text = R"({"array":[1,-2.5,true,false,null],"nested":{"empty":{},"list":[]},"text":"a\"b\\c\ndé😀"})";
+	const auto json = seam::lsp::Json::parse(text);
+
+	REQUIRE(json["array"].as_array().size() == 5);
+	REQUIRE(json["array"].as_array()[1].as_number() == -2.5);
+	REQUIRE(json["text"].as_string() == "a\"b\\c\nd\xc3\xa9\xf0\x9f\x98\x80");
+	REQUIRE(json["missing"].is_null());
+	REQUIRE(seam::lsp::Json::parse(json.dump()) == json);
+	REQUIRE(seam::lsp::Json(seam::lsp::Json::Object { { "id", 7 } }).dump() == R"({"id":7})");
+}
+
+TEST_CASE("malformed json is rejected") {
+	const auto text = GENERATE(R"({"a":})", R"([1,2)", R"("open)", R"({"a" 1})", R"(tru)", R"(1 2)", R"("\x")");
+	REQUIRE_THROWS_AS(seam::lsp::Json::parse(text), seam::ProtocolException);
+	REQUIRE_THROWS_AS(seam::lsp::Json::parse(std::string(10000, '[')), seam::ProtocolException);
+}
+
+TEST_CASE("messages are framed by content length") {
+	std::stringstream stream;
+	seam::lsp::write_message(stream, R"({"a":1})");
+	seam::lsp::write_message(stream, "[]");
+
+	REQUIRE(seam::lsp::read_message(stream) == R"({"a":1})");
+	REQUIRE(seam::lsp::read_message(stream) == "[]");
+	REQUIRE_FALSE(seam::lsp::read_message(stream));
+}
+
+TEST_CASE("edits only reparse the declarations they touch") {
+	seam::lsp::Document document(generate_module(500));
+	REQUIRE(document.diagnostics().empty());
+
+	// inside the body of f250
+	const seam::lsp::Position position { 250 * 6 + 2, 11 };
+	document.edit({ position, position }, "+ y ");
+
+	REQUIRE(document.reparsed_declarations() <= 2);
+	REQUIRE(render(document) == std::vector<std::string> {
+		std::to_string(document.offset(position) + 2) + ":use of undeclared identifier 'y'"
+	});
+
+	document.edit({ position, { position.line, position.character + 4 } }, "");
+	REQUIRE(document.reparsed_declarations() <= 2);
+	REQUIRE(document.diagnostics().empty());
+	REQUIRE(document.text() == generate_module(500));
+}
+
+TEST_CASE("imports are parsed in documents") {
+	seam::lsp::Document document("import math\nimport geometry.shapes\nfn f() -> i64 { return 1 }");
+	REQUIRE(document.diagnostics().empty());
+
+	document.replace("import 42\nfn f() -> i64 { return 1 }");
+	REQUIRE(render(document) == std::vector<std::string> { "7:expected <identifier>, got <number_literal>" });
+}
+
+TEST_CASE("positions count characters") {
+	const std::string text = "fn f() {\n\tlet s := \"é😀x\"\n}";
+	seam::lsp::Document document(text, seam::lsp::PositionEncoding::Utf32);
+
+	const auto x = text.find('x');
+	REQUIRE(document.position(x).line == 1);
+	REQUIRE(document.position(x).character == 13);
+	REQUIRE(document.offset({ 1, 13 }) == x);
+	REQUIRE(document.offset({ 1, 100 }) == text.find('\n', x));
+
+	document.edit({ { 1, 11 }, { 1, 13 } }, "ab");
+	REQUIRE(document.text() == "fn f() {\n\tlet s := \"abx\"\n}");
+}
+
+TEST_CASE("positions count utf-16 code units by default") {
+	const std::string text = "fn f() {\n\tlet s := \"é😀x\"\n}";
+	seam::lsp::Document document(text);
+
+	// the emoji is past U+FFFF and takes a surrogate pair
+	const auto x = text.find('x');
+	REQUIRE(document.position(x).line == 1);
+	REQUIRE(document.position(x).character == 14);
+	REQUIRE(document.offset({ 1, 14 }) == x);
+	REQUIRE(document.offset({ 1, 12 }) == text.find("😀"));
+	REQUIRE(document.offset({ 1, 100 }) == text.find('\n', x));
+
+	document.edit({ { 1, 11 }, { 1, 14 } }, "ab");
+	REQUIRE(document.text() == "fn f() {\n\tlet s := \"abx\"\n}");
+}
+
+TEST_CASE("edits that open strings swallow later declarations") {
+	seam::lsp::Document document(generate_module(10));
+
+	const seam::lsp::Position position { 3 * 6 + 2, 1 };
+	document.edit({ position, position }, "\"");
+	REQUIRE(render(document) == render(*std::make_unique<seam::lsp::Document>(document.text())));
+	REQUIRE_FALSE(document.diagnostics().empty());
+
+	document.edit({ position, { position.line, position.character + 1 } }, "");
+	REQUIRE(document.reparsed_declarations() > 2);
+	REQUIRE(document.diagnostics().empty());
+}
+
+TEST_CASE("incremental edits match a fresh parse") {
+	const char* fragments[] = {
+		"fn", "type", " ", "\n", "{", "}", "(", ")", "\"", "//", "///", "x", "f3", "let y := 1\n",
+		"return ", "1.2.3", ":=", "a", "fn g() { }\n", "type T = i64\n", "type R { fn m() {} }\n", "import m\n",
+	};
+	std::mt19937 random(GENERATE(range(0u, 8u)));
+
+	auto text = generate_module(12);
+	seam::lsp::Document document(text);
+
+	for (auto step = 0; step < 60; step++) {
+		const auto start = std::uniform_int_distribution<size_t>(0, text.length())(random);
+		const auto length = std::uniform_int_distribution<size_t>(0, std::min<size_t>(text.length() - start, 12))(random);
+		const std::string insert = random() % 3 ? fragments[random() % std::size(fragments)] : "";
+
+		document.edit({ document.position(start), document.position(start + length) }, insert);
+		text.replace(start, length, insert);
+
+		REQUIRE(document.text() == text);
+		seam::lsp::Document fresh(text);
+		REQUIRE(render(document) == render(fresh));
+	}
+}
+
+TEST_CASE("hover and definition through the protocol") {
+	Client client;
+
+	const auto initialize = client.request("initialize", seam::lsp::Json::Object {});
+	REQUIRE(initialize["result"]["capabilities"]["hoverProvider"].as_bool());
+
+	client.notify("initialized", seam::lsp::Json::Object {});
+	client.notify("textDocument/didOpen", seam::lsp::Json::Object {
+		{ "textDocument", seam::lsp::Json::Object {
+			{ "uri", "file:///main.seam" },
+			{ "languageId", "seam" },
+			{ "version", 1 },
+			{ "text", "fn add(a: i64, b: i64) -> i64 {\n\tlet sum := a + b\n\treturn sum\n}\n" }
+		} }
+	});
+
+	// nothing is published until the client goes quiet
+	REQUIRE(client.received.size() == 1);
+	client.server.idle();
+	REQUIRE(client.received.back()["method"].as_string() == "textDocument/publishDiagnostics");
+	REQUIRE(client.received.back()["params"]["diagnostics"].as_array().empty());
+
+	const auto hover = client.request("textDocument/hover", text_position(2, 9));
+	REQUIRE(hover["result"]["contents"]["value"].as_string() == "```seam\nlet sum: i64\n```");
+
+	const auto definition = client.request("textDocument/definition", text_position(2, 9));
+	REQUIRE(definition["result"]["range"]["start"] == position(1, 5));
+	REQUIRE(definition["result"]["range"]["end"] == position(1, 8));
+
+	REQUIRE(client.request("textDocument/hover", text_position(0, 1))["result"].is_null());
+
+	client.notify("textDocument/didChange", seam::lsp::Json::Object {
+		{ "textDocument", seam::lsp::Json::Object { { "uri", "file:///main.seam" }, { "version", 2 } } },
+		{ "contentChanges", seam::lsp::Json::Array {
+			seam::lsp::Json::Object {
+				{ "range", seam::lsp::Json::Object { { "start", position(1, 16) }, { "end", position(1, 17) } } },
+				{ "text", "c" }
+			}
+		} }
+	});
+	client.server.idle();
+
+	const auto diagnostics = client.received.back()["params"]["diagnostics"].as_array();
+	REQUIRE(diagnostics.size() == 1);
+	REQUIRE(diagnostics[0]["message"].as_string() == "use of undeclared identifier 'c'");
+	REQUIRE(diagnostics[0]["range"]["start"] == position(1, 16));
+
+	const auto hover_add = client.request("textDocument/hover", text_position(0, 4));
+	REQUIRE(hover_add["result"]["contents"]["value"].as_string() == "```seam\nfn add: fn(i64, i64) -> i64\n```");
+
+	REQUIRE(client.request("workspace/symbol", seam::lsp::Json::Object {})["error"]["code"].as_int() == -32601);
+}
+
+TEST_CASE("position encoding is negotiated") {
+	const auto offers = GENERATE(
+		std::make_pair(seam::lsp::Json::Array {}, "utf-16"),
+		std::make_pair(seam::lsp::Json::Array { "utf-8", "utf-16" }, "utf-16"),
+		std::make_pair(seam::lsp::Json::Array { "utf-16", "utf-32" }, "utf-32"));
+
+	Client client;
+	const auto capabilities = offers.first.empty()
+		? seam::lsp::Json(seam::lsp::Json::Object {})
+		: seam::lsp::Json(seam::lsp::Json::Object { { "general", seam::lsp::Json::Object { { "positionEncodings", offers.first } } } });
+	const auto initialize = client.request("initialize", seam::lsp::Json::Object { { "capabilities", capabilities } });
+	REQUIRE(initialize["result"]["capabilities"]["positionEncoding"].as_string() == offers.second);
+
+	client.notify("textDocument/didOpen", seam::lsp::Json::Object {
+		{ "textDocument", seam::lsp::Json::Object {
+			{ "uri", "file:///main.seam" },
+			{ "languageId", "seam" },
+			{ "version", 1 },
+			{ "text", "fn g(s: string, a: i64) -> i64 {\n\treturn a\n}\nfn f(a: i64) -> i64 {\n\treturn g(\"😀\", a)\n}\n" }
+		} }
+	});
+
+	// the emoji is one code point but two utf-16 code units
+	const auto wide = std::string(offers.second) == "utf-16" ? 1 : 0;
+	auto hover = client.request("textDocument/hover", text_position(4, 15 + wide));
+	REQUIRE(hover["result"]["contents"]["value"].as_string() == "```seam\na: i64\n```");
+	REQUIRE(hover["result"]["range"]["start"] == position(4, 15 + wide));
+	REQUIRE(hover["result"]["range"]["end"] == position(4, 16 + wide));
+
+	client.notify("textDocument/didChange", seam::lsp::Json::Object {
+		{ "textDocument", seam::lsp::Json::Object { { "uri", "file:///main.seam" }, { "version", 2 } } },
+		{ "contentChanges", seam::lsp::Json::Array {
+			seam::lsp::Json::Object {
+				{ "range", seam::lsp::Json::Object { { "start", position(4, 12 + wide) }, { "end", position(4, 12 + wide) } } },
+				{ "text", "x" }
+			}
+		} }
+	});
+
+	hover = client.request("textDocument/hover", text_position(4, 16 + wide));
+	REQUIRE(hover["result"]["contents"]["value"].as_string() == "```seam\na: i64\n```");
+	REQUIRE(hover["result"]["range"]["start"] == position(4, 16 + wide));
+}
+
+TEST_CASE("running over a stream") {
+	std::stringstream in;
+	const auto send = [&](const seam::lsp::Json& message) { seam::lsp::write_message(in, message.dump()); };
+
+	send(seam::lsp::Json::Object { { "jsonrpc", "2.0" }, { "id", 1 }, { "method", "initialize" }, { "params", seam::lsp::Json::Object {} } });
+	send(seam::lsp::Json::Object { { "jsonrpc", "2.0" }, { "method", "textDocument/didOpen" }, { "params", seam::lsp::Json::Object {
+		{ "textDocument", seam::lsp::Json::Object { { "uri", "file:///a.seam" }, { "text", "fn main() { let x := y }" } } }
+	} } });
+	send(seam::lsp::Json::Object { { "jsonrpc", "2.0" }, { "id", 2 }, { "method", "shutdown" } });
+	send(seam::lsp::Json::Object { { "jsonrpc", "2.0" }, { "method", "exit" } });
+
+	std::stringstream out;
+	seam::lsp::Server server([](const seam::lsp::Json&) {});
+	REQUIRE(server.run(in, out) == 0);
+
+	std::vector<seam::lsp::Json> received;
+	while (const auto body = seam::lsp::read_message(out)) {
+		received.push_back(seam::lsp::Json::parse(*body));
+	}
+
+	// the script never pauses, so diagnostics are never published
+	REQUIRE(received.size() == 2);
+	REQUIRE(received[0]["id"].as_int() == 1);
+	REQUIRE(received[1]["id"].as_int() == 2);
+}
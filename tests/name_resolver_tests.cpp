@@ -0,0 +1,121 @@
+#include <catch2/catch.hpp>
+#include <parser/parser.h>
+#include <semantic/name_resolver.h>
+
+namespace {
+	std::unique_ptr<seam::ast::Program> resolve(const std::string& raw_source, seam::semantic::Context& context) {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+
+		auto program = parser.parse();
+
+		seam::semantic::NameResolver resolver(context);
+		program->accept(resolver);
+
+		return program;
+	}
+}
+
+TEST_CASE("scoped symbol table shadows and restores bindings", "[SymbolTable]") {
+	seam::semantic::ScopedSymbolTable table;
+	seam::symbol::Symbol outer { seam::symbol::SymbolType::Variable, 1, { 0, 0 } };
+	seam::symbol::Symbol inner { seam::symbol::SymbolType::Variable, 1, { 1, 1 } };
+
+	REQUIRE(table.declare(1, &outer) == nullptr);
+	REQUIRE(table.declare(1, &inner) == &outer); // same scope
+
+	table.push_scope();
+	REQUIRE(table.declare(1, &inner) == nullptr);
+	REQUIRE(table.lookup(1) == &inner);
+	table.pop_scope();
+
+	REQUIRE(table.lookup(1) == &outer);
+	REQUIRE(table.lookup(2) == nullptr);
+
+	SECTION("growing keeps bindings") {
+		std::vector<seam::symbol::Symbol> symbols(1000, outer);
+
+		table.push_scope();
+		for (seam::symbol::SymbolId id = 2; id < 1000; id++) {
+			REQUIRE(table.declare(id, &symbols[id]) == nullptr);
+		}
+		for (seam::symbol::SymbolId id = 2; id < 1000; id++) {
+			REQUIRE(table.lookup(id) == &symbols[id]);
+		}
+		table.pop_scope();
+
+		REQUIRE(table.lookup(500) == nullptr);
+		REQUIRE(table.lookup(1) == &outer);
+	}
+}
+
+TEST_CASE("resolving names") {
+	seam::semantic::Context context;
+	const auto program = resolve(R"(
+		fn main(a: i64) {
+			let x := a
+			if (x == 1) {
+				let x := helper(x)
+			}
+			x = x + 1
+		}
+
+		fn helper(value: i64) -> i64 {
+			main(value)
+		}
+	)", context);
+
+	REQUIRE_FALSE(context.has_errors());
+
+	const auto main = dynamic_cast<seam::ast::FunctionDeclaration*>(program->body[0].get());
+	const auto let = dynamic_cast<seam::ast::statement::LetStatement*>(main->body->statements[0].get());
+	const auto a = dynamic_cast<seam::ast::expression::Identifier*>(let->expr.get());
+
+	REQUIRE(a->symbol);
+	REQUIRE(a->symbol->type == seam::symbol::SymbolType::Parameter);
+	REQUIRE(context.interner().name(a->symbol->name) == "a");
+}
+
+TEST_CASE("reporting name errors") {
+	seam::semantic::Context context;
+	resolve(R"(
+		fn main(a: i64) {
+			let x := y
+			let a := 1
+			let a := 2
+			x(1)
+		}
+	)", context);
+
+	// parameters share the body's scope, so both lets redeclare a
+	const auto& diagnostics = context.diagnostics();
+	REQUIRE(diagnostics.size() == 4);
+	REQUIRE(diagnostics[0].message() == "use of undeclared identifier 'y'");
+	REQUIRE(diagnostics[1].message() == "redeclaration of 'a'");
+	REQUIRE(diagnostics[2].message() == "redeclaration of 'a'");
+	REQUIRE(diagnostics[3].message() == "'x' is not a function");
+}
+
+TEST_CASE("undeclared names are not interned") {
+	seam::semantic::Context context;
+	resolve("fn main(a: i64) { let b := a + undeclared { let a := 1 } }", context);
+
+	// a nested block may still shadow a parameter
+	REQUIRE(context.diagnostics().size() == 1);
+	REQUIRE_FALSE(context.interner().find("undeclared"));
+}
+
+TEST_CASE("resolving deeply nested blocks") {
+	std::string body = "let v := 0 ";
+	for (auto i = 0; i < 200; i++) {
+		body += "{ let v := v + 1 ";
+	}
+	for (auto i = 0; i < 200; i++) {
+		body += "} ";
+	}
+
+	seam::semantic::Context context;
+	resolve("fn main() { " + body + "}", context);
+
+	REQUIRE_FALSE(context.has_errors());
+}
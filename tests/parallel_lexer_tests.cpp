@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+#include <parser/parallel_lexer.h>
+#include <parser/parser.h>
+#include <ast/print_visitor.h>
+
+#include <random>
+
+namespace {
+	void require_same_tokens(const seam::Source* source, seam::TokenSource& tokens) {
+		seam::Lexer lexer(source);
+
+		while (true) {
+			REQUIRE(tokens.peek() == lexer.peek());
+			const auto expected = lexer.next();
+			const auto token = tokens.next();
+
+			REQUIRE(token->type == expected->type);
+			REQUIRE(token->lexeme == expected->lexeme);
+			REQUIRE(token->position.start_idx == expected->position.start_idx);
+			REQUIRE(token->position.end_idx == expected->position.end_idx);
+			REQUIRE(token->error == expected->error);
+
+			if (token->type == seam::TokenType::None) {
+				break;
+			}
+		}
+
+		REQUIRE(tokens.next()->type == seam::TokenType::None);
+	}
+
+	// fragments whose strings and comments straddle chunk boundaries
+	const char* fragments[] = {
+		"fn", "main", "(", ")", "->", "i64", "{", "}", "let", "x", ":=", "12", "0x1F", "2.5",
+		"+=", "==", "&&", "\"a string with spaces\"", "\"\"", "// line comment\n", "/// long\ncomment ///",
+		"\"// not a comment\"", "/// \"not a string\" ///", "\n", "\t", "  ",
+	};
+
+	std::string random_source(const unsigned seed, const size_t length) {
+		std::mt19937 random(seed);
+		std::uniform_int_distribution<size_t> pick(0, std::size(fragments) - 1);
+
+		std::string source;
+		while (source.length() < length) {
+			source += fragments[pick(random)];
+			source += ' ';
+		}
+		return source;
+	}
+}
+
+TEST_CASE("parallel lexer produces the lexer's tokens") {
+	const auto threads = GENERATE(1, 2, 7);
+	const auto seed = GENERATE(range(0u, 20u));
+
+	const auto source = std::make_unique<seam::Source>(random_source(seed, 2000));
+	seam::ParallelLexer lexer(source.get(), threads, 16);
+	require_same_tokens(source.get(), lexer);
+}
+
+TEST_CASE("parallel lexing across straddling tokens") {
+	SECTION("string spanning several chunks") {
+		const auto source = std::make_unique<seam::Source>("let x := \"" + std::string(500, ' ') + "\" let y := 1");
+		seam::ParallelLexer lexer(source.get(), 8, 16);
+		require_same_tokens(source.get(), lexer);
+	}
+
+	SECTION("unterminated comment") {
+		const auto source = std::make_unique<seam::Source>("let x := 1 /// " + std::string(500, ' ') + " let y := 1");
+		seam::ParallelLexer lexer(source.get(), 8, 16);
+		require_same_tokens(source.get(), lexer);
+	}
+
+	SECTION("unterminated string") {
+		const auto source = std::make_unique<seam::Source>("let x := 1 \"" + std::string(500, ' '));
+		seam::ParallelLexer lexer(source.get(), 8, 16);
+		require_same_tokens(source.get(), lexer);
+	}
+
+	SECTION("no whitespace") {
+		const auto source = std::make_unique<seam::Source>(std::string(500, 'a'));
+		seam::ParallelLexer lexer(source.get(), 8, 16);
+		require_same_tokens(source.get(), lexer);
+	}
+
+	SECTION("empty") {
+		const auto source = std::make_unique<seam::Source>("");
+		seam::ParallelLexer lexer(source.get(), 8, 16);
+		require_same_tokens(source.get(), lexer);
+	}
+}
+
+TEST_CASE("parsing from a parallel lexer") {
+	std::string raw_source;
+	for (auto i = 0; i < 50; i++) {
+		raw_source += "fn f" + std::to_string(i) + "(a: i64) -> i64 {\n\t/// \"doc\" ///\n\tlet s := \"a // b\"\n\treturn a + " + std::to_string(i) + "\n}\n";
+	}
+	const auto source = std::make_unique<seam::Source>(raw_source);
+
+	const auto print = [&](std::unique_ptr<seam::TokenSource> tokens) {
+		seam::Parser parser(std::move(tokens));
+		seam::ast::PrintVisitor visitor;
+		parser.parse()->accept(visitor);
+		return visitor.str();
+	};
+
+	REQUIRE(print(std::make_unique<seam::ParallelLexer>(source.get(), 4, 32)) == print(std::make_unique<seam::Lexer>(source.get())));
+}
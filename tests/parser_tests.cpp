@@ -1,10 +1,121 @@
 #include <catch2/catch.hpp>
+#include <functional>
 #include <iostream>
 #include <parser/parser.h>
+#include <driver/compiler.h>
 #include <ast/print_visitor.h>
 
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+namespace {
+	// renders an expression tree as a fully parenthesised string
+	std::string to_sexpr(seam::ast::expression::Expression* expr) {
+		using namespace seam::ast::expression;
+
+		if (const auto binary = dynamic_cast<BinaryExpression*>(expr)) {
+			return "(" + to_sexpr(binary->lhs.get()) + " " + seam::token_type_to_name(binary->op) + " " + to_sexpr(binary->rhs.get()) + ")";
+		}
+		if (const auto unary = dynamic_cast<UnaryExpression*>(expr)) {
+			return "(" + std::string(seam::token_type_to_name(unary->op)) + to_sexpr(unary->expr.get()) + ")";
+		}
+		if (const auto postfix = dynamic_cast<PostfixExpression*>(expr)) {
+			return "(" + to_sexpr(postfix->rhs.get()) + seam::token_type_to_name(postfix->op) + ")";
+		}
+		if (const auto call = dynamic_cast<FunctionCall*>(expr)) {
+			std::string result = to_sexpr(call->function.get()) + "(";
+			for (size_t i = 0; i < call->args.size(); i++) {
+				result += (i ? ", " : "") + to_sexpr(call->args[i].get());
+			}
+			return result + ")";
+		}
+		if (const auto identifier = dynamic_cast<Identifier*>(expr)) {
+			return identifier->identifier;
+		}
+		if (const auto number = dynamic_cast<NumberLiteral*>(expr)) {
+			return number->value;
+		}
+		return "?";
+	}
+
+	// parses a single statement body and returns the expression of its first statement
+	std::string parse_first_expression(const std::string& body) {
+		const auto source = std::make_unique<seam::Source>("fn main() { " + body + " }");
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+
+		const auto program = parser.parse();
+		const auto func = dynamic_cast<seam::ast::FunctionDeclaration*>(program->body.front().get());
+		const auto let = dynamic_cast<seam::ast::statement::LetStatement*>(func->body->statements.front().get());
+
+		return to_sexpr(let->expr.get());
+	}
+
+	std::string repeat(const std::string& text, const size_t count) {
+		std::string result;
+		for (size_t i = 0; i < count; i++) {
+			result += text;
+		}
+		return result;
+	}
+
+	// a program nesting one construct to a depth
+	std::string nested(const std::string& kind, const size_t depth) {
+		if (kind == "parentheses") {
+			return "fn f() { let x := " + repeat("(", depth) + "1" + repeat(")", depth) + " }";
+		}
+		if (kind == "prefix operators") {
+			return "fn f() { let x := " + repeat("- ", depth) + "1 }";
+		}
+		if (kind == "assignments") {
+			return "fn f() { a" + repeat(" = a", depth) + " }";
+		}
+		if (kind == "blocks") {
+			return "fn f() " + repeat("{ ", depth) + repeat("} ", depth);
+		}
+		if (kind == "ifs") {
+			return "fn f() { " + repeat("if (a) { ", depth) + repeat("} ", depth) + "}";
+		}
+		return repeat("type t { ", depth) + repeat("} ", depth);
+	}
+
+	// parses a source, returning the error raised if any
+	std::string parse_error(const std::string& raw_source, const size_t max_depth = seam::default_max_parse_depth) {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		try {
+			seam::Parser(std::make_unique<seam::Lexer>(source.get()), max_depth).parse();
+		} catch (const seam::SeamException& e) {
+			return e.what();
+		}
+		return "";
+	}
+
+	/**
+	 * Runs a function on a thread with a small stack, like the workers
+	 * of a compile pool.
+	 */
+	void run_on_stack(const size_t stack_size, const std::function<void()>& function) {
+#ifdef __linux__
+		pthread_attr_t attributes;
+		pthread_attr_init(&attributes);
+		pthread_attr_setstacksize(&attributes, stack_size);
+
+		pthread_t thread;
+		const auto run = [](void* data) -> void* {
+			(*static_cast<const std::function<void()>*>(data))();
+			return nullptr;
+		};
+		REQUIRE(pthread_create(&thread, &attributes, run, const_cast<std::function<void()>*>(&function)) == 0);
+		pthread_join(thread, nullptr);
+		pthread_attr_destroy(&attributes);
+#else
+		function();
+#endif
+	}
+}
+
 TEST_CASE("test asdasdasd") {
-	const std::wstring raw_source = LR"(
+	const std::string raw_source = R"(
         fn main() {
 			if (true == false) {
 				random_function(1, 2, 3)
@@ -22,6 +133,236 @@ TEST_CASE("test asdasdasd") {
 		seam::ast::PrintVisitor visitor;
 		ast->accept(visitor);
 
-		std::wcout << visitor.str() << std::endl;
+		std::cout << visitor.str() << std::endl;
 	}());
-}
\ No newline at end of file
+}
+
+TEST_CASE("parser raises lexical errors") {
+	const auto source = std::make_unique<seam::Source>(R"(fn main() { let x := 1.2.3 })");
+	seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+
+	REQUIRE_THROWS_AS(parser.parse(), seam::LexicalException);
+}
+
+TEST_CASE("expression precedence and associativity") {
+	REQUIRE(parse_first_expression("let x := 1 + 2 * 3 - 4 / 2") == "((1 + (2 * 3)) - (4 / 2))");
+	REQUIRE(parse_first_expression("let x := a - b - c") == "((a - b) - c)");
+	REQUIRE(parse_first_expression("let x := -a + b") == "((-a) + b)");
+	REQUIRE(parse_first_expression("let x := a == b && c == d") == "((a == b) && (c == d))");
+	REQUIRE(parse_first_expression("let x := f(a, b + 1) * 2") == "(f(a, (b + 1)) * 2)");
+	REQUIRE(parse_first_expression("let x := (a + b) * c") == "((a + b) * c)");
+	REQUIRE(parse_first_expression("a = b = c + 1") == "(a = (b = (c + 1)))");
+	REQUIRE(parse_first_expression("i++") == "(i++)");
+}
+
+TEST_CASE("expression errors") {
+	const auto source = std::make_unique<seam::Source>(R"(fn main() { let x := 1 + })");
+	seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+
+	REQUIRE_THROWS_WITH(parser.parse(), "expected expression after +, got }");
+}
+
+TEST_CASE("long operator chains parse") {
+	std::string chain = "let x := 1";
+	for (auto i = 0; i < 2000; i++) {
+		chain += " + 1";
+	}
+
+	REQUIRE_NOTHROW(parse_first_expression(chain));
+}
+
+TEST_CASE("parallel parsing matches a single pass") {
+	std::string raw_source;
+	for (auto i = 0; i < 40; i++) {
+		raw_source += "fn f" + std::to_string(i) + "(a: i64) -> i64 {\n\tif (a == 0) { return " + std::to_string(i) + " }\n\treturn f0(a - 1)\n}\n";
+		raw_source += "type T" + std::to_string(i) + " = i64\n";
+		raw_source += "type R" + std::to_string(i) + " {\n\tfn inner() { let x := 1 }\n\ttype N = T0\n}\n";
+	}
+	const auto source = std::make_unique<seam::Source>(raw_source);
+
+	const auto print = [](const std::unique_ptr<seam::ast::Program>& program) {
+		seam::ast::PrintVisitor visitor;
+		program->accept(visitor);
+		return visitor.str();
+	};
+
+	seam::Parser sequential(std::make_unique<seam::Lexer>(source.get()));
+	seam::Parser parallel(std::make_unique<seam::Lexer>(source.get()));
+	const auto program = parallel.parse_parallel(4);
+
+	REQUIRE(program->body.size() == 120);
+	REQUIRE(print(program) == print(sequential.parse()));
+}
+
+TEST_CASE("parallel parsing raises the first error") {
+	const auto raw_source = GENERATE(
+		"fn a() {} fn b() { let x := } fn c() { let y := }",
+		"fn a() {} fn b( fn c() {}",
+		"fn a() {} 42 fn c() {}",
+		"fn a() {} } fn c() {}",
+		"fn a() {} fn b() -> fn c() {}",
+		"fn a() {} type B fn c() { 1.2.3 }",
+		"fn a() { 1.2.3 } fn b() { let x := }",
+		"let x := 1 fn a() {}",
+		"fn a() { fn b() {} }",
+		"");
+	const auto source = std::make_unique<seam::Source>(raw_source);
+
+	std::string sequential_error;
+	try {
+		seam::Parser(std::make_unique<seam::Lexer>(source.get())).parse();
+	} catch (const seam::SeamException& e) {
+		sequential_error = e.what() + std::to_string(e.position().start_idx);
+	}
+
+	std::string parallel_error;
+	try {
+		seam::Parser(std::make_unique<seam::Lexer>(source.get())).parse_parallel(3);
+	} catch (const seam::SeamException& e) {
+		parallel_error = e.what() + std::to_string(e.position().start_idx);
+	}
+
+	REQUIRE(parallel_error == sequential_error);
+}
+
+TEST_CASE("imports come before declarations") {
+	const auto source = std::make_unique<seam::Source>("import math\nimport geometry.shapes\nfn f() {}");
+	const auto program = seam::Parser(std::make_unique<seam::Lexer>(source.get())).parse();
+
+	REQUIRE(program->imports.size() == 2);
+	REQUIRE(program->imports[0].module == "math");
+	REQUIRE(program->imports[1].module == "geometry.shapes");
+	REQUIRE(program->imports[1].position.start_idx == 19);
+	REQUIRE(program->body.size() == 1);
+
+	const auto raw_source = GENERATE("fn f() {} import math", "import", "import 42", "import a..b", "import a.");
+	const auto invalid = std::make_unique<seam::Source>(raw_source);
+	REQUIRE_THROWS_AS(seam::Parser(std::make_unique<seam::Lexer>(invalid.get())).parse(), seam::ParserException);
+}
+
+TEST_CASE("nesting is bounded") {
+	const std::string kind = GENERATE("parentheses", "prefix operators", "assignments", "blocks", "ifs", "types");
+	constexpr auto limit = seam::default_max_parse_depth;
+
+	// whatever the construct, parsing gives up with a diagnostic rather than overflowing
+	std::string shallow, deep, configured;
+	run_on_stack(256 * 1024, [&] {
+		shallow = parse_error(nested(kind, limit - 8));
+		deep = parse_error(nested(kind, limit * 64));
+		configured = parse_error(nested(kind, 16), 8);
+	});
+
+	INFO(kind);
+	REQUIRE(shallow.empty());
+	REQUIRE(deep == "nesting is deeper than 256 levels");
+	REQUIRE(configured == "nesting is deeper than 8 levels");
+}
+
+TEST_CASE("long elseif chains parse") {
+	constexpr auto length = 50000;
+
+	std::string raw_source = "fn f(a: i64) -> i64 {\n\tif (a == 0) { return 0 }\n";
+	for (auto i = 1; i <= length; i++) {
+		raw_source += "\telseif (a == " + std::to_string(i) + ") { return " + std::to_string(i) + " }\n";
+	}
+	raw_source += "\telse { return -1 }\n}\n";
+
+	std::unique_ptr<seam::ast::Program> program;
+	run_on_stack(256 * 1024, [&] {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		program = seam::Parser(std::make_unique<seam::Lexer>(source.get())).parse();
+	});
+	REQUIRE(program);
+
+	// each elseif is the only statement of the else block before it
+	const auto func = dynamic_cast<seam::ast::FunctionDeclaration*>(program->body.front().get());
+	auto stat = dynamic_cast<seam::ast::statement::IfStatement*>(func->body->statements.front().get());
+	for (auto i = 0; i < length; i++) {
+		REQUIRE(stat->else_body->statements.size() == 1);
+		stat = dynamic_cast<seam::ast::statement::IfStatement*>(stat->else_body->statements.front().get());
+		REQUIRE(stat);
+	}
+	REQUIRE(dynamic_cast<seam::ast::statement::ReturnStatement*>(stat->else_body->statements.front().get()));
+}
+
+TEST_CASE("long elseif chains compile on a small stack") {
+	// branches that return, and branches that fall through to one value merged across the chain
+	const bool returns = GENERATE(true, false);
+	std::string raw_source = "fn f(a: i64) -> i64 {\n\tlet b := -1\n\tif (a == 0) { return 0 }\n";
+	for (auto i = 1; i <= 50000; i++) {
+		raw_source += "\telseif (a == " + std::to_string(i) + ") { " + (returns ? "return " : "b = ") + std::to_string(i) + " }\n";
+	}
+	raw_source += "\treturn b\n}\n";
+
+	// the passes after the parser follow the chain in a loop too
+	const auto emit = GENERATE(seam::driver::EmitKind::Object, seam::driver::EmitKind::C, seam::driver::EmitKind::Ir);
+	seam::driver::CompileResult result;
+	run_on_stack(256 * 1024, [&] {
+		seam::driver::TimeReport report;
+		result = seam::driver::compile("chain.seam", raw_source, seam::driver::CompileOptions { emit }, report);
+	});
+
+	REQUIRE(result.diagnostics.empty());
+	REQUIRE(result.output);
+}
+
+TEST_CASE("nesting within the limit compiles on a small stack") {
+	constexpr auto depth = seam::default_max_parse_depth - 8;
+	const std::string kind = GENERATE("parentheses", "prefix operators", "blocks", "ifs", "elseifs", "types");
+	const auto emit = GENERATE(seam::driver::EmitKind::Object, seam::driver::EmitKind::C, seam::driver::EmitKind::Ir);
+
+	std::string raw_source;
+	if (kind == "parentheses") {
+		raw_source = "fn f() -> i64 { return " + repeat("(", depth) + "1" + repeat(")", depth) + " }";
+	} else if (kind == "prefix operators") {
+		raw_source = "fn f() -> i64 { return " + repeat("- ", depth) + "1 }";
+	} else if (kind == "blocks") {
+		raw_source = "fn f() -> i64 " + repeat("{ ", depth) + "return 1 " + repeat("} ", depth);
+	} else if (kind == "ifs") {
+		raw_source = "fn f(a: bool) -> i64 { " + repeat("if (a) { ", depth) + repeat("} ", depth) + "return 1 }";
+	} else if (kind == "elseifs") {
+		raw_source = "fn f(a: i64) -> i64 { if (a == 0) { return 0 }";
+		for (auto i = 1; i <= depth; i++) {
+			raw_source += " elseif (a == " + std::to_string(i) + ") { return " + std::to_string(i) + " }";
+		}
+		raw_source += " return -1 }";
+	} else {
+		raw_source = repeat("type t { ", depth) + "fn f() -> i64 { return 1 } " + repeat("} ", depth);
+	}
+
+	// every pass after the parser stays within the stack the parser does
+	seam::driver::CompileResult result;
+	run_on_stack(256 * 1024, [&] {
+		seam::driver::TimeReport report;
+		result = seam::driver::compile("nested.seam", raw_source, seam::driver::CompileOptions { emit }, report);
+	});
+
+	INFO(kind);
+	REQUIRE(result.diagnostics.empty());
+	REQUIRE(result.output);
+}
+
+TEST_CASE("deep trees are torn down in bounded stack") {
+	// a million levels would take tens of megabytes of stack to destroy recursively
+	run_on_stack(256 * 1024, [] {
+		std::unique_ptr<seam::ast::expression::Expression> expr = std::make_unique<seam::ast::expression::Identifier>("a");
+		for (auto i = 0; i < 1000000; i++) {
+			expr = std::make_unique<seam::ast::expression::BinaryExpression>(
+				seam::TokenType::OpAdd, std::move(expr), std::make_unique<seam::ast::expression::NumberLiteral>(int64_t { 1 }));
+		}
+		expr.reset();
+
+		std::unique_ptr<seam::ast::statement::StatementBlock> block;
+		for (auto i = 0; i < 100000; i++) {
+			seam::ast::statement::StatementList list;
+			list.push_back(std::make_unique<seam::ast::statement::IfStatement>(
+				std::make_unique<seam::ast::expression::BooleanLiteral>(true), std::move(block)));
+			block = std::make_unique<seam::ast::statement::StatementBlock>(std::move(list));
+		}
+		seam::ast::DeclarationList body;
+		body.push_back(std::make_unique<seam::ast::FunctionDeclaration>("f", seam::ast::ParameterList {}, "", std::move(block)));
+		seam::ast::Program program(std::move(body));
+	});
+
+	SUCCEED("trees were destroyed on a 256 KB stack");
+}
@@ -0,0 +1,117 @@
+#include <catch2/catch.hpp>
+#include <ast/recursive_visitor.h>
+#include <parser/parser.h>
+
+#include <stdexcept>
+
+namespace {
+	std::unique_ptr<seam::ast::Program> parse(const std::string& raw_source) {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+		return parser.parse();
+	}
+
+	/**
+	 * Records the hooks run, leaving out declarations and blocks.
+	 */
+	class Tracer final : public seam::ast::RecursiveVisitor<Tracer> {
+	public:
+		std::vector<std::string> trace;
+		bool skip_arguments = false;
+
+		void enter(seam::ast::expression::Identifier& expr) { trace.push_back(expr.identifier); }
+		void enter(seam::ast::expression::NumberLiteral& expr) { trace.push_back(expr.value); }
+		void leave(seam::ast::expression::NumberLiteral& expr) { trace.push_back("/" + expr.value); }
+		void enter(seam::ast::expression::BinaryExpression& expr) { trace.emplace_back("binary"); }
+		void leave(seam::ast::expression::BinaryExpression& expr) { trace.emplace_back("/binary"); }
+
+		bool enter(seam::ast::expression::FunctionCall& expr) {
+			trace.emplace_back("call");
+			return !skip_arguments;
+		}
+
+		void leave(seam::ast::expression::FunctionCall& expr) { trace.emplace_back("/call"); }
+
+		void enter(seam::ast::statement::LetStatement& stat) {
+			if (stat.name == "fail") {
+				throw std::runtime_error("fail");
+			}
+		}
+
+		void leave(seam::ast::statement::LetStatement& stat) { trace.push_back("let " + stat.name); }
+	};
+
+	class Counter final : public seam::ast::RecursiveVisitor<Counter> {
+	public:
+		size_t calls = 0;
+
+		void enter(seam::ast::expression::FunctionCall& call) { calls++; }
+	};
+
+	class Declarations final : public seam::ast::RecursiveVisitor<Declarations> {
+	public:
+		std::vector<std::string> names;
+
+		void leave(seam::ast::statement::LetStatement& stat) { names.push_back(stat.name); }
+	};
+}
+
+TEST_CASE("hooks run around children in source order") {
+	const auto program = parse("fn main() { let a := f(1 + b, 2) }");
+	Tracer tracer;
+	program->accept(tracer);
+
+	REQUIRE(tracer.trace == std::vector<std::string> {
+		"call", "f", "binary", "1", "/1", "b", "/binary", "2", "/2", "/call", "let a"
+	});
+}
+
+TEST_CASE("passes may hook only entering or only leaving") {
+	const auto program = parse("fn main() { let a := f(g(1)) let b := h() }");
+
+	Counter counter;
+	program->accept(counter);
+	REQUIRE(counter.calls == 3);
+
+	Declarations declarations;
+	program->accept(declarations);
+	REQUIRE(declarations.names == std::vector<std::string> { "a", "b" });
+}
+
+TEST_CASE("entering can skip a subtree") {
+	const auto program = parse("fn main() { let a := f(1 + b, 2) + 3 }");
+	Tracer tracer;
+	tracer.skip_arguments = true;
+	program->accept(tracer);
+
+	REQUIRE(tracer.trace == std::vector<std::string> { "binary", "call", "3", "/3", "/binary", "let a" });
+}
+
+TEST_CASE("walks start over after a hook throws") {
+	const auto failing = parse("fn main() { let a := 1 let fail := 2 let b := 3 }");
+	const auto program = parse("fn main() { let c := 4 }");
+	Tracer tracer;
+
+	REQUIRE_THROWS_AS(failing->accept(tracer), std::runtime_error);
+	tracer.trace.clear();
+	program->accept(tracer);
+
+	REQUIRE(tracer.trace == std::vector<std::string> { "4", "/4", "let c" });
+}
+
+TEST_CASE("deep trees are walked without recursion") {
+	// a million levels would take tens of megabytes of stack to walk recursively
+	std::unique_ptr<seam::ast::expression::Expression> expr = std::make_unique<seam::ast::expression::Identifier>("a");
+	for (auto i = 0; i < 1000000; i++) {
+		expr = std::make_unique<seam::ast::expression::BinaryExpression>(
+			seam::TokenType::OpAdd, std::move(expr), std::make_unique<seam::ast::expression::NumberLiteral>(int64_t { 1 }));
+	}
+
+	Tracer tracer;
+	expr->accept(tracer);
+
+	REQUIRE(tracer.trace.size() == 4000001);
+	REQUIRE(tracer.trace.front() == "binary");
+	REQUIRE(tracer.trace[1000000] == "a");
+	REQUIRE(tracer.trace.back() == "/binary");
+}
@@ -2,7 +2,7 @@
 #include <source.h>
 
 TEST_CASE("source reader reads next characters", "[SourceReader]") {
-	const std::wstring test_source_1 = L"The quick brown fox jumped over the lazy dog";
+	const std::string test_source_1 = "The quick brown fox jumped over the lazy dog";
 	const auto source = std::make_unique<seam::Source>(test_source_1);
 
 	seam::SourceReader source_reader{
@@ -23,12 +23,12 @@ TEST_CASE("source reader reads next characters", "[SourceReader]") {
 		for (size_t it = 0; it < source_reader.length(); it++) {
 			static_cast<void>(source_reader.next_char());
 		}
-		REQUIRE(source_reader.next_char() == WEOF);
+		REQUIRE(source_reader.next_char() == EOF);
 	}
 }
 
 TEST_CASE("source reader consumes correctly", "[SourceReader]") {
-	const std::wstring test_source_1 = L"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.";
+	const std::string test_source_1 = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.";
 	const auto source = std::make_unique<seam::Source>(test_source_1);
 
 	seam::SourceReader source_reader{
@@ -59,7 +59,7 @@ TEST_CASE("source reader consumes correctly", "[SourceReader]") {
 }
 
 TEST_CASE("source reader peeks correctly", "[SourceReader]") {
-	const std::wstring test_source_1 = L"The quick brown fox jumped over the lazy dog";
+	const std::string test_source_1 = "The quick brown fox jumped over the lazy dog";
 	const auto source = std::make_unique<seam::Source>(test_source_1);
 
 	seam::SourceReader source_reader {
@@ -80,12 +80,12 @@ TEST_CASE("source reader peeks correctly", "[SourceReader]") {
 	}
 
 	SECTION("peek out of bounds") {
-		REQUIRE(source_reader.peek_char(1000) == WEOF);
+		REQUIRE(source_reader.peek_char(1000) == EOF);
 	}
 }
 
 TEST_CASE("get source string from source object", "[Source]") {
-    const std::wstring test_source_1 = L"The quick brown fox jumped over the lazy dog";
+    const std::string test_source_1 = "The quick brown fox jumped over the lazy dog";
     const auto source = std::make_unique<seam::Source>(test_source_1);
 
     seam::SourceReader source_reader {
@@ -95,9 +95,30 @@ TEST_CASE("get source string from source object", "[Source]") {
     REQUIRE(source->get() == test_source_1);
 }
 
+TEST_CASE("sources are read as UTF-8 bytes", "[SourceReader]") {
+	const auto source = std::make_unique<seam::Source>("é\"");
+	seam::SourceReader source_reader{
+		source.get()
+	};
+
+	REQUIRE(source_reader.length() == 3);
+	REQUIRE(source_reader.next_char() == 0xc3);
+	REQUIRE(source_reader.next_char() == 0xa9);
+	REQUIRE(source_reader.next_char() == '"');
+	REQUIRE(source_reader.next_char() == EOF);
+	REQUIRE(source_reader.consume() == "é\"");
+
+	REQUIRE(seam::is_valid_utf8("plain, é, € and 😀"));
+	REQUIRE_FALSE(seam::is_valid_utf8("\xc3"));
+	REQUIRE_FALSE(seam::is_valid_utf8("\xc0\xaf"));
+	REQUIRE_FALSE(seam::is_valid_utf8("\xed\xa0\x80"));
+	REQUIRE_FALSE(seam::is_valid_utf8("\xf4\x90\x80\x80"));
+	REQUIRE_FALSE(seam::is_valid_utf8("\xff"));
+}
+
 /*
 TEST_CASE("source reader reads correctly", "[SourceReader]") {
-	const std::wstring test_source_1 = L"The quick brown fox jumped over the lazy dog";
+	const std::string test_source_1 = "The quick brown fox jumped over the lazy dog";
 	const auto source = std::make_unique<seam::Source>(test_source_1);
 	
 	seam::SourceReader source_reader {
@@ -139,15 +160,15 @@ TEST_CASE("source reader reads correctly", "[SourceReader]") {
 	SECTION("read overflow") {
 		source_reader.discard(source_reader.length());
 		
-		REQUIRE(source_reader.peek_char() == WEOF);
-		REQUIRE(source_reader.next_char() == WEOF);
+		REQUIRE(source_reader.peek_char() == EOF);
+		REQUIRE(source_reader.next_char() == EOF);
 	}
 
 	SECTION("discard with length out of bound") {
 		source_reader.discard(source_reader.length() + 90);
 
-		REQUIRE(source_reader.peek_char() == WEOF);
-		REQUIRE(source_reader.next_char() == WEOF);
+		REQUIRE(source_reader.peek_char() == EOF);
+		REQUIRE(source_reader.next_char() == EOF);
 	}
 
 	SECTION("discard with length in bound") {
@@ -174,11 +195,11 @@ TEST_CASE("source reader reads correctly", "[SourceReader]") {
 		REQUIRE(source_reader.consume() == test_source_1.substr(read_len));
 	}
 
-	SECTION("get wchar_t out of bound") {
-		REQUIRE(source_reader.get_char(10000) == WEOF);
+	SECTION("get char out of bound") {
+		REQUIRE(source_reader.get_char(10000) == EOF);
 	}
 
-	SECTION("get wchar_t in bound") {
+	SECTION("get char in bound") {
 		REQUIRE(source_reader.get_char(2) == test_source_1[2]);
 	}
 }*/
\ No newline at end of file
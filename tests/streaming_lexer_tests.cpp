@@ -0,0 +1,160 @@
+#include <catch2/catch.hpp>
+#include <parser/parser.h>
+#include <ast/print_visitor.h>
+#include <parser/ring_buffer.h>
+#include <parser/streaming_lexer.h>
+
+#include <thread>
+
+namespace {
+	std::string generate_source(const int functions) {
+		std::string source;
+		for (auto i = 0; i < functions; i++) {
+			source += "fn f" + std::to_string(i) + "(a: i64) -> i64 {\n";
+			source += "\t// comment " + std::to_string(i) + "\n";
+			source += "\tlet s := \"text\"\n\tlet x := a * 2.5 + " + std::to_string(i) + "\n";
+			source += "\twhile (x == a == false) { x += 1 }\n\treturn x\n}\n";
+		}
+		return source;
+	}
+
+	std::string print(std::unique_ptr<seam::TokenSource> tokens) {
+		seam::Parser parser(std::move(tokens));
+		const auto program = parser.parse();
+
+		seam::ast::PrintVisitor visitor;
+		program->accept(visitor);
+		return visitor.str();
+	}
+}
+
+TEST_CASE("ring buffer keeps order across threads") {
+	seam::SpscRingBuffer<int, 8> buffer;
+	constexpr auto count = 100000;
+
+	std::thread producer([&] {
+		for (auto i = 0; i < count; i++) {
+			while (!buffer.try_push(i)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	auto expected = 0;
+	while (expected < count) {
+		if (const auto value = buffer.try_pop()) {
+			REQUIRE(*value == expected);
+			expected++;
+		} else {
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+
+	REQUIRE_FALSE(buffer.try_pop());
+}
+
+TEST_CASE("ring buffer rejects pushes when full") {
+	seam::SpscRingBuffer<int, 2> buffer;
+	auto a = 1, b = 2, c = 3;
+
+	REQUIRE(buffer.try_push(a));
+	REQUIRE(buffer.try_push(b));
+	REQUIRE_FALSE(buffer.try_push(c));
+	REQUIRE(buffer.try_pop() == 1);
+	REQUIRE(buffer.try_push(c));
+	REQUIRE(buffer.try_pop() == 2);
+	REQUIRE(buffer.try_pop() == 3);
+}
+
+TEST_CASE("streaming lexer produces the lexer's tokens") {
+	const auto source = std::make_unique<seam::Source>(generate_source(200) + "1.2.3 \"unterminated");
+
+	// small batches cross many batch boundaries
+	const auto batch_size = GENERATE(1, 7, 256);
+	seam::Lexer lexer(source.get());
+	seam::StreamingLexer streaming(source.get(), batch_size);
+
+	while (true) {
+		REQUIRE(streaming.peek() == lexer.peek());
+		const auto expected = lexer.next();
+		const auto token = streaming.next();
+
+		REQUIRE(token->type == expected->type);
+		REQUIRE(token->lexeme == expected->lexeme);
+		REQUIRE(token->position.start_idx == expected->position.start_idx);
+		REQUIRE(token->position.end_idx == expected->position.end_idx);
+		REQUIRE(token->error == expected->error);
+
+		if (token->type == seam::TokenType::None) {
+			break;
+		}
+	}
+
+	// the end of input repeats, like the lexer
+	REQUIRE(streaming.next()->type == seam::TokenType::None);
+	REQUIRE(streaming.peek() == seam::TokenType::None);
+}
+
+TEST_CASE("streaming lexer repeats the end of input it was given") {
+	const auto source = std::make_unique<seam::Source>(generate_source(10));
+	seam::StreamingLexer streaming(source.get(), 4);
+
+	auto end = streaming.next();
+	while (end->type != seam::TokenType::None) {
+		end = streaming.next();
+	}
+
+	for (auto i = 0; i < 3; i++) {
+		const auto token = streaming.next();
+		REQUIRE(token->type == seam::TokenType::None);
+		REQUIRE(token->position.start_idx == end->position.start_idx);
+		REQUIRE(token->position.end_idx == end->position.end_idx);
+	}
+}
+
+TEST_CASE("ring buffer waits block until the other side moves") {
+	seam::SpscRingBuffer<int, 2> buffer;
+	std::atomic<int> popped = 0;
+
+	std::thread consumer([&] {
+		while (popped < 3) {
+			if (buffer.try_pop()) {
+				popped++;
+			} else {
+				buffer.wait_for_element();
+			}
+		}
+	});
+
+	for (auto value = 0; value < 3; value++) {
+		while (!buffer.try_push(value)) {
+			buffer.wait_for_space();
+		}
+	}
+	consumer.join();
+
+	REQUIRE(popped == 3);
+}
+
+TEST_CASE("parsing from a streaming lexer") {
+	const auto source = std::make_unique<seam::Source>(generate_source(100));
+
+	REQUIRE(print(std::make_unique<seam::StreamingLexer>(source.get(), 16))
+		== print(std::make_unique<seam::Lexer>(source.get())));
+}
+
+TEST_CASE("streaming lexer errors reach the parser") {
+	const auto source = std::make_unique<seam::Source>(R"(fn main() { let x := 1.2.3 })");
+	seam::Parser parser(std::make_unique<seam::StreamingLexer>(source.get()));
+
+	REQUIRE_THROWS_AS(parser.parse(), seam::LexicalException);
+}
+
+TEST_CASE("streaming lexer stops early when destroyed") {
+	// far more batches than the queue holds, the producer is blocked when destroyed
+	const auto source = std::make_unique<seam::Source>(generate_source(2000));
+	seam::StreamingLexer streaming(source.get(), 1);
+
+	REQUIRE(streaming.next()->type == seam::TokenType::KeywordFn);
+}
@@ -0,0 +1,192 @@
+#include <catch2/catch.hpp>
+#include <parser/parser.h>
+#include <semantic/name_resolver.h>
+#include <semantic/type_checker.h>
+
+namespace {
+	std::unique_ptr<seam::ast::Program> check(const std::string& raw_source, seam::semantic::Context& context) {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+
+		auto program = parser.parse();
+
+		seam::semantic::NameResolver resolver(context);
+		program->accept(resolver);
+
+		seam::semantic::TypeChecker checker(context, 1);
+		program->accept(checker);
+
+		return program;
+	}
+
+	std::vector<std::string> messages(const seam::semantic::Context& context) {
+		std::vector<std::string> result;
+		for (const auto& diagnostic : context.diagnostics()) {
+			result.push_back(diagnostic.message());
+		}
+		return result;
+	}
+}
+
+TEST_CASE("type table hash-conses types", "[TypeTable]") {
+	seam::type::TypeTable table;
+	const auto i64 = seam::type::TypeTable::builtin(seam::type::BuiltIn::i64);
+	const auto boolean = seam::type::TypeTable::builtin(seam::type::BuiltIn::Bool);
+
+	const auto function = table.function({ i64, i64 }, boolean);
+	REQUIRE(table.function({ i64, i64 }, boolean) == function);
+	REQUIRE(table.function({ i64 }, boolean) != function);
+	REQUIRE(table.function({ i64, i64 }, i64) != function);
+
+	// records are nominal, each declaration is its own type
+	REQUIRE(table.record(3) != table.record(3));
+
+	REQUIRE(table.is_integer(i64));
+	REQUIRE_FALSE(table.is_integer(boolean));
+	REQUIRE(table.is_float(seam::type::TypeTable::builtin(seam::type::BuiltIn::f32)));
+}
+
+TEST_CASE("checking well typed programs") {
+	seam::semantic::Context context;
+	const auto program = check(R"(
+		type Int = i32
+		type Count = Int
+
+		fn main(a: i64) -> i64 {
+			let x := a + 1
+			let y: Count = 2
+			let z: f64 = 1.5 * 2
+			let flag := x == 3 && true
+			if (flag) {
+				y = y + helper(y, z)
+				y++
+			}
+			return x
+		}
+
+		fn helper(value: i32, scale: f64) -> i32 {
+			return -value
+		}
+	)", context);
+
+	INFO(messages(context).size());
+	REQUIRE_FALSE(context.has_errors());
+
+	const auto main = dynamic_cast<seam::ast::FunctionDeclaration*>(program->body[2].get());
+	const auto& types = context.types();
+	const auto let = [&](const size_t index) {
+		return dynamic_cast<seam::ast::statement::LetStatement*>(main->body->statements[index].get());
+	};
+
+	REQUIRE(let(0)->symbol->type_id == types.builtin(seam::type::BuiltIn::i64));
+	REQUIRE(let(1)->symbol->type_id == types.builtin(seam::type::BuiltIn::i32));
+	REQUIRE(let(1)->expr->type_id == types.builtin(seam::type::BuiltIn::i32));
+	REQUIRE(let(2)->expr->type_id == types.builtin(seam::type::BuiltIn::f64));
+	REQUIRE(let(3)->symbol->type_id == types.builtin(seam::type::BuiltIn::Bool));
+	REQUIRE(types.name(main->symbol->type_id, context.interner()) == "fn(i64) -> i64");
+}
+
+TEST_CASE("reporting type errors") {
+	seam::semantic::Context context;
+	check(R"(
+		type Loop = Loop
+
+		fn main(a: i64) -> bool {
+			let b: Missing = 1
+			let c: bool = a
+			let d := a + true
+			if (a) {
+				1 = a
+			}
+			helper(1)
+			return a
+		}
+
+		fn helper(x: i64, y: i64) {
+			x = 1.5
+		}
+	)", context);
+
+	REQUIRE(messages(context) == std::vector<std::string> {
+		"type alias 'Loop' refers to itself",
+		"unknown type 'Missing'",
+		"expected bool but got i64",
+		"expected i64 but got bool",
+		"expected bool but got i64",
+		"cannot assign to this expression",
+		"'helper' expects 2 argument(s)",
+		"expected bool but got i64",
+		"expected i64 but got f64",
+	});
+}
+
+TEST_CASE("types of the same name in different scopes are distinct") {
+	seam::semantic::Context context;
+	check(R"(
+		type Foo {}
+		type Outer = Foo
+
+		type Scope {
+			type Foo {}
+
+			fn same(x: Foo) -> Foo {
+				return x
+			}
+
+			fn other(x: Outer) -> Foo {
+				return x
+			}
+		}
+	)", context);
+
+	REQUIRE(messages(context) == std::vector<std::string> {
+		"expected Foo but got Foo",
+	});
+}
+
+TEST_CASE("error types do not cascade") {
+	seam::semantic::Context context;
+	check(R"(
+		fn main() {
+			let x := undeclared + 1
+			let y := x * 2 + x
+			let z: i64 = y
+		}
+	)", context);
+
+	REQUIRE(messages(context) == std::vector<std::string> {
+		"use of undeclared identifier 'undeclared'",
+	});
+}
+
+TEST_CASE("parallel body checking matches sequential checking") {
+	std::string source;
+	for (auto i = 0; i < 64; i++) {
+		const auto index = std::to_string(i);
+		source += "fn f" + index + "(a: i64) -> i64 {\n"
+			"\tlet x" + index + ": bool = a\n"
+			"\tlet y := f" + std::to_string((i + 1) % 64) + "(a) + " + index + "\n"
+			"\treturn y\n"
+			"}\n";
+	}
+
+	seam::semantic::Context sequential;
+	const auto sequential_program = check(source, sequential);
+
+	// re-check the same program with several workers
+	seam::semantic::Context parallel;
+	const auto parallel_source = std::make_unique<seam::Source>(source);
+	seam::Parser parser(std::make_unique<seam::Lexer>(parallel_source.get()));
+	const auto parallel_program = parser.parse();
+
+	seam::semantic::NameResolver resolver(parallel);
+	parallel_program->accept(resolver);
+	seam::semantic::TypeChecker checker(parallel, 4);
+	parallel_program->accept(checker);
+
+	REQUIRE(sequential.diagnostics().size() == 64);
+	REQUIRE(messages(parallel) == messages(sequential));
+	for (size_t i = 0; i < 64; i++) {
+		REQUIRE(parallel.diagnostics()[i].position.start_idx == sequential.diagnostics()[i].position.start_idx);
+	}
+}
@@ -0,0 +1,295 @@
+#include <catch2/catch.hpp>
+#include <backend/x86_64/assembler.h>
+#include <backend/x86_64/code_generator.h>
+#include <backend/x86_64/register_allocator.h>
+#include <ir/interpreter.h>
+#include <ir/lowering.h>
+#include <ir/passes.h>
+#include <parser/parser.h>
+#include <semantic/name_resolver.h>
+#include <semantic/type_checker.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+
+using namespace seam::backend::x86_64;
+
+namespace {
+	seam::ir::Module lower(const std::string& raw_source) {
+		const auto source = std::make_unique<seam::Source>(raw_source);
+		seam::Parser parser(std::make_unique<seam::Lexer>(source.get()));
+		const auto program = parser.parse();
+
+		seam::semantic::Context context;
+		seam::semantic::NameResolver resolver(context);
+		program->accept(resolver);
+		seam::semantic::TypeChecker checker(context, 1);
+		program->accept(checker);
+		REQUIRE_FALSE(context.has_errors());
+
+		seam::ir::AstLowering lowering(context);
+		return lowering.lower(*program);
+	}
+
+	std::vector<uint8_t> encode(const std::function<void(Assembler&)>& emit) {
+		Assembler assembler;
+		emit(assembler);
+		return assembler.finish();
+	}
+
+	const auto program = R"(
+		fn fib(n: i64) -> i64 {
+			if (n == 0) {
+				return 0
+			}
+			if (n == 1) {
+				return 1
+			}
+			return fib(n - 1) + fib(n - 2)
+		}
+
+		fn sum(n: i64, a: i64, b: i64) -> i64 {
+			let total := 0
+			let i := 0
+			while (i == n == false) {
+				total += a * b + i / 2 - fib(i / 8)
+				i++
+			}
+			return total
+		}
+
+		fn pressure(a: i64, b: i64) -> i64 {
+			let c := a + b
+			let d := a * b
+			let e := c - d
+			let f := c * 3
+			let g := d + 7
+			let h := e * f
+			let i := g - a
+			let j := fib(h / 1000 / 1000 & 7) + i
+			return a + b + c + d + e + f + g + h + i + j
+		}
+
+		fn divide(a: i64, b: i64) -> i64 {
+			return a / b
+		}
+
+		fn mix(x: f64, n: i64, y: f64) -> f64 {
+			let total: f64 = 0
+			let i := 0
+			while (i == n == false) {
+				total += x * y - x / y
+				i++
+			}
+			return -total
+		}
+
+		fn same(x: f64, y: f64, a: i64) -> bool {
+			return x == y && a == 1
+		}
+	)";
+
+	struct Case {
+		const char* call;
+		std::string function;
+		std::vector<seam::ir::Value> arguments;
+		bool is_float;
+	};
+
+	const std::vector<Case> cases {
+		{ "fib(20)", "fib", { { 20 } }, false },
+		{ "sum(100, 3, 5)", "sum", { { 100 }, { 3 }, { 5 } }, false },
+		{ "pressure(123456, 789)", "pressure", { { 123456 }, { 789 } }, false },
+		{ "divide(-7, 2)", "divide", { { -7 }, { 2 } }, false },
+		{ "divide(INT64_MIN, -1)", "divide", { { INT64_MIN }, { -1 } }, false },
+		{ "mix(1.5, 10, 4.0)", "mix", { { .f64 = 1.5 }, { 10 }, { .f64 = 4.0 } }, true },
+		{ "same(2.0, 2.0, 1)", "same", { { .f64 = 2.0 }, { .f64 = 2.0 }, { 1 } }, false },
+		{ "same(2.0, 3.0, 1)", "same", { { .f64 = 2.0 }, { .f64 = 3.0 }, { 1 } }, false },
+	};
+
+	bool has_c_compiler() {
+#if defined(__linux__) && defined(__x86_64__)
+		return std::system("cc --version > /dev/null 2>&1") == 0;
+#else
+		return false;
+#endif
+	}
+
+	/**
+	 * Links the object with a C driver printing each case and returns
+	 * the output, one line per case.
+	 */
+	std::vector<std::string> run_native(const std::vector<uint8_t>& object) {
+		const auto directory = std::filesystem::temp_directory_path() / "seam_backend_tests";
+		std::filesystem::create_directories(directory);
+
+		std::ofstream(directory / "program.o", std::ios::binary).write(reinterpret_cast<const char*>(object.data()), static_cast<std::streamsize>(object.size()));
+
+		std::ofstream driver(directory / "driver.c");
+		driver << "#include <stdint.h>\n#include <stdio.h>\n#include <string.h>\n"
+			"int64_t fib(int64_t); int64_t sum(int64_t, int64_t, int64_t); int64_t pressure(int64_t, int64_t);\n"
+			"int64_t divide(int64_t, int64_t); double mix(double, int64_t, double); _Bool same(double, double, int64_t);\n"
+			"static void print_float(double value) { int64_t bits; memcpy(&bits, &value, 8); printf(\"%lld\\n\", (long long) bits); }\n"
+			"int main(void) {\n";
+		for (const auto& c : cases) {
+			if (c.is_float) driver << "\tprint_float(" << c.call << ");\n";
+			else driver << "\tprintf(\"%lld\\n\", (long long) " << c.call << ");\n";
+		}
+		driver << "\treturn 0;\n}\n";
+		driver.close();
+
+		const auto executable = directory / "program";
+		const auto command = "cc -o " + executable.string() + " " + (directory / "driver.c").string() + " " + (directory / "program.o").string();
+		REQUIRE(std::system(command.c_str()) == 0);
+
+		std::vector<std::string> lines;
+		auto* pipe = popen(executable.string().c_str(), "r");
+		REQUIRE(pipe != nullptr);
+		char line[64];
+		while (fgets(line, sizeof(line), pipe) != nullptr) {
+			lines.emplace_back(line, strcspn(line, "\n"));
+		}
+		REQUIRE(pclose(pipe) == 0);
+
+		std::filesystem::remove_all(directory);
+		return lines;
+	}
+
+	void require_matches_interpreter(const seam::ir::Module& module) {
+		const auto object = seam::backend::write_elf_object(CodeGenerator().generate(module));
+		const auto lines = run_native(object);
+		REQUIRE(lines.size() == cases.size());
+
+		for (size_t i = 0; i < cases.size(); i++) {
+			seam::ir::Interpreter interpreter(module);
+			const auto expected = interpreter.call(*module.find(cases[i].function), cases[i].arguments).i64;
+			INFO(cases[i].call);
+			REQUIRE(lines[i] == std::to_string(expected));
+		}
+	}
+}
+
+TEST_CASE("encoding x86-64 instructions") {
+	REQUIRE(encode([](auto& a) { a.mov(Register::Rax, Register::Rbx); }) == std::vector<uint8_t> { 0x48, 0x89, 0xd8 });
+	REQUIRE(encode([](auto& a) { a.mov(Register::R12, Register::Rdi); }) == std::vector<uint8_t> { 0x49, 0x89, 0xfc });
+	REQUIRE(encode([](auto& a) { a.push(Register::R15); a.pop(Register::Rbx); }) == std::vector<uint8_t> { 0x41, 0x57, 0x5b });
+	REQUIRE(encode([](auto& a) { a.load(Register::R13, -16); }) == std::vector<uint8_t> { 0x4c, 0x8b, 0xad, 0xf0, 0xff, 0xff, 0xff });
+	REQUIRE(encode([](auto& a) { a.load_indirect(Register::Rax, Register::Rax); }) == std::vector<uint8_t> { 0x48, 0x8b, 0x00 });
+	REQUIRE(encode([](auto& a) { a.load_indirect(Register::Rcx, Register::R12); }) == std::vector<uint8_t> { 0x49, 0x8b, 0x0c, 0x24 });
+	REQUIRE(encode([](auto& a) { a.load_indirect(Register::Rax, Register::R13); }) == std::vector<uint8_t> { 0x49, 0x8b, 0x45, 0x00 });
+	REQUIRE(encode([](auto& a) { a.imul(Register::Rax, Register::Rcx); }) == std::vector<uint8_t> { 0x48, 0x0f, 0xaf, 0xc1 });
+	REQUIRE(encode([](auto& a) { a.mov(Register::Rax, static_cast<int64_t>(-1)); }) == std::vector<uint8_t> { 0x48, 0xc7, 0xc0, 0xff, 0xff, 0xff, 0xff });
+	REQUIRE(encode([](auto& a) { a.movq(XmmRegister::Xmm1, Register::Rcx); }) == std::vector<uint8_t> { 0x66, 0x48, 0x0f, 0x6e, 0xc9 });
+	REQUIRE(encode([](auto& a) { a.sse(SseOperation::Mul, XmmRegister::Xmm0, XmmRegister::Xmm1); }) == std::vector<uint8_t> { 0xf2, 0x0f, 0x59, 0xc1 });
+
+	SECTION("jumps are patched relative to the next instruction") {
+		const auto code = encode([](auto& a) {
+			const auto label = a.create_label();
+			a.jmp(label);
+			a.ret();
+			a.bind(label);
+		});
+		REQUIRE(code == std::vector<uint8_t> { 0xe9, 0x01, 0x00, 0x00, 0x00, 0xc3 });
+	}
+}
+
+TEST_CASE("linear scan allocation") {
+	const auto module = lower(program);
+
+	SECTION("register pressure spills to the stack") {
+		const auto& function = module.functions[*module.find("pressure")];
+		const auto allocation = allocate_registers(function);
+
+		size_t registers = 0, spilled = 0;
+		for (const auto& location : allocation.locations) {
+			registers += location.kind == Location::Kind::Register;
+			spilled += location.kind == Location::Kind::Stack;
+		}
+		REQUIRE(registers > 0);
+		REQUIRE(spilled > 0);
+		REQUIRE(spilled == allocation.spill_slots);
+		REQUIRE(allocation.used_registers.size() == std::size(allocatable_registers));
+	}
+
+	SECTION("functions of a few values are not spilled") {
+		const auto allocation = allocate_registers(module.functions[*module.find("divide")]);
+		REQUIRE(allocation.spill_slots == 0);
+	}
+}
+
+TEST_CASE("writing ELF objects") {
+	const auto object = seam::backend::write_elf_object(CodeGenerator().generate(lower(program)));
+
+	REQUIRE(object.size() > 64);
+	REQUIRE(std::vector<uint8_t>(object.begin(), object.begin() + 4) == std::vector<uint8_t> { 0x7f, 'E', 'L', 'F' });
+	// relocatable, x86-64
+	REQUIRE(object[16] == 1);
+	REQUIRE(object[18] == 62);
+}
+
+TEST_CASE("native code matches the interpreter") {
+	if (!has_c_compiler()) {
+		WARN("no C compiler to link with, skipping");
+		return;
+	}
+
+	SECTION("unoptimised") {
+		require_matches_interpreter(lower(program));
+	}
+
+	SECTION("optimised") {
+		auto module = lower(program);
+		auto manager = seam::ir::PassManager::standard_pipeline();
+		manager.run(module);
+		require_matches_interpreter(module);
+	}
+}
+
+TEST_CASE("functions with stack arguments are rejected") {
+	const auto module = lower("fn many(a: i64, b: i64, c: i64, d: i64, e: i64, f: i64, g: i64) -> i64 { return g }");
+	REQUIRE_THROWS_AS(CodeGenerator().generate(module), seam::CodegenException);
+}
+
+TEST_CASE("calls into other modules are relocated") {
+	auto module = lower(R"(
+		fn helper(x: i64) -> i64 { return x }
+		fn twice(x: i64) -> i64 { return helper(x) + helper(x + 1) }
+	)");
+	// helper becomes a declaration, as if it were imported
+	auto& helper = module.functions[*module.find("helper")];
+	helper.blocks.clear();
+	helper.values.clear();
+
+	const auto code = CodeGenerator().generate(module);
+	REQUIRE(code.symbols.size() == 1);
+	REQUIRE(code.relocations.size() == 2);
+	REQUIRE(code.relocations[0].symbol == "helper");
+	REQUIRE(code.text[code.relocations[0].offset - 1] == 0xe8);
+
+	if (!has_c_compiler()) {
+		WARN("no C compiler to link with, skipping");
+		return;
+	}
+
+	const auto directory = std::filesystem::temp_directory_path() / "seam_relocation_tests";
+	std::filesystem::create_directories(directory);
+	const auto object = seam::backend::write_elf_object(code);
+	std::ofstream(directory / "twice.o", std::ios::binary).write(reinterpret_cast<const char*>(object.data()), static_cast<std::streamsize>(object.size()));
+	std::ofstream(directory / "driver.c") << "#include <stdint.h>\n#include <stdio.h>\n"
+		"int64_t twice(int64_t);\nint64_t helper(int64_t x) { return x * 3; }\n"
+		"int main(void) { printf(\"%lld\\n\", (long long) twice(5)); return 0; }\n";
+
+	const auto executable = directory / "program";
+	const auto command = "cc -o " + executable.string() + " " + (directory / "driver.c").string() + " " + (directory / "twice.o").string()
+		+ " && " + executable.string() + " > " + (directory / "output").string();
+	REQUIRE(std::system(command.c_str()) == 0);
+
+	std::string output;
+	std::ifstream(directory / "output") >> output;
+	std::filesystem::remove_all(directory);
+	REQUIRE(output == "33");
+}